@@ -1,6 +1,7 @@
 import 'dart:async';
 import 'dart:io';
 import 'dart:math';
+import 'dart:typed_data';
 
 import 'package:flutter/material.dart';
 import 'package:flutter/services.dart';
@@ -52,6 +53,22 @@ void main() async {
     },
   );
 
+  await runZonedGuarded(
+    () async => test4(),
+    (error, stack) {
+      stderr.writeln('TEST error: $error\nstack: $stack');
+      exitCode = 1;
+    },
+  );
+
+  await runZonedGuarded(
+    () async => test5(),
+    (error, stack) {
+      stderr.writeln('TEST error: $error\nstack: $stack');
+      exitCode = 1;
+    },
+  );
+
   stdout.write('\n\n\n---\n\n\n');
 
   if (exitCode != 0) {
@@ -122,6 +139,129 @@ Future<void> test3() async {
   await dispose();
 }
 
+/// Test push stream write, playback across the ring end and underruns
+///
+Future<void> test4() async {
+  await initialize();
+
+  final ret = await SoLoud.instance.loadPushStream(
+    channels: 1,
+    bufferFrames: 4096,
+  );
+  assert(
+    ret.error == PlayerErrors.noError && ret.sound != null,
+    'loadPushStream() failed!',
+  );
+  final stream = ret.sound!;
+  var handle = 0;
+  final sine = Float32List.fromList(
+    List.generate(4096, (i) => sin(i * 2 * pi * 440 / 44100) * 0.2),
+  );
+
+  /// Fill most of the ring and let the engine read it all
+  {
+    final written = SoLoud.instance.pushStreamWrite(
+      stream,
+      Float32List.sublistView(sine, 0, 3000),
+    );
+    final info = SoLoud.instance.getPushStreamInfo(stream);
+    assert(
+      written == 3000 &&
+          info.capacityFrames == 4096 &&
+          info.bufferedFrames == 3000 &&
+          info.underruns == 0,
+      'pushStreamWrite() failed!',
+    );
+
+    handle = (await SoLoud.instance.play(stream)).newHandle;
+    await delay(300);
+    final drained = SoLoud.instance.getPushStreamInfo(stream);
+    assert(
+      drained.bufferedFrames == 0 &&
+          drained.underruns == 1 &&
+          drained.silentFrames > 0,
+      'push stream underrun not counted!',
+    );
+  }
+
+  /// A full ring now starts at frame 3000, so both the write and the
+  /// read wrap around its end. The voice is paused while writing so the
+  /// engine doesn't read meanwhile.
+  {
+    SoLoud.instance.setPause(handle, true);
+    final written = SoLoud.instance.pushStreamWrite(stream, sine);
+    final full = SoLoud.instance.getPushStreamInfo(stream);
+    assert(
+      written == 4096 && full.bufferedFrames == 4096,
+      'pushStreamWrite() across the ring end failed!',
+    );
+    assert(
+      SoLoud.instance.pushStreamWrite(stream, sine) == 0,
+      'pushStreamWrite() into a full ring failed!',
+    );
+
+    SoLoud.instance.setPause(handle, false);
+    await delay(300);
+    final drained = SoLoud.instance.getPushStreamInfo(stream);
+    assert(
+      drained.bufferedFrames == 0 && drained.underruns == 2,
+      'push stream read across the ring end failed!',
+    );
+  }
+
+  await dispose();
+}
+
+/// Test the engine status block: every field is set to a distinct value
+/// and read back, so a header or voice offset not matching status_block.h
+/// reads a wrong value
+///
+Future<void> test5() async {
+  await initialize();
+  await loadAsset();
+
+  final reader = SoLoud.instance.enableEngineStatus();
+  assert(reader != null, 'enableEngineStatus() failed!');
+
+  final handle =
+      (await SoLoud.instance.play(currentSound!, paused: true)).newHandle;
+  SoLoud.instance.setGlobalVolume(0.75);
+  SoLoud.instance.setVolume(handle, 0.5);
+  SoLoud.instance.setPan(handle, -0.25);
+  SoLoud.instance.setRelativePlaySpeed(handle, 1.5);
+  SoLoud.instance.setLooping(handle, true);
+  SoLoud.instance.seek(handle, 1);
+  await delay(300);
+
+  final status = reader!.read();
+  assert(status != null, 'EngineStatusReader.read() failed!');
+  assert(
+    status!.sampleRate == 44100 &&
+        status.engineTime > 0 &&
+        status.globalVolume == 0.75 &&
+        status.peak.length == 2 &&
+        status.rms.length == 2,
+    'EngineStatus header offsets do not match status_block.h!',
+  );
+
+  final voice = status.voices[handle];
+  assert(
+    status.voices.length == 1 &&
+        voice != null &&
+        voice.position == 1 &&
+        voice.volume == 0.5 &&
+        voice.pan == -0.25 &&
+        voice.relativeSpeed == 1.5 &&
+        voice.loopCount == 0 &&
+        voice.paused &&
+        voice.looping,
+    'EngineStatus voice offsets do not match status_block.h!',
+  );
+
+  SoLoud.instance.disableEngineStatus();
+  await dispose();
+}
+
 /// Test play, pause, seek, position
 ///
 Future<void> test2() async {
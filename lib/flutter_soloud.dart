@@ -2,8 +2,10 @@
 ///
 library flutter_soloud;
 
+export 'src/engine_status.dart';
 export 'src/enums.dart';
 export 'src/filter_params.dart';
+export 'src/sfxr_params.dart';
 export 'src/soloud.dart';
 export 'src/soloud_capture.dart';
 export 'src/tools/soloud_tools.dart';
@@ -8,6 +8,7 @@ import 'dart:typed_data';
 
 import 'package:flutter/material.dart';
 import 'package:flutter_soloud/src/enums.dart';
+import 'package:flutter_soloud/src/sfxr_params.dart';
 import 'package:flutter_soloud/src/soloud.dart';
 import 'package:flutter_soloud/src/soloud_controller.dart';
 
@@ -28,25 +29,74 @@ enum MessageEvents {
   loadFile,
   loadFromMemory,
   loadWaveform,
+  loadPushStream,
+  loadPlaylist,
+  loadPolySynth,
+  loadFmSynth,
+  loadGranular,
+  createVariationContainer,
+  loadSfxrPreset,
+  loadSfxrParams,
+  loadSfxrFile,
+  speak,
+  cacheSpeech,
+  createSampler,
+  destroySampler,
   speechText,
   play,
   play3d,
   stop,
   disposeSound,
   disposeAllSound,
+  getWaveformPeaks,
+  computeSpectrogram,
+  analyzeRhythm,
+  getLoudness,
+  setLoudnessNormalization,
 }
 
 /// definitions to be checked in main isolate
 typedef ArgsLoadFromMemory = ({int buffer, int hash, int length});
 typedef ArgsInitEngine = ();
 typedef ArgsDisposeEngine = ();
-typedef ArgsLoadFile = ({String completeFileName, LoadMode mode});
+typedef ArgsLoadFile = ({
+  String completeFileName,
+  LoadMode mode,
+  double? trimSilenceDb,
+  LoopSearch loopSearch,
+});
 typedef ArgsLoadWaveform = ({
   int waveForm,
   bool superWave,
   double scale,
   double detune,
 });
+/// The loaders below can be called again with equal args while waiting:
+/// the audio isolate answers with their [request] number alone.
+typedef ArgsLoadPushStream = ({
+  int request,
+  int sampleRate,
+  int channels,
+  PushStreamFormat format,
+  int bufferFrames,
+  int prebufferFrames,
+});
+typedef ArgsLoadPlaylist = ({int request, int sampleRate, int channels});
+typedef ArgsLoadPolySynth = ({int request, WaveForm waveform, int maxVoices});
+typedef ArgsLoadFmSynth = ({int request, int operators, int maxVoices});
+typedef ArgsLoadGranular = ({int request, int soundHash});
+typedef ArgsCreateVariationContainer = ({
+  int request,
+  List<int> soundHashes,
+  VariationMode mode,
+});
+typedef ArgsLoadSfxrPreset = ({int request, SfxrPreset preset, int seed});
+typedef ArgsLoadSfxrParams = ({int request, SfxrParams params});
+typedef ArgsLoadSfxrFile = ({int request, Uint8List bytes});
+typedef ArgsSpeak = ({int request, String text});
+typedef ArgsCacheSpeech = ({int request, String text});
+typedef ArgsCreateSampler = ({int request});
+typedef ArgsDestroySampler = ({int request, int id});
 typedef ArgsSpeechText = ({String textToSpeech});
 typedef ArgsPlay = ({int soundHash, double volume, double pan, bool paused});
 typedef ArgsPlay3d = ({
@@ -63,6 +113,32 @@ typedef ArgsPlay3d = ({
 typedef ArgsStop = ({int handle});
 typedef ArgsDisposeSound = ({int soundHash});
 typedef ArgsDisposeAllSound = ();
+typedef ArgsGetWaveformPeaks = ({
+  int request,
+  int soundHash,
+  double startTime,
+  double endTime,
+  int buckets,
+});
+typedef ArgsComputeSpectrogram = ({
+  int request,
+  int soundHash,
+  int size,
+  int hop,
+  SpectrogramWindow window,
+  int matrix,
+  bool decibels,
+  double minDb,
+});
+typedef ArgsAnalyzeRhythm = ({int request, int soundHash});
+typedef ArgsGetLoudness = ({int request, int soundHash});
+typedef ArgsSetLoudnessNormalization = ({
+  int request,
+  int soundHash,
+  bool enabled,
+  double targetLufs,
+  double truePeakLimit,
+});
 
 /// Top Level audio isolate function
 ///
@@ -83,6 +159,51 @@ void audioIsolate(SendPort isolateToMainStream) {
   final activeSounds = <SoundProps>[];
   var loopRunning = false;
 
+  /// Add the sound made by a loader to [activeSounds], once since the
+  /// native caches can return a sound already loaded.
+  SoundProps? addNewSound(({PlayerErrors error, int soundHash}) ret) {
+    if (ret.error != PlayerErrors.noError) return null;
+    return activeSounds.firstWhere(
+      (s) => s.soundHash == ret.soundHash,
+      orElse: () {
+        final newSound = SoundProps(ret.soundHash);
+        activeSounds.add(newSound);
+        return newSound;
+      },
+    );
+  }
+
+  /// Send the sound made by the loader [event] back to the main isolate.
+  void sendNewSound(
+    MessageEvents event,
+    int request,
+    ({PlayerErrors error, int soundHash}) ret,
+  ) {
+    isolateToMainStream.send({
+      'event': event,
+      'args': (request: request),
+      'return': (error: ret.error, sound: addNewSound(ret)),
+    });
+  }
+
+  /// Poll the native analysis started by [prepare] every 10 ms, letting the
+  /// other messages be managed meanwhile, then call [done] once it is
+  /// ready or has failed.
+  void whenAnalyzed(
+    ({PlayerErrors error, bool ready}) Function() prepare,
+    void Function(PlayerErrors error) done,
+  ) {
+    final ret = prepare();
+    if (ret.error != PlayerErrors.noError || ret.ready) {
+      done(ret.error);
+      return;
+    }
+    Future.delayed(
+      const Duration(milliseconds: 10),
+      () => whenAnalyzed(prepare, done),
+    );
+  }
+
   /// Tell the main isolate how to communicate with this isolate
   isolateToMainStream.send(mainToIsolateStream.sendPort);
 
@@ -135,6 +256,21 @@ void audioIsolate(SendPort isolateToMainStream) {
         if (ret.error == PlayerErrors.noError) {
           newSound = SoundProps(ret.soundHash);
           activeSounds.add(newSound);
+          if (args.mode == LoadMode.memory &&
+              (args.trimSilenceDb != null ||
+                  args.loopSearch != LoopSearch.none)) {
+            final bounds = soLoudController.soLoudFFI.trimSound(
+              ret.soundHash,
+              args.trimSilenceDb != null,
+              args.trimSilenceDb ?? 0,
+              args.loopSearch,
+            );
+            if (bounds.error == PlayerErrors.noError) {
+              newSound
+                ..trimmed = (start: bounds.start, end: bounds.end)
+                ..loop = (start: bounds.loopStart, end: bounds.loopEnd);
+            }
+          }
         } else if (ret.error == PlayerErrors.fileAlreadyLoaded) {
           /// the file is already loaded.
           /// Check if it is already in [activeSound] else add it
@@ -188,6 +324,109 @@ void audioIsolate(SendPort isolateToMainStream) {
         });
         break;
 
+      case MessageEvents.loadPushStream:
+        final args = event['args']! as ArgsLoadPushStream;
+        final ret = soLoudController.soLoudFFI.loadPushStream(
+          args.sampleRate,
+          args.channels,
+          args.format,
+          args.bufferFrames,
+          args.prebufferFrames,
+        );
+        sendNewSound(MessageEvents.loadPushStream, args.request, ret);
+        break;
+
+      case MessageEvents.loadPlaylist:
+        final args = event['args']! as ArgsLoadPlaylist;
+        final ret = soLoudController.soLoudFFI
+            .loadPlaylist(args.sampleRate, args.channels);
+        sendNewSound(MessageEvents.loadPlaylist, args.request, ret);
+        break;
+
+      case MessageEvents.loadPolySynth:
+        final args = event['args']! as ArgsLoadPolySynth;
+        final ret = soLoudController.soLoudFFI
+            .loadPolySynth(args.waveform, args.maxVoices);
+        sendNewSound(MessageEvents.loadPolySynth, args.request, ret);
+        break;
+
+      case MessageEvents.loadFmSynth:
+        final args = event['args']! as ArgsLoadFmSynth;
+        final ret = soLoudController.soLoudFFI
+            .loadFmSynth(args.operators, args.maxVoices);
+        sendNewSound(MessageEvents.loadFmSynth, args.request, ret);
+        break;
+
+      case MessageEvents.loadGranular:
+        final args = event['args']! as ArgsLoadGranular;
+        final ret = soLoudController.soLoudFFI.loadGranular(args.soundHash);
+        sendNewSound(MessageEvents.loadGranular, args.request, ret);
+        break;
+
+      case MessageEvents.createVariationContainer:
+        final args = event['args']! as ArgsCreateVariationContainer;
+        final ret = soLoudController.soLoudFFI
+            .createVariationContainer(args.soundHashes, args.mode);
+        sendNewSound(MessageEvents.createVariationContainer, args.request, ret);
+        break;
+
+      case MessageEvents.loadSfxrPreset:
+        final args = event['args']! as ArgsLoadSfxrPreset;
+        final ret =
+            soLoudController.soLoudFFI.sfxrLoadPreset(args.preset, args.seed);
+        sendNewSound(MessageEvents.loadSfxrPreset, args.request, ret);
+        break;
+
+      case MessageEvents.loadSfxrParams:
+        final args = event['args']! as ArgsLoadSfxrParams;
+        final ret = soLoudController.soLoudFFI.sfxrLoadParams(args.params);
+        sendNewSound(MessageEvents.loadSfxrParams, args.request, ret);
+        break;
+
+      case MessageEvents.loadSfxrFile:
+        final args = event['args']! as ArgsLoadSfxrFile;
+        final ret = soLoudController.soLoudFFI.sfxrLoadMem(args.bytes);
+        sendNewSound(MessageEvents.loadSfxrFile, args.request, ret);
+        break;
+
+      case MessageEvents.speak:
+        final args = event['args']! as ArgsSpeak;
+        final ret = soLoudController.soLoudFFI.speechSpeak(args.text);
+        final sound = addNewSound((error: ret.error, soundHash: ret.soundHash));
+        sound?.handle.add(ret.handle);
+        isolateToMainStream.send({
+          'event': event['event'],
+          'args': (request: args.request),
+          'return': (error: ret.error, sound: sound, handle: ret.handle),
+        });
+        break;
+
+      case MessageEvents.cacheSpeech:
+        final args = event['args']! as ArgsCacheSpeech;
+        final ret = soLoudController.soLoudFFI.speechCache(args.text);
+        sendNewSound(MessageEvents.cacheSpeech, args.request, ret);
+        break;
+
+      case MessageEvents.createSampler:
+        final args = event['args']! as ArgsCreateSampler;
+        final ret = soLoudController.soLoudFFI.createSampler();
+        isolateToMainStream.send({
+          'event': event['event'],
+          'args': (request: args.request),
+          'return': ret,
+        });
+        break;
+
+      case MessageEvents.destroySampler:
+        final args = event['args']! as ArgsDestroySampler;
+        soLoudController.soLoudFFI.destroySampler(args.id);
+        isolateToMainStream.send({
+          'event': event['event'],
+          'args': (request: args.request),
+          'return': (),
+        });
+        break;
+
       case MessageEvents.speechText:
         final args = event['args']! as ArgsSpeechText;
         final ret = soLoudController.soLoudFFI.speechText(args.textToSpeech);
@@ -211,6 +450,15 @@ void audioIsolate(SendPort isolateToMainStream) {
           pan: args.pan,
           paused: args.paused,
         );
+        // a trigger dropped by the instance limit of the sound
+        if (ret == 0) {
+          isolateToMainStream.send({
+            'event': event['event'],
+            'args': args,
+            'return': (error: PlayerErrors.noError, newHandle: 0),
+          });
+          break;
+        }
         // add the new handle to the [activeSound] hash list
         try {
           activeSounds
@@ -235,15 +483,24 @@ void audioIsolate(SendPort isolateToMainStream) {
 
       case MessageEvents.stop:
         final args = event['args']! as ArgsStop;
+        final isGroup = soLoudController.soLoudFFI.isVoiceGroup(args.handle);
         soLoudController.soLoudFFI.stop(args.handle);
 
-        /// find a sound with this handle and remove that handle from the list
+        /// find a sound with this handle and remove that handle from the list.
+        /// The voices of a group are all stopped and removed
+        final removed = <int>[];
         for (final sound in activeSounds) {
-          sound.handle.removeWhere((element) => element == args.handle);
+          sound.handle.removeWhere((element) {
+            final stopped = element == args.handle ||
+                (isGroup &&
+                    !soLoudController.soLoudFFI.getIsValidVoiceHandle(element));
+            if (stopped) removed.add(element);
+            return stopped;
+          });
         }
 
         isolateToMainStream
-            .send({'event': event['event'], 'args': args, 'return': ()});
+            .send({'event': event['event'], 'args': args, 'return': removed});
         break;
 
       case MessageEvents.disposeSound:
@@ -280,6 +537,135 @@ void audioIsolate(SendPort isolateToMainStream) {
             .send({'event': event['event'], 'args': args, 'return': ()});
         break;
 
+      case MessageEvents.getWaveformPeaks:
+        final args = event['args']! as ArgsGetWaveformPeaks;
+        whenAnalyzed(
+          () => soLoudController.soLoudFFI.prepareWaveformPeaks(args.soundHash),
+          (error) {
+            final ret = error == PlayerErrors.noError
+                ? soLoudController.soLoudFFI.getWaveformPeaks(
+                    args.soundHash,
+                    args.startTime,
+                    args.endTime,
+                    args.buckets,
+                  )
+                : (
+                    error: error,
+                    min: Float32List(0),
+                    max: Float32List(0),
+                    rms: Float32List(0),
+                  );
+            isolateToMainStream.send({
+              'event': event['event'],
+              'args': (request: args.request),
+              'return': ret,
+            });
+          },
+        );
+        break;
+
+      case MessageEvents.computeSpectrogram:
+        final args = event['args']! as ArgsComputeSpectrogram;
+        void reply(PlayerErrors error) => isolateToMainStream.send({
+              'event': event['event'],
+              'args': (request: args.request),
+              'return': error,
+            });
+        final start = args.decibels
+            ? soLoudController.soLoudFFI.computeSpectrogramDb(
+                args.soundHash,
+                args.size,
+                args.hop,
+                args.window,
+                ffi.Pointer<ffi.Uint8>.fromAddress(args.matrix),
+                args.minDb,
+              )
+            : soLoudController.soLoudFFI.computeSpectrogram(
+                args.soundHash,
+                args.size,
+                args.hop,
+                args.window,
+                ffi.Pointer<ffi.Float>.fromAddress(args.matrix),
+              );
+        if (start.error != PlayerErrors.noError) {
+          reply(start.error);
+          break;
+        }
+        whenAnalyzed(
+          () => soLoudController.soLoudFFI.pollSpectrogram(start.job),
+          reply,
+        );
+        break;
+
+      case MessageEvents.analyzeRhythm:
+        final args = event['args']! as ArgsAnalyzeRhythm;
+        whenAnalyzed(
+          () =>
+              soLoudController.soLoudFFI.prepareRhythmAnalysis(args.soundHash),
+          (error) {
+            final ret = error == PlayerErrors.noError
+                ? soLoudController.soLoudFFI.analyzeRhythm(args.soundHash)
+                : (
+                    error: error,
+                    bpm: 0.0,
+                    onsets: Float32List(0),
+                    beats: Float32List(0),
+                  );
+            isolateToMainStream.send({
+              'event': event['event'],
+              'args': (request: args.request),
+              'return': ret,
+            });
+          },
+        );
+        break;
+
+      case MessageEvents.getLoudness:
+        final args = event['args']! as ArgsGetLoudness;
+        whenAnalyzed(
+          () => soLoudController.soLoudFFI.prepareLoudness(args.soundHash),
+          (error) {
+            final ret = error == PlayerErrors.noError
+                ? soLoudController.soLoudFFI.getLoudness(args.soundHash)
+                : (error: error, integrated: 0.0, truePeak: 0.0);
+            isolateToMainStream.send({
+              'event': event['event'],
+              'args': (request: args.request),
+              'return': ret,
+            });
+          },
+        );
+        break;
+
+      case MessageEvents.setLoudnessNormalization:
+        final args = event['args']! as ArgsSetLoudnessNormalization;
+        void normalize(PlayerErrors error) {
+          final ret = error == PlayerErrors.noError
+              ? soLoudController.soLoudFFI.setLoudnessNormalization(
+                  args.soundHash,
+                  args.enabled,
+                  args.targetLufs,
+                  args.truePeakLimit,
+                )
+              : (error: error, gain: 1.0);
+          isolateToMainStream.send({
+            'event': event['event'],
+            'args': (request: args.request),
+            'return': ret,
+          });
+        }
+
+        /// removing the gain doesn't need the measure
+        if (args.enabled) {
+          whenAnalyzed(
+            () => soLoudController.soLoudFFI.prepareLoudness(args.soundHash),
+            normalize,
+          );
+        } else {
+          normalize(PlayerErrors.noError);
+        }
+        break;
+
       //////////////////////////////////
       /// 3D audio
 
@@ -296,6 +682,15 @@ void audioIsolate(SendPort isolateToMainStream) {
           volume: args.volume,
           paused: args.paused,
         );
+        // a trigger dropped by the instance limit of the sound
+        if (ret == 0) {
+          isolateToMainStream.send({
+            'event': event['event'],
+            'args': args,
+            'return': (error: PlayerErrors.noError, newHandle: 0),
+          });
+          break;
+        }
         // add the new handle to the [activeSound] hash list
         try {
           activeSounds
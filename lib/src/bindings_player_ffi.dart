@@ -4,11 +4,80 @@
 // ignore_for_file: avoid_positional_boolean_parameters, require_trailing_commas
 
 import 'dart:ffi' as ffi;
+import 'dart:math';
+import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 import 'package:flutter_soloud/src/enums.dart';
+import 'package:flutter_soloud/src/sfxr_params.dart';
 import 'package:logging/logging.dart';
 
+/// SequencerStepEdit struct exposed in C
+final class _SequencerStepEdit extends ffi.Struct {
+  @ffi.UnsignedInt()
+  external int track;
+
+  @ffi.UnsignedInt()
+  external int step;
+
+  @ffi.UnsignedInt()
+  external int soundHash;
+
+  @ffi.Float()
+  external double volume;
+
+  @ffi.Float()
+  external double pan;
+
+  @ffi.Float()
+  external double pitch;
+}
+
+/// SamplerZone struct exposed in C
+final class _SamplerZone extends ffi.Struct {
+  @ffi.UnsignedInt()
+  external int soundHash;
+
+  @ffi.Int()
+  external int loKey;
+
+  @ffi.Int()
+  external int hiKey;
+
+  @ffi.Float()
+  external double loVelocity;
+
+  @ffi.Float()
+  external double hiVelocity;
+
+  @ffi.Float()
+  external double rootKey;
+
+  @ffi.Float()
+  external double volume;
+
+  @ffi.Float()
+  external double pan;
+
+  @ffi.UnsignedInt()
+  external int loop;
+
+  @ffi.Float()
+  external double loopStart;
+
+  @ffi.Float()
+  external double release;
+
+  @ffi.UnsignedInt()
+  external int trigger;
+
+  @ffi.UnsignedInt()
+  external int seqLength;
+
+  @ffi.UnsignedInt()
+  external int seqPosition;
+}
+
 /// FFI bindings to SoLoud
 class FlutterSoLoudFfi {
   static final Logger _log = Logger('flutter_soloud.FlutterSoLoudFfi');
@@ -296,557 +365,2134 @@ class FlutterSoLoudFfi {
   late final _setWaveform =
       _setWaveformPtr.asFunction<void Function(int, int)>();
 
-  /// Speech the text given
-  ///
-  /// [textToSpeech]
-  /// Returns PlayerErrors.noError if success and handle sound identifier
-  // TODO(me): add other T2S parameters
-  ({PlayerErrors error, int handle}) speechText(String textToSpeech) {
+  /// Create a new sound which plays PCM data pushed from Dart
+  ///
+  /// [sampleRate] sample rate of the data
+  /// [channels] number of interleaved channels, 1 to 8
+  /// [format] format of the samples
+  /// [bufferFrames] size of the ring buffer in frames
+  /// [prebufferFrames] frames to buffer before starting the playback and
+  /// after every underrun
+  /// Returns [PlayerErrors.noError] if success and the sound hash
+  ({PlayerErrors error, int soundHash}) loadPushStream(
+    int sampleRate,
+    int channels,
+    PushStreamFormat format,
+    int bufferFrames,
+    int prebufferFrames,
+  ) {
     // ignore: omit_local_variable_types
-    final ffi.Pointer<ffi.UnsignedInt> handle = calloc();
-    final e = _speechText(
-      textToSpeech.toNativeUtf8().cast<ffi.Char>(),
-      handle,
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _loadPushStream(
+      sampleRate,
+      channels,
+      format.index,
+      bufferFrames,
+      prebufferFrames,
+      h,
     );
-    final ret = (error: PlayerErrors.values[e], handle: handle.value);
-    calloc.free(handle);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
     return ret;
   }
 
-  late final _speechTextPtr = _lookup<
+  late final _loadPushStreamPtr = _lookup<
       ffi.NativeFunction<
           ffi.Int32 Function(
-            ffi.Pointer<ffi.Char>,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Int,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
             ffi.Pointer<ffi.UnsignedInt>,
-          )>>('speechText');
-  late final _speechText = _speechTextPtr.asFunction<
-      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.UnsignedInt>)>();
+          )>>('loadPushStream');
+  late final _loadPushStream = _loadPushStreamPtr.asFunction<
+      int Function(int, int, int, int, int, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Switch pause state of an already loaded sound identified by [handle]
+  /// Get the contiguous free region of the push stream ring buffer.
+  /// Write interleaved frames directly into [data] and then
+  /// call [pushStreamCommit] to make them playable.
   ///
-  /// [handle] the sound handle
-  void pauseSwitch(int handle) {
-    return _pauseSwitch(handle);
+  /// [hash] the unique sound hash of a push stream
+  /// Returns the pointer to write to and how many frames fit there
+  ({ffi.Pointer<ffi.Void> data, int frames}) pushStreamGetWriteSpan(int hash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Pointer<ffi.Void>> data = calloc();
+    final frames = _pushStreamGetWriteSpan(hash, data);
+    final ret = (data: data.value, frames: frames);
+    calloc.free(data);
+    return ret;
   }
 
-  late final _pauseSwitchPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
-    'pauseSwitch',
-  );
-  late final _pauseSwitch = _pauseSwitchPtr.asFunction<void Function(int)>();
+  late final _pushStreamGetWriteSpanPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.UnsignedInt Function(ffi.UnsignedInt,
+              ffi.Pointer<ffi.Pointer<ffi.Void>>)>>('pushStreamGetWriteSpan');
+  late final _pushStreamGetWriteSpan = _pushStreamGetWriteSpanPtr.asFunction<
+      int Function(int, ffi.Pointer<ffi.Pointer<ffi.Void>>)>();
 
-  /// Pause or unpause already loaded sound identified by [handle]
+  /// Commit [frames] frames written into the span given by
+  /// [pushStreamGetWriteSpan]
   ///
-  /// [handle] the sound handle
-  /// [pause] the sound handle
-  void setPause(int handle, int pause) {
-    return _setPause(handle, pause);
+  /// Returns the number of frames committed
+  int pushStreamCommit(int hash, int frames) {
+    return _pushStreamCommit(hash, frames);
   }
 
-  late final _setPausePtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Int)>>(
-          'setPause');
-  late final _setPause = _setPausePtr.asFunction<void Function(int, int)>();
+  late final _pushStreamCommitPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.UnsignedInt Function(
+              ffi.UnsignedInt, ffi.UnsignedInt)>>('pushStreamCommit');
+  late final _pushStreamCommit =
+      _pushStreamCommitPtr.asFunction<int Function(int, int)>();
 
-  /// Gets the pause state
+  /// Copy [frames] interleaved frames from [data] into the push stream
   ///
-  /// [handle] the sound handle
-  /// Return true if paused
-  bool getPause(int handle) {
-    return _getPause(handle) == 1;
+  /// Returns the number of frames written. Less than [frames]
+  /// if the ring buffer is full
+  int pushStreamWrite(int hash, ffi.Pointer<ffi.Void> data, int frames) {
+    return _pushStreamWrite(hash, data, frames);
   }
 
-  late final _getPausePtr =
-      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
-    'getPause',
-  );
-  late final _getPause = _getPausePtr.asFunction<int Function(int)>();
+  late final _pushStreamWritePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.UnsignedInt Function(ffi.UnsignedInt, ffi.Pointer<ffi.Void>,
+              ffi.UnsignedInt)>>('pushStreamWrite');
+  late final _pushStreamWrite = _pushStreamWritePtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Void>, int)>();
 
-  /// Set a sound's relative play speed.
-  /// Setting the value to 0 will cause undefined behavior, likely a crash.
-  /// Change the relative play speed of a sample. This changes the effective
-  /// sample rate while leaving the base sample rate alone.
+  /// Set the number of frames to buffer before starting the playback
   ///
-  /// Note that playing a sound at a higher sample rate will require SoLoud
-  /// to request more samples from the sound source, which will require more
-  /// memory and more processing power. Playing at a slower sample
-  /// rate is cheaper.
-  ///
-  /// [handle] the sound handle
-  /// [speed] the new speed
-  void setRelativePlaySpeed(int handle, double speed) {
-    return _setRelativePlaySpeed(handle, speed);
+  PlayerErrors pushStreamSetPrebuffer(int hash, int frames) {
+    return PlayerErrors.values[_pushStreamSetPrebuffer(hash, frames)];
   }
 
-  late final _setRelativePlaySpeedPtr = _lookup<
-          ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Float)>>(
-      'setRelativePlaySpeed');
-  late final _setRelativePlaySpeed =
-      _setRelativePlaySpeedPtr.asFunction<void Function(int, double)>();
+  late final _pushStreamSetPrebufferPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.UnsignedInt)>>('pushStreamSetPrebuffer');
+  late final _pushStreamSetPrebuffer =
+      _pushStreamSetPrebufferPtr.asFunction<int Function(int, int)>();
 
-  /// Return the current play speed.
+  /// Signal that no more data will be pushed. The sound ends when
+  /// the buffered data has been played
   ///
-  /// [handle] the sound handle
-  double getRelativePlaySpeed(int handle) {
-    return _getRelativePlaySpeed(handle);
+  PlayerErrors pushStreamEnd(int hash) {
+    return PlayerErrors.values[_pushStreamEnd(hash)];
   }
 
-  late final _getRelativePlaySpeedPtr =
-      _lookup<ffi.NativeFunction<ffi.Float Function(ffi.UnsignedInt)>>(
-          'getRelativePlaySpeed');
-  late final _getRelativePlaySpeed =
-      _getRelativePlaySpeedPtr.asFunction<double Function(int)>();
+  late final _pushStreamEndPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'pushStreamEnd');
+  late final _pushStreamEnd = _pushStreamEndPtr.asFunction<int Function(int)>();
 
-  /// Play already loaded sound identified by [soundHash].
+  /// Get the state of a push stream
   ///
-  /// [soundHash] the unique sound hash of a sound
-  /// [volume] 1.0f full volume
-  /// [pan] 0.0f centered
-  /// [paused] 0 not pause
-  /// Return the handle of the sound, 0 if error
-  int play(
-    int soundHash, {
-    double volume = 1,
-    double pan = 0,
-    bool paused = false,
-  }) {
-    return _play(soundHash, volume, pan, paused ? 1 : 0);
+  ({
+    PlayerErrors error,
+    int bufferedFrames,
+    int capacityFrames,
+    int underruns,
+    int silentFrames,
+  }) getPushStreamInfo(int hash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> info =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>() * 4);
+    final e = _getPushStreamInfo(
+      hash,
+      info,
+      info.elementAt(1),
+      info.elementAt(2),
+      info.elementAt(3),
+    );
+    final ret = (
+      error: PlayerErrors.values[e],
+      bufferedFrames: info[0],
+      capacityFrames: info[1],
+      underruns: info[2],
+      silentFrames: info[3],
+    );
+    calloc.free(info);
+    return ret;
   }
 
-  late final _playPtr = _lookup<
+  late final _getPushStreamInfoPtr = _lookup<
       ffi.NativeFunction<
-          ffi.UnsignedInt Function(
+          ffi.Int32 Function(
             ffi.UnsignedInt,
-            ffi.Float,
-            ffi.Float,
-            ffi.Int,
-          )>>('play');
-  late final _play =
-      _playPtr.asFunction<int Function(int, double, double, int)>();
+            ffi.Pointer<ffi.UnsignedInt>,
+            ffi.Pointer<ffi.UnsignedInt>,
+            ffi.Pointer<ffi.UnsignedInt>,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('getPushStreamInfo');
+  late final _getPushStreamInfo = _getPushStreamInfoPtr.asFunction<
+      int Function(
+        int,
+        ffi.Pointer<ffi.UnsignedInt>,
+        ffi.Pointer<ffi.UnsignedInt>,
+        ffi.Pointer<ffi.UnsignedInt>,
+        ffi.Pointer<ffi.UnsignedInt>,
+      )>();
 
-  /// Stop already loaded sound identified by [handle] and clear it.
+  /// Create a new empty playlist. Play it with [play] after adding items
   ///
-  /// [handle]
-  void stop(int handle) {
-    return _stop(handle);
+  /// [sampleRate] sample rate the items are converted to
+  /// [channels] number of channels, 1 to 8
+  /// Returns [PlayerErrors.noError] if success and the sound hash
+  ({PlayerErrors error, int soundHash}) loadPlaylist(
+    int sampleRate,
+    int channels,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _loadPlaylist(sampleRate, channels, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
+    return ret;
   }
 
-  late final _stopPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>('stop');
-  late final _stop = _stopPtr.asFunction<void Function(int)>();
+  late final _loadPlaylistPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('loadPlaylist');
+  late final _loadPlaylist = _loadPlaylistPtr
+      .asFunction<int Function(int, int, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Stop all handles of the already loaded sound identified
-  /// by [soundHash] and dispose it.
+  /// Append a file to the playlist
   ///
-  /// [soundHash]
-  void disposeSound(int soundHash) {
-    return _stopSound(soundHash);
+  /// [hash] the unique sound hash of a playlist
+  /// [completeFileName] the complete file path
+  /// Returns the index of the new item or -1 if [hash] is not a playlist
+  int playlistAddItem(int hash, String completeFileName) {
+    final name = completeFileName.toNativeUtf8();
+    final ret = _playlistAddItem(hash, name.cast<ffi.Char>());
+    calloc.free(name);
+    return ret;
   }
 
-  late final _stopSoundPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
-    'disposeSound',
-  );
-  late final _stopSound = _stopSoundPtr.asFunction<void Function(int)>();
+  late final _playlistAddItemPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.UnsignedInt, ffi.Pointer<ffi.Char>)>>('playlistAddItem');
+  late final _playlistAddItem = _playlistAddItemPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Char>)>();
 
-  /// Dispose all sounds already loaded
-  void disposeAllSound() {
-    return _disposeAllSound();
+  /// Remove all the items. The item playing goes on to its end and the
+  /// items added afterwards play from the first one
+  ///
+  /// [hash] the unique sound hash of a playlist
+  PlayerErrors playlistClear(int hash) {
+    return PlayerErrors.values[_playlistClear(hash)];
   }
 
-  late final _disposeAllSoundPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function()>>('disposeAllSound');
-  late final _disposeAllSound =
-      _disposeAllSoundPtr.asFunction<void Function()>();
+  late final _playlistClearPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'playlistClear');
+  late final _playlistClear =
+      _playlistClearPtr.asFunction<int Function(int)>();
 
-  /// This function can be used to set a sample to play on repeat,
-  /// instead of just playing once
+  /// Set the crossfade between items
   ///
-  /// [handle]
-  /// [enable]
-  void setLooping(int handle, bool enable) {
-    return _setLooping(handle, enable ? 1 : 0);
+  /// [hash] the unique sound hash of a playlist
+  /// [seconds] length of the equal-power crossfade. 0 for a gapless splice
+  PlayerErrors playlistSetCrossfade(int hash, double seconds) {
+    return PlayerErrors.values[_playlistSetCrossfade(hash, seconds)];
   }
 
-  late final _setLoopingPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Int)>>(
-    'setLooping',
-  );
-  late final _setLooping = _setLoopingPtr.asFunction<void Function(int, int)>();
+  late final _playlistSetCrossfadePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Float)>>('playlistSetCrossfade');
+  late final _playlistSetCrossfade =
+      _playlistSetCrossfadePtr.asFunction<int Function(int, double)>();
 
-  /// Enable or disable visualization
+  /// Restart from the first item after the last one
   ///
-  /// [enabled] enable or disable it
-  void setVisualizationEnabled(bool enabled) {
-    return _setVisualizationEnabled(
-      enabled ? 1 : 0,
-    );
+  /// [hash] the unique sound hash of a playlist
+  /// [loop] whether to loop the playlist
+  PlayerErrors playlistSetLoop(int hash, bool loop) {
+    return PlayerErrors.values[_playlistSetLoop(hash, loop)];
   }
 
-  late final _setVisualizationEnabledPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
-    'setVisualizationEnabled',
-  );
-  late final _setVisualizationEnabled =
-      _setVisualizationEnabledPtr.asFunction<void Function(int)>();
+  late final _playlistSetLoopPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Bool)>>('playlistSetLoop');
+  late final _playlistSetLoop =
+      _playlistSetLoopPtr.asFunction<int Function(int, bool)>();
 
-  /// Returns valid data only if VisualizationEnabled is true
+  /// Jump to the next item, crossfading if a crossfade is set
   ///
-  /// [fft]
-  /// Return a 256 float array containing FFT data.
-  void getFft(ffi.Pointer<ffi.Float> fft) {
-    return _getFft(fft);
+  /// [hash] the unique sound hash of a playlist
+  PlayerErrors playlistSkip(int hash) {
+    return PlayerErrors.values[_playlistSkip(hash)];
   }
 
-  late final _getFftPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
-    'getFft',
-  );
-  late final _getFft =
-      _getFftPtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+  late final _playlistSkipPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'playlistSkip');
+  late final _playlistSkip = _playlistSkipPtr.asFunction<int Function(int)>();
 
-  /// Returns valid data only if VisualizationEnabled is true
+  /// Get the index of the item currently playing
   ///
-  /// fft
-  /// Return a 256 float array containing wave data.
-  void getWave(ffi.Pointer<ffi.Float> wave) {
-    return _getWave(wave);
+  /// [hash] the unique sound hash of a playlist
+  /// Returns the item index or -1 if nothing is playing
+  int playlistGetCurrentIndex(int hash) {
+    return _playlistGetCurrentIndex(hash);
   }
 
-  late final _getWavePtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
-    'getWave',
-  );
-  late final _getWave =
-      _getWavePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+  late final _playlistGetCurrentIndexPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+          'playlistGetCurrentIndex');
+  late final _playlistGetCurrentIndex =
+      _playlistGetCurrentIndexPtr.asFunction<int Function(int)>();
 
-  /// Returns valid data only if VisualizationEnabled is true
+  /// Create a new polyphonic instrument
   ///
-  /// fft
-  /// Return a float array containing wave data.
-  PlayerErrors getFullWave(ffi.Pointer<ffi.Float> wave) {
-    _getFullWave(wave);
-    return PlayerErrors.noError;
+  /// [waveform] the waveform of the notes
+  /// [maxVoices] notes playing at once, 1 to 32
+  /// Returns [PlayerErrors.noError] if success and the sound hash
+  ({PlayerErrors error, int soundHash}) loadPolySynth(
+    WaveForm waveform,
+    int maxVoices,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _loadPolySynth(waveform.index, maxVoices, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
+    return ret;
   }
 
-  late final _getFullWavePtr =
-  _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
-    'getFullWave',
-  );
-  late final _getFullWave =
-  _getFullWavePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
-
-  /// Smooth FFT data.
-  /// When new data is read and the values are decreasing, the new value will be
-  /// decreased with an amplitude between the old and the new value.
-  /// This will result on a less shaky visualization.
+  late final _loadPolySynthPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.Int,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('loadPolySynth');
+  late final _loadPolySynth = _loadPolySynthPtr
+      .asFunction<int Function(int, int, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Start a note
+  ///
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// [note] MIDI note number, can be fractional
+  /// [velocity] 0 to 1
+  /// [glide] if > 0, seconds to glide from the pitch of the previous note
+  PlayerErrors polySynthNoteOn(
+    int hash,
+    double note,
+    double velocity,
+    double glide,
+  ) {
+    return PlayerErrors.values[_polySynthNoteOn(hash, note, velocity, glide)];
+  }
+
+  late final _polySynthNoteOnPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Float)>>('polySynthNoteOn');
+  late final _polySynthNoteOn = _polySynthNoteOnPtr
+      .asFunction<int Function(int, double, double, double)>();
+
+  /// Release a note
   ///
-  /// [smooth] must be in the [0.0 ~ 1.0] range.
-  /// 0 = no smooth
-  /// 1 = full smooth
-  /// the new value is calculated with:
-  /// newFreq = smooth * oldFreq + (1 - smooth) * newFreq
-  void setFftSmoothing(double smooth) {
-    return _setFftSmoothing(smooth);
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// [note] the note given to [polySynthNoteOn]
+  PlayerErrors polySynthNoteOff(int hash, double note) {
+    return PlayerErrors.values[_polySynthNoteOff(hash, note)];
   }
 
-  late final _setFftSmoothingPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Float)>>(
-    'setFftSmoothing',
-  );
-  late final _setFftSmoothing =
-      _setFftSmoothingPtr.asFunction<void Function(double)>();
+  late final _polySynthNoteOffPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'polySynthNoteOff');
+  late final _polySynthNoteOff =
+      _polySynthNoteOffPtr.asFunction<int Function(int, double)>();
+
+  /// Glide a playing note to a new pitch
+  ///
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// [note] the note given to [polySynthNoteOn]
+  /// [pitch] the new MIDI note number
+  /// [glide] seconds to reach [pitch]
+  PlayerErrors polySynthSetNotePitch(
+    int hash,
+    double note,
+    double pitch,
+    double glide,
+  ) {
+    return PlayerErrors
+        .values[_polySynthSetNotePitch(hash, note, pitch, glide)];
+  }
 
-  /// Return in [samples] a 512 float array.
-  /// The first 256 floats represent the FFT frequencies data [>=0.0].
-  /// The other 256 floats represent the wave data (amplitude) [-1.0~1.0].
+  late final _polySynthSetNotePitchPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Float)>>('polySynthSetNotePitch');
+  late final _polySynthSetNotePitch = _polySynthSetNotePitchPtr
+      .asFunction<int Function(int, double, double, double)>();
+
+  /// Release all the notes
   ///
-  /// [samples] should be allocated and freed in dart side
-  void getAudioTexture(ffi.Pointer<ffi.Float> samples) {
-    return _getAudioTexture(samples);
+  /// [hash] the unique sound hash of a polyphonic instrument
+  PlayerErrors polySynthAllNotesOff(int hash) {
+    return PlayerErrors.values[_polySynthAllNotesOff(hash)];
   }
 
-  late final _getAudioTexturePtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
-    'getAudioTexture',
-  );
-  late final _getAudioTexture =
-      _getAudioTexturePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+  late final _polySynthAllNotesOffPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'polySynthAllNotesOff');
+  late final _polySynthAllNotesOff =
+      _polySynthAllNotesOffPtr.asFunction<int Function(int)>();
 
-  /// Return a floats matrix of 256x512
-  /// Every row are composed of 256 FFT values plus 256 of wave data
-  /// Every time is called, a new row is stored in the
-  /// first row and all the previous rows are shifted
-  /// up (the last one will be lost).
+  /// Set the waveform of all the notes
   ///
-  /// [samples]
-  PlayerErrors getAudioTexture2D(ffi.Pointer<ffi.Pointer<ffi.Float>> samples) {
-    if (samples == ffi.nullptr) return PlayerErrors.nullPointer;
-    final ret = _getAudioTexture2D(samples);
-    return PlayerErrors.values[ret];
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// [waveform] the new waveform
+  PlayerErrors polySynthSetWaveform(int hash, WaveForm waveform) {
+    return PlayerErrors.values[_polySynthSetWaveform(hash, waveform.index)];
   }
 
-  late final _getAudioTexture2DPtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int32 Function(
-            ffi.Pointer<ffi.Pointer<ffi.Float>>,
-          )>>('getAudioTexture2D');
-  late final _getAudioTexture2D = _getAudioTexture2DPtr
-      .asFunction<int Function(ffi.Pointer<ffi.Pointer<ffi.Float>>)>();
+  late final _polySynthSetWaveformPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Int)>>(
+      'polySynthSetWaveform');
+  late final _polySynthSetWaveform =
+      _polySynthSetWaveformPtr.asFunction<int Function(int, int)>();
 
-  /// Get the sound length in seconds
+  /// Set the envelope of the notes
   ///
-  /// [soundHash] the sound hash
-  /// Returns sound length in seconds
-  double getLength(int soundHash) {
-    return _getLength(soundHash);
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// [attack] [decay] [release] times in seconds
+  /// [sustain] level 0 to 1
+  PlayerErrors polySynthSetADSR(
+    int hash,
+    double attack,
+    double decay,
+    double sustain,
+    double release,
+  ) {
+    return PlayerErrors
+        .values[_polySynthSetADSR(hash, attack, decay, sustain, release)];
   }
 
-  late final _getLengthPtr =
-      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
-    'getLength',
-  );
-  late final _getLength = _getLengthPtr.asFunction<double Function(int)>();
+  late final _polySynthSetADSRPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float, ffi.Float,
+              ffi.Float)>>('polySynthSetADSR');
+  late final _polySynthSetADSR = _polySynthSetADSRPtr
+      .asFunction<int Function(int, double, double, double, double)>();
 
-  /// Seek playing in [time] seconds
-  /// [time]
-  /// [handle] the sound handle
-  /// Returns [PlayerErrors.noError] if success
+  /// Get the number of notes sounding, releasing ones included
   ///
-  /// NOTE: when seeking an MP3 file loaded using `mode`=`LoadMode.disk` the
-  /// seek operation is performed but there will be delays. This occurs because
-  /// the MP3 codec must compute each frame length to gain a new position.
-  /// The problem is explained in souloud_wavstream.cpp
-  /// in `WavStreamInstance::seek` function.
+  /// [hash] the unique sound hash of a polyphonic instrument
+  /// Returns the number of voices or -1 if [hash] is not a polyphonic
+  /// instrument
+  int polySynthGetActiveVoices(int hash) {
+    return _polySynthGetActiveVoices(hash);
+  }
+
+  late final _polySynthGetActiveVoicesPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+          'polySynthGetActiveVoices');
+  late final _polySynthGetActiveVoices =
+      _polySynthGetActiveVoicesPtr.asFunction<int Function(int)>();
+
+  /// Create a new polyphonic FM instrument
+  ///
+  /// [operators] 4 or 6
+  /// [maxVoices] notes playing at once, 1 to 32
+  /// Returns [PlayerErrors.noError] if success and the sound hash
+  ({PlayerErrors error, int soundHash}) loadFmSynth(
+    int operators,
+    int maxVoices,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _loadFmSynth(operators, maxVoices, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
+    return ret;
+  }
+
+  late final _loadFmSynthPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('loadFmSynth');
+  late final _loadFmSynth = _loadFmSynthPtr
+      .asFunction<int Function(int, int, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Use one of the preset algorithms
   ///
-  /// This mode is useful ie for background music, not for a music player
-  /// where a seek slider for MP3s is a must.
-  /// If you need to seek MP3s without lags, please, use
-  /// `mode`=`LoadMode.memory` instead or other supported audio formats!
+  /// [hash] the unique sound hash of an FM instrument
+  /// [algorithm] 0 to 7
+  PlayerErrors fmSynthSetAlgorithm(int hash, int algorithm) {
+    return PlayerErrors.values[_fmSynthSetAlgorithm(hash, algorithm)];
+  }
+
+  late final _fmSynthSetAlgorithmPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.UnsignedInt)>>('fmSynthSetAlgorithm');
+  late final _fmSynthSetAlgorithm =
+      _fmSynthSetAlgorithmPtr.asFunction<int Function(int, int)>();
+
+  /// Set a custom algorithm
+  ///
+  /// [hash] the unique sound hash of an FM instrument
+  /// [modulators] for each operator, the bit mask of the operators
+  /// modulating it
+  /// [carriers] bit mask of the operators summed to the output
+  PlayerErrors fmSynthSetRouting(
+    int hash,
+    List<int> modulators,
+    int carriers,
+  ) {
+    // the native side reads one mask per operator: missing ones stay 0
+    final ffi.Pointer<ffi.UnsignedInt> m = calloc(
+        ffi.sizeOf<ffi.UnsignedInt>() * max(modulators.length, 6));
+    for (var i = 0; i < modulators.length; i++) {
+      m.elementAt(i).value = modulators[i];
+    }
+    final e = _fmSynthSetRouting(hash, m, carriers);
+    calloc.free(m);
+    return PlayerErrors.values[e];
+  }
+
+  late final _fmSynthSetRoutingPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Pointer<ffi.UnsignedInt>,
+              ffi.UnsignedInt)>>('fmSynthSetRouting');
+  late final _fmSynthSetRouting = _fmSynthSetRoutingPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.UnsignedInt>, int)>();
+
+  /// Set the parameters of an operator
+  ///
+  /// [hash] the unique sound hash of an FM instrument
+  /// [op] the operator index
+  /// [ratio] frequency ratio to the note
+  /// [detune] fixed frequency offset in Hz
+  /// [level] amplitude of a carrier, modulation index of a modulator
+  /// [feedback] self modulation, 0 to 1
+  PlayerErrors fmSynthSetOperator(
+    int hash,
+    int op,
+    double ratio,
+    double detune,
+    double level,
+    double feedback,
+  ) {
+    return PlayerErrors.values[
+        _fmSynthSetOperator(hash, op, ratio, detune, level, feedback)];
+  }
+
+  late final _fmSynthSetOperatorPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedInt, ffi.Float,
+              ffi.Float, ffi.Float, ffi.Float)>>('fmSynthSetOperator');
+  late final _fmSynthSetOperator = _fmSynthSetOperatorPtr
+      .asFunction<int Function(int, int, double, double, double, double)>();
+
+  /// Set the envelope of an operator
+  ///
+  /// [hash] the unique sound hash of an FM instrument
+  /// [op] the operator index
+  /// [attack] [decay] [release] times in seconds
+  /// [sustain] level 0 to 1
+  PlayerErrors fmSynthSetOperatorEnvelope(
+    int hash,
+    int op,
+    double attack,
+    double decay,
+    double sustain,
+    double release,
+  ) {
+    return PlayerErrors.values[_fmSynthSetOperatorEnvelope(
+        hash, op, attack, decay, sustain, release)];
+  }
+
+  late final _fmSynthSetOperatorEnvelopePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedInt, ffi.Float,
+              ffi.Float, ffi.Float, ffi.Float)>>('fmSynthSetOperatorEnvelope');
+  late final _fmSynthSetOperatorEnvelope = _fmSynthSetOperatorEnvelopePtr
+      .asFunction<int Function(int, int, double, double, double, double)>();
+
+  /// Create a granular synthesis sound reading a loaded sound
   ///
-  int seek(int handle, double time) {
-    return _seek(handle, time);
+  /// [wavHash] the unique sound hash of a sound loaded in memory
+  /// Returns [PlayerErrors.noError] if success and the sound hash
+  ({PlayerErrors error, int soundHash}) loadGranular(int wavHash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _loadGranular(wavHash, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
+    return ret;
   }
 
-  late final _seekPtr = _lookup<
-      ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
-    'seek',
-  );
-  late final _seek = _seekPtr.asFunction<int Function(int, double)>();
+  late final _loadGranularPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Pointer<ffi.UnsignedInt>)>>('loadGranular');
+  late final _loadGranular = _loadGranularPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Get current sound position  in seconds
+  /// Create a variation container picking one of [soundHashes] each time
+  /// it is played
   ///
-  /// [handle] the sound handle
-  /// Returns time in seconds
-  double getPosition(int handle) {
-    return _getPosition(handle);
+  /// Returns [PlayerErrors.noError] if success and the container hash
+  ({PlayerErrors error, int soundHash}) createVariationContainer(
+    List<int> soundHashes,
+    VariationMode mode,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> hashes =
+        calloc(soundHashes.length * ffi.sizeOf<ffi.UnsignedInt>());
+    for (var i = 0; i < soundHashes.length; i++) {
+      hashes[i] = soundHashes[i];
+    }
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _createVariationContainer(
+        hashes, soundHashes.length, mode.index, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc
+      ..free(hashes)
+      ..free(h);
+    return ret;
   }
 
-  late final _getPositionPtr =
-      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
-    'getPosition',
+  late final _createVariationContainerPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.UnsignedInt>, ffi.UnsignedInt,
+              ffi.Int, ffi.Pointer<ffi.UnsignedInt>)>>(
+    'createVariationContainer',
   );
-  late final _getPosition = _getPositionPtr.asFunction<double Function(int)>();
+  late final _createVariationContainer =
+      _createVariationContainerPtr.asFunction<
+          int Function(ffi.Pointer<ffi.UnsignedInt>, int, int,
+              ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Set the ranges of the random pitch in semitones and volume multiplier
+  /// of each trigger of a variation container
+  PlayerErrors variationSetRandomization(
+    int hash,
+    double minPitch,
+    double maxPitch,
+    double minVolume,
+    double maxVolume,
+  ) {
+    return PlayerErrors.values[_variationSetRandomization(
+        hash, minPitch, maxPitch, minVolume, maxVolume)];
+  }
 
-  /// Get current Global volume
+  late final _variationSetRandomizationPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float, ffi.Float,
+              ffi.Float)>>('variationSetRandomization');
+  late final _variationSetRandomization = _variationSetRandomizationPtr
+      .asFunction<int Function(int, double, double, double, double)>();
+
+  /// Render an sfxr preset to a new sound on a worker thread
+  ///
+  /// [preset] the template
+  /// [seed] randomizes the template
+  /// Returns [PlayerErrors.noError] if success and the sound hash, the same
+  /// for equal parameters
+  ({PlayerErrors error, int soundHash}) sfxrLoadPreset(
+    SfxrPreset preset,
+    int seed,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _sfxrLoadPreset(preset.index, seed, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc.free(h);
+    return ret;
+  }
+
+  late final _sfxrLoadPresetPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Int, ffi.Int,
+              ffi.Pointer<ffi.UnsignedInt>)>>('sfxrLoadPreset');
+  late final _sfxrLoadPreset = _sfxrLoadPresetPtr
+      .asFunction<int Function(int, int, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Render an sfxr parameter set to a new sound on a worker thread
   ///
-  /// Returns the volume
-  double getGlobalVolume() {
-    return _getGlobalVolume();
+  /// Returns [PlayerErrors.noError] if success and the sound hash, the same
+  /// for equal parameters
+  ({PlayerErrors error, int soundHash}) sfxrLoadParams(SfxrParams params) {
+    final values = params.values;
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> v = calloc(values.length * 4);
+    for (var i = 0; i < values.length; i++) {
+      v[i] = values[i];
+    }
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _sfxrLoadParams(params.waveType.index, v, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc
+      ..free(v)
+      ..free(h);
+    return ret;
   }
 
-  late final _getGlobalVolumePtr =
-      _lookup<ffi.NativeFunction<ffi.Double Function()>>('getGlobalVolume');
-  late final _getGlobalVolume =
-      _getGlobalVolumePtr.asFunction<double Function()>();
+  late final _sfxrLoadParamsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Int, ffi.Pointer<ffi.Float>,
+              ffi.Pointer<ffi.UnsignedInt>)>>('sfxrLoadParams');
+  late final _sfxrLoadParams = _sfxrLoadParamsPtr.asFunction<
+      int Function(
+          int, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Set current Global volume
+  /// Render the content of an sfxr .sfs file to a new sound on a worker
+  /// thread
   ///
-  /// Returns [PlayerErrors.noError] if success
-  int setGlobalVolume(double volume) {
-    return _setGlobalVolume(volume);
+  /// Returns [PlayerErrors.noError] if success and the sound hash, the same
+  /// for equal parameters
+  ({PlayerErrors error, int soundHash}) sfxrLoadMem(Uint8List bytes) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Uint8> mem = calloc(bytes.length);
+    mem.asTypedList(bytes.length).setAll(0, bytes);
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _sfxrLoadMem(mem, bytes.length, h);
+    final ret = (error: PlayerErrors.values[e], soundHash: h.value);
+    calloc
+      ..free(mem)
+      ..free(h);
+    return ret;
   }
 
-  late final _setGlobalVolumePtr =
-      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Float)>>(
-          'setGlobalVolume');
-  late final _setGlobalVolume =
-      _setGlobalVolumePtr.asFunction<int Function(double)>();
+  late final _sfxrLoadMemPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.Uint8>, ffi.UnsignedInt,
+              ffi.Pointer<ffi.UnsignedInt>)>>('sfxrLoadMem');
+  late final _sfxrLoadMem = _sfxrLoadMemPtr.asFunction<
+      int Function(ffi.Pointer<ffi.Uint8>, int, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Get current [handle] volume
+  /// Set how many grains start per second
+  PlayerErrors granularSetDensity(int hash, double density) {
+    return PlayerErrors.values[_granularSetDensity(hash, density)];
+  }
+
+  late final _granularSetDensityPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'granularSetDensity');
+  late final _granularSetDensity =
+      _granularSetDensityPtr.asFunction<int Function(int, double)>();
+
+  /// Set where the grains are read, from 0 (start) to 1 (end)
+  PlayerErrors granularSetPosition(int hash, double position) {
+    return PlayerErrors.values[_granularSetPosition(hash, position)];
+  }
+
+  late final _granularSetPositionPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'granularSetPosition');
+  late final _granularSetPosition =
+      _granularSetPositionPtr.asFunction<int Function(int, double)>();
+
+  /// Set the random offset of the grains around the position, in seconds
+  PlayerErrors granularSetSpray(int hash, double spray) {
+    return PlayerErrors.values[_granularSetSpray(hash, spray)];
+  }
+
+  late final _granularSetSprayPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'granularSetSpray');
+  late final _granularSetSpray =
+      _granularSetSprayPtr.asFunction<int Function(int, double)>();
+
+  /// Set the transposition of the grains and its random spread, in
+  /// semitones
+  PlayerErrors granularSetPitch(int hash, double pitch, double pitchSpray) {
+    return PlayerErrors.values[_granularSetPitch(hash, pitch, pitchSpray)];
+  }
+
+  late final _granularSetPitchPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('granularSetPitch');
+  late final _granularSetPitch =
+      _granularSetPitchPtr.asFunction<int Function(int, double, double)>();
+
+  /// Set the length of the grains in seconds
+  PlayerErrors granularSetSize(int hash, double size) {
+    return PlayerErrors.values[_granularSetSize(hash, size)];
+  }
+
+  late final _granularSetSizePtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'granularSetSize');
+  late final _granularSetSize =
+      _granularSetSizePtr.asFunction<int Function(int, double)>();
+
+  /// Set the window of the grains
+  PlayerErrors granularSetWindow(int hash, GrainWindow window) {
+    return PlayerErrors.values[_granularSetWindow(hash, window.index)];
+  }
+
+  late final _granularSetWindowPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Int32)>>(
+      'granularSetWindow');
+  late final _granularSetWindow =
+      _granularSetWindowPtr.asFunction<int Function(int, int)>();
+
+  /// Speech the text given
   ///
-  /// Returns the volume
-  double getVolume(int handle) {
-    return _getVolume(handle);
+  /// [textToSpeech]
+  /// Returns PlayerErrors.noError if success and handle sound identifier
+  // TODO(me): add other T2S parameters
+  ({PlayerErrors error, int handle}) speechText(String textToSpeech) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> handle = calloc();
+    final e = _speechText(
+      textToSpeech.toNativeUtf8().cast<ffi.Char>(),
+      handle,
+    );
+    final ret = (error: PlayerErrors.values[e], handle: handle.value);
+    calloc.free(handle);
+    return ret;
   }
 
-  late final _getVolumePtr =
-      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
-          'getVolume');
-  late final _getVolume = _getVolumePtr.asFunction<double Function(int)>();
+  late final _speechTextPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.Pointer<ffi.Char>,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('speechText');
+  late final _speechText = _speechTextPtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Speak a text as a new sound, overlapping the other utterances
+  ///
+  /// [text] the text to speak
+  /// Returns the new sound, or the sound cached by [speechCache], and the
+  /// voice speaking
+  ({PlayerErrors error, int soundHash, int handle}) speechSpeak(String text) {
+    final t = text.toNativeUtf8();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> hash =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> handle =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _speechSpeak(t.cast<ffi.Char>(), hash, handle);
+    final ret = (
+      error: PlayerErrors.values[e],
+      soundHash: hash.value,
+      handle: handle.value,
+    );
+    calloc
+      ..free(t)
+      ..free(hash)
+      ..free(handle);
+    return ret;
+  }
+
+  late final _speechSpeakPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.UnsignedInt>,
+              ffi.Pointer<ffi.UnsignedInt>)>>('speechSpeak');
+  late final _speechSpeak = _speechSpeakPtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.UnsignedInt>,
+          ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Set the voice of the next utterances
+  void speechSetParams(
+    int baseFrequency,
+    double baseSpeed,
+    double baseDeclination,
+    SpeechWaveform baseWaveform,
+    bool engineRate,
+  ) {
+    return _speechSetParams(baseFrequency, baseSpeed, baseDeclination,
+        baseWaveform.index, engineRate);
+  }
+
+  late final _speechSetParamsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(ffi.UnsignedInt, ffi.Float, ffi.Float, ffi.Int,
+              ffi.Bool)>>('speechSetParams');
+  late final _speechSetParams = _speechSetParamsPtr
+      .asFunction<void Function(int, double, double, int, bool)>();
+
+  /// Synthesize a text now and keep it as a sound played by [speechSpeak]
+  ///
+  /// [text] the text to cache
+  /// Returns the cached sound
+  ({PlayerErrors error, int soundHash}) speechCache(String text) {
+    final t = text.toNativeUtf8();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> hash =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _speechCache(t.cast<ffi.Char>(), hash);
+    final ret = (error: PlayerErrors.values[e], soundHash: hash.value);
+    calloc
+      ..free(t)
+      ..free(hash);
+    return ret;
+  }
+
+  late final _speechCachePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.UnsignedInt>)>>('speechCache');
+  late final _speechCache = _speechCachePtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Switch pause state of an already loaded sound identified by [handle]
+  ///
+  /// [handle] the sound handle
+  void pauseSwitch(int handle) {
+    return _pauseSwitch(handle);
+  }
+
+  late final _pauseSwitchPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+    'pauseSwitch',
+  );
+  late final _pauseSwitch = _pauseSwitchPtr.asFunction<void Function(int)>();
+
+  /// Pause or unpause already loaded sound identified by [handle]
+  ///
+  /// [handle] the sound handle
+  /// [pause] the sound handle
+  void setPause(int handle, int pause) {
+    return _setPause(handle, pause);
+  }
+
+  late final _setPausePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Int)>>(
+          'setPause');
+  late final _setPause = _setPausePtr.asFunction<void Function(int, int)>();
+
+  /// Gets the pause state
+  ///
+  /// [handle] the sound handle
+  /// Return true if paused
+  bool getPause(int handle) {
+    return _getPause(handle) == 1;
+  }
+
+  late final _getPausePtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+    'getPause',
+  );
+  late final _getPause = _getPausePtr.asFunction<int Function(int)>();
+
+  /// Set a sound's relative play speed.
+  /// Setting the value to 0 will cause undefined behavior, likely a crash.
+  /// Change the relative play speed of a sample. This changes the effective
+  /// sample rate while leaving the base sample rate alone.
+  ///
+  /// Note that playing a sound at a higher sample rate will require SoLoud
+  /// to request more samples from the sound source, which will require more
+  /// memory and more processing power. Playing at a slower sample
+  /// rate is cheaper.
+  ///
+  /// [handle] the sound handle
+  /// [speed] the new speed
+  void setRelativePlaySpeed(int handle, double speed) {
+    return _setRelativePlaySpeed(handle, speed);
+  }
+
+  late final _setRelativePlaySpeedPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Float)>>(
+      'setRelativePlaySpeed');
+  late final _setRelativePlaySpeed =
+      _setRelativePlaySpeedPtr.asFunction<void Function(int, double)>();
+
+  /// Return the current play speed.
+  ///
+  /// [handle] the sound handle
+  double getRelativePlaySpeed(int handle) {
+    return _getRelativePlaySpeed(handle);
+  }
+
+  late final _getRelativePlaySpeedPtr =
+      _lookup<ffi.NativeFunction<ffi.Float Function(ffi.UnsignedInt)>>(
+          'getRelativePlaySpeed');
+  late final _getRelativePlaySpeed =
+      _getRelativePlaySpeedPtr.asFunction<double Function(int)>();
+
+  /// Play a voice at [tempo] times its speed keeping its pitch, and
+  /// transposed by [pitch] semitones keeping its tempo.
+  ///
+  /// [handle] the sound handle
+  /// [mode] the stretch algorithm
+  /// [tempo] from 0.25 to 4
+  /// [pitch] semitones from -24 to 24
+  /// Return [PlayerErrors.noError] if success
+  PlayerErrors setTimeStretch(
+    int handle,
+    TimeStretchMode mode,
+    double tempo,
+    double pitch,
+  ) {
+    return PlayerErrors
+        .values[_setTimeStretch(handle, mode.index, tempo, pitch)];
+  }
+
+  late final _setTimeStretchPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Int32, ffi.Float,
+              ffi.Float)>>('setTimeStretch');
+  late final _setTimeStretch = _setTimeStretchPtr
+      .asFunction<int Function(int, int, double, double)>();
+
+  /// Play a voice without time stretch again.
+  ///
+  /// [handle] the sound handle
+  void removeTimeStretch(int handle) {
+    return _removeTimeStretch(handle);
+  }
+
+  late final _removeTimeStretchPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+          'removeTimeStretch');
+  late final _removeTimeStretch =
+      _removeTimeStretchPtr.asFunction<void Function(int)>();
+
+  /// Return the share of a core spent stretching a voice, 0.01 being 1%.
+  ///
+  /// [handle] the sound handle
+  double getTimeStretchLoad(int handle) {
+    return _getTimeStretchLoad(handle);
+  }
+
+  late final _getTimeStretchLoadPtr =
+      _lookup<ffi.NativeFunction<ffi.Float Function(ffi.UnsignedInt)>>(
+          'getTimeStretchLoad');
+  late final _getTimeStretchLoad =
+      _getTimeStretchLoadPtr.asFunction<double Function(int)>();
+
+  /// Play already loaded sound identified by [soundHash].
+  ///
+  /// [soundHash] the unique sound hash of a sound
+  /// [volume] 1.0f full volume
+  /// [pan] 0.0f centered
+  /// [paused] 0 not pause
+  /// Return the handle of the sound, 0 if error
+  int play(
+    int soundHash, {
+    double volume = 1,
+    double pan = 0,
+    bool paused = false,
+  }) {
+    return _play(soundHash, volume, pan, paused ? 1 : 0);
+  }
+
+  late final _playPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.UnsignedInt Function(
+            ffi.UnsignedInt,
+            ffi.Float,
+            ffi.Float,
+            ffi.Int,
+          )>>('play');
+  late final _play =
+      _playPtr.asFunction<int Function(int, double, double, int)>();
+
+  /// Limit the voices of a sound playing at once and how often it can be
+  /// triggered
+  PlayerErrors setInstanceLimit(
+    int soundHash,
+    int maxInstances,
+    StealPolicy policy,
+    double minRetriggerInterval,
+  ) {
+    return PlayerErrors.values[_setInstanceLimit(
+        soundHash, maxInstances, policy.index, minRetriggerInterval)];
+  }
+
+  late final _setInstanceLimitPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedInt, ffi.Int,
+              ffi.Float)>>('setInstanceLimit');
+  late final _setInstanceLimit = _setInstanceLimitPtr
+      .asFunction<int Function(int, int, int, double)>();
+
+  /// Stop already loaded sound identified by [handle] and clear it.
+  ///
+  /// [handle]
+  void stop(int handle) {
+    return _stop(handle);
+  }
+
+  late final _stopPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>('stop');
+  late final _stop = _stopPtr.asFunction<void Function(int)>();
+
+  /// Stop all handles of the already loaded sound identified
+  /// by [soundHash] and dispose it.
+  ///
+  /// [soundHash]
+  void disposeSound(int soundHash) {
+    return _stopSound(soundHash);
+  }
+
+  late final _stopSoundPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+    'disposeSound',
+  );
+  late final _stopSound = _stopSoundPtr.asFunction<void Function(int)>();
+
+  /// Dispose all sounds already loaded
+  void disposeAllSound() {
+    return _disposeAllSound();
+  }
+
+  late final _disposeAllSoundPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('disposeAllSound');
+  late final _disposeAllSound =
+      _disposeAllSoundPtr.asFunction<void Function()>();
+
+  /// This function can be used to set a sample to play on repeat,
+  /// instead of just playing once
+  ///
+  /// [handle]
+  /// [enable]
+  void setLooping(int handle, bool enable) {
+    return _setLooping(handle, enable ? 1 : 0);
+  }
+
+  late final _setLoopingPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt, ffi.Int)>>(
+    'setLooping',
+  );
+  late final _setLooping = _setLoopingPtr.asFunction<void Function(int, int)>();
+
+  /// Enable or disable visualization
+  ///
+  /// [enabled] enable or disable it
+  void setVisualizationEnabled(bool enabled) {
+    return _setVisualizationEnabled(
+      enabled ? 1 : 0,
+    );
+  }
+
+  late final _setVisualizationEnabledPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
+    'setVisualizationEnabled',
+  );
+  late final _setVisualizationEnabled =
+      _setVisualizationEnabledPtr.asFunction<void Function(int)>();
+
+  /// Returns valid data only if VisualizationEnabled is true
+  ///
+  /// [fft]
+  /// Return a 256 float array containing FFT data.
+  void getFft(ffi.Pointer<ffi.Float> fft) {
+    return _getFft(fft);
+  }
+
+  late final _getFftPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
+    'getFft',
+  );
+  late final _getFft =
+      _getFftPtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+
+  /// Returns valid data only if VisualizationEnabled is true
+  ///
+  /// fft
+  /// Return a 256 float array containing wave data.
+  void getWave(ffi.Pointer<ffi.Float> wave) {
+    return _getWave(wave);
+  }
+
+  late final _getWavePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
+    'getWave',
+  );
+  late final _getWave =
+      _getWavePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+
+  /// Returns valid data only if VisualizationEnabled is true
+  ///
+  /// fft
+  /// Return a float array containing wave data.
+  PlayerErrors getFullWave(ffi.Pointer<ffi.Float> wave) {
+    _getFullWave(wave);
+    return PlayerErrors.noError;
+  }
+
+  late final _getFullWavePtr =
+  _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
+    'getFullWave',
+  );
+  late final _getFullWave =
+  _getFullWavePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+
+  /// Smooth FFT data.
+  /// When new data is read and the values are decreasing, the new value will be
+  /// decreased with an amplitude between the old and the new value.
+  /// This will result on a less shaky visualization.
+  ///
+  /// [smooth] must be in the [0.0 ~ 1.0] range.
+  /// 0 = no smooth
+  /// 1 = full smooth
+  /// the new value is calculated with:
+  /// newFreq = smooth * oldFreq + (1 - smooth) * newFreq
+  void setFftSmoothing(double smooth) {
+    return _setFftSmoothing(smooth);
+  }
+
+  late final _setFftSmoothingPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Float)>>(
+    'setFftSmoothing',
+  );
+  late final _setFftSmoothing =
+      _setFftSmoothingPtr.asFunction<void Function(double)>();
+
+  /// Return in [samples] a 512 float array.
+  /// The first 256 floats represent the FFT frequencies data [>=0.0].
+  /// The other 256 floats represent the wave data (amplitude) [-1.0~1.0].
+  ///
+  /// [samples] should be allocated and freed in dart side
+  void getAudioTexture(ffi.Pointer<ffi.Float> samples) {
+    return _getAudioTexture(samples);
+  }
+
+  late final _getAudioTexturePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Float>)>>(
+    'getAudioTexture',
+  );
+  late final _getAudioTexture =
+      _getAudioTexturePtr.asFunction<void Function(ffi.Pointer<ffi.Float>)>();
+
+  /// Return a floats matrix of 256x512
+  /// Every row are composed of 256 FFT values plus 256 of wave data
+  /// Every time is called, a new row is stored in the
+  /// first row and all the previous rows are shifted
+  /// up (the last one will be lost).
+  ///
+  /// [samples]
+  PlayerErrors getAudioTexture2D(ffi.Pointer<ffi.Pointer<ffi.Float>> samples) {
+    if (samples == ffi.nullptr) return PlayerErrors.nullPointer;
+    final ret = _getAudioTexture2D(samples);
+    return PlayerErrors.values[ret];
+  }
+
+  late final _getAudioTexture2DPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.Pointer<ffi.Pointer<ffi.Float>>,
+          )>>('getAudioTexture2D');
+  late final _getAudioTexture2D = _getAudioTexture2DPtr
+      .asFunction<int Function(ffi.Pointer<ffi.Pointer<ffi.Float>>)>();
+
+  /// Get the sound length in seconds
+  ///
+  /// [soundHash] the sound hash
+  /// Returns sound length in seconds
+  double getLength(int soundHash) {
+    return _getLength(soundHash);
+  }
+
+  late final _getLengthPtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
+    'getLength',
+  );
+  late final _getLength = _getLengthPtr.asFunction<double Function(int)>();
+
+  /// Seek playing in [time] seconds
+  /// [time]
+  /// [handle] the sound handle
+  /// Returns [PlayerErrors.noError] if success
+  ///
+  /// NOTE: when seeking an MP3 file loaded using `mode`=`LoadMode.disk` the
+  /// seek operation is performed but there will be delays. This occurs because
+  /// the MP3 codec must compute each frame length to gain a new position.
+  /// The problem is explained in souloud_wavstream.cpp
+  /// in `WavStreamInstance::seek` function.
+  ///
+  /// This mode is useful ie for background music, not for a music player
+  /// where a seek slider for MP3s is a must.
+  /// If you need to seek MP3s without lags, please, use
+  /// `mode`=`LoadMode.memory` instead or other supported audio formats!
+  ///
+  int seek(int handle, double time) {
+    return _seek(handle, time);
+  }
+
+  late final _seekPtr = _lookup<
+      ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+    'seek',
+  );
+  late final _seek = _seekPtr.asFunction<int Function(int, double)>();
+
+  /// Get current sound position  in seconds
+  ///
+  /// [handle] the sound handle
+  /// Returns time in seconds
+  double getPosition(int handle) {
+    return _getPosition(handle);
+  }
+
+  late final _getPositionPtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
+    'getPosition',
+  );
+  late final _getPosition = _getPositionPtr.asFunction<double Function(int)>();
+
+  /// Get current Global volume
+  ///
+  /// Returns the volume
+  double getGlobalVolume() {
+    return _getGlobalVolume();
+  }
+
+  late final _getGlobalVolumePtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function()>>('getGlobalVolume');
+  late final _getGlobalVolume =
+      _getGlobalVolumePtr.asFunction<double Function()>();
+
+  /// Set current Global volume
+  ///
+  /// Returns [PlayerErrors.noError] if success
+  int setGlobalVolume(double volume) {
+    return _setGlobalVolume(volume);
+  }
+
+  late final _setGlobalVolumePtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Float)>>(
+          'setGlobalVolume');
+  late final _setGlobalVolume =
+      _setGlobalVolumePtr.asFunction<int Function(double)>();
+
+  /// Get current [handle] volume
+  ///
+  /// Returns the volume
+  double getVolume(int handle) {
+    return _getVolume(handle);
+  }
+
+  late final _getVolumePtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
+          'getVolume');
+  late final _getVolume = _getVolumePtr.asFunction<double Function(int)>();
+
+  /// Set current [handle] volume
+  ///
+  /// Returns [PlayerErrors.noError] if success
+  int setVolume(int handle, double volume) {
+    return _setVolume(handle, volume);
+  }
+
+  late final _setVolumePtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'setVolume');
+  late final _setVolume = _setVolumePtr.asFunction<int Function(int, double)>();
+
+  /// Check if a handle is still valid.
+  ///
+  /// [handle] handle to check
+  /// Return true if it still exists
+  bool getIsValidVoiceHandle(int handle) {
+    return _getIsValidVoiceHandle(handle) == 1;
+  }
+
+  late final _getIsValidVoiceHandlePtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+    'getIsValidVoiceHandle',
+  );
+  late final _getIsValidVoiceHandle =
+      _getIsValidVoiceHandlePtr.asFunction<int Function(int)>();
+
+  /// Set [handle] pan
+  int setPan(int handle, double pan) {
+    return _setPan(handle, pan);
+  }
+
+  late final _setPanPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'setPan');
+  late final _setPan = _setPanPtr.asFunction<int Function(int, double)>();
+
+  /// Protect [handle] from being stopped or made virtual
+  int setProtectVoice(int handle, bool protect) {
+    return _setProtectVoice(handle, protect);
+  }
+
+  late final _setProtectVoicePtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Bool)>>(
+      'setProtectVoice');
+  late final _setProtectVoice =
+      _setProtectVoicePtr.asFunction<int Function(int, bool)>();
+
+  /////////////////////////////////////////
+  /// voice groups
+  /////////////////////////////////////////
+
+  /// Create a voice group
+  ({PlayerErrors error, int group}) createVoiceGroup() {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> g =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _createVoiceGroup(g);
+    final ret = (error: PlayerErrors.values[e], group: g.value);
+    calloc.free(g);
+    return ret;
+  }
+
+  late final _createVoiceGroupPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int32 Function(ffi.Pointer<ffi.UnsignedInt>)>>(
+      'createVoiceGroup');
+  late final _createVoiceGroup = _createVoiceGroupPtr
+      .asFunction<int Function(ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Destroy a voice group
+  PlayerErrors destroyVoiceGroup(int group) {
+    return PlayerErrors.values[_destroyVoiceGroup(group)];
+  }
+
+  late final _destroyVoiceGroupPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'destroyVoiceGroup');
+  late final _destroyVoiceGroup =
+      _destroyVoiceGroupPtr.asFunction<int Function(int)>();
+
+  /// Add voices to a voice group
+  PlayerErrors addVoicesToGroup(int group, List<int> handles) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> h =
+        calloc(handles.length * ffi.sizeOf<ffi.UnsignedInt>());
+    for (var i = 0; i < handles.length; i++) {
+      h[i] = handles[i];
+    }
+    final e = _addVoicesToGroup(group, h, handles.length);
+    calloc.free(h);
+    return PlayerErrors.values[e];
+  }
+
+  late final _addVoicesToGroupPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Pointer<ffi.UnsignedInt>,
+              ffi.UnsignedInt)>>('addVoicesToGroup');
+  late final _addVoicesToGroup = _addVoicesToGroupPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.UnsignedInt>, int)>();
+
+  /// Check if [handle] is a voice group
+  bool isVoiceGroup(int handle) {
+    return _isVoiceGroup(handle) == 1;
+  }
+
+  late final _isVoiceGroupPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+          'isVoiceGroup');
+  late final _isVoiceGroup = _isVoiceGroupPtr.asFunction<int Function(int)>();
+
+  /// Check if all the voices of [group] have ended
+  bool isVoiceGroupEmpty(int group) {
+    return _isVoiceGroupEmpty(group) == 1;
+  }
+
+  late final _isVoiceGroupEmptyPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+          'isVoiceGroupEmpty');
+  late final _isVoiceGroupEmpty =
+      _isVoiceGroupEmptyPtr.asFunction<int Function(int)>();
+
+  /////////////////////////////////////////
+  /// faders
+  /////////////////////////////////////////
+
+  /// Smoothly change the global volume over specified time.
+  ///
+  int fadeGlobalVolume(double to, double time) {
+    return _fadeGlobalVolume(to, time);
+  }
+
+  late final _fadeGlobalVolumePtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Float, ffi.Float)>>(
+          'fadeGlobalVolume');
+  late final _fadeGlobalVolume =
+      _fadeGlobalVolumePtr.asFunction<int Function(double, double)>();
+
+  /// Smoothly change a channel's volume over specified time.
+  ///
+  int fadeVolume(int handle, double to, double time) {
+    return _fadeVolume(handle, to, time);
+  }
+
+  late final _fadeVolumePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadeVolume');
+  late final _fadeVolume =
+      _fadeVolumePtr.asFunction<int Function(int, double, double)>();
+
+  /// Smoothly change a channel's pan setting over specified time.
+  ///
+  int fadePan(int handle, double to, double time) {
+    return _fadePan(handle, to, time);
+  }
+
+  late final _fadePanPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadePan');
+  late final _fadePan =
+      _fadePanPtr.asFunction<int Function(int, double, double)>();
+
+  /// Smoothly change a channel's relative play speed over specified time.
+  ///
+  int fadeRelativePlaySpeed(int handle, double to, double time) {
+    return _fadeRelativePlaySpeed(handle, to, time);
+  }
+
+  late final _fadeRelativePlaySpeedPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadeRelativePlaySpeed');
+  late final _fadeRelativePlaySpeed =
+      _fadeRelativePlaySpeedPtr.asFunction<int Function(int, double, double)>();
+
+  /// After specified time, pause the channel.
+  ///
+  int schedulePause(int handle, double time) {
+    return _schedulePause(handle, time);
+  }
+
+  late final _schedulePausePtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'schedulePause');
+  late final _schedulePause =
+      _schedulePausePtr.asFunction<int Function(int, double)>();
+
+  /// After specified time, stop the channel.
+  ///
+  int scheduleStop(int handle, double time) {
+    return _scheduleStop(handle, time);
+  }
+
+  late final _scheduleStopPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'scheduleStop');
+  late final _scheduleStop =
+      _scheduleStopPtr.asFunction<int Function(int, double)>();
+
+  /// Set fader to oscillate the volume at specified frequency.
+  ///
+  int oscillateVolume(int handle, double from, double to, double time) {
+    return _oscillateVolume(handle, from, to, time);
+  }
+
+  late final _oscillateVolumePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Float)>>('oscillateVolume');
+  late final _oscillateVolume = _oscillateVolumePtr
+      .asFunction<int Function(int, double, double, double)>();
+
+  /// Set fader to oscillate the panning at specified frequency.
+  ///
+  int oscillatePan(int handle, double from, double to, double time) {
+    return _oscillatePan(handle, from, to, time);
+  }
+
+  late final _oscillatePanPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Float)>>('oscillatePan');
+  late final _oscillatePan =
+      _oscillatePanPtr.asFunction<int Function(int, double, double, double)>();
+
+  /// Set fader to oscillate the relative play speed at specified frequency.
+  ///
+  int oscillateRelativePlaySpeed(
+      int handle, double from, double to, double time) {
+    return _oscillateRelativePlaySpeed(handle, from, to, time);
+  }
+
+  late final _oscillateRelativePlaySpeedPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Float)>>('oscillateRelativePlaySpeed');
+  late final _oscillateRelativePlaySpeed = _oscillateRelativePlaySpeedPtr
+      .asFunction<int Function(int, double, double, double)>();
+
+  /// Set fader to oscillate the global volume at specified frequency.
+  ///
+  int oscillateGlobalVolume(double from, double to, double time) {
+    return _oscillateGlobalVolume(from, to, time);
+  }
+
+  late final _oscillateGlobalVolumePtr = _lookup<
+          ffi
+          .NativeFunction<ffi.Int32 Function(ffi.Float, ffi.Float, ffi.Float)>>(
+      'oscillateGlobalVolume');
+  late final _oscillateGlobalVolume = _oscillateGlobalVolumePtr
+      .asFunction<int Function(double, double, double)>();
+
+  /////////////////////////////////////////
+  /// timeline
+  /////////////////////////////////////////
+
+  /// Get the engine time: the number of samples mixed since the
+  /// engine has been initialized
+  int getEngineTime() {
+    return _getEngineTime();
+  }
+
+  late final _getEngineTimePtr =
+      _lookup<ffi.NativeFunction<ffi.UnsignedLongLong Function()>>(
+          'getEngineTime');
+  late final _getEngineTime = _getEngineTimePtr.asFunction<int Function()>();
+
+  /// Get the engine sample rate
+  int getEngineSampleRate() {
+    return _getEngineSampleRate();
+  }
+
+  late final _getEngineSampleRatePtr =
+      _lookup<ffi.NativeFunction<ffi.UnsignedInt Function()>>(
+          'getEngineSampleRate');
+  late final _getEngineSampleRate =
+      _getEngineSampleRatePtr.asFunction<int Function()>();
+
+  /// Play a sound at an exact engine time
+  ///
+  /// [soundHash] the unique sound hash of a sound
+  /// [time] engine time in samples
+  /// Returns [PlayerErrors.noError] if success and the event id
+  ({PlayerErrors error, int eventId}) schedulePlayAt(
+    int soundHash,
+    int time,
+    double volume,
+    double pan,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _schedulePlayAt(soundHash, time, volume, pan, id);
+    final ret = (error: PlayerErrors.values[e], eventId: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _schedulePlayAtPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedLongLong,
+            ffi.Float,
+            ffi.Float,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('schedulePlayAt');
+  late final _schedulePlayAt = _schedulePlayAtPtr.asFunction<
+      int Function(int, int, double, double, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Change a voice at an exact engine time
+  ///
+  /// [handle] the voice to change
+  /// [playEventId] if not 0, the voice started by this play event
+  /// [time] engine time in samples
+  /// [action] what to change
+  /// [value] the new value
+  /// Returns [PlayerErrors.noError] if success and the event id
+  ({PlayerErrors error, int eventId}) scheduleVoiceEventAt(
+    int handle,
+    int playEventId,
+    int time,
+    ScheduledVoiceAction action,
+    double value,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _scheduleVoiceEventAt(
+      handle,
+      playEventId,
+      time,
+      action.index + 1,
+      value,
+      id,
+    );
+    final ret = (error: PlayerErrors.values[e], eventId: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _scheduleVoiceEventAtPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.UnsignedLongLong,
+            ffi.Int,
+            ffi.Float,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('scheduleVoiceEventAt');
+  late final _scheduleVoiceEventAt = _scheduleVoiceEventAtPtr.asFunction<
+      int Function(
+          int, int, int, int, double, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Set a parameter of an active global filter at an exact engine time
+  ///
+  /// [filterType] filter to change
+  /// [attributeId] the attribute index
+  /// [value] the new value
+  /// [time] engine time in samples
+  /// Returns [PlayerErrors.noError] if success and the event id
+  ({PlayerErrors error, int eventId}) scheduleFilterParamAt(
+    int filterType,
+    int attributeId,
+    double value,
+    int time,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _scheduleFilterParamAt(filterType, attributeId, value, time, id);
+    final ret = (error: PlayerErrors.values[e], eventId: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _scheduleFilterParamAtPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.Int32,
+            ffi.Int,
+            ffi.Float,
+            ffi.UnsignedLongLong,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('scheduleFilterParamAt');
+  late final _scheduleFilterParamAt = _scheduleFilterParamAtPtr.asFunction<
+      int Function(int, int, double, int, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Remove a scheduled event not yet run
+  ///
+  /// Returns true if the event was pending
+  bool cancelScheduledEvent(int eventId) {
+    return _cancelScheduledEvent(eventId);
+  }
+
+  late final _cancelScheduledEventPtr =
+      _lookup<ffi.NativeFunction<ffi.Bool Function(ffi.UnsignedInt)>>(
+          'cancelScheduledEvent');
+  late final _cancelScheduledEvent =
+      _cancelScheduledEventPtr.asFunction<bool Function(int)>();
+
+  /// Remove all the scheduled events not yet run
+  void cancelAllScheduledEvents() {
+    return _cancelAllScheduledEvents();
+  }
+
+  late final _cancelAllScheduledEventsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>(
+          'cancelAllScheduledEvents');
+  late final _cancelAllScheduledEvents =
+      _cancelAllScheduledEventsPtr.asFunction<void Function()>();
+
+  /// Get the voice started by a [schedulePlayAt] event
+  ///
+  /// Returns the handle or 0 if the event has not been run yet
+  int getScheduledHandle(int eventId) {
+    return _getScheduledHandle(eventId);
+  }
+
+  late final _getScheduledHandlePtr =
+      _lookup<ffi.NativeFunction<ffi.UnsignedInt Function(ffi.UnsignedInt)>>(
+          'getScheduledHandle');
+  late final _getScheduledHandle =
+      _getScheduledHandlePtr.asFunction<int Function(int)>();
+
+  /////////////////////////////////////////
+  /// sequencers
+  /////////////////////////////////////////
+
+  /// Create a new stopped step sequencer with an empty pattern
+  ///
+  /// [bpm] tempo in beats per minute
+  /// [stepsPerBeat] ie 4 for 16th notes
+  /// [steps] pattern length
+  /// [tracks] number of rows of the pattern
+  /// Returns [PlayerErrors.noError] if success and the sequencer id
+  ({PlayerErrors error, int id}) createSequencer(
+    double bpm,
+    int stepsPerBeat,
+    int steps,
+    int tracks,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _createSequencer(bpm, stepsPerBeat, steps, tracks, id);
+    final ret = (error: PlayerErrors.values[e], id: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _createSequencerPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.Float,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('createSequencer');
+  late final _createSequencer = _createSequencerPtr.asFunction<
+      int Function(double, int, int, int, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Stop and remove a sequencer
+  void destroySequencer(int id) {
+    return _destroySequencer(id);
+  }
+
+  late final _destroySequencerPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+          'destroySequencer');
+  late final _destroySequencer =
+      _destroySequencerPtr.asFunction<void Function(int)>();
+
+  /// Change the tempo. It takes effect from the next step
+  PlayerErrors sequencerSetTempo(int id, double bpm, int stepsPerBeat) {
+    return PlayerErrors.values[_sequencerSetTempo(id, bpm, stepsPerBeat)];
+  }
+
+  late final _sequencerSetTempoPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float,
+              ffi.UnsignedInt)>>('sequencerSetTempo');
+  late final _sequencerSetTempo =
+      _sequencerSetTempoPtr.asFunction<int Function(int, double, int)>();
+
+  /// Delay the odd steps by [swing] (0 to 0.9) of a step
+  PlayerErrors sequencerSetSwing(int id, double swing) {
+    return PlayerErrors.values[_sequencerSetSwing(id, swing)];
+  }
+
+  late final _sequencerSetSwingPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>('sequencerSetSwing');
+  late final _sequencerSetSwing =
+      _sequencerSetSwingPtr.asFunction<int Function(int, double)>();
+
+  /// Resize the pattern. The cells inside the new size are kept
+  PlayerErrors sequencerSetSize(int id, int steps, int tracks) {
+    return PlayerErrors.values[_sequencerSetSize(id, steps, tracks)];
+  }
+
+  late final _sequencerSetSizePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedInt,
+              ffi.UnsignedInt)>>('sequencerSetSize');
+  late final _sequencerSetSize =
+      _sequencerSetSizePtr.asFunction<int Function(int, int, int)>();
+
+  /// Change many pattern cells at once with a single call
+  ///
+  /// Returns [PlayerErrors.invalidParameter] if a sound or a cell is not
+  /// found. The other edits are applied anyway
+  PlayerErrors sequencerSetSteps(int id, List<SequencerStep> steps) {
+    if (steps.isEmpty) return PlayerErrors.noError;
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<_SequencerStepEdit> edits =
+        calloc(ffi.sizeOf<_SequencerStepEdit>() * steps.length);
+    for (var i = 0; i < steps.length; i++) {
+      edits[i]
+        ..track = steps[i].track
+        ..step = steps[i].step
+        ..soundHash = steps[i].soundHash
+        ..volume = steps[i].volume
+        ..pan = steps[i].pan
+        ..pitch = steps[i].pitch;
+    }
+    final e = _sequencerSetSteps(id, edits, steps.length);
+    calloc.free(edits);
+    return PlayerErrors.values[e];
+  }
+
+  late final _sequencerSetStepsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<_SequencerStepEdit>,
+            ffi.UnsignedInt,
+          )>>('sequencerSetSteps');
+  late final _sequencerSetSteps = _sequencerSetStepsPtr.asFunction<
+      int Function(int, ffi.Pointer<_SequencerStepEdit>, int)>();
+
+  /// Start the sequencer from [step] at the engine time [time]
+  PlayerErrors sequencerStart(int id, int time, int step) {
+    return PlayerErrors.values[_sequencerStart(id, time, step)];
+  }
+
+  late final _sequencerStartPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedLongLong,
+              ffi.UnsignedInt)>>('sequencerStart');
+  late final _sequencerStart =
+      _sequencerStartPtr.asFunction<int Function(int, int, int)>();
 
-  /// Set current [handle] volume
-  ///
-  /// Returns [PlayerErrors.noError] if success
-  int setVolume(int handle, double volume) {
-    return _setVolume(handle, volume);
+  /// Stop the sequencer
+  PlayerErrors sequencerStop(int id) {
+    return PlayerErrors.values[_sequencerStop(id)];
   }
 
-  late final _setVolumePtr = _lookup<
-          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
-      'setVolume');
-  late final _setVolume = _setVolumePtr.asFunction<int Function(int, double)>();
+  late final _sequencerStopPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'sequencerStop');
+  late final _sequencerStop = _sequencerStopPtr.asFunction<int Function(int)>();
 
-  /// Check if a handle is still valid.
-  ///
-  /// [handle] handle to check
-  /// Return true if it still exists
-  bool getIsValidVoiceHandle(int handle) {
-    return _getIsValidVoiceHandle(handle) == 1;
+  /// Get the last step played or -1 if stopped
+  int sequencerGetCurrentStep(int id) {
+    return _sequencerGetCurrentStep(id);
   }
 
-  late final _getIsValidVoiceHandlePtr =
+  late final _sequencerGetCurrentStepPtr =
       _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
-    'getIsValidVoiceHandle',
-  );
-  late final _getIsValidVoiceHandle =
-      _getIsValidVoiceHandlePtr.asFunction<int Function(int)>();
+          'sequencerGetCurrentStep');
+  late final _sequencerGetCurrentStep =
+      _sequencerGetCurrentStepPtr.asFunction<int Function(int)>();
 
   /////////////////////////////////////////
-  /// faders
+  /// samplers
   /////////////////////////////////////////
 
-  /// Smoothly change the global volume over specified time.
+  /// Create a new multi-sample instrument without zones
   ///
-  int fadeGlobalVolume(double to, double time) {
-    return _fadeGlobalVolume(to, time);
+  /// Returns [PlayerErrors.noError] if success and the sampler id
+  ({PlayerErrors error, int id}) createSampler() {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _createSampler(id);
+    final ret = (error: PlayerErrors.values[e], id: id.value);
+    calloc.free(id);
+    return ret;
   }
 
-  late final _fadeGlobalVolumePtr =
-      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Float, ffi.Float)>>(
-          'fadeGlobalVolume');
-  late final _fadeGlobalVolume =
-      _fadeGlobalVolumePtr.asFunction<int Function(double, double)>();
+  late final _createSamplerPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.UnsignedInt>)>>(
+      'createSampler');
+  late final _createSampler = _createSamplerPtr
+      .asFunction<int Function(ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Smoothly change a channel's volume over specified time.
-  ///
-  int fadeVolume(int handle, double to, double time) {
-    return _fadeVolume(handle, to, time);
+  /// Release the notes and remove a sampler
+  void destroySampler(int id) {
+    return _destroySampler(id);
   }
 
-  late final _fadeVolumePtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int32 Function(
-              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadeVolume');
-  late final _fadeVolume =
-      _fadeVolumePtr.asFunction<int Function(int, double, double)>();
+  late final _destroySamplerPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+          'destroySampler');
+  late final _destroySampler =
+      _destroySamplerPtr.asFunction<void Function(int)>();
 
-  /// Smoothly change a channel's pan setting over specified time.
-  ///
-  int fadePan(int handle, double to, double time) {
-    return _fadePan(handle, to, time);
+  /// Add zones to a sampler
+  PlayerErrors samplerAddZones(int id, List<SamplerZone> zones) {
+    if (zones.isEmpty) return PlayerErrors.noError;
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<_SamplerZone> z =
+        calloc(ffi.sizeOf<_SamplerZone>() * zones.length);
+    for (var i = 0; i < zones.length; i++) {
+      z[i]
+        ..soundHash = zones[i].soundHash
+        ..loKey = zones[i].loKey
+        ..hiKey = zones[i].hiKey
+        ..loVelocity = zones[i].loVelocity
+        ..hiVelocity = zones[i].hiVelocity
+        ..rootKey = zones[i].rootKey
+        ..volume = zones[i].volume
+        ..pan = zones[i].pan
+        ..loop = zones[i].loop ? 1 : 0
+        ..loopStart = zones[i].loopStart
+        ..release = zones[i].release
+        ..trigger = zones[i].trigger.index
+        ..seqLength = zones[i].seqLength
+        ..seqPosition = zones[i].seqPosition;
+    }
+    final e = _samplerAddZones(id, z, zones.length);
+    calloc.free(z);
+    return PlayerErrors.values[e];
   }
 
-  late final _fadePanPtr = _lookup<
+  late final _samplerAddZonesPtr = _lookup<
       ffi.NativeFunction<
           ffi.Int32 Function(
-              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadePan');
-  late final _fadePan =
-      _fadePanPtr.asFunction<int Function(int, double, double)>();
+            ffi.UnsignedInt,
+            ffi.Pointer<_SamplerZone>,
+            ffi.UnsignedInt,
+          )>>('samplerAddZones');
+  late final _samplerAddZones = _samplerAddZonesPtr
+      .asFunction<int Function(int, ffi.Pointer<_SamplerZone>, int)>();
 
-  /// Smoothly change a channel's relative play speed over specified time.
+  /// Remove all the zones of a sampler
+  PlayerErrors samplerClearZones(int id) {
+    return PlayerErrors.values[_samplerClearZones(id)];
+  }
+
+  late final _samplerClearZonesPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'samplerClearZones');
+  late final _samplerClearZones =
+      _samplerClearZonesPtr.asFunction<int Function(int)>();
+
+  /// Start the zones of a note
   ///
-  int fadeRelativePlaySpeed(int handle, double to, double time) {
-    return _fadeRelativePlaySpeed(handle, to, time);
+  /// Returns [PlayerErrors.noError] if success and the handle of the first
+  /// voice started, 0 if no zone matches
+  ({PlayerErrors error, int handle}) samplerNoteOn(
+    int id,
+    double note,
+    double velocity,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> handle =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _samplerNoteOn(id, note, velocity, handle);
+    final ret = (error: PlayerErrors.values[e], handle: handle.value);
+    calloc.free(handle);
+    return ret;
   }
 
-  late final _fadeRelativePlaySpeedPtr = _lookup<
+  late final _samplerNoteOnPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Int32 Function(
-              ffi.UnsignedInt, ffi.Float, ffi.Float)>>('fadeRelativePlaySpeed');
-  late final _fadeRelativePlaySpeed =
-      _fadeRelativePlaySpeedPtr.asFunction<int Function(int, double, double)>();
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
+              ffi.Pointer<ffi.UnsignedInt>)>>('samplerNoteOn');
+  late final _samplerNoteOn = _samplerNoteOnPtr.asFunction<
+      int Function(int, double, double, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// After specified time, pause the channel.
-  ///
-  int schedulePause(int handle, double time) {
-    return _schedulePause(handle, time);
+  /// Release a note and start its release zones
+  PlayerErrors samplerNoteOff(int id, double note) {
+    return PlayerErrors.values[_samplerNoteOff(id, note)];
   }
 
-  late final _schedulePausePtr = _lookup<
+  late final _samplerNoteOffPtr = _lookup<
           ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
-      'schedulePause');
-  late final _schedulePause =
-      _schedulePausePtr.asFunction<int Function(int, double)>();
+      'samplerNoteOff');
+  late final _samplerNoteOff =
+      _samplerNoteOffPtr.asFunction<int Function(int, double)>();
 
-  /// After specified time, stop the channel.
-  ///
-  int scheduleStop(int handle, double time) {
-    return _scheduleStop(handle, time);
+  /// Release all the notes
+  PlayerErrors samplerAllNotesOff(int id) {
+    return PlayerErrors.values[_samplerAllNotesOff(id)];
   }
 
-  late final _scheduleStopPtr = _lookup<
-          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
-      'scheduleStop');
-  late final _scheduleStop =
-      _scheduleStopPtr.asFunction<int Function(int, double)>();
+  late final _samplerAllNotesOffPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt)>>(
+          'samplerAllNotesOff');
+  late final _samplerAllNotesOff =
+      _samplerAllNotesOffPtr.asFunction<int Function(int)>();
 
-  /// Set fader to oscillate the volume at specified frequency.
-  ///
-  int oscillateVolume(int handle, double from, double to, double time) {
-    return _oscillateVolume(handle, from, to, time);
+  /// Get how many notes are held and still sounding
+  int samplerGetActiveNotes(int id) {
+    return _samplerGetActiveNotes(id);
   }
 
-  late final _oscillateVolumePtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
-              ffi.Float)>>('oscillateVolume');
-  late final _oscillateVolume = _oscillateVolumePtr
-      .asFunction<int Function(int, double, double, double)>();
+  late final _samplerGetActiveNotesPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.UnsignedInt)>>(
+          'samplerGetActiveNotes');
+  late final _samplerGetActiveNotes =
+      _samplerGetActiveNotesPtr.asFunction<int Function(int)>();
 
-  /// Set fader to oscillate the panning at specified frequency.
-  ///
-  int oscillatePan(int handle, double from, double to, double time) {
-    return _oscillatePan(handle, from, to, time);
+  /////////////////////////////////////////
+  /// status block
+  /////////////////////////////////////////
+
+  /// Start or stop publishing the engine state after every mixed block
+  void setStatusBlockEnabled(bool enabled) {
+    return _setStatusBlockEnabled(enabled);
   }
 
-  late final _oscillatePanPtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
-              ffi.Float)>>('oscillatePan');
-  late final _oscillatePan =
-      _oscillatePanPtr.asFunction<int Function(int, double, double, double)>();
+  late final _setStatusBlockEnabledPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Bool)>>(
+          'setStatusBlockEnabled');
+  late final _setStatusBlockEnabled =
+      _setStatusBlockEnabledPtr.asFunction<void Function(bool)>();
 
-  /// Set fader to oscillate the relative play speed at specified frequency.
+  /// Get the memory where the engine state is published
   ///
-  int oscillateRelativePlaySpeed(
-      int handle, double from, double to, double time) {
-    return _oscillateRelativePlaySpeed(handle, from, to, time);
+  /// Returns the memory pointer and its size in bytes
+  ({ffi.Pointer<ffi.Uint8> data, int size}) getStatusBlock() {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> size =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final data = _getStatusBlock(size);
+    final ret = (data: data.cast<ffi.Uint8>(), size: size.value);
+    calloc.free(size);
+    return ret;
   }
 
-  late final _oscillateRelativePlaySpeedPtr = _lookup<
+  late final _getStatusBlockPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Int32 Function(ffi.UnsignedInt, ffi.Float, ffi.Float,
-              ffi.Float)>>('oscillateRelativePlaySpeed');
-  late final _oscillateRelativePlaySpeed = _oscillateRelativePlaySpeedPtr
-      .asFunction<int Function(int, double, double, double)>();
+          ffi.Pointer<ffi.Void> Function(
+              ffi.Pointer<ffi.UnsignedInt>)>>('getStatusBlock');
+  late final _getStatusBlock = _getStatusBlockPtr.asFunction<
+      ffi.Pointer<ffi.Void> Function(ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Set fader to oscillate the global volume at specified frequency.
+  /////////////////////////////////////////
+  /// audio clock
+  /////////////////////////////////////////
+
+  /// Get the engine time being heard now, in seconds
+  double getOutputTime() {
+    return _getOutputTime();
+  }
+
+  late final _getOutputTimePtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function()>>('getOutputTime');
+  late final _getOutputTime = _getOutputTimePtr.asFunction<double Function()>();
+
+  /// Get the position of the voice [handle] being heard now, in seconds
   ///
-  int oscillateGlobalVolume(double from, double to, double time) {
-    return _oscillateGlobalVolume(from, to, time);
+  /// Returns -1 if the handle is not valid
+  double getOutputPosition(int handle) {
+    return _getOutputPosition(handle);
   }
 
-  late final _oscillateGlobalVolumePtr = _lookup<
-          ffi
-          .NativeFunction<ffi.Int32 Function(ffi.Float, ffi.Float, ffi.Float)>>(
-      'oscillateGlobalVolume');
-  late final _oscillateGlobalVolume = _oscillateGlobalVolumePtr
-      .asFunction<int Function(double, double, double)>();
+  late final _getOutputPositionPtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function(ffi.UnsignedInt)>>(
+          'getOutputPosition');
+  late final _getOutputPosition =
+      _getOutputPositionPtr.asFunction<double Function(int)>();
+
+  /// Set an extra output latency in seconds
+  void setOutputLatencyOffset(double seconds) {
+    return _setOutputLatencyOffset(seconds);
+  }
+
+  late final _setOutputLatencyOffsetPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Double)>>(
+          'setOutputLatencyOffset');
+  late final _setOutputLatencyOffset =
+      _setOutputLatencyOffsetPtr.asFunction<void Function(double)>();
+
+  /// Get the output latency in seconds, offset included
+  double getOutputLatency() {
+    return _getOutputLatency();
+  }
+
+  late final _getOutputLatencyPtr =
+      _lookup<ffi.NativeFunction<ffi.Double Function()>>('getOutputLatency');
+  late final _getOutputLatency =
+      _getOutputLatencyPtr.asFunction<double Function()>();
 
-  /////////////////////////////////////////
-  /// Filters
-  /////////////////////////////////////////
 
   /// Check if the given filter is active or not.
   ///
@@ -907,74 +2553,391 @@ class FlutterSoLoudFfi {
     return ret;
   }
 
-  late final _getFilterParamNamesPtr = _lookup<
+  late final _getFilterParamNamesPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Int32, ffi.Pointer<ffi.Int>,
+              ffi.Pointer<ffi.Pointer<ffi.Char>>)>>('getFilterParamNames');
+  late final _getFilterParamNames = _getFilterParamNamesPtr.asFunction<
+      int Function(
+          int, ffi.Pointer<ffi.Int>, ffi.Pointer<ffi.Pointer<ffi.Char>>)>();
+
+  /// Add the filter [filterType].
+  ///
+  /// [filterType] filter to add
+  /// Returns [PlayerErrors.noError] if no errors
+  ///
+  int addGlobalFilter(int filterType) {
+    return _addGlobalFilter(filterType);
+  }
+
+  late final _addGlobalFilterPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Int32)>>(
+          'addGlobalFilter');
+  late final _addGlobalFilter =
+      _addGlobalFilterPtr.asFunction<int Function(int)>();
+
+  /// Remove the filter [filterType].
+  ///
+  /// [filterType] filter to remove
+  /// Returns [PlayerErrors.noError] if no errors
+  ///
+  int removeGlobalFilter(int filterType) {
+    return _removeGlobalFilter(filterType);
+  }
+
+  late final _removeGlobalFilterPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Int32)>>(
+          'removeGlobalFilter');
+  late final _removeGlobalFilter =
+      _removeGlobalFilterPtr.asFunction<int Function(int)>();
+
+  /// Set the effect parameter with id [attributeId]
+  /// of [filterType] with [value] value.
+  ///
+  /// [filterType] filter to modify a param
+  /// Returns [PlayerErrors.noError] if no errors
+  ///
+  int setFxParams(int filterType, int attributeId, double value) {
+    return _setFxParams(filterType, attributeId, value);
+  }
+
+  late final _setFxParamsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Int32, ffi.Int, ffi.Float)>>('setFxParams');
+  late final _setFxParams =
+      _setFxParamsPtr.asFunction<int Function(int, int, double)>();
+
+  /// Get the effect parameter with id [attributeId] of [filterType].
+  ///
+  /// [filterType] filter to modify a param
+  /// Returns the value of param
+  ///
+  double getFxParams(int filterType, int attributeId) {
+    return _getFxParams(filterType, attributeId);
+  }
+
+  late final _getFxParamsPtr =
+      _lookup<ffi.NativeFunction<ffi.Float Function(ffi.Int32, ffi.Int)>>(
+          'getFxParams');
+  late final _getFxParams =
+      _getFxParamsPtr.asFunction<double Function(int, int)>();
+
+  /////////////////////////////////////////
+  /// Modulation
+  /////////////////////////////////////////
+
+  /// Set the tempo of the modulation sources synced to beats
+  ///
+  /// [bpm] beats per minute
+  /// Returns [PlayerErrors.noError] if success
+  PlayerErrors modSetTempo(double bpm) {
+    return PlayerErrors.values[_modSetTempo(bpm)];
+  }
+
+  late final _modSetTempoPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Float)>>(
+          'modSetTempo');
+  late final _modSetTempo =
+      _modSetTempoPtr.asFunction<int Function(double)>();
+
+  /// Create an LFO from -1 to 1
+  ///
+  /// [shape] the [ModShape]
+  /// [rate] cycles per second
+  /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+  /// Returns [PlayerErrors.noError] if success and the id of the source
+  ({PlayerErrors error, int id}) modCreateLfo(
+    ModShape shape,
+    double rate,
+    double syncBeats,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _modCreateLfo(shape.index, rate, syncBeats, id);
+    final ret = (error: PlayerErrors.values[e], id: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _modCreateLfoPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Int32, ffi.Float, ffi.Float,
+              ffi.Pointer<ffi.UnsignedInt>)>>('modCreateLfo');
+  late final _modCreateLfo = _modCreateLfoPtr.asFunction<
+      int Function(int, double, double, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Create an envelope from 0 to 1, opened and closed by [modSetGate]
+  ///
+  /// [attack] [decay] [release] times in seconds
+  /// [sustain] level 0 to 1
+  /// Returns [PlayerErrors.noError] if success and the id of the source
+  ({PlayerErrors error, int id}) modCreateEnvelope(
+    double attack,
+    double decay,
+    double sustain,
+    double release,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _modCreateEnvelope(attack, decay, sustain, release, id);
+    final ret = (error: PlayerErrors.values[e], id: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _modCreateEnvelopePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Float, ffi.Float, ffi.Float, ffi.Float,
+              ffi.Pointer<ffi.UnsignedInt>)>>('modCreateEnvelope');
+  late final _modCreateEnvelope = _modCreateEnvelopePtr.asFunction<
+      int Function(
+          double, double, double, double, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Create a source with a new random value from -1 to 1 every cycle
+  ///
+  /// [rate] cycles per second
+  /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+  /// [smooth] glide from a value to the next instead of jumping
+  /// Returns [PlayerErrors.noError] if success and the id of the source
+  ({PlayerErrors error, int id}) modCreateRandom(
+    double rate,
+    double syncBeats,
+    bool smooth,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _modCreateRandom(rate, syncBeats, smooth, id);
+    final ret = (error: PlayerErrors.values[e], id: id.value);
+    calloc.free(id);
+    return ret;
+  }
+
+  late final _modCreateRandomPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Float, ffi.Float, ffi.Bool,
+              ffi.Pointer<ffi.UnsignedInt>)>>('modCreateRandom');
+  late final _modCreateRandom = _modCreateRandomPtr.asFunction<
+      int Function(double, double, bool, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Change the speed of an LFO or of a random source
+  ///
+  /// [id] the source id
+  /// [shape] the [ModShape], not used by random sources
+  /// [rate] cycles per second
+  /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+  /// Returns [PlayerErrors.noError] if success
+  PlayerErrors modSetSourceRate(
+    int id,
+    ModShape shape,
+    double rate,
+    double syncBeats,
+  ) {
+    return PlayerErrors.values[
+        _modSetSourceRate(id, shape.index, rate, syncBeats)];
+  }
+
+  late final _modSetSourceRatePtr = _lookup<
       ffi.NativeFunction<
-          ffi.Int32 Function(ffi.Int32, ffi.Pointer<ffi.Int>,
-              ffi.Pointer<ffi.Pointer<ffi.Char>>)>>('getFilterParamNames');
-  late final _getFilterParamNames = _getFilterParamNamesPtr.asFunction<
-      int Function(
-          int, ffi.Pointer<ffi.Int>, ffi.Pointer<ffi.Pointer<ffi.Char>>)>();
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Int32, ffi.Float,
+              ffi.Float)>>('modSetSourceRate');
+  late final _modSetSourceRate = _modSetSourceRatePtr
+      .asFunction<int Function(int, int, double, double)>();
 
-  /// Add the filter [filterType].
-  ///
-  /// [filterType] filter to add
-  /// Returns [PlayerErrors.noError] if no errors
+  /// Open or close the gate of an envelope
   ///
-  int addGlobalFilter(int filterType) {
-    return _addGlobalFilter(filterType);
+  /// [id] the source id
+  /// [gate] true to start the attack, false to start the release
+  /// Returns [PlayerErrors.noError] if success
+  PlayerErrors modSetGate(int id, bool gate) {
+    return PlayerErrors.values[_modSetGate(id, gate)];
   }
 
-  late final _addGlobalFilterPtr =
-      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Int32)>>(
-          'addGlobalFilter');
-  late final _addGlobalFilter =
-      _addGlobalFilterPtr.asFunction<int Function(int)>();
+  late final _modSetGatePtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Bool)>>(
+      'modSetGate');
+  late final _modSetGate =
+      _modSetGatePtr.asFunction<int Function(int, bool)>();
 
-  /// Remove the filter [filterType].
-  ///
-  /// [filterType] filter to remove
-  /// Returns [PlayerErrors.noError] if no errors
+  /// Remove a source and its routes
   ///
-  int removeGlobalFilter(int filterType) {
-    return _removeGlobalFilter(filterType);
+  /// [id] the source id
+  void modRemoveSource(int id) {
+    return _modRemoveSource(id);
   }
 
-  late final _removeGlobalFilterPtr =
-      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Int32)>>(
-          'removeGlobalFilter');
-  late final _removeGlobalFilter =
-      _removeGlobalFilterPtr.asFunction<int Function(int)>();
+  late final _modRemoveSourcePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+          'modRemoveSource');
+  late final _modRemoveSource =
+      _modRemoveSourcePtr.asFunction<void Function(int)>();
+
+  /// Route a source to a parameter of a waveform sound
+  ///
+  /// [sourceId] the source id
+  /// [hash] the unique sound hash of a waveform
+  /// [param] the [ModWaveformParam]
+  /// [depth] the change when the source is 1, in semitones for the
+  /// frequency
+  /// Returns [PlayerErrors.noError] if success and the id of the route
+  ({PlayerErrors error, int routeId}) modAddWaveformRoute(
+    int sourceId,
+    int hash,
+    ModWaveformParam param,
+    double depth,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e = _modAddWaveformRoute(sourceId, hash, param.index, depth, id);
+    final ret = (error: PlayerErrors.values[e], routeId: id.value);
+    calloc.free(id);
+    return ret;
+  }
 
-  /// Set the effect parameter with id [attributeId]
-  /// of [filterType] with [value] value.
-  ///
-  /// [filterType] filter to modify a param
-  /// Returns [PlayerErrors.noError] if no errors
-  ///
-  int setFxParams(int filterType, int attributeId, double value) {
-    return _setFxParams(filterType, attributeId, value);
+  late final _modAddWaveformRoutePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.UnsignedInt, ffi.Int32,
+              ffi.Float, ffi.Pointer<ffi.UnsignedInt>)>>('modAddWaveformRoute');
+  late final _modAddWaveformRoute = _modAddWaveformRoutePtr.asFunction<
+      int Function(int, int, int, double, ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Route a source to a parameter of a global filter
+  ///
+  /// [sourceId] the source id
+  /// [filterType] the filter, it can be added later
+  /// [attributeId] the parameter
+  /// [depth] the change when the source is 1
+  /// Returns [PlayerErrors.noError] if success and the id of the route
+  ({PlayerErrors error, int routeId}) modAddFilterRoute(
+    int sourceId,
+    int filterType,
+    int attributeId,
+    double depth,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> id =
+        calloc(ffi.sizeOf<ffi.UnsignedInt>());
+    final e =
+        _modAddFilterRoute(sourceId, filterType, attributeId, depth, id);
+    final ret = (error: PlayerErrors.values[e], routeId: id.value);
+    calloc.free(id);
+    return ret;
   }
 
-  late final _setFxParamsPtr = _lookup<
+  late final _modAddFilterRoutePtr = _lookup<
       ffi.NativeFunction<
-          ffi.Int32 Function(ffi.Int32, ffi.Int, ffi.Float)>>('setFxParams');
-  late final _setFxParams =
-      _setFxParamsPtr.asFunction<int Function(int, int, double)>();
+          ffi.Int32 Function(ffi.UnsignedInt, ffi.Int32, ffi.Int, ffi.Float,
+              ffi.Pointer<ffi.UnsignedInt>)>>('modAddFilterRoute');
+  late final _modAddFilterRoute = _modAddFilterRoutePtr.asFunction<
+      int Function(int, int, int, double, ffi.Pointer<ffi.UnsignedInt>)>();
 
-  /// Get the effect parameter with id [attributeId] of [filterType].
+  /// Change the depth of a route
   ///
-  /// [filterType] filter to modify a param
-  /// Returns the value of param
+  /// [routeId] the route id
+  /// [depth] the change when the source is 1
+  /// Returns [PlayerErrors.noError] if success
+  PlayerErrors modSetRouteDepth(int routeId, double depth) {
+    return PlayerErrors.values[_modSetRouteDepth(routeId, depth)];
+  }
+
+  late final _modSetRouteDepthPtr = _lookup<
+          ffi.NativeFunction<ffi.Int32 Function(ffi.UnsignedInt, ffi.Float)>>(
+      'modSetRouteDepth');
+  late final _modSetRouteDepth =
+      _modSetRouteDepthPtr.asFunction<int Function(int, double)>();
+
+  /// Remove a route. A parameter without routes gets back its value
   ///
-  double getFxParams(int filterType, int attributeId) {
-    return _getFxParams(filterType, attributeId);
+  /// [routeId] the route id
+  void modRemoveRoute(int routeId) {
+    return _modRemoveRoute(routeId);
   }
 
-  late final _getFxParamsPtr =
-      _lookup<ffi.NativeFunction<ffi.Float Function(ffi.Int32, ffi.Int)>>(
-          'getFxParams');
-  late final _getFxParams =
-      _getFxParamsPtr.asFunction<double Function(int, int)>();
+  late final _modRemoveRoutePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.UnsignedInt)>>(
+          'modRemoveRoute');
+  late final _modRemoveRoute =
+      _modRemoveRoutePtr.asFunction<void Function(int)>();
+
+  /////////////////////////////////////////
+  /// Mixer snapshots
+  /////////////////////////////////////////
+
+  /// Create or replace the mixer snapshot [name]
+  ///
+  /// [parent] the snapshot to inherit from, empty for none
+  /// [capture] store the current state of the mixer
+  PlayerErrors snapshotCreate(String name, String parent, bool capture) {
+    final n = name.toNativeUtf8();
+    final p = parent.toNativeUtf8();
+    final e = _snapshotCreate(n.cast<ffi.Char>(), p.cast<ffi.Char>(), capture);
+    calloc
+      ..free(n)
+      ..free(p);
+    return PlayerErrors.values[e];
+  }
+
+  late final _snapshotCreatePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>,
+              ffi.Bool)>>('snapshotCreate');
+  late final _snapshotCreate = _snapshotCreatePtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, bool)>();
+
+  /// Set a value of the mixer snapshot [name]
+  ///
+  /// [filterType] the filter index, -1 for the global volume
+  PlayerErrors snapshotSetValue(
+    String name,
+    int filterType,
+    int attributeId,
+    double value,
+  ) {
+    final n = name.toNativeUtf8();
+    final e =
+        _snapshotSetValue(n.cast<ffi.Char>(), filterType, attributeId, value);
+    calloc.free(n);
+    return PlayerErrors.values[e];
+  }
+
+  late final _snapshotSetValuePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(ffi.Pointer<ffi.Char>, ffi.Int, ffi.Int,
+              ffi.Float)>>('snapshotSetValue');
+  late final _snapshotSetValue = _snapshotSetValuePtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, int, int, double)>();
+
+  /// Remove the mixer snapshot [name]
+  PlayerErrors snapshotRemove(String name) {
+    final n = name.toNativeUtf8();
+    final e = _snapshotRemove(n.cast<ffi.Char>());
+    calloc.free(n);
+    return PlayerErrors.values[e];
+  }
+
+  late final _snapshotRemovePtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.Char>)>>(
+          'snapshotRemove');
+  late final _snapshotRemove =
+      _snapshotRemovePtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Blend the mixer to the snapshot [name] in [time] seconds
+  PlayerErrors snapshotBlend(String name, double time) {
+    final n = name.toNativeUtf8();
+    final e = _snapshotBlend(n.cast<ffi.Char>(), time);
+    calloc.free(n);
+    return PlayerErrors.values[e];
+  }
+
+  late final _snapshotBlendPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+              ffi.Pointer<ffi.Char>, ffi.Float)>>('snapshotBlend');
+  late final _snapshotBlend = _snapshotBlendPtr
+      .asFunction<int Function(ffi.Pointer<ffi.Char>, double)>();
 
   /////////////////////////////////////////
   /// 3D audio methods
@@ -1336,6 +3299,462 @@ class FlutterSoLoudFfi {
   late final _set3dSourceDopplerFactor =
       _set3dSourceDopplerFactorPtr.asFunction<void Function(int, double)>();
 
+  /////////////////////////////////////////
+  /// Offline analysis
+  /////////////////////////////////////////
+
+  /// Start computing the peak pyramid of a sound on a worker
+  ///
+  /// Returns whether [getWaveformPeaks] can be called without waiting
+  ({PlayerErrors error, bool ready}) prepareWaveformPeaks(int soundHash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Int> ready = calloc(ffi.sizeOf<ffi.Int>());
+    final e = _prepareWaveformPeaks(soundHash, ready);
+    final ret = (error: PlayerErrors.values[e], ready: ready.value == 1);
+    calloc.free(ready);
+    return ret;
+  }
+
+  late final _prepareWaveformPeaksPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Int>,
+          )>>('prepareWaveformPeaks');
+  late final _prepareWaveformPeaks = _prepareWaveformPeaksPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Int>)>();
+
+  /// Get the waveform overview of a sound loaded as a Wav or a WavStream,
+  /// waiting for its peak pyramid
+  ///
+  /// [startTime] [endTime] the range in seconds, [endTime] 0 for the end
+  /// [buckets] the number of values returned in each list
+  ({
+    PlayerErrors error,
+    Float32List min,
+    Float32List max,
+    Float32List rms,
+  }) getWaveformPeaks(
+    int soundHash,
+    double startTime,
+    double endTime,
+    int buckets,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> data =
+        calloc(buckets * 3 * ffi.sizeOf<ffi.Float>());
+    final e = _getWaveformPeaks(soundHash, startTime, endTime, buckets, data,
+        data.elementAt(buckets), data.elementAt(buckets * 2));
+    final values = data.asTypedList(buckets * 3);
+    final ret = (
+      error: PlayerErrors.values[e],
+      min: Float32List.fromList(values.sublist(0, buckets)),
+      max: Float32List.fromList(values.sublist(buckets, buckets * 2)),
+      rms: Float32List.fromList(values.sublist(buckets * 2)),
+    );
+    calloc.free(data);
+    return ret;
+  }
+
+  late final _getWaveformPeaksPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Float,
+            ffi.Float,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+          )>>('getWaveformPeaks');
+  late final _getWaveformPeaks = _getWaveformPeaksPtr.asFunction<
+      int Function(int, double, double, int, ffi.Pointer<ffi.Float>,
+          ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Float>)>();
+
+  /// Get the dimensions of the spectrogram of a sound
+  ///
+  /// [size] the FFT size, a power of two from 64 to 16384
+  /// [hop] the samples between two frames, from 1 to [size]
+  ({PlayerErrors error, int rows, int bins}) getSpectrogramSize(
+    int soundHash,
+    int size,
+    int hop,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> rows = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> bins = calloc();
+    final e = _getSpectrogramSize(soundHash, size, hop, rows, bins);
+    final ret = (
+      error: PlayerErrors.values[e],
+      rows: rows.value,
+      bins: bins.value,
+    );
+    calloc
+      ..free(rows)
+      ..free(bins);
+    return ret;
+  }
+
+  late final _getSpectrogramSizePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.UnsignedInt>,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('getSpectrogramSize');
+  late final _getSpectrogramSize = _getSpectrogramSizePtr.asFunction<
+      int Function(int, int, int, ffi.Pointer<ffi.UnsignedInt>,
+          ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Start computing the magnitude spectrogram of a sound on a worker into
+  /// [matrix], of rows * bins floats given by [getSpectrogramSize]
+  ///
+  /// Returns the job to pass to [pollSpectrogram]
+  ({PlayerErrors error, int job}) computeSpectrogram(
+    int soundHash,
+    int size,
+    int hop,
+    SpectrogramWindow window,
+    ffi.Pointer<ffi.Float> matrix,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> job = calloc();
+    final e =
+        _computeSpectrogram(soundHash, size, hop, window.index, matrix, job);
+    final ret = (error: PlayerErrors.values[e], job: job.value);
+    calloc.free(job);
+    return ret;
+  }
+
+  late final _computeSpectrogramPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Int,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('computeSpectrogram');
+  late final _computeSpectrogram = _computeSpectrogramPtr.asFunction<
+      int Function(int, int, int, int, ffi.Pointer<ffi.Float>,
+          ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Start computing the spectrogram of a sound on a worker into [matrix],
+  /// of rows * bins bytes given by [getSpectrogramSize], the levels from
+  /// [minDb] to 0 dB quantized from 0 to 255
+  ///
+  /// Returns the job to pass to [pollSpectrogram]
+  ({PlayerErrors error, int job}) computeSpectrogramDb(
+    int soundHash,
+    int size,
+    int hop,
+    SpectrogramWindow window,
+    ffi.Pointer<ffi.Uint8> matrix,
+    double minDb,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> job = calloc();
+    final e = _computeSpectrogramDb(
+        soundHash, size, hop, window.index, matrix, minDb, job);
+    final ret = (error: PlayerErrors.values[e], job: job.value);
+    calloc.free(job);
+    return ret;
+  }
+
+  late final _computeSpectrogramDbPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.UnsignedInt,
+            ffi.Int,
+            ffi.Pointer<ffi.Uint8>,
+            ffi.Float,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('computeSpectrogramDb');
+  late final _computeSpectrogramDb = _computeSpectrogramDbPtr.asFunction<
+      int Function(int, int, int, int, ffi.Pointer<ffi.Uint8>, double,
+          ffi.Pointer<ffi.UnsignedInt>)>();
+
+  /// Check whether a spectrogram started by [computeSpectrogram] or
+  /// [computeSpectrogramDb] is done, forgetting the job once it is
+  ///
+  /// Returns [PlayerErrors.invalidParameter] if the job was stopped by
+  /// disposing of its sound
+  ({PlayerErrors error, bool ready}) pollSpectrogram(int job) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Int> done = calloc(ffi.sizeOf<ffi.Int>());
+    final e = _pollSpectrogram(job, done);
+    final ret = (error: PlayerErrors.values[e], ready: done.value == 1);
+    calloc.free(done);
+    return ret;
+  }
+
+  late final _pollSpectrogramPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Int>,
+          )>>('pollSpectrogram');
+  late final _pollSpectrogram = _pollSpectrogramPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Int>)>();
+
+  /// Start detecting the rhythm of a sound on a worker
+  ///
+  /// Returns whether [analyzeRhythm] can be called without waiting
+  ({PlayerErrors error, bool ready}) prepareRhythmAnalysis(int soundHash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Int> ready = calloc(ffi.sizeOf<ffi.Int>());
+    final e = _prepareRhythmAnalysis(soundHash, ready);
+    final ret = (error: PlayerErrors.values[e], ready: ready.value == 1);
+    calloc.free(ready);
+    return ret;
+  }
+
+  late final _prepareRhythmAnalysisPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Int>,
+          )>>('prepareRhythmAnalysis');
+  late final _prepareRhythmAnalysis = _prepareRhythmAnalysisPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Int>)>();
+
+  /// Detect the onsets, the tempo and the beats of a sound, waiting for
+  /// its analysis
+  ///
+  /// Returns the tempo in BPM, 0 if none was found, and the onset and beat
+  /// times in seconds
+  ({
+    PlayerErrors error,
+    double bpm,
+    Float32List onsets,
+    Float32List beats,
+  }) analyzeRhythm(int soundHash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> bpm = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> onsetCount = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.UnsignedInt> beatCount = calloc();
+    var e = _analyzeRhythm(soundHash, bpm, onsetCount, beatCount);
+    var onsets = Float32List(0);
+    var beats = Float32List(0);
+    if (e == PlayerErrors.noError.index) {
+      // ignore: omit_local_variable_types
+      final ffi.Pointer<ffi.Float> times = calloc(
+          (onsetCount.value + beatCount.value + 1) * ffi.sizeOf<ffi.Float>());
+      e = _getRhythmEvents(
+          soundHash, times, times.elementAt(onsetCount.value));
+      final values = times.asTypedList(onsetCount.value + beatCount.value);
+      onsets = Float32List.fromList(values.sublist(0, onsetCount.value));
+      beats = Float32List.fromList(values.sublist(onsetCount.value));
+      calloc.free(times);
+    }
+    final ret = (
+      error: PlayerErrors.values[e],
+      bpm: bpm.value,
+      onsets: onsets,
+      beats: beats,
+    );
+    calloc
+      ..free(bpm)
+      ..free(onsetCount)
+      ..free(beatCount);
+    return ret;
+  }
+
+  late final _analyzeRhythmPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.UnsignedInt>,
+            ffi.Pointer<ffi.UnsignedInt>,
+          )>>('analyzeRhythm');
+  late final _analyzeRhythm = _analyzeRhythmPtr.asFunction<
+      int Function(int, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.UnsignedInt>,
+          ffi.Pointer<ffi.UnsignedInt>)>();
+
+  late final _getRhythmEventsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+          )>>('getRhythmEvents');
+  late final _getRhythmEvents = _getRhythmEventsPtr.asFunction<
+      int Function(int, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Float>)>();
+
+  /// Start measuring the loudness of a sound on a worker
+  ///
+  /// Returns whether [getLoudness] can be called without waiting
+  ({PlayerErrors error, bool ready}) prepareLoudness(int soundHash) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Int> ready = calloc(ffi.sizeOf<ffi.Int>());
+    final e = _prepareLoudness(soundHash, ready);
+    final ret = (error: PlayerErrors.values[e], ready: ready.value == 1);
+    calloc.free(ready);
+    return ret;
+  }
+
+  late final _prepareLoudnessPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Int>,
+          )>>('prepareLoudness');
+  late final _prepareLoudness = _prepareLoudnessPtr
+      .asFunction<int Function(int, ffi.Pointer<ffi.Int>)>();
+
+  /// Measure the loudness of the sounds loaded from files from now on,
+  /// each on a worker thread as soon as it is loaded
+  void setLoudnessMeasurementOnLoad(bool enabled) {
+    return _setLoudnessMeasurementOnLoad(enabled ? 1 : 0);
+  }
+
+  late final _setLoudnessMeasurementOnLoadPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
+    'setLoudnessMeasurementOnLoad',
+  );
+  late final _setLoudnessMeasurementOnLoad =
+      _setLoudnessMeasurementOnLoadPtr.asFunction<void Function(int)>();
+
+  /// Get the EBU R128 loudness of a sound, waiting for its measure if
+  /// still running
+  ///
+  /// Returns the integrated loudness in LUFS and the true peak in dBTP
+  ({PlayerErrors error, double integrated, double truePeak}) getLoudness(
+    int soundHash,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> integrated = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> truePeak = calloc();
+    final e = _getLoudness(soundHash, integrated, truePeak);
+    final ret = (
+      error: PlayerErrors.values[e],
+      integrated: integrated.value,
+      truePeak: truePeak.value,
+    );
+    calloc
+      ..free(integrated)
+      ..free(truePeak);
+    return ret;
+  }
+
+  late final _getLoudnessPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+          )>>('getLoudness');
+  late final _getLoudness = _getLoudnessPtr.asFunction<
+      int Function(int, ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Float>)>();
+
+  /// Set the gain bringing a sound to [targetLufs], folded into the volume
+  /// of its next voices
+  ///
+  /// Returns the gain applied
+  ({PlayerErrors error, double gain}) setLoudnessNormalization(
+    int soundHash,
+    bool enabled,
+    double targetLufs,
+    double truePeakLimit,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> gain = calloc();
+    final e = _setLoudnessNormalization(
+        soundHash, enabled ? 1 : 0, targetLufs, truePeakLimit, gain);
+    final ret = (error: PlayerErrors.values[e], gain: gain.value);
+    calloc.free(gain);
+    return ret;
+  }
+
+  late final _setLoudnessNormalizationPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Int,
+            ffi.Float,
+            ffi.Float,
+            ffi.Pointer<ffi.Float>,
+          )>>('setLoudnessNormalization');
+  late final _setLoudnessNormalization =
+      _setLoudnessNormalizationPtr.asFunction<
+          int Function(int, int, double, double, ffi.Pointer<ffi.Float>)>();
+
+  /// Cut the silence of a sound loaded into memory and find its loop
+  ///
+  /// [trimSilence] whether to cut the frames below [thresholdDb]
+  /// Returns [PlayerErrors.noError] if success, the part kept in seconds of
+  /// the original sound and the loop in seconds of the trimmed one
+  ({
+    PlayerErrors error,
+    double start,
+    double end,
+    double loopStart,
+    double loopEnd,
+  }) trimSound(
+    int soundHash,
+    bool trimSilence,
+    double thresholdDb,
+    LoopSearch loopSearch,
+  ) {
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> start = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> end = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> loopStart = calloc();
+    // ignore: omit_local_variable_types
+    final ffi.Pointer<ffi.Float> loopEnd = calloc();
+    final e = _trimSound(soundHash, trimSilence ? 1 : 0, thresholdDb,
+        loopSearch.index, start, end, loopStart, loopEnd);
+    final ret = (
+      error: PlayerErrors.values[e],
+      start: start.value,
+      end: end.value,
+      loopStart: loopStart.value,
+      loopEnd: loopEnd.value,
+    );
+    calloc
+      ..free(start)
+      ..free(end)
+      ..free(loopStart)
+      ..free(loopEnd);
+    return ret;
+  }
+
+  late final _trimSoundPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int32 Function(
+            ffi.UnsignedInt,
+            ffi.Int,
+            ffi.Float,
+            ffi.Int,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+            ffi.Pointer<ffi.Float>,
+          )>>('trimSound');
+  late final _trimSound = _trimSoundPtr.asFunction<
+      int Function(
+        int,
+        int,
+        double,
+        int,
+        ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>,
+      )>();
+
   /// internal test. Does nothing now
   ///
   void test() {
@@ -0,0 +1,150 @@
+import 'dart:ffi' as ffi;
+import 'dart:typed_data';
+
+/// Layout version of the native status block this reader understands.
+const int _statusBlockVersion = 1;
+
+/// Size of the native `StatusHeader`.
+const int _headerSize = 104;
+
+/// Size of the native `StatusVoice`.
+const int _voiceSize = 32;
+
+/// The state of a voice in an [EngineStatus].
+final class VoiceStatus {
+  /// Constructs a new [VoiceStatus].
+  const VoiceStatus({
+    required this.handle,
+    required this.position,
+    required this.volume,
+    required this.pan,
+    required this.relativeSpeed,
+    required this.loopCount,
+    required this.paused,
+    required this.looping,
+  });
+
+  /// The voice handle.
+  final int handle;
+
+  /// The position in seconds.
+  final double position;
+
+  /// The volume set to the voice.
+  final double volume;
+
+  /// The pan set to the voice.
+  final double pan;
+
+  /// The relative play speed set to the voice.
+  final double relativeSpeed;
+
+  /// How many times the voice has looped.
+  final int loopCount;
+
+  /// Whether the voice is paused.
+  final bool paused;
+
+  /// Whether the voice is looping.
+  final bool looping;
+}
+
+/// The state of the engine after a mixed block.
+final class EngineStatus {
+  /// Constructs a new [EngineStatus].
+  const EngineStatus({
+    required this.engineTime,
+    required this.sampleRate,
+    required this.globalVolume,
+    required this.peak,
+    required this.rms,
+    required this.voices,
+  });
+
+  /// The engine time in samples at the end of the block.
+  final int engineTime;
+
+  /// The engine sample rate.
+  final int sampleRate;
+
+  /// The global volume.
+  final double globalVolume;
+
+  /// The peak of each output channel in the block.
+  final List<double> peak;
+
+  /// The RMS of each output channel in the block.
+  final List<double> rms;
+
+  /// The voices playing or paused, by handle.
+  final Map<int, VoiceStatus> voices;
+}
+
+/// Reads the engine state published by the audio thread after every
+/// mixed block, without FFI calls nor locks.
+///
+/// The memory is shared with the native side and protected by a seqlock:
+/// a read copies it and retries if the audio thread wrote meanwhile.
+final class EngineStatusReader {
+  /// Constructs a reader over the native status block at [data].
+  EngineStatusReader(ffi.Pointer<ffi.Uint8> data, int size)
+      : _data = ByteData.sublistView(data.asTypedList(size));
+
+  final ByteData _data;
+
+  /// Read the latest state.
+  ///
+  /// Returns null if the native layout is not the expected one or if the
+  /// block was being written during all the [attempts].
+  EngineStatus? read({int attempts = 8}) {
+    if (_data.getUint32(4, Endian.host) != _statusBlockVersion) return null;
+
+    for (var i = 0; i < attempts; i++) {
+      final sequence = _data.getUint32(0, Endian.host);
+      // never published or being written
+      if (sequence == 0 || sequence.isOdd) continue;
+
+      final status = _parse();
+      if (_data.getUint32(0, Endian.host) == sequence) return status;
+    }
+    return null;
+  }
+
+  EngineStatus _parse() {
+    final channels = _data.getUint32(20, Endian.host);
+    final voiceCount = _data.getUint32(24, Endian.host);
+    final voiceCapacity = _data.getUint32(28, Endian.host);
+    final peak = <double>[];
+    final rms = <double>[];
+    for (var ch = 0; ch < channels && ch < 8; ch++) {
+      peak.add(_data.getFloat32(40 + ch * 4, Endian.host));
+      rms.add(_data.getFloat32(72 + ch * 4, Endian.host));
+    }
+
+    final voices = <int, VoiceStatus>{};
+    for (var i = 0; i < voiceCount && i < voiceCapacity; i++) {
+      final offset = _headerSize + i * _voiceSize;
+      final handle = _data.getUint32(offset + 8, Endian.host);
+      final flags = _data.getUint32(offset + 12, Endian.host);
+      voices[handle] = VoiceStatus(
+        handle: handle,
+        position: _data.getFloat64(offset, Endian.host),
+        volume: _data.getFloat32(offset + 16, Endian.host),
+        pan: _data.getFloat32(offset + 20, Endian.host),
+        relativeSpeed: _data.getFloat32(offset + 24, Endian.host),
+        loopCount: _data.getUint32(offset + 28, Endian.host),
+        paused: flags & 1 != 0,
+        looping: flags & 2 != 0,
+      );
+    }
+
+    return EngineStatus(
+      engineTime: _data.getUint64(8, Endian.host),
+      sampleRate: _data.getUint32(16, Endian.host),
+      globalVolume: _data.getFloat32(32, Endian.host),
+      peak: peak,
+      rms: rms,
+      voices: voices,
+    );
+  }
+}
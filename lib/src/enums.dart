@@ -11,6 +11,118 @@ final class CaptureDevice {
   final bool isDefault;
 }
 
+/// A cell of a sequencer pattern, see [SoLoud.sequencerSetSteps].
+final class SequencerStep {
+  /// Constructs a new [SequencerStep].
+  const SequencerStep({
+    required this.track,
+    required this.step,
+    required this.soundHash,
+    this.volume = 1,
+    this.pan = 0,
+    this.pitch = 1,
+  });
+
+  /// Constructs a [SequencerStep] which empties the cell.
+  const SequencerStep.clear({required this.track, required this.step})
+      : soundHash = 0,
+        volume = 1,
+        pan = 0,
+        pitch = 1;
+
+  /// The pattern row.
+  final int track;
+
+  /// The step in the row.
+  final int step;
+
+  /// The hash of the sound to play, 0 for none.
+  final int soundHash;
+
+  /// The volume of the sound.
+  final double volume;
+
+  /// The pan of the sound, -1 left, 0 center, 1 right.
+  final double pan;
+
+  /// The relative play speed of the sound, 1 is the original pitch.
+  final double pitch;
+}
+
+/// When a [SamplerZone] plays.
+enum SamplerTrigger {
+  /// When the note starts.
+  attack,
+
+  /// When the note is released, ie for the noise of a piano damper.
+  release,
+}
+
+/// A sample of a sampler mapped to a range of keys and velocities, see
+/// [SoLoud.samplerAddZones].
+final class SamplerZone {
+  /// Constructs a new [SamplerZone].
+  const SamplerZone({
+    required this.soundHash,
+    this.loKey = 0,
+    this.hiKey = 127,
+    this.loVelocity = 0,
+    this.hiVelocity = 1,
+    this.rootKey = 60,
+    this.volume = 1,
+    this.pan = 0,
+    this.loop = false,
+    this.loopStart = 0,
+    this.release = 0,
+    this.trigger = SamplerTrigger.attack,
+    this.seqLength = 1,
+    this.seqPosition = 1,
+  });
+
+  /// The hash of the sound to play, loaded in memory.
+  final int soundHash;
+
+  /// The lowest MIDI key playing this zone.
+  final int loKey;
+
+  /// The highest MIDI key playing this zone.
+  final int hiKey;
+
+  /// The lowest velocity, from 0 to 1, playing this zone.
+  final double loVelocity;
+
+  /// The highest velocity, from 0 to 1, playing this zone.
+  final double hiVelocity;
+
+  /// The key which plays the sample at its original speed.
+  final double rootKey;
+
+  /// The volume of the sample, multiplied by the note velocity.
+  final double volume;
+
+  /// The pan of the sample, -1 left, 0 center, 1 right.
+  final double pan;
+
+  /// Whether to loop from [loopStart] to the end while the note is held.
+  final bool loop;
+
+  /// The loop start in seconds.
+  final double loopStart;
+
+  /// The fade out time in seconds after the note is released.
+  final double release;
+
+  /// When the zone plays.
+  final SamplerTrigger trigger;
+
+  /// Round robin: if greater than 1, the zone plays only on the
+  /// [seqPosition]th (from 1) of every [seqLength] notes of a key.
+  final int seqLength;
+
+  /// See [seqLength].
+  final int seqPosition;
+}
+
 /// Possible capture errors
 enum CaptureErrors {
   /// No error
@@ -205,3 +317,153 @@ enum LoadMode {
   /// More CPU, less memory allocated, seeking lags with MP3s.
   disk,
 }
+
+/// The sample format of the data pushed into a push stream.
+enum PushStreamFormat {
+  /// 32 bit float little endian samples in the [-1.0 ~ 1.0] range.
+  f32le,
+
+  /// 16 bit signed integer little endian samples.
+  s16le,
+}
+
+/// What a voice event scheduled with [SoLoud.scheduleVoiceEventAt] changes.
+enum ScheduledVoiceAction {
+  /// Stop the voice.
+  stop,
+
+  /// Pause the voice if the value is not 0, otherwise resume it.
+  pause,
+
+  /// Set the voice volume.
+  volume,
+
+  /// Set the voice pan.
+  pan,
+
+  /// Set the voice relative play speed.
+  relativeSpeed,
+
+  /// Seek the voice to the value in seconds.
+  seek,
+}
+
+/// The shape of an LFO created with [SoLoud.createModLfo].
+enum ModShape {
+  /// Sine wave.
+  sine,
+
+  /// Triangle wave.
+  triangle,
+
+  /// Square wave, 1 for the first half of the cycle.
+  square,
+
+  /// Ramp from -1 to 1.
+  sawUp,
+
+  /// Ramp from 1 to -1.
+  sawDown,
+}
+
+/// The parameter of a waveform sound changed by a modulation route.
+enum ModWaveformParam {
+  /// The frequency. The depth of the route is in semitones.
+  freq,
+
+  /// The superwave detune.
+  detune,
+
+  /// The superwave scale.
+  scale,
+}
+
+/// The window shaping each grain of a granular sound.
+enum GrainWindow {
+  /// Smooth raised cosine.
+  hann,
+
+  /// Bell curve, softer than [hann].
+  gaussian,
+
+  /// Flat with short fades, the grains sound more like the source.
+  trapezoid,
+}
+
+/// The voice stopped when a sound reaches its maximum number of
+/// instances, see [SoLoud.setInstanceLimit].
+enum StealPolicy {
+  /// the voice started first
+  oldest,
+
+  /// the voice with the lowest volume
+  quietest,
+
+  /// none: the new trigger is dropped
+  reject,
+}
+
+/// How a variation container picks the sound of each trigger, see
+/// [SoLoud.createVariationContainer].
+enum VariationMode {
+  /// a random sound, never the last one twice in a row
+  randomNoRepeat,
+
+  /// all the sounds in a random order, then again in another order
+  shuffle,
+
+  /// the sounds in the order given
+  sequential,
+}
+
+/// The glottal source of the speech synthesizer, see
+/// [SoLoud.setSpeechParams].
+enum SpeechWaveform {
+  saw,
+  triangle,
+  sin,
+  square,
+  pulse,
+  noise,
+  warble,
+}
+
+/// How a voice is stretched in time by [SoLoud.setTimeStretch].
+enum TimeStretchMode {
+  /// Overlap-add of slices of the sound lined up on their waveform. Best for
+  /// speech, cheap.
+  wsola,
+
+  /// Phase vocoder. Best for music, keeps chords in tune, about 4 times the
+  /// cost of [wsola].
+  phaseVocoder,
+}
+
+/// The window applied to each frame by [SoLoud.computeSpectrogram].
+enum SpectrogramWindow {
+  /// good all-round frequency resolution and leakage
+  hann,
+
+  /// a narrower main lobe than [hann], more distant leakage
+  hamming,
+
+  /// the lowest leakage, the widest main lobe
+  blackman,
+
+  /// no window: the sharpest peaks, the most leakage
+  rectangular,
+}
+
+/// How [SoLoud.loadFile] finds the loop of a sound.
+enum LoopSearch {
+  /// the loop is the whole sound
+  none,
+
+  /// the loop starts and ends on rising zero crossings, the closest to the
+  /// bounds. Cheap, enough for tonal sounds
+  zeroCrossing,
+
+  /// the loop ends where the sound best matches its start, within its last
+  /// 2 seconds. Best for noisy beds
+  correlation,
+}
@@ -0,0 +1,157 @@
+/// The waveform of an sfxr effect.
+enum SfxrWaveType {
+  square,
+  sawtooth,
+  sine,
+  noise,
+}
+
+/// The randomized effect templates of sfxr, see [SoLoud.loadSfxrPreset].
+enum SfxrPreset {
+  coin,
+  laser,
+  explosion,
+  powerUp,
+  hurt,
+  jump,
+  blip,
+}
+
+/// The parameters of an sfxr effect, see [SoLoud.loadSfxrParams].
+///
+/// They follow the sliders of the original sfxr tool: most range from 0 to
+/// 1, and the ramps, the phaser and the arpeggio modulation from -1 to 1.
+/// The defaults are those of a reset sfxr: a 0.57 seconds square beep.
+class SfxrParams {
+  ///
+  const SfxrParams({
+    this.waveType = SfxrWaveType.square,
+    this.baseFreq = 0.3,
+    this.freqLimit = 0,
+    this.freqRamp = 0,
+    this.freqDeltaRamp = 0,
+    this.duty = 0,
+    this.dutyRamp = 0,
+    this.vibratoStrength = 0,
+    this.vibratoSpeed = 0,
+    this.vibratoDelay = 0,
+    this.attack = 0,
+    this.sustain = 0.3,
+    this.decay = 0.4,
+    this.punch = 0,
+    this.lowPassResonance = 0,
+    this.lowPassFreq = 1,
+    this.lowPassRamp = 0,
+    this.highPassFreq = 0,
+    this.highPassRamp = 0,
+    this.phaserOffset = 0,
+    this.phaserRamp = 0,
+    this.repeatSpeed = 0,
+    this.arpeggioSpeed = 0,
+    this.arpeggioMod = 0,
+    this.volume = 0.5,
+  });
+
+  ///
+  final SfxrWaveType waveType;
+
+  /// start frequency
+  final double baseFreq;
+
+  /// the effect stops when the frequency falls below this
+  final double freqLimit;
+
+  /// frequency slide
+  final double freqRamp;
+
+  /// change of the frequency slide
+  final double freqDeltaRamp;
+
+  /// square wave duty cycle
+  final double duty;
+
+  /// change of the duty cycle
+  final double dutyRamp;
+
+  ///
+  final double vibratoStrength;
+
+  ///
+  final double vibratoSpeed;
+
+  ///
+  final double vibratoDelay;
+
+  /// envelope attack time
+  final double attack;
+
+  /// envelope sustain time
+  final double sustain;
+
+  /// envelope decay time
+  final double decay;
+
+  /// louder start of the sustain
+  final double punch;
+
+  ///
+  final double lowPassResonance;
+
+  /// low-pass cutoff, 1 is off
+  final double lowPassFreq;
+
+  ///
+  final double lowPassRamp;
+
+  /// high-pass cutoff, 0 is off
+  final double highPassFreq;
+
+  ///
+  final double highPassRamp;
+
+  ///
+  final double phaserOffset;
+
+  ///
+  final double phaserRamp;
+
+  /// restarts the effect, 0 is off
+  final double repeatSpeed;
+
+  /// when the frequency jumps, 0 is off
+  final double arpeggioSpeed;
+
+  /// the frequency jump
+  final double arpeggioMod;
+
+  ///
+  final double volume;
+
+  /// The values passed to the native side, in its order.
+  List<double> get values => [
+        baseFreq,
+        freqLimit,
+        freqRamp,
+        freqDeltaRamp,
+        duty,
+        dutyRamp,
+        vibratoStrength,
+        vibratoSpeed,
+        vibratoDelay,
+        attack,
+        sustain,
+        decay,
+        punch,
+        lowPassResonance,
+        lowPassFreq,
+        lowPassRamp,
+        highPassFreq,
+        highPassRamp,
+        phaserOffset,
+        phaserRamp,
+        repeatSpeed,
+        arpeggioSpeed,
+        arpeggioMod,
+        volume,
+      ];
+}
@@ -42,6 +42,14 @@ class SoundProps {
   /// the user can listen ie when a sound ends or key events (TODO)
   StreamController<StreamSoundEvent> soundEvents = StreamController.broadcast();
 
+  /// the part of the file kept by [SoLoud.loadFile], in seconds of the file.
+  /// null if the sound was not trimmed
+  ({double start, double end})? trimmed;
+
+  /// the loop found by [SoLoud.loadFile], in seconds of the loaded sound.
+  /// null if no loop was searched
+  ({double start, double end})? loop;
+
   @override
   String toString() {
     return 'soundHash: $soundHash has ${handle.length} active handles';
@@ -283,6 +291,36 @@ interface class SoLoud {
     return completer.future;
   }
 
+  /// The number of the next request of the loaders and analyses which can
+  /// be called again with equal args while waiting, see [_request].
+  int _nextRequest = 0;
+
+  /// Send the [args] of the [request] to the audio isolate, which owns the
+  /// native list of sounds, and wait for the result of [event]. The
+  /// isolate answers with the [request] number alone.
+  Future<dynamic> _request(MessageEvents event, int request, Record args) {
+    _mainToIsolateStream?.send({'event': event, 'args': args});
+    return _waitForEvent(event, (request: request));
+  }
+
+  /// Add the sound returned by a loader to [activeSounds], once since the
+  /// native caches can return a sound already loaded.
+  ({PlayerErrors error, SoundProps? sound}) _addLoadedSound(
+    Object? result,
+    String from,
+  ) {
+    final ret = result! as ({PlayerErrors error, SoundProps? sound});
+    _logPlayerError(ret.error, from: '$from() result');
+    final sound = ret.sound;
+    if (ret.error != PlayerErrors.noError || sound == null) {
+      return (error: ret.error, sound: null);
+    }
+    final cached = activeSounds.where((s) => s.soundHash == sound.soundHash);
+    if (cached.isNotEmpty) return (error: ret.error, sound: cached.first);
+    activeSounds.add(sound);
+    return (error: ret.error, sound: sound);
+  }
+
   /// Initializes the audio engine.
   ///
   /// Use [initialize] instead. This method is simply an alias for [initialize]
@@ -659,11 +697,20 @@ interface class SoLoud {
   /// from the given file when needed (more CPU, less memory allocated).
   /// See the [seek] note problem when using [LoadMode] = `LoadMode.disk`.
   /// Default is `LoadMode.memory`.
+  /// [trimSilenceDb] if not null, the frames quieter than this level in dB
+  /// at the start and the end of the sound are cut, keeping 5 ms around the
+  /// audible part.
+  /// [loopSearch] how to find a seamless loop. The data after the loop end
+  /// is dropped and the sound loops back to the loop start.
+  /// The trimming and the loop only apply to `LoadMode.memory`, their
+  /// bounds are reported in [SoundProps.trimmed] and [SoundProps.loop].
   /// Returns PlayerErrors.noError if success and a new sound.
   ///
   Future<({PlayerErrors error, SoundProps? sound})> loadFile(
     String completeFileName, {
     LoadMode mode = LoadMode.memory,
+    double? trimSilenceDb,
+    LoopSearch loopSearch = LoopSearch.none,
   }) async {
     if (!isInitialized) {
       _log.severe(() => 'loadFile(): ${PlayerErrors.engineNotInited}');
@@ -672,12 +719,22 @@ interface class SoLoud {
     _mainToIsolateStream?.send(
       {
         'event': MessageEvents.loadFile,
-        'args': (completeFileName: completeFileName, mode: mode),
+        'args': (
+          completeFileName: completeFileName,
+          mode: mode,
+          trimSilenceDb: trimSilenceDb,
+          loopSearch: loopSearch,
+        ),
       },
     );
     final ret = (await _waitForEvent(
       MessageEvents.loadFile,
-      (completeFileName: completeFileName, mode: mode),
+      (
+        completeFileName: completeFileName,
+        mode: mode,
+        trimSilenceDb: trimSilenceDb,
+        loopSearch: loopSearch,
+      ),
     )) as ({PlayerErrors error, SoundProps? sound});
     if (ret.error == PlayerErrors.noError) {
       activeSounds.add(ret.sound!);
@@ -829,271 +886,1209 @@ interface class SoLoud {
     return PlayerErrors.noError;
   }
 
-  /// Speech the given text
-  ///
-  /// [textToSpeech] the text to be spoken
-  /// Returns PlayerErrors.noError if success and a new sound
-  ///
-  Future<({PlayerErrors error, SoundProps sound})> speechText(
-    String textToSpeech,
-  ) async {
-    if (!isInitialized) {
-      _log.severe(() => 'speechText(): ${PlayerErrors.engineNotInited}');
-      return (error: PlayerErrors.engineNotInited, sound: SoundProps(-1));
-    }
-    _mainToIsolateStream?.send(
-      {
-        'event': MessageEvents.speechText,
-        'args': (textToSpeech: textToSpeech),
-      },
-    );
-    final ret = (await _waitForEvent(
-      MessageEvents.speechText,
-      (textToSpeech: textToSpeech),
-    )) as ({PlayerErrors error, SoundProps sound});
-    _logPlayerError(ret.error, from: 'speechText() result');
-    if (ret.error == PlayerErrors.noError) {
-      activeSounds.add(ret.sound);
-    }
-    return (error: ret.error, sound: activeSounds.last);
-  }
+  /// Bytes per interleaved frame of the push streams created, by sound hash.
+  final Map<int, int> _pushStreamFrameBytes = {};
 
-  /// Play already loaded sound identified by [sound]
-  ///
-  /// [sound] the sound to play
-  /// [volume] 1.0f full volume
-  /// [pan] 0.0f centered
-  /// [paused] 0 not pause
-  /// Returns PlayerErrors.noError if success, the new sound and
-  /// the new handle newHandle
+  /// Create a new sound which plays PCM data pushed from Dart, ie
+  /// generated audio or audio received from the network.
   ///
-  Future<({PlayerErrors error, SoundProps sound, int newHandle})> play(
-    SoundProps sound, {
-    double volume = 1,
-    double pan = 0,
-    bool paused = false,
+  /// The data is stored into a ring buffer of [bufferFrames] frames
+  /// allocated once. Writing into it doesn't allocate nor lock the
+  /// audio thread.
+  /// [sampleRate] and [channels] describe the data to be pushed.
+  /// [prebufferFrames] frames are buffered before the playback starts and
+  /// after every underrun, to absorb jitter of the producer.
+  /// Returns PlayerErrors.noError if success and a new sound.
+  Future<({PlayerErrors error, SoundProps? sound})> loadPushStream({
+    int sampleRate = 44100,
+    int channels = 2,
+    PushStreamFormat format = PushStreamFormat.f32le,
+    int bufferFrames = 44100,
+    int prebufferFrames = 0,
   }) async {
     if (!isInitialized) {
-      _log.severe(() => 'play(): ${PlayerErrors.engineNotInited}');
-      return (error: PlayerErrors.engineNotInited, sound: sound, newHandle: 0);
+      _log.severe(() => 'loadPushStream(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
     }
-    _mainToIsolateStream?.send(
-      {
-        'event': MessageEvents.play,
-        'args': (
-          soundHash: sound.soundHash,
-          volume: volume,
-          pan: pan,
-          paused: paused
+    final request = _nextRequest++;
+    final ret = _addLoadedSound(
+      await _request(
+        MessageEvents.loadPushStream,
+        request,
+        (
+          request: request,
+          sampleRate: sampleRate,
+          channels: channels,
+          format: format,
+          bufferFrames: bufferFrames,
+          prebufferFrames: prebufferFrames,
         ),
-      },
+      ),
+      'loadPushStream',
     );
-    final ret = (await _waitForEvent(
-      MessageEvents.play,
-      (soundHash: sound.soundHash, volume: volume, pan: pan, paused: paused),
-    )) as ({PlayerErrors error, int newHandle});
-    _logPlayerError(ret.error, from: 'play()');
-    if (ret.error != PlayerErrors.noError) {
-      return (error: ret.error, sound: sound, newHandle: 0);
+    if (ret.sound != null) {
+      _pushStreamFrameBytes[ret.sound!.soundHash] =
+          channels * (format == PushStreamFormat.f32le ? 4 : 2);
     }
+    return ret;
+  }
 
-    try {
-      /// add the new handle to the sound
-      activeSounds
-          .firstWhere((s) => s.soundHash == sound.soundHash)
-          .handle
-          .add(ret.newHandle);
-      sound.handle.add(ret.newHandle);
-    } catch (e) {
-      _log.severe('play(): soundHash ${sound.soundHash} not found', e);
-      return (
-        error: PlayerErrors.soundHashNotFound,
-        sound: sound,
-        newHandle: 0
-      );
+  /// Get a view of the free space of the push stream ring buffer.
+  ///
+  /// Write interleaved frames directly into [bytes] and then call
+  /// [pushStreamCommit] with the number of frames written. No copies
+  /// are made between Dart and the audio thread.
+  /// [frames] is the number of frames which fit into [bytes].
+  ({Uint8List bytes, int frames}) pushStreamWriteSpan(SoundProps sound) {
+    final frameBytes = _pushStreamFrameBytes[sound.soundHash];
+    if (!isInitialized || frameBytes == null) {
+      return (bytes: Uint8List(0), frames: 0);
+    }
+    final span =
+        SoLoudController().soLoudFFI.pushStreamGetWriteSpan(sound.soundHash);
+    if (span.frames == 0) {
+      return (bytes: Uint8List(0), frames: 0);
     }
     return (
-      error: PlayerErrors.noError,
-      sound: sound,
-      newHandle: ret.newHandle
+      bytes: span.data.cast<ffi.Uint8>().asTypedList(span.frames * frameBytes),
+      frames: span.frames,
     );
   }
 
-  /// Pause or unpause already loaded sound identified by [handle]
-  ///
-  /// [handle] the sound handle
-  /// Returns [PlayerErrors.noError] if success
+  /// Make [frames] frames written into [pushStreamWriteSpan] playable.
   ///
-  PlayerErrors pauseSwitch(int handle) {
+  /// Returns the number of frames committed.
+  int pushStreamCommit(SoundProps sound, int frames) {
+    if (!isInitialized) return 0;
+    return SoLoudController()
+        .soLoudFFI
+        .pushStreamCommit(sound.soundHash, frames);
+  }
+
+  /// Copy interleaved [data] into the push stream. [data] must be a
+  /// [Float32List] or an [Int16List] matching the format given to
+  /// [loadPushStream].
+  ///
+  /// Returns the number of frames written. This is less than the frames
+  /// in [data] when the ring buffer is full.
+  int pushStreamWrite(SoundProps sound, TypedData data) {
+    final frameBytes = _pushStreamFrameBytes[sound.soundHash];
+    if (!isInitialized || frameBytes == null) return 0;
+    final src = data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
+    final totalFrames = src.length ~/ frameBytes;
+    var written = 0;
+    // the free space can be split in two spans when the ring wraps
+    while (written < totalFrames) {
+      final span = pushStreamWriteSpan(sound);
+      if (span.frames == 0) break;
+      final n = span.frames < totalFrames - written
+          ? span.frames
+          : totalFrames - written;
+      span.bytes.setRange(
+        0,
+        n * frameBytes,
+        src,
+        written * frameBytes,
+      );
+      written += pushStreamCommit(sound, n);
+    }
+    return written;
+  }
+
+  /// Signal that no more data will be pushed into [sound]. Its voices
+  /// end when all the buffered data has been played.
+  PlayerErrors pushStreamEnd(SoundProps sound) {
     if (!isInitialized) {
-      _log.severe(() => 'pauseSwitch(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'pushStreamEnd(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    SoLoudController().soLoudFFI.pauseSwitch(handle);
-    return PlayerErrors.noError;
+    final ret = SoLoudController().soLoudFFI.pushStreamEnd(sound.soundHash);
+    _logPlayerError(ret, from: 'pushStreamEnd() result');
+    return ret;
   }
 
-  /// Pause or unpause already loaded sound identified by [handle]
-  ///
-  /// [handle] the sound handle
-  /// Returns [PlayerErrors.noError] if success
-  ///
-  PlayerErrors setPause(int handle, bool pause) {
+  /// Change the frames to buffer before starting the playback and after
+  /// every underrun.
+  PlayerErrors pushStreamSetPrebuffer(SoundProps sound, int frames) {
     if (!isInitialized) {
-      _log.severe(() => 'setPause(): ${PlayerErrors.engineNotInited}');
+      _log.severe(
+          () => 'pushStreamSetPrebuffer(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    SoLoudController().soLoudFFI.setPause(handle, pause ? 1 : 0);
-    return PlayerErrors.noError;
+    final ret = SoLoudController()
+        .soLoudFFI
+        .pushStreamSetPrebuffer(sound.soundHash, frames);
+    _logPlayerError(ret, from: 'pushStreamSetPrebuffer() result');
+    return ret;
   }
 
-  /// Gets the pause state
-  ///
-  /// [handle] the sound handle
-  /// Return [PlayerErrors.noError] on success and true if paused
+  /// Get the buffered frames, the ring buffer capacity, how many times
+  /// the playback ran out of data and how many frames of silence were
+  /// played because of that.
+  ({
+    PlayerErrors error,
+    int bufferedFrames,
+    int capacityFrames,
+    int underruns,
+    int silentFrames,
+  }) getPushStreamInfo(SoundProps sound) {
+    return SoLoudController().soLoudFFI.getPushStreamInfo(sound.soundHash);
+  }
+
+  /// Create a new empty playlist. Its items are played back to back
+  /// without gaps, or overlapped with an equal-power crossfade.
   ///
-  ({PlayerErrors error, bool pause}) getPause(int handle) {
+  /// While an item plays, the next one is opened and its beginning is
+  /// decoded on a background thread, so transitions don't stall the
+  /// audio. Items are converted to [sampleRate] and [channels].
+  /// Only one voice of a playlist can play at a time.
+  /// Returns PlayerErrors.noError if success and a new sound.
+  Future<({PlayerErrors error, SoundProps? sound})> loadPlaylist({
+    int sampleRate = 44100,
+    int channels = 2,
+  }) async {
     if (!isInitialized) {
-      _log.severe(() => 'getPause(): ${PlayerErrors.engineNotInited}');
-      return (error: PlayerErrors.engineNotInited, pause: false);
+      _log.severe(() => 'loadPlaylist(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
     }
-    final ret = SoLoudController().soLoudFFI.getPause(handle);
-    return (error: PlayerErrors.noError, pause: ret);
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadPlaylist,
+        request,
+        (request: request, sampleRate: sampleRate, channels: channels),
+      ),
+      'loadPlaylist',
+    );
   }
 
-  /// Set a sound's relative play speed.
-  /// Setting the value to 0 will cause undefined behavior, likely a crash.
-  /// Change the relative play speed of a sample. This changes the effective
-  /// sample rate while leaving the base sample rate alone.
-  ///
-  /// Note that playing a sound at a higher sample rate will require SoLoud
-  /// to request more samples from the sound source, which will require more
-  /// memory and more processing power. Playing at a slower sample
-  /// rate is cheaper.
+  /// Append the file at [completeFileName] to the [playlist].
   ///
-  /// [handle] the sound handle
-  /// [speed] the new speed
-  PlayerErrors setRelativePlaySpeed(int handle, double speed) {
+  /// Files which can't be opened are skipped when their turn comes.
+  /// Returns the index of the new item or -1 if [playlist] is not a playlist.
+  int playlistAddItem(SoundProps playlist, String completeFileName) {
     if (!isInitialized) {
-      _log.severe(
-          () => 'setRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
-      return PlayerErrors.engineNotInited;
+      _log.severe(() => 'playlistAddItem(): ${PlayerErrors.engineNotInited}');
+      return -1;
     }
-    SoLoudController().soLoudFFI.setRelativePlaySpeed(handle, speed);
-    return PlayerErrors.noError;
+    return SoLoudController()
+        .soLoudFFI
+        .playlistAddItem(playlist.soundHash, completeFileName);
   }
 
-  /// Return the current play speed.
+  /// Remove all the items of [playlist].
   ///
-  /// [handle] the sound handle
-  ({PlayerErrors error, double speed}) getRelativePlaySpeed(int handle) {
+  /// The item playing goes on to its end, the next one already opened is
+  /// dropped and the items added afterwards play from the first one added.
+  PlayerErrors playlistClear(SoundProps playlist) {
     if (!isInitialized) {
-      _log.severe(
-          () => 'getRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
-      return (error: PlayerErrors.engineNotInited, speed: 1);
+      _log.severe(() => 'playlistClear(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.getRelativePlaySpeed(handle);
-    return (error: PlayerErrors.noError, speed: ret);
+    final ret = SoLoudController().soLoudFFI.playlistClear(playlist.soundHash);
+    _logPlayerError(ret, from: 'playlistClear() result');
+    return ret;
   }
 
-  /// Stop already loaded sound identified by [handle] and clear it from the
-  /// sound handle list
-  ///
-  /// [handle] the sound handle to stop
-  /// Return [PlayerErrors.noError] on success
+  /// Set the crossfade between the items of [playlist].
   ///
-  Future<PlayerErrors> stop(int handle) async {
+  /// A zero [duration] splices the items without gaps.
+  PlayerErrors playlistSetCrossfade(SoundProps playlist, Duration duration) {
     if (!isInitialized) {
-      _log.severe(() => 'stop(): ${PlayerErrors.engineNotInited}');
+      _log.severe(
+          () => 'playlistSetCrossfade(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    _mainToIsolateStream?.send(
-      {
-        'event': MessageEvents.stop,
-        'args': (handle: handle),
-      },
-    );
-    await _waitForEvent(MessageEvents.stop, (handle: handle));
+    final ret = SoLoudController().soLoudFFI.playlistSetCrossfade(
+          playlist.soundHash,
+          duration.inMicroseconds / Duration.microsecondsPerSecond,
+        );
+    _logPlayerError(ret, from: 'playlistSetCrossfade() result');
+    return ret;
+  }
 
-    /// find a sound with this handle and remove that handle from the list
-    for (final sound in activeSounds) {
-      sound.handle.removeWhere((element) => element == handle);
+  /// Restart [playlist] from its first item after the last one.
+  PlayerErrors playlistSetLoop(SoundProps playlist, bool loop) {
+    if (!isInitialized) {
+      _log.severe(() => 'playlistSetLoop(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
     }
-    return PlayerErrors.noError;
+    final ret = SoLoudController()
+        .soLoudFFI
+        .playlistSetLoop(playlist.soundHash, loop);
+    _logPlayerError(ret, from: 'playlistSetLoop() result');
+    return ret;
   }
 
-  /// Stop all handles of the already loaded sound identified
-  /// by soundHash of [sound] and dispose it
-  ///
-  /// [sound] the sound to clear
-  /// Return [PlayerErrors.noError] on success
-  ///
-  Future<PlayerErrors> disposeSound(SoundProps sound) async {
+  /// Jump to the next item of [playlist].
+  PlayerErrors playlistSkip(SoundProps playlist) {
     if (!isInitialized) {
-      _log.severe(() => 'disposeSound(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'playlistSkip(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    _mainToIsolateStream?.send(
-      {
-        'event': MessageEvents.disposeSound,
-        'args': (soundHash: sound.soundHash),
-      },
-    );
-    await _waitForEvent(
-        MessageEvents.disposeSound, (soundHash: sound.soundHash));
+    final ret = SoLoudController().soLoudFFI.playlistSkip(playlist.soundHash);
+    _logPlayerError(ret, from: 'playlistSkip() result');
+    return ret;
+  }
 
-    /// remove the sound with [soundHash]
-    activeSounds.removeWhere(
-      (element) {
-        return element.soundHash == sound.soundHash;
-      },
-    );
-    return PlayerErrors.noError;
+  /// Get the index of the [playlist] item currently playing or -1.
+  int playlistGetCurrentIndex(SoundProps playlist) {
+    if (!isInitialized) return -1;
+    return SoLoudController()
+        .soLoudFFI
+        .playlistGetCurrentIndex(playlist.soundHash);
   }
 
-  /// Disposes all sounds already loaded. Complete silence.
-  ///
-  /// No need to call this method when shutting down the engine.
-  /// (It is automatically called from within [shutdown].)
-  ///
-  /// Return [PlayerErrors.noError] on success
+  /// Create a polyphonic instrument playing [waveform].
   ///
-  Future<PlayerErrors> disposeAllSound() async {
-    if (!_isEngineInitialized) {
-      _log.severe(() => 'disposeAllSound(): ${PlayerErrors.engineNotInited}');
-      return PlayerErrors.engineNotInited;
+  /// Play the returned sound once, then start and release notes with
+  /// [polySynthNoteOn] and [polySynthNoteOff]: each note has its own
+  /// oscillator, envelope and glide, and costs one call. When more than
+  /// [maxVoices] notes are held, the oldest one is stolen.
+  /// Playing it again restarts it, and the notes sent while it is not
+  /// playing are ignored.
+  Future<({PlayerErrors error, SoundProps? sound})> loadPolySynth({
+    WaveForm waveform = WaveForm.sin,
+    int maxVoices = 16,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadPolySynth(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
     }
-    _mainToIsolateStream?.send(
-      {
-        'event': MessageEvents.disposeAllSound,
-        'args': (),
-      },
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadPolySynth,
+        request,
+        (request: request, waveform: waveform, maxVoices: maxVoices),
+      ),
+      'loadPolySynth',
     );
-    await _waitForEvent(MessageEvents.disposeAllSound, ());
-
-    /// remove the sound with [soundHash]
-    activeSounds.clear();
-    return PlayerErrors.noError;
   }
 
-  /// This function can be used to set a sample to play on repeat,
-  /// instead of just playing once
-  ///
-  /// [handle] the handle for which enable or disable the loop
-  /// [enable]
-  /// Return [PlayerErrors.noError] on success
+  /// Start [note] on the polyphonic instrument [synth].
   ///
-  PlayerErrors setLooping(int handle, bool enable) {
+  /// [note] is a MIDI note number (60 is middle C), it can be fractional
+  /// and identifies the note for [polySynthNoteOff].
+  /// [velocity] from 0 to 1.
+  /// [glide] if > 0, seconds to glide from the pitch of the previous note.
+  PlayerErrors polySynthNoteOn(
+    SoundProps synth,
+    double note, {
+    double velocity = 1,
+    double glide = 0,
+  }) {
     if (!isInitialized) {
-      _log.severe(() => 'setLooping(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'polySynthNoteOn(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    SoLoudController().soLoudFFI.setLooping(handle, enable);
-    return PlayerErrors.noError;
+    final ret = SoLoudController()
+        .soLoudFFI
+        .polySynthNoteOn(synth.soundHash, note, velocity, glide);
+    _logPlayerError(ret, from: 'polySynthNoteOn() result');
+    return ret;
   }
 
-  /// Enable or disable visualization.
-  /// When enabled it will be possible to get FFT and wave data.
+  /// Release [note] on the polyphonic instrument [synth].
+  PlayerErrors polySynthNoteOff(SoundProps synth, double note) {
+    if (!isInitialized) {
+      _log.severe(() => 'polySynthNoteOff(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.polySynthNoteOff(synth.soundHash, note);
+    _logPlayerError(ret, from: 'polySynthNoteOff() result');
+    return ret;
+  }
+
+  /// Glide the playing [note] of [synth] to [pitch] in [glide] seconds.
+  /// The note keeps its identity for [polySynthNoteOff].
+  PlayerErrors polySynthSetNotePitch(
+    SoundProps synth,
+    double note,
+    double pitch, {
+    double glide = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'polySynthSetNotePitch(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .polySynthSetNotePitch(synth.soundHash, note, pitch, glide);
+    _logPlayerError(ret, from: 'polySynthSetNotePitch() result');
+    return ret;
+  }
+
+  /// Release all the notes of [synth].
+  PlayerErrors polySynthAllNotesOff(SoundProps synth) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'polySynthAllNotesOff(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.polySynthAllNotesOff(synth.soundHash);
+    _logPlayerError(ret, from: 'polySynthAllNotesOff() result');
+    return ret;
+  }
+
+  /// Set the waveform of all the notes of [synth].
+  PlayerErrors polySynthSetWaveform(SoundProps synth, WaveForm waveform) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'polySynthSetWaveform(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .polySynthSetWaveform(synth.soundHash, waveform);
+    _logPlayerError(ret, from: 'polySynthSetWaveform() result');
+    return ret;
+  }
+
+  /// Set the envelope of the notes of [synth]: [attack], [decay] and
+  /// [release] in seconds and the [sustain] level from 0 to 1.
+  PlayerErrors polySynthSetADSR(
+    SoundProps synth, {
+    double attack = 0.01,
+    double decay = 0.1,
+    double sustain = 0.7,
+    double release = 0.3,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'polySynthSetADSR(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .polySynthSetADSR(synth.soundHash, attack, decay, sustain, release);
+    _logPlayerError(ret, from: 'polySynthSetADSR() result');
+    return ret;
+  }
+
+  /// Create a polyphonic FM instrument of 4 or 6 sine [operators].
+  ///
+  /// Its notes are played with [polySynthNoteOn], [polySynthNoteOff] and
+  /// [polySynthSetNotePitch]. By default it plays a sine with algorithm 0:
+  /// give the modulators a level with [fmSynthSetOperator].
+  Future<({PlayerErrors error, SoundProps? sound})> loadFmSynth({
+    int operators = 4,
+    int maxVoices = 16,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadFmSynth(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadFmSynth,
+        request,
+        (request: request, operators: operators, maxVoices: maxVoices),
+      ),
+      'loadFmSynth',
+    );
+  }
+
+  /// Use one of the 8 preset [algorithm]s of [synth].
+  ///
+  /// With 4 operators, where "3 > 2" means that operator 3 modulates
+  /// operator 2 and operator 0 is always a carrier:
+  /// 0: 3 > 2 > 1 > 0, 1: 3 + 2 > 1 > 0, 2: 3 + (2 > 1) > 0,
+  /// 3: (3 > 2) + 1 > 0, 4: 3 > 2 and 1 > 0, 5: 3 > (2 + 1 + 0),
+  /// 6: 3 > 2 plus 1 and 0, 7: all carriers.
+  /// With 6 operators:
+  /// 0: 5 > 4 > 3 > 2 > 1 > 0, 1: 5 > 4 > 3 > 2 and 1 > 0,
+  /// 2: 5 > 4 > 3 and 2 > 1 > 0, 3: 5 > 4, 3 > 2 and 1 > 0,
+  /// 4: 5 > (4 + 3 + 2 + 1 + 0), 5: 5 + 4 + 3 + 2 + 1 > 0,
+  /// 6: 5 > 4, 3 > 2 plus 1 and 0, 7: all carriers.
+  PlayerErrors fmSynthSetAlgorithm(SoundProps synth, int algorithm) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'fmSynthSetAlgorithm(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .fmSynthSetAlgorithm(synth.soundHash, algorithm);
+    _logPlayerError(ret, from: 'fmSynthSetAlgorithm() result');
+    return ret;
+  }
+
+  /// Set a custom algorithm of [synth].
+  ///
+  /// [modulators] has one bit mask per operator, with the bits of the
+  /// operators modulating it: only operators with a higher index can
+  /// modulate an operator. [carriers] is the bit mask of the operators
+  /// heard.
+  PlayerErrors fmSynthSetRouting(
+    SoundProps synth,
+    List<int> modulators,
+    int carriers,
+  ) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'fmSynthSetRouting(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .fmSynthSetRouting(synth.soundHash, modulators, carriers);
+    _logPlayerError(ret, from: 'fmSynthSetRouting() result');
+    return ret;
+  }
+
+  /// Set the operator [op] of [synth].
+  ///
+  /// [ratio] is its frequency ratio to the note and [detune] a fixed
+  /// offset in Hz. [level] is the amplitude of a carrier or the modulation
+  /// index, in cycles, of a modulator. [feedback] from 0 to 1 makes the
+  /// operator modulate itself.
+  PlayerErrors fmSynthSetOperator(
+    SoundProps synth,
+    int op, {
+    double ratio = 1,
+    double detune = 0,
+    double level = 1,
+    double feedback = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'fmSynthSetOperator(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.fmSynthSetOperator(
+        synth.soundHash, op, ratio, detune, level, feedback);
+    _logPlayerError(ret, from: 'fmSynthSetOperator() result');
+    return ret;
+  }
+
+  /// Set the envelope of the operator [op] of [synth]: [attack], [decay]
+  /// and [release] in seconds and the [sustain] level from 0 to 1.
+  PlayerErrors fmSynthSetOperatorEnvelope(
+    SoundProps synth,
+    int op, {
+    double attack = 0.005,
+    double decay = 0.2,
+    double sustain = 0.7,
+    double release = 0.3,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() =>
+          'fmSynthSetOperatorEnvelope(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.fmSynthSetOperatorEnvelope(
+        synth.soundHash, op, attack, decay, sustain, release);
+    _logPlayerError(ret, from: 'fmSynthSetOperatorEnvelope() result');
+    return ret;
+  }
+
+  /// Get how many notes of [synth] are sounding, releasing ones included.
+  int polySynthGetActiveVoices(SoundProps synth) {
+    if (!isInitialized) return 0;
+    final ret =
+        SoLoudController().soLoudFFI.polySynthGetActiveVoices(synth.soundHash);
+    return ret < 0 ? 0 : ret;
+  }
+
+  /// Create a granular synthesis sound from [sound], which must be loaded
+  /// with [LoadMode.memory].
+  ///
+  /// Once played it starts short windowed grains of [sound] until
+  /// stopped: see [granularSetDensity], [granularSetPosition],
+  /// [granularSetSpray], [granularSetPitch], [granularSetSize] and
+  /// [granularSetWindow]. It goes silent if [sound] is disposed.
+  Future<({PlayerErrors error, SoundProps? sound})> loadGranular(
+    SoundProps sound,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadGranular(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadGranular,
+        request,
+        (request: request, soundHash: sound.soundHash),
+      ),
+      'loadGranular',
+    );
+  }
+
+  /// Create a variation container: a sound which, each time it is played
+  /// with [play] or [play3d], plays one of [sounds] picked by [mode] with
+  /// a random pitch from [minPitch] to [maxPitch] semitones and a volume
+  /// multiplied by a random value from [minVolume] to [maxVolume].
+  ///
+  /// The selection is done natively, so a footstep or an impact with
+  /// variants costs a single [play] call. The handles returned are those
+  /// of the picked sounds. Disposing a sound removes it from the
+  /// containers, disposing the container leaves [sounds] loaded.
+  Future<({PlayerErrors error, SoundProps? sound})> createVariationContainer(
+    List<SoundProps> sounds, {
+    VariationMode mode = VariationMode.randomNoRepeat,
+    double minPitch = 0,
+    double maxPitch = 0,
+    double minVolume = 1,
+    double maxVolume = 1,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'createVariationContainer(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    final ret = _addLoadedSound(
+      await _request(
+        MessageEvents.createVariationContainer,
+        request,
+        (
+          request: request,
+          soundHashes: sounds.map((s) => s.soundHash).toList(),
+          mode: mode,
+        ),
+      ),
+      'createVariationContainer',
+    );
+    final container = ret.sound;
+    if (container == null) return ret;
+    setVariationRandomization(
+      container,
+      minPitch: minPitch,
+      maxPitch: maxPitch,
+      minVolume: minVolume,
+      maxVolume: maxVolume,
+    );
+    return (error: ret.error, sound: container);
+  }
+
+  /// Set the random pitch and volume ranges of the triggers of a
+  /// variation [container], see [createVariationContainer].
+  PlayerErrors setVariationRandomization(
+    SoundProps container, {
+    double minPitch = 0,
+    double maxPitch = 0,
+    double minVolume = 1,
+    double maxVolume = 1,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() =>
+          'setVariationRandomization(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.variationSetRandomization(
+        container.soundHash, minPitch, maxPitch, minVolume, maxVolume);
+    _logPlayerError(ret, from: 'setVariationRandomization() result');
+    return ret;
+  }
+
+  /// Render an sfxr [preset] to a sound, randomized by [seed]: the same
+  /// seed gives the same effect, so random `jump` or `coin` variations can
+  /// be made at runtime with `Random().nextInt()`.
+  ///
+  /// The effect is rendered to PCM on a worker thread, so playing it only
+  /// copies samples on the audio thread. It takes about a millisecond;
+  /// playing the sound before that starts it as soon as it is ready.
+  /// Effects are cached by their parameters: loading equal parameters
+  /// again returns the same sound until it is disposed.
+  Future<({PlayerErrors error, SoundProps? sound})> loadSfxrPreset(
+    SfxrPreset preset, {
+    int seed = 0,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadSfxrPreset(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadSfxrPreset,
+        request,
+        (request: request, preset: preset, seed: seed),
+      ),
+      'loadSfxrPreset',
+    );
+  }
+
+  /// Render an sfxr effect described by [params] to a sound, see
+  /// [loadSfxrPreset].
+  Future<({PlayerErrors error, SoundProps? sound})> loadSfxrParams(
+    SfxrParams params,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadSfxrParams(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadSfxrParams,
+        request,
+        (request: request, params: params),
+      ),
+      'loadSfxrParams',
+    );
+  }
+
+  /// Render the effect saved by the sfxr tool in a .sfs file to a sound,
+  /// see [loadSfxrPreset].
+  Future<({PlayerErrors error, SoundProps? sound})> loadSfxrFile(
+    Uint8List bytes,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'loadSfxrFile(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.loadSfxrFile,
+        request,
+        (request: request, bytes: bytes),
+      ),
+      'loadSfxrFile',
+    );
+  }
+
+  /// Set how many grains of [granular] start per second, 20 by default.
+  PlayerErrors granularSetDensity(SoundProps granular, double density) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'granularSetDensity(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetDensity(granular.soundHash, density);
+    _logPlayerError(ret, from: 'granularSetDensity() result');
+    return ret;
+  }
+
+  /// Set where the grains of [granular] are read, from 0 (start) to 1
+  /// (end).
+  PlayerErrors granularSetPosition(SoundProps granular, double position) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'granularSetPosition(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetPosition(granular.soundHash, position);
+    _logPlayerError(ret, from: 'granularSetPosition() result');
+    return ret;
+  }
+
+  /// Scatter the grains of [granular] up to [spray] seconds around the
+  /// position.
+  PlayerErrors granularSetSpray(SoundProps granular, double spray) {
+    if (!isInitialized) {
+      _log.severe(() => 'granularSetSpray(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetSpray(granular.soundHash, spray);
+    _logPlayerError(ret, from: 'granularSetSpray() result');
+    return ret;
+  }
+
+  /// Transpose the grains of [granular] by [pitch] semitones, plus a
+  /// random amount up to [pitchSpray] semitones for each grain.
+  PlayerErrors granularSetPitch(
+    SoundProps granular,
+    double pitch, {
+    double pitchSpray = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'granularSetPitch(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetPitch(granular.soundHash, pitch, pitchSpray);
+    _logPlayerError(ret, from: 'granularSetPitch() result');
+    return ret;
+  }
+
+  /// Set the length of the grains of [granular] in seconds, 0.1 by
+  /// default. The level is kept even when the grains overlap.
+  PlayerErrors granularSetSize(SoundProps granular, double size) {
+    if (!isInitialized) {
+      _log.severe(() => 'granularSetSize(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetSize(granular.soundHash, size);
+    _logPlayerError(ret, from: 'granularSetSize() result');
+    return ret;
+  }
+
+  /// Set the window shaping the grains of [granular].
+  PlayerErrors granularSetWindow(SoundProps granular, GrainWindow window) {
+    if (!isInitialized) {
+      _log.severe(() => 'granularSetWindow(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .granularSetWindow(granular.soundHash, window);
+    _logPlayerError(ret, from: 'granularSetWindow() result');
+    return ret;
+  }
+
+  /// Speech the given text
+  ///
+  /// [textToSpeech] the text to be spoken
+  /// Returns PlayerErrors.noError if success and a new sound
+  ///
+  Future<({PlayerErrors error, SoundProps sound})> speechText(
+    String textToSpeech,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'speechText(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: SoundProps(-1));
+    }
+    _mainToIsolateStream?.send(
+      {
+        'event': MessageEvents.speechText,
+        'args': (textToSpeech: textToSpeech),
+      },
+    );
+    final ret = (await _waitForEvent(
+      MessageEvents.speechText,
+      (textToSpeech: textToSpeech),
+    )) as ({PlayerErrors error, SoundProps sound});
+    _logPlayerError(ret.error, from: 'speechText() result');
+    if (ret.error == PlayerErrors.noError) {
+      activeSounds.add(ret.sound);
+    }
+    return (error: ret.error, sound: activeSounds.last);
+  }
+
+  /// Speak [text] as a new sound. Unlike [speechText], the utterances can
+  /// overlap, and the text is converted phrase by phrase off the calling
+  /// thread: the first phrase starts playing within milliseconds, while
+  /// the next ones are converted.
+  ///
+  /// If [text] was cached by [cacheSpeech] with the same parameters, the
+  /// cached sound is played instead.
+  ///
+  /// Returns the sound, to dispose when it is not needed anymore, and the
+  /// voice speaking.
+  Future<({PlayerErrors error, SoundProps? sound, int handle})> speak(
+    String text,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'speak(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null, handle: 0);
+    }
+    final request = _nextRequest++;
+    final result = (await _request(
+      MessageEvents.speak,
+      request,
+      (request: request, text: text),
+    )) as ({PlayerErrors error, SoundProps? sound, int handle});
+    final ret = _addLoadedSound(
+      (error: result.error, sound: result.sound),
+      'speak',
+    );
+    if (ret.sound == null) {
+      return (error: ret.error, sound: null, handle: 0);
+    }
+    ret.sound!.handle.add(result.handle);
+    return (error: ret.error, sound: ret.sound, handle: result.handle);
+  }
+
+  /// Set the voice of the utterances started next by [speak] and
+  /// [cacheSpeech].
+  ///
+  /// [baseFrequency] base pitch, 1330 by default
+  /// [baseSpeed] 10 by default
+  /// [baseDeclination] how much the pitch falls along a phrase, 0.5 by
+  /// default
+  /// [synthesizeAtEngineRate] synthesize at the sample rate of the engine
+  /// instead of 11025 Hz, skipping the resampling: a brighter voice for
+  /// about 4 times the synthesis work.
+  PlayerErrors setSpeechParams({
+    int baseFrequency = 1330,
+    double baseSpeed = 10,
+    double baseDeclination = 0.5,
+    SpeechWaveform baseWaveform = SpeechWaveform.square,
+    bool synthesizeAtEngineRate = false,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'setSpeechParams(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.speechSetParams(
+          baseFrequency,
+          baseSpeed,
+          baseDeclination,
+          baseWaveform,
+          synthesizeAtEngineRate,
+        );
+    return PlayerErrors.noError;
+  }
+
+  /// Synthesize [text] now with the current parameters and keep it as a
+  /// sound, which [speak] plays instead of synthesizing the same text
+  /// again. Useful for the common phrases of an app. Disposing the sound
+  /// removes it from the cache.
+  Future<({PlayerErrors error, SoundProps? sound})> cacheSpeech(
+    String text,
+  ) async {
+    if (!isInitialized) {
+      _log.severe(() => 'cacheSpeech(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: null);
+    }
+    final request = _nextRequest++;
+    return _addLoadedSound(
+      await _request(
+        MessageEvents.cacheSpeech,
+        request,
+        (request: request, text: text),
+      ),
+      'cacheSpeech',
+    );
+  }
+
+  /// Play already loaded sound identified by [sound]
+  ///
+  /// [sound] the sound to play
+  /// [volume] 1.0f full volume
+  /// [pan] 0.0f centered
+  /// [paused] 0 not pause
+  /// Returns PlayerErrors.noError if success, the new sound and
+  /// the new handle newHandle
+  ///
+  Future<({PlayerErrors error, SoundProps sound, int newHandle})> play(
+    SoundProps sound, {
+    double volume = 1,
+    double pan = 0,
+    bool paused = false,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(() => 'play(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, sound: sound, newHandle: 0);
+    }
+    _mainToIsolateStream?.send(
+      {
+        'event': MessageEvents.play,
+        'args': (
+          soundHash: sound.soundHash,
+          volume: volume,
+          pan: pan,
+          paused: paused
+        ),
+      },
+    );
+    final ret = (await _waitForEvent(
+      MessageEvents.play,
+      (soundHash: sound.soundHash, volume: volume, pan: pan, paused: paused),
+    )) as ({PlayerErrors error, int newHandle});
+    _logPlayerError(ret.error, from: 'play()');
+    if (ret.error != PlayerErrors.noError) {
+      return (error: ret.error, sound: sound, newHandle: 0);
+    }
+    // dropped by the instance limit, see [setInstanceLimit]
+    if (ret.newHandle == 0) {
+      return (error: PlayerErrors.noError, sound: sound, newHandle: 0);
+    }
+
+    try {
+      /// add the new handle to the sound
+      activeSounds
+          .firstWhere((s) => s.soundHash == sound.soundHash)
+          .handle
+          .add(ret.newHandle);
+      sound.handle.add(ret.newHandle);
+    } catch (e) {
+      _log.severe('play(): soundHash ${sound.soundHash} not found', e);
+      return (
+        error: PlayerErrors.soundHashNotFound,
+        sound: sound,
+        newHandle: 0
+      );
+    }
+    return (
+      error: PlayerErrors.noError,
+      sound: sound,
+      newHandle: ret.newHandle
+    );
+  }
+
+  /// Limit the voices of [sound] playing at once to [maxInstances] (0 for
+  /// no limit), and drop the triggers closer than [minRetriggerInterval] to
+  /// the previous one. Useful for sounds fired many times per frame, such
+  /// as gunshots or particle hits, which would otherwise pile up identical
+  /// voices that cost CPU and sound phased.
+  ///
+  /// When the limit is reached, [policy] stops the oldest or the quietest
+  /// voice of the sound, or rejects the new one. [play] and [play3d] return
+  /// a `newHandle` of 0 for a rejected trigger. The limits are checked by
+  /// the engine before any voice is created, so they also apply to the
+  /// plays scheduled on the timeline, the sequencer steps, the sampler
+  /// notes and the sounds picked by a variation container. The interval is
+  /// measured in engine time.
+  PlayerErrors setInstanceLimit(
+    SoundProps sound, {
+    int maxInstances = 0,
+    StealPolicy policy = StealPolicy.oldest,
+    Duration minRetriggerInterval = Duration.zero,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'setInstanceLimit(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.setInstanceLimit(
+          sound.soundHash,
+          maxInstances,
+          policy,
+          minRetriggerInterval.inMicroseconds / 1e6,
+        );
+    _logPlayerError(ret, from: 'setInstanceLimit() result');
+    return ret;
+  }
+
+  /// Pause or unpause already loaded sound identified by [handle]
+  ///
+  /// [handle] the sound handle
+  /// Returns [PlayerErrors.noError] if success
+  ///
+  PlayerErrors pauseSwitch(int handle) {
+    if (!isInitialized) {
+      _log.severe(() => 'pauseSwitch(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.pauseSwitch(handle);
+    return PlayerErrors.noError;
+  }
+
+  /// Pause or unpause already loaded sound identified by [handle]
+  ///
+  /// [handle] the sound handle
+  /// Returns [PlayerErrors.noError] if success
+  ///
+  PlayerErrors setPause(int handle, bool pause) {
+    if (!isInitialized) {
+      _log.severe(() => 'setPause(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.setPause(handle, pause ? 1 : 0);
+    return PlayerErrors.noError;
+  }
+
+  /// Gets the pause state
+  ///
+  /// [handle] the sound handle
+  /// Return [PlayerErrors.noError] on success and true if paused
+  ///
+  ({PlayerErrors error, bool pause}) getPause(int handle) {
+    if (!isInitialized) {
+      _log.severe(() => 'getPause(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, pause: false);
+    }
+    final ret = SoLoudController().soLoudFFI.getPause(handle);
+    return (error: PlayerErrors.noError, pause: ret);
+  }
+
+  /// Set a sound's relative play speed.
+  /// Setting the value to 0 will cause undefined behavior, likely a crash.
+  /// Change the relative play speed of a sample. This changes the effective
+  /// sample rate while leaving the base sample rate alone.
+  ///
+  /// Note that playing a sound at a higher sample rate will require SoLoud
+  /// to request more samples from the sound source, which will require more
+  /// memory and more processing power. Playing at a slower sample
+  /// rate is cheaper.
+  ///
+  /// [handle] the sound handle
+  /// [speed] the new speed
+  PlayerErrors setRelativePlaySpeed(int handle, double speed) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'setRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.setRelativePlaySpeed(handle, speed);
+    return PlayerErrors.noError;
+  }
+
+  /// Return the current play speed.
+  ///
+  /// [handle] the sound handle
+  ({PlayerErrors error, double speed}) getRelativePlaySpeed(int handle) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'getRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, speed: 1);
+    }
+    final ret = SoLoudController().soLoudFFI.getRelativePlaySpeed(handle);
+    return (error: PlayerErrors.noError, speed: ret);
+  }
+
+  /// Play the voice [handle] at [tempo] times its speed without changing its
+  /// pitch, transposed by [pitch] semitones without changing its tempo.
+  /// Both stack on [setRelativePlaySpeed], which still changes the pitch.
+  ///
+  /// Use [TimeStretchMode.wsola] for speech, e.g. podcasts, and
+  /// [TimeStretchMode.phaseVocoder] for music. Changing only [tempo] or
+  /// [pitch] is seamless, changing [mode] restarts the stretcher and skips
+  /// a few milliseconds. [getTimeStretchLoad] reports its cost.
+  ///
+  /// [tempo] from 0.25 to 4
+  /// [pitch] semitones from -24 to 24
+  PlayerErrors setTimeStretch(
+    int handle, {
+    TimeStretchMode mode = TimeStretchMode.wsola,
+    double tempo = 1,
+    double pitch = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'setTimeStretch(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .setTimeStretch(handle, mode, tempo, pitch);
+    _logPlayerError(ret, from: 'setTimeStretch() result');
+    return ret;
+  }
+
+  /// Play the voice [handle] without time stretch again.
+  PlayerErrors removeTimeStretch(int handle) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'removeTimeStretch(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.removeTimeStretch(handle);
+    return PlayerErrors.noError;
+  }
+
+  /// Return the share of a core spent stretching the voice [handle], 0.01
+  /// being 1%, averaged over the last blocks. 0 if it is not stretched.
+  ({PlayerErrors error, double load}) getTimeStretchLoad(int handle) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'getTimeStretchLoad(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, load: 0);
+    }
+    final ret = SoLoudController().soLoudFFI.getTimeStretchLoad(handle);
+    return (error: PlayerErrors.noError, load: ret);
+  }
+
+  /// Stop already loaded sound identified by [handle] and clear it from the
+  /// sound handle list
+  ///
+  /// [handle] the sound handle to stop
+  /// Return [PlayerErrors.noError] on success
+  ///
+  Future<PlayerErrors> stop(int handle) async {
+    if (!isInitialized) {
+      _log.severe(() => 'stop(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    _mainToIsolateStream?.send(
+      {
+        'event': MessageEvents.stop,
+        'args': (handle: handle),
+      },
+    );
+    final removed = (await _waitForEvent(
+      MessageEvents.stop,
+      (handle: handle),
+    )) as List<int>;
+
+    /// find a sound with this handle, or with a voice of the group [handle],
+    /// and remove that handle from the list
+    for (final sound in activeSounds) {
+      sound.handle.removeWhere(
+        (element) => element == handle || removed.contains(element),
+      );
+    }
+    return PlayerErrors.noError;
+  }
+
+  /// Stop all handles of the already loaded sound identified
+  /// by soundHash of [sound] and dispose it
+  ///
+  /// [sound] the sound to clear
+  /// Return [PlayerErrors.noError] on success
+  ///
+  Future<PlayerErrors> disposeSound(SoundProps sound) async {
+    if (!isInitialized) {
+      _log.severe(() => 'disposeSound(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    _mainToIsolateStream?.send(
+      {
+        'event': MessageEvents.disposeSound,
+        'args': (soundHash: sound.soundHash),
+      },
+    );
+    await _waitForEvent(
+        MessageEvents.disposeSound, (soundHash: sound.soundHash));
+
+    /// remove the sound with [soundHash]
+    _pushStreamFrameBytes.remove(sound.soundHash);
+    activeSounds.removeWhere(
+      (element) {
+        return element.soundHash == sound.soundHash;
+      },
+    );
+    return PlayerErrors.noError;
+  }
+
+  /// Disposes all sounds already loaded. Complete silence.
+  ///
+  /// No need to call this method when shutting down the engine.
+  /// (It is automatically called from within [shutdown].)
+  ///
+  /// Return [PlayerErrors.noError] on success
+  ///
+  Future<PlayerErrors> disposeAllSound() async {
+    if (!_isEngineInitialized) {
+      _log.severe(() => 'disposeAllSound(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    _mainToIsolateStream?.send(
+      {
+        'event': MessageEvents.disposeAllSound,
+        'args': (),
+      },
+    );
+    await _waitForEvent(MessageEvents.disposeAllSound, ());
+
+    /// remove the sound with [soundHash]
+    activeSounds.clear();
+    return PlayerErrors.noError;
+  }
+
+  /// This function can be used to set a sample to play on repeat,
+  /// instead of just playing once
+  ///
+  /// [handle] the handle for which enable or disable the loop
+  /// [enable]
+  /// Return [PlayerErrors.noError] on success
+  ///
+  PlayerErrors setLooping(int handle, bool enable) {
+    if (!isInitialized) {
+      _log.severe(() => 'setLooping(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.setLooping(handle, enable);
+    return PlayerErrors.noError;
+  }
+
+  /// Enable or disable visualization.
+  /// When enabled it will be possible to get FFT and wave data.
   ///
   /// [enabled]
   /// Return [PlayerErrors.noError] on success
@@ -1107,18 +2102,303 @@ interface class SoLoud {
     return PlayerErrors.noError;
   }
 
-  /// Get the sound length in seconds
+  /// Get the sound length in seconds
+  ///
+  /// [sound] the sound hash to get the length
+  /// returns sound length in seconds
+  ///
+  ({PlayerErrors error, double length}) getLength(SoundProps sound) {
+    if (!isInitialized) {
+      _log.severe(() => 'getLength(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, length: 0.0);
+    }
+    final ret = SoLoudController().soLoudFFI.getLength(sound.soundHash);
+    return (error: PlayerErrors.noError, length: ret);
+  }
+
+  /// Get a waveform overview of [sound] to draw it: the minimum, maximum
+  /// and RMS of its samples, all channels together, in [buckets] equal
+  /// parts of the range from [start] to [end] (the end of the sound if
+  /// null).
+  ///
+  /// The first call computes a pyramid of peaks at 256, 1024 and 4096
+  /// samples per bucket, in parallel for a sound loaded in memory or by
+  /// decoding a [LoadMode.disk] sound once, on a native worker that blocks
+  /// neither the UI nor the audio isolate. It is kept until the sound is
+  /// disposed, so zooming and scrolling are then cheap and never copy the
+  /// samples to Dart. Disposing of the sound meanwhile stops the
+  /// computation and returns [PlayerErrors.invalidParameter].
+  ///
+  /// Only sounds loaded from files or memory can be read.
+  Future<
+      ({
+        PlayerErrors error,
+        Float32List min,
+        Float32List max,
+        Float32List rms,
+      })> getWaveformPeaks(
+    SoundProps sound, {
+    Duration start = Duration.zero,
+    Duration? end,
+    int buckets = 1024,
+  }) async {
+    if (!isInitialized) {
+      _log.severe(() => 'getWaveformPeaks(): ${PlayerErrors.engineNotInited}');
+      return (
+        error: PlayerErrors.engineNotInited,
+        min: Float32List(0),
+        max: Float32List(0),
+        rms: Float32List(0),
+      );
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.getWaveformPeaks,
+      request,
+      (
+        request: request,
+        soundHash: sound.soundHash,
+        startTime: start.inMicroseconds / 1e6,
+        endTime: (end?.inMicroseconds ?? 0) / 1e6,
+        buckets: buckets,
+      ),
+    )) as ({
+      PlayerErrors error,
+      Float32List min,
+      Float32List max,
+      Float32List rms,
+    });
+    _logPlayerError(ret.error, from: 'getWaveformPeaks() result');
+    return ret;
+  }
+
+  /// Get the dimensions of the spectrogram of [sound]: the [rows] are the
+  /// frames, one every [hop] samples, and the [bins] the [size] / 2 + 1
+  /// frequencies of each frame.
+  ///
+  /// Use them to allocate the matrix passed to [computeSpectrogram] or
+  /// [computeSpectrogramDb].
+  ({PlayerErrors error, int rows, int bins}) getSpectrogramSize(
+    SoundProps sound, {
+    int size = 2048,
+    int hop = 512,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'getSpectrogramSize(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, rows: 0, bins: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .getSpectrogramSize(sound.soundHash, size, hop);
+    _logPlayerError(ret.error, from: 'getSpectrogramSize() result');
+    return ret;
+  }
+
+  /// Compute the whole spectrogram of [sound] natively into [matrix], a
+  /// buffer of rows * bins floats given by [getSpectrogramSize], row by row.
+  ///
+  /// The channels are mixed to mono, cut in frames of [size] samples (a
+  /// power of two from 64 to 16384) every [hop] samples and shaped by
+  /// [window]. The magnitudes are 1 for a full scale sine. The frames are
+  /// split across the cores, so even long sounds take a fraction of their
+  /// length, without crossing to Dart frame by frame.
+  ///
+  /// The spectrogram is computed on a native worker that blocks neither the
+  /// UI nor the audio isolate: keep [matrix] allocated until the returned
+  /// future completes. Disposing of the sound meanwhile stops the
+  /// computation and returns [PlayerErrors.invalidParameter].
+  ///
+  /// Only sounds loaded from files or memory can be read.
+  Future<PlayerErrors> computeSpectrogram(
+    SoundProps sound,
+    ffi.Pointer<ffi.Float> matrix, {
+    int size = 2048,
+    int hop = 512,
+    SpectrogramWindow window = SpectrogramWindow.hann,
+  }) async {
+    if (!isInitialized || matrix == ffi.nullptr) {
+      _log.severe(
+          () => 'computeSpectrogram(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.computeSpectrogram,
+      request,
+      (
+        request: request,
+        soundHash: sound.soundHash,
+        size: size,
+        hop: hop,
+        window: window,
+        matrix: matrix.address,
+        decibels: false,
+        minDb: -100.0,
+      ),
+    )) as PlayerErrors;
+    _logPlayerError(ret, from: 'computeSpectrogram() result');
+    return ret;
+  }
+
+  /// Like [computeSpectrogram], but into rows * bins bytes ready to be
+  /// drawn: the levels from [minDb] to 0 dB are quantized from 0 to 255.
+  Future<PlayerErrors> computeSpectrogramDb(
+    SoundProps sound,
+    ffi.Pointer<ffi.Uint8> matrix, {
+    int size = 2048,
+    int hop = 512,
+    SpectrogramWindow window = SpectrogramWindow.hann,
+    double minDb = -100,
+  }) async {
+    if (!isInitialized || matrix == ffi.nullptr) {
+      _log.severe(
+          () => 'computeSpectrogramDb(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.computeSpectrogram,
+      request,
+      (
+        request: request,
+        soundHash: sound.soundHash,
+        size: size,
+        hop: hop,
+        window: window,
+        matrix: matrix.address,
+        decibels: true,
+        minDb: minDb,
+      ),
+    )) as PlayerErrors;
+    _logPlayerError(ret, from: 'computeSpectrogramDb() result');
+    return ret;
+  }
+
+  /// Analyze the rhythm of [sound] for beat-synced gameplay or visuals:
+  /// its tempo in beats per minute, the [onsets] of its notes and hits and
+  /// its [beats], in seconds.
+  ///
+  /// The onsets are the peaks of the spectral flux, the tempo is its
+  /// periodicity (favouring tempos around 120 BPM, so a track may be
+  /// reported at half or double its felt tempo) and the beats the regular
+  /// path through its peaks at that tempo. The [bpm] is 0 if no tempo was
+  /// found.
+  ///
+  /// The analysis runs on a native worker that blocks neither the UI nor the
+  /// audio isolate, and is cached until the sound is disposed: later calls
+  /// return at once. Disposing of the sound meanwhile stops the analysis
+  /// and returns [PlayerErrors.invalidParameter]. Only sounds loaded from
+  /// files or memory can be analyzed.
+  Future<
+      ({
+        PlayerErrors error,
+        double bpm,
+        Float32List onsets,
+        Float32List beats,
+      })> analyzeRhythm(SoundProps sound) async {
+    if (!isInitialized) {
+      _log.severe(() => 'analyzeRhythm(): ${PlayerErrors.engineNotInited}');
+      return (
+        error: PlayerErrors.engineNotInited,
+        bpm: 0.0,
+        onsets: Float32List(0),
+        beats: Float32List(0),
+      );
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.analyzeRhythm,
+      request,
+      (request: request, soundHash: sound.soundHash),
+    )) as ({
+      PlayerErrors error,
+      double bpm,
+      Float32List onsets,
+      Float32List beats,
+    });
+    _logPlayerError(ret.error, from: 'analyzeRhythm() result');
+    return ret;
+  }
+
+  /// Measure the EBU R128 loudness of every sound loaded with [loadFile]
+  /// from now on, each on a native worker thread as soon as it is loaded,
+  /// so that [getLoudness] and [setLoudnessNormalization] find it ready.
+  void setLoudnessMeasurementOnLoad(bool enabled) {
+    if (!isInitialized) {
+      _log.severe(() =>
+          'setLoudnessMeasurementOnLoad(): ${PlayerErrors.engineNotInited}');
+      return;
+    }
+    SoLoudController().soLoudFFI.setLoudnessMeasurementOnLoad(enabled);
+  }
+
+  /// Get the EBU R128 loudness of [sound]: its [integrated] loudness in
+  /// LUFS and its [truePeak] in dBTP, both `double.negativeInfinity` for a
+  /// silent sound.
+  ///
+  /// The sound is measured once, streaming through its decoder on a native
+  /// worker that blocks neither the UI nor the audio isolate, and the
+  /// result is cached until it is disposed. If the measure started at load
+  /// time (see [setLoudnessMeasurementOnLoad]) this completes when it is
+  /// done. Disposing of the sound meanwhile stops the measure and returns
+  /// [PlayerErrors.invalidParameter]. Only sounds loaded from files or
+  /// memory can be measured.
+  Future<({PlayerErrors error, double integrated, double truePeak})>
+      getLoudness(SoundProps sound) async {
+    if (!isInitialized) {
+      _log.severe(() => 'getLoudness(): ${PlayerErrors.engineNotInited}');
+      return (
+        error: PlayerErrors.engineNotInited,
+        integrated: 0.0,
+        truePeak: 0.0,
+      );
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.getLoudness,
+      request,
+      (request: request, soundHash: sound.soundHash),
+    )) as ({PlayerErrors error, double integrated, double truePeak});
+    _logPlayerError(ret.error, from: 'getLoudness() result');
+    return ret;
+  }
+
+  /// Normalize the loudness of [sound] to [targetLufs], measuring it first
+  /// if needed (see [getLoudness]).
   ///
-  /// [sound] the sound hash to get the length
-  /// returns sound length in seconds
+  /// The gain is lowered to keep the true peak below [truePeakLimit] dBTP,
+  /// and is 1 for a silent sound. It is folded into the volume of the
+  /// voices of [sound] played from now on, so it costs nothing per sample
+  /// and [setVolume] and the faders still work on top of it. Pass
+  /// [enabled] false to remove it.
   ///
-  ({PlayerErrors error, double length}) getLength(SoundProps sound) {
+  /// Returns the gain applied.
+  Future<({PlayerErrors error, double gain})> setLoudnessNormalization(
+    SoundProps sound, {
+    bool enabled = true,
+    double targetLufs = -16,
+    double truePeakLimit = -1,
+  }) async {
     if (!isInitialized) {
-      _log.severe(() => 'getLength(): ${PlayerErrors.engineNotInited}');
-      return (error: PlayerErrors.engineNotInited, length: 0.0);
+      _log.severe(
+          () => 'setLoudnessNormalization(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, gain: 1.0);
     }
-    final ret = SoLoudController().soLoudFFI.getLength(sound.soundHash);
-    return (error: PlayerErrors.noError, length: ret);
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.setLoudnessNormalization,
+      request,
+      (
+        request: request,
+        soundHash: sound.soundHash,
+        enabled: enabled,
+        targetLufs: targetLufs,
+        truePeakLimit: truePeakLimit,
+      ),
+    )) as ({PlayerErrors error, double gain});
+    _logPlayerError(ret.error, from: 'setLoudnessNormalization() result');
+    return ret;
   }
 
   /// Seek playing in [time] seconds
@@ -1228,6 +2508,96 @@ interface class SoLoud {
     return (error: PlayerErrors.noError, isValid: ret);
   }
 
+  /// Set [handle] pan, from -1 left to 1 right.
+  ///
+  /// [handle] a voice or a voice group, see [createVoiceGroup]
+  PlayerErrors setPan(int handle, double pan) {
+    if (!isInitialized) {
+      _log.severe(() => 'setPan(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.setPan(handle, pan);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Protect [handle] from being stopped or made virtual when more voices
+  /// play than the maximum of active voices, for music or dialogue.
+  ///
+  /// [handle] a voice or a voice group, see [createVoiceGroup]
+  PlayerErrors setProtectVoice(int handle, bool protect) {
+    if (!isInitialized) {
+      _log.severe(() => 'setProtectVoice(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.setProtectVoice(handle, protect);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Create a voice group: a handle standing for many voices, accepted in
+  /// place of a voice handle by [stop], [setPause], [setVolume], [setPan],
+  /// [setRelativePlaySpeed], [setLooping], [setProtectVoice], the fade,
+  /// schedule and oscillate methods and the 3D source setters. They then
+  /// apply to all the voices of the group in one call under one lock, for
+  /// example to pause all the gameplay audio when a menu opens.
+  ///
+  /// Ended voices leave the group by themselves. Returns the group handle,
+  /// 0 with [PlayerErrors.outOfMemory] if no more groups can be created.
+  ({PlayerErrors error, int group}) createVoiceGroup() {
+    if (!isInitialized) {
+      _log.severe(() => 'createVoiceGroup(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, group: 0);
+    }
+    final ret = SoLoudController().soLoudFFI.createVoiceGroup();
+    _logPlayerError(ret.error, from: 'createVoiceGroup() result');
+    return ret;
+  }
+
+  /// Destroy a voice group made by [createVoiceGroup]. Its voices keep
+  /// playing.
+  PlayerErrors destroyVoiceGroup(int group) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'destroyVoiceGroup(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.destroyVoiceGroup(group);
+    _logPlayerError(ret, from: 'destroyVoiceGroup() result');
+    return ret;
+  }
+
+  /// Add the voices [handles] to [group] in one call. The voices already
+  /// ended are skipped, and a voice already in the group is not added
+  /// twice.
+  PlayerErrors addVoicesToGroup(int group, List<int> handles) {
+    if (!isInitialized) {
+      _log.severe(() => 'addVoicesToGroup(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.addVoicesToGroup(group, handles);
+    _logPlayerError(ret, from: 'addVoicesToGroup() result');
+    return ret;
+  }
+
+  /// Whether [handle] is a voice group.
+  bool isVoiceGroup(int handle) {
+    if (!isInitialized) {
+      _log.severe(() => 'isVoiceGroup(): ${PlayerErrors.engineNotInited}');
+      return false;
+    }
+    return SoLoudController().soLoudFFI.isVoiceGroup(handle);
+  }
+
+  /// Whether all the voices of [group] have ended.
+  bool isVoiceGroupEmpty(int group) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'isVoiceGroupEmpty(): ${PlayerErrors.engineNotInited}');
+      return true;
+    }
+    return SoLoudController().soLoudFFI.isVoiceGroupEmpty(group);
+  }
+
   /// Return a floats matrix of 256x512
   /// Every row are composed of 256 FFT values plus 256 of wave data.
   /// Every time is called, a new row is stored in the
@@ -1300,136 +2670,573 @@ interface class SoLoud {
   ///
   PlayerErrors setFftSmoothing(double smooth) {
     if (!isInitialized) {
-      _log.severe(() => 'setFftSmoothing(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'setFftSmoothing(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    SoLoudController().soLoudFFI.setFftSmoothing(smooth);
+    return PlayerErrors.noError;
+  }
+
+  /////////////////////////////////////////
+  /// faders
+  /////////////////////////////////////////
+
+  /// Smoothly change the global volume over specified time.
+  ///
+  PlayerErrors fadeGlobalVolume(double to, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'fadeGlobalVolume(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.fadeGlobalVolume(to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Smoothly change a channel's volume over specified time.
+  ///
+  PlayerErrors fadeVolume(int handle, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'fadeVolume(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.fadeVolume(handle, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Smoothly change a channel's pan setting over specified time.
+  ///
+  PlayerErrors fadePan(int handle, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'fadePan(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.fadePan(handle, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Smoothly change a channel's relative play speed over specified time.
+  ///
+  PlayerErrors fadeRelativePlaySpeed(int handle, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'fadeRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.fadeRelativePlaySpeed(handle, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// After specified time, pause the channel.
+  ///
+  PlayerErrors schedulePause(int handle, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'schedulePause(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.schedulePause(handle, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// After specified time, stop the channel.
+  ///
+  PlayerErrors scheduleStop(int handle, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'scheduleStop(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.scheduleStop(handle, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Set fader to oscillate the volume at specified frequency.
+  ///
+  PlayerErrors oscillateVolume(
+      int handle, double from, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'oscillateVolume(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.oscillateVolume(handle, from, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Set fader to oscillate the panning at specified frequency.
+  ///
+  PlayerErrors oscillatePan(int handle, double from, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(() => 'oscillatePan(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.oscillatePan(handle, from, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Set fader to oscillate the relative play speed at specified frequency.
+  ///
+  PlayerErrors oscillateRelativePlaySpeed(
+      int handle, double from, double to, double time) {
+    if (!isInitialized) {
+      _log.severe('oscillateRelativePlaySpeed(): '
+          '${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .oscillateRelativePlaySpeed(handle, from, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  /// Set fader to oscillate the global volume at specified frequency.
+  ///
+  PlayerErrors oscillateGlobalVolume(double from, double to, double time) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'oscillateGlobalVolume(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.oscillateGlobalVolume(from, to, time);
+    return PlayerErrors.values[ret];
+  }
+
+  // ///////////////////////////////////////
+  //  timeline
+  // ///////////////////////////////////////
+
+  /// Get the engine time: the number of samples mixed since [initialize].
+  ///
+  /// Events scheduled with [schedulePlayAt] and [scheduleVoiceEventAt]
+  /// use this clock. Schedule them a little ahead (ie one buffer) of the
+  /// current engine time to have them land on the exact sample.
+  int getEngineTime() {
+    if (!isInitialized) return 0;
+    return SoLoudController().soLoudFFI.getEngineTime();
+  }
+
+  /// Get the engine sample rate, the unit of [getEngineTime].
+  int getEngineSampleRate() {
+    if (!isInitialized) return 0;
+    return SoLoudController().soLoudFFI.getEngineSampleRate();
+  }
+
+  /// Play [sound] when the engine time reaches [time] samples.
+  ///
+  /// The sound starts on the exact sample, whatever the timing of the
+  /// Dart code. The voice handle can be read with [getScheduledHandle]
+  /// once the event has been run.
+  /// Returns PlayerErrors.noError if success and the id of the event.
+  ({PlayerErrors error, int eventId}) schedulePlayAt(
+    SoundProps sound,
+    int time, {
+    double volume = 1,
+    double pan = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'schedulePlayAt(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, eventId: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .schedulePlayAt(sound.soundHash, time, volume, pan);
+    _logPlayerError(ret.error, from: 'schedulePlayAt() result');
+    return ret;
+  }
+
+  /// Change a voice when the engine time reaches [time] samples.
+  ///
+  /// The voice is [handle] or, if [playEventId] is given, the voice
+  /// started by that [schedulePlayAt] event, so a note can be stopped
+  /// before knowing its handle.
+  /// [value] is the new volume, pan or speed, the seconds to seek to or,
+  /// for [ScheduledVoiceAction.pause], not 0 to pause.
+  /// Returns PlayerErrors.noError if success and the id of the event.
+  ({PlayerErrors error, int eventId}) scheduleVoiceEventAt(
+    int time,
+    ScheduledVoiceAction action, {
+    int handle = 0,
+    int playEventId = 0,
+    double value = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'scheduleVoiceEventAt(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, eventId: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .scheduleVoiceEventAt(handle, playEventId, time, action, value);
+    _logPlayerError(ret.error, from: 'scheduleVoiceEventAt() result');
+    return ret;
+  }
+
+  /// Set the [attributeId] parameter of the active global filter
+  /// [filterType] to [value] when the engine time reaches [time] samples.
+  ///
+  /// Returns PlayerErrors.noError if success and the id of the event.
+  ({PlayerErrors error, int eventId}) scheduleFilterParamAt(
+    FilterType filterType,
+    int attributeId,
+    double value,
+    int time,
+  ) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'scheduleFilterParamAt(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, eventId: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .scheduleFilterParamAt(filterType.index, attributeId, value, time);
+    _logPlayerError(ret.error, from: 'scheduleFilterParamAt() result');
+    return ret;
+  }
+
+  /// Remove the event [eventId] if it has not been run yet.
+  ///
+  /// Returns true if the event was pending.
+  bool cancelScheduledEvent(int eventId) {
+    if (!isInitialized) return false;
+    return SoLoudController().soLoudFFI.cancelScheduledEvent(eventId);
+  }
+
+  /// Remove all the events not run yet.
+  void cancelAllScheduledEvents() {
+    if (!isInitialized) return;
+    SoLoudController().soLoudFFI.cancelAllScheduledEvents();
+  }
+
+  /// Get the voice started by the [schedulePlayAt] event [eventId] of
+  /// [sound], and add it to the [sound] handles.
+  ///
+  /// Returns the handle or 0 if the event has not been run yet.
+  int getScheduledHandle(SoundProps sound, int eventId) {
+    if (!isInitialized) return 0;
+    final handle = SoLoudController().soLoudFFI.getScheduledHandle(eventId);
+    if (handle != 0) {
+      sound.handle.add(handle);
+      for (final s in activeSounds) {
+        if (s.soundHash == sound.soundHash) s.handle.add(handle);
+      }
+    }
+    return handle;
+  }
+
+  // ///////////////////////////////////////
+  //  sequencers
+  // ///////////////////////////////////////
+
+  /// Create a step sequencer: a pattern of [tracks] rows of [steps] steps,
+  /// each of which can trigger a sound with its own volume, pan and pitch.
+  ///
+  /// The steps are fired by the audio thread on their exact sample, so the
+  /// timing doesn't depend on the UI load. [stepsPerBeat] is 4 for 16th
+  /// notes. The sequencer is created stopped, see [sequencerStart].
+  /// Returns PlayerErrors.noError if success and the sequencer id.
+  ({PlayerErrors error, int id}) createSequencer({
+    double bpm = 120,
+    int stepsPerBeat = 4,
+    int steps = 16,
+    int tracks = 1,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'createSequencer(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, id: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .createSequencer(bpm, stepsPerBeat, steps, tracks);
+    _logPlayerError(ret.error, from: 'createSequencer() result');
+    return ret;
+  }
+
+  /// Stop and remove the sequencer [id].
+  void destroySequencer(int id) {
+    if (!isInitialized) return;
+    SoLoudController().soLoudFFI.destroySequencer(id);
+  }
+
+  /// Change the tempo of the sequencer [id], from its next step.
+  PlayerErrors sequencerSetTempo(int id, double bpm, {int stepsPerBeat = 4}) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'sequencerSetTempo(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.sequencerSetTempo(id, bpm, stepsPerBeat);
+    _logPlayerError(ret, from: 'sequencerSetTempo() result');
+    return ret;
+  }
+
+  /// Delay the odd steps of the sequencer [id] by [swing] (0 to 0.9)
+  /// of a step.
+  PlayerErrors sequencerSetSwing(int id, double swing) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'sequencerSetSwing(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    SoLoudController().soLoudFFI.setFftSmoothing(smooth);
-    return PlayerErrors.noError;
+    final ret = SoLoudController().soLoudFFI.sequencerSetSwing(id, swing);
+    _logPlayerError(ret, from: 'sequencerSetSwing() result');
+    return ret;
   }
 
-  /////////////////////////////////////////
-  /// faders
-  /////////////////////////////////////////
+  /// Resize the pattern of the sequencer [id], keeping the cells which
+  /// fit in the new size.
+  PlayerErrors sequencerSetSize(int id, {required int steps, int tracks = 1}) {
+    if (!isInitialized) {
+      _log.severe(() => 'sequencerSetSize(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.sequencerSetSize(id, steps, tracks);
+    _logPlayerError(ret, from: 'sequencerSetSize() result');
+    return ret;
+  }
 
-  /// Smoothly change the global volume over specified time.
+  /// Change many cells of the sequencer [id] with a single native call.
   ///
-  PlayerErrors fadeGlobalVolume(double to, double time) {
+  /// It can be called while playing, the changes are heard from the
+  /// next step.
+  PlayerErrors sequencerSetSteps(int id, List<SequencerStep> steps) {
     if (!isInitialized) {
-      _log.severe(() => 'fadeGlobalVolume(): ${PlayerErrors.engineNotInited}');
+      _log.severe(
+          () => 'sequencerSetSteps(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.fadeGlobalVolume(to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.sequencerSetSteps(id, steps);
+    _logPlayerError(ret, from: 'sequencerSetSteps() result');
+    return ret;
   }
 
-  /// Smoothly change a channel's volume over specified time.
-  ///
-  PlayerErrors fadeVolume(int handle, double to, double time) {
+  /// Start the sequencer [id] from [step] at the engine [time], in
+  /// samples (see [getEngineTime]). By default it starts right away.
+  PlayerErrors sequencerStart(int id, {int? time, int step = 0}) {
     if (!isInitialized) {
-      _log.severe(() => 'fadeVolume(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'sequencerStart(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.fadeVolume(handle, to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController()
+        .soLoudFFI
+        .sequencerStart(id, time ?? getEngineTime(), step);
+    _logPlayerError(ret, from: 'sequencerStart() result');
+    return ret;
   }
 
-  /// Smoothly change a channel's pan setting over specified time.
-  ///
-  PlayerErrors fadePan(int handle, double to, double time) {
+  /// Stop the sequencer [id]. Sounds already triggered keep playing.
+  PlayerErrors sequencerStop(int id) {
     if (!isInitialized) {
-      _log.severe(() => 'fadePan(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'sequencerStop(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.fadePan(handle, to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.sequencerStop(id);
+    _logPlayerError(ret, from: 'sequencerStop() result');
+    return ret;
   }
 
-  /// Smoothly change a channel's relative play speed over specified time.
+  /// Get the last step played by the sequencer [id], or -1 if stopped.
+  int sequencerGetCurrentStep(int id) {
+    if (!isInitialized) return -1;
+    return SoLoudController().soLoudFFI.sequencerGetCurrentStep(id);
+  }
+
+  // ///////////////////////////////////////
+  //  samplers
+  // ///////////////////////////////////////
+
+  /// Create a multi-sample instrument.
   ///
-  PlayerErrors fadeRelativePlaySpeed(int handle, double to, double time) {
+  /// Add the samples with [samplerAddZones], then each [samplerNoteOn]
+  /// starts all the zones matching the key and velocity of the note in one
+  /// native call, pitched by the engine resampler.
+  /// Returns PlayerErrors.noError if success and the sampler id.
+  Future<({PlayerErrors error, int id})> createSampler() async {
     if (!isInitialized) {
-      _log.severe(
-          () => 'fadeRelativePlaySpeed(): ${PlayerErrors.engineNotInited}');
-      return PlayerErrors.engineNotInited;
+      _log.severe(() => 'createSampler(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, id: 0);
+    }
+    final request = _nextRequest++;
+    final ret = (await _request(
+      MessageEvents.createSampler,
+      request,
+      (request: request),
+    )) as ({PlayerErrors error, int id});
+    _logPlayerError(ret.error, from: 'createSampler() result');
+    return ret;
+  }
+
+  /// Release the notes and remove the sampler [id].
+  Future<void> destroySampler(int id) async {
+    if (!isInitialized) {
+      _log.severe(() => 'destroySampler(): ${PlayerErrors.engineNotInited}');
+      return;
     }
-    final ret =
-        SoLoudController().soLoudFFI.fadeRelativePlaySpeed(handle, to, time);
-    return PlayerErrors.values[ret];
+    final request = _nextRequest++;
+    await _request(
+      MessageEvents.destroySampler,
+      request,
+      (request: request, id: id),
+    );
   }
 
-  /// After specified time, pause the channel.
+  /// Add [zones] to the sampler [id].
   ///
-  PlayerErrors schedulePause(int handle, double time) {
+  /// The sounds must be loaded with [LoadMode.memory]. All the zones
+  /// matching a note play together, use [SamplerZone.seqLength] to
+  /// alternate them instead.
+  /// Returns [PlayerErrors.invalidParameter] if a sound or a zone is not
+  /// valid. The other zones are added anyway.
+  PlayerErrors samplerAddZones(int id, List<SamplerZone> zones) {
     if (!isInitialized) {
-      _log.severe(() => 'schedulePause(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'samplerAddZones(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.schedulePause(handle, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.samplerAddZones(id, zones);
+    _logPlayerError(ret, from: 'samplerAddZones() result');
+    return ret;
   }
 
-  /// After specified time, stop the channel.
-  ///
-  PlayerErrors scheduleStop(int handle, double time) {
+  /// Remove all the zones of the sampler [id].
+  PlayerErrors samplerClearZones(int id) {
     if (!isInitialized) {
-      _log.severe(() => 'scheduleStop(): ${PlayerErrors.engineNotInited}');
+      _log.severe(
+          () => 'samplerClearZones(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController().soLoudFFI.scheduleStop(handle, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.samplerClearZones(id);
+    _logPlayerError(ret, from: 'samplerClearZones() result');
+    return ret;
   }
 
-  /// Set fader to oscillate the volume at specified frequency.
+  /// Start the zones of the MIDI [note] with [velocity] from 0 to 1.
   ///
-  PlayerErrors oscillateVolume(
-      int handle, double from, double to, double time) {
+  /// [note] can be fractional. Starting a note already playing cuts it.
+  /// Returns the handle of the first voice started, 0 if no zone matches.
+  ({PlayerErrors error, int handle}) samplerNoteOn(
+    int id,
+    double note, {
+    double velocity = 1,
+  }) {
     if (!isInitialized) {
-      _log.severe(() => 'oscillateVolume(): ${PlayerErrors.engineNotInited}');
-      return PlayerErrors.engineNotInited;
+      _log.severe(() => 'samplerNoteOn(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, handle: 0);
     }
     final ret =
-        SoLoudController().soLoudFFI.oscillateVolume(handle, from, to, time);
-    return PlayerErrors.values[ret];
+        SoLoudController().soLoudFFI.samplerNoteOn(id, note, velocity);
+    _logPlayerError(ret.error, from: 'samplerNoteOn() result');
+    return ret;
   }
 
-  /// Set fader to oscillate the panning at specified frequency.
-  ///
-  PlayerErrors oscillatePan(int handle, double from, double to, double time) {
+  /// Release [note]: its voices fade out in the release time of their
+  /// zones and the release zones start.
+  PlayerErrors samplerNoteOff(int id, double note) {
     if (!isInitialized) {
-      _log.severe(() => 'oscillatePan(): ${PlayerErrors.engineNotInited}');
+      _log.severe(() => 'samplerNoteOff(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret =
-        SoLoudController().soLoudFFI.oscillatePan(handle, from, to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.samplerNoteOff(id, note);
+    _logPlayerError(ret, from: 'samplerNoteOff() result');
+    return ret;
   }
 
-  /// Set fader to oscillate the relative play speed at specified frequency.
-  ///
-  PlayerErrors oscillateRelativePlaySpeed(
-      int handle, double from, double to, double time) {
+  /// Release all the notes of the sampler [id].
+  PlayerErrors samplerAllNotesOff(int id) {
     if (!isInitialized) {
-      _log.severe('oscillateRelativePlaySpeed(): '
-          '${PlayerErrors.engineNotInited}');
+      _log.severe(
+          () => 'samplerAllNotesOff(): ${PlayerErrors.engineNotInited}');
       return PlayerErrors.engineNotInited;
     }
-    final ret = SoLoudController()
-        .soLoudFFI
-        .oscillateRelativePlaySpeed(handle, from, to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.samplerAllNotesOff(id);
+    _logPlayerError(ret, from: 'samplerAllNotesOff() result');
+    return ret;
   }
 
-  /// Set fader to oscillate the global volume at specified frequency.
+  /// Get how many notes of the sampler [id] are held and still sounding.
+  int samplerGetActiveNotes(int id) {
+    if (!isInitialized) return 0;
+    return SoLoudController().soLoudFFI.samplerGetActiveNotes(id);
+  }
+
+  // ///////////////////////////////////////
+  //  audio clock
+  // ///////////////////////////////////////
+
+  /// Get the engine time in seconds being heard now.
   ///
-  PlayerErrors oscillateGlobalVolume(double from, double to, double time) {
+  /// Unlike [getEngineTime], which advances once per mixed buffer (about
+  /// 46 ms), this clock is interpolated with the monotonic clock between
+  /// the buffers and is delayed by the output latency (see
+  /// [getOutputLatency]), so it can drive video or lyrics sync.
+  /// It never goes back.
+  double getOutputTime() {
+    if (!isInitialized) return 0;
+    return SoLoudController().soLoudFFI.getOutputTime();
+  }
+
+  /// Get the position in seconds of the voice [handle] being heard now.
+  ///
+  /// Like [getOutputTime], it is interpolated between the mixed buffers
+  /// and corrected by the output latency, while [getPosition] returns the
+  /// position of the last sample mixed.
+  /// Return PlayerErrors.noError if success and the position in seconds.
+  ({PlayerErrors error, double position}) getOutputPosition(int handle) {
     if (!isInitialized) {
       _log.severe(
-          () => 'oscillateGlobalVolume(): ${PlayerErrors.engineNotInited}');
-      return PlayerErrors.engineNotInited;
+          () => 'getOutputPosition(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, position: 0.0);
     }
-    final ret =
-        SoLoudController().soLoudFFI.oscillateGlobalVolume(from, to, time);
-    return PlayerErrors.values[ret];
+    final ret = SoLoudController().soLoudFFI.getOutputPosition(handle);
+    if (ret < 0) {
+      _logPlayerError(PlayerErrors.invalidParameter,
+          from: 'getOutputPosition() result');
+      return (error: PlayerErrors.invalidParameter, position: 0.0);
+    }
+    return (error: PlayerErrors.noError, position: ret);
+  }
+
+  /// Add [seconds] to the output latency reported by the device, ie to
+  /// compensate for bluetooth headphones. Can be negative.
+  void setOutputLatencyOffset(double seconds) {
+    SoLoudController().soLoudFFI.setOutputLatencyOffset(seconds);
+  }
+
+  /// Get the time in seconds between a sample being mixed and being
+  /// heard: the buffering of the device plus [setOutputLatencyOffset].
+  double getOutputLatency() {
+    if (!isInitialized) return 0;
+    return SoLoudController().soLoudFFI.getOutputLatency();
+  }
+
+  // ///////////////////////////////////////
+  //  status block
+  // ///////////////////////////////////////
+
+  /// Start publishing the engine state after every mixed block and get
+  /// a reader for it.
+  ///
+  /// The engine clock, the state of every voice (position, volume, pan,
+  /// pause, loop count) and the output meters can then be read with
+  /// [EngineStatusReader.read] once per UI frame, without any FFI call
+  /// nor locking the audio thread, instead of calling [getPosition],
+  /// [getVolume], [getIsValidVoiceHandle] and [getPause] per handle.
+  EngineStatusReader? enableEngineStatus() {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'enableEngineStatus(): ${PlayerErrors.engineNotInited}');
+      return null;
+    }
+    SoLoudController().soLoudFFI.setStatusBlockEnabled(true);
+    final block = SoLoudController().soLoudFFI.getStatusBlock();
+    return EngineStatusReader(block.data, block.size);
+  }
+
+  /// Stop publishing the engine state. Readers keep the last state.
+  void disableEngineStatus() {
+    if (!isInitialized) return;
+    SoLoudController().soLoudFFI.setStatusBlockEnabled(false);
   }
 
   // ////////////////////////////////////////////////
@@ -1622,6 +3429,293 @@ interface class SoLoud {
     return ret;
   }
 
+  // ////////////////////////////////////////////////
+  // Below all the methods to modulate the waveform and filter parameters
+  // with native LFOs, envelopes and random sources. They run on the audio
+  // thread once every 128 samples: after the routes are set up nothing
+  // has to be called from Dart.
+  // ////////////////////////////////////////////////
+
+  /// Set the tempo of the sources synced to beats, 120 by default.
+  PlayerErrors setModTempo(double bpm) {
+    if (!isInitialized) {
+      _log.severe(() => 'setModTempo(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.modSetTempo(bpm);
+    _logPlayerError(ret, from: 'setModTempo() result');
+    return ret;
+  }
+
+  /// Create an LFO going from -1 to 1 with the given [shape].
+  ///
+  /// It runs at [rate] cycles per second or, if [syncBeats] is greater
+  /// than 0, with a cycle [syncBeats] long at the tempo set with
+  /// [setModTempo]. Returns the id of the source to use with
+  /// [addModWaveformRoute] and [addModFilterRoute].
+  ({PlayerErrors error, int id}) createModLfo({
+    ModShape shape = ModShape.sine,
+    double rate = 1,
+    double syncBeats = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'createModLfo(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, id: 0);
+    }
+    final ret =
+        SoLoudController().soLoudFFI.modCreateLfo(shape, rate, syncBeats);
+    _logPlayerError(ret.error, from: 'createModLfo() result');
+    return ret;
+  }
+
+  /// Create an envelope going from 0 to 1 and back.
+  ///
+  /// It starts with [setModGate] to true and releases with [setModGate]
+  /// to false. [attack], [decay] and [release] are in seconds, [sustain]
+  /// from 0 to 1.
+  ({PlayerErrors error, int id}) createModEnvelope({
+    double attack = 0.01,
+    double decay = 0.1,
+    double sustain = 0.7,
+    double release = 0.3,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'createModEnvelope(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, id: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .modCreateEnvelope(attack, decay, sustain, release);
+    _logPlayerError(ret.error, from: 'createModEnvelope() result');
+    return ret;
+  }
+
+  /// Create a source taking a new random value from -1 to 1 every cycle.
+  ///
+  /// The cycle is set like for [createModLfo]. If [smooth] is true the
+  /// value glides to the next one instead of jumping.
+  ({PlayerErrors error, int id}) createModRandom({
+    double rate = 1,
+    double syncBeats = 0,
+    bool smooth = false,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'createModRandom(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, id: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .modCreateRandom(rate, syncBeats, smooth);
+    _logPlayerError(ret.error, from: 'createModRandom() result');
+    return ret;
+  }
+
+  /// Change the shape and speed of an LFO or of a random source.
+  PlayerErrors setModSourceRate(
+    int sourceId, {
+    ModShape shape = ModShape.sine,
+    double rate = 1,
+    double syncBeats = 0,
+  }) {
+    if (!isInitialized) {
+      _log.severe(() => 'setModSourceRate(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .modSetSourceRate(sourceId, shape, rate, syncBeats);
+    _logPlayerError(ret, from: 'setModSourceRate() result');
+    return ret;
+  }
+
+  /// Open or close the gate of the envelope [sourceId].
+  PlayerErrors setModGate(int sourceId, bool gate) {
+    if (!isInitialized) {
+      _log.severe(() => 'setModGate(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.modSetGate(sourceId, gate);
+    _logPlayerError(ret, from: 'setModGate() result');
+    return ret;
+  }
+
+  /// Remove the source [sourceId] and its routes.
+  void removeModSource(int sourceId) {
+    if (!isInitialized) {
+      _log.severe(() => 'removeModSource(): ${PlayerErrors.engineNotInited}');
+      return;
+    }
+    SoLoudController().soLoudFFI.modRemoveSource(sourceId);
+  }
+
+  /// Route [sourceId] to the [param] of the waveform [sound].
+  ///
+  /// The parameter becomes its value plus [depth] times the source, or
+  /// for the frequency, its value shifted by [depth] semitones times the
+  /// source. The values set later with [setWaveformFreq],
+  /// [setWaveformDetune] and [setWaveformScale] are modulated the same way.
+  ({PlayerErrors error, int routeId}) addModWaveformRoute(
+    int sourceId,
+    SoundProps sound,
+    ModWaveformParam param,
+    double depth,
+  ) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'addModWaveformRoute(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, routeId: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .modAddWaveformRoute(sourceId, sound.soundHash, param, depth);
+    _logPlayerError(ret.error, from: 'addModWaveformRoute() result');
+    return ret;
+  }
+
+  /// Route [sourceId] to the parameter [attributeId] of the global
+  /// [filterType].
+  ///
+  /// The parameter becomes its value plus [depth] times the source. The
+  /// filter can be added later, the values set with [setFxParams] are
+  /// modulated the same way.
+  ({PlayerErrors error, int routeId}) addModFilterRoute(
+    int sourceId,
+    FilterType filterType,
+    int attributeId,
+    double depth,
+  ) {
+    if (!isInitialized) {
+      _log.severe(() => 'addModFilterRoute(): ${PlayerErrors.engineNotInited}');
+      return (error: PlayerErrors.engineNotInited, routeId: 0);
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .modAddFilterRoute(sourceId, filterType.index, attributeId, depth);
+    _logPlayerError(ret.error, from: 'addModFilterRoute() result');
+    return ret;
+  }
+
+  /// Change the [depth] of the route [routeId].
+  PlayerErrors setModRouteDepth(int routeId, double depth) {
+    if (!isInitialized) {
+      _log.severe(() => 'setModRouteDepth(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.modSetRouteDepth(routeId, depth);
+    _logPlayerError(ret, from: 'setModRouteDepth() result');
+    return ret;
+  }
+
+  /// Remove the route [routeId]. A parameter left without routes gets
+  /// back its value.
+  void removeModRoute(int routeId) {
+    if (!isInitialized) {
+      _log.severe(() => 'removeModRoute(): ${PlayerErrors.engineNotInited}');
+      return;
+    }
+    SoLoudController().soLoudFFI.modRemoveRoute(routeId);
+  }
+
+  /// Create or replace the mixer snapshot [name]: a state of the global
+  /// volume and of the global filter parameters, which
+  /// [blendToMixerSnapshot] moves the mixer to in one call.
+  ///
+  /// With [capture] the snapshot stores the current state of the mixer,
+  /// otherwise it starts empty and is filled by [setMixerSnapshotVolume]
+  /// and [setMixerSnapshotFilterParam].
+  ///
+  /// A snapshot with a [parent] inherits the values it doesn't set, so
+  /// "pause" can be defined from "gameplay" by only lowering the volume and
+  /// the cutoff of a filter. When capturing, it only stores the values
+  /// which differ from its parent.
+  PlayerErrors createMixerSnapshot(
+    String name, {
+    String? parent,
+    bool capture = true,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'createMixerSnapshot(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .snapshotCreate(name, parent ?? '', capture);
+    _logPlayerError(ret, from: 'createMixerSnapshot() result');
+    return ret;
+  }
+
+  /// Set the global volume of the mixer snapshot [name].
+  PlayerErrors setMixerSnapshotVolume(String name, double volume) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'setMixerSnapshotVolume(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret =
+        SoLoudController().soLoudFFI.snapshotSetValue(name, -1, 0, volume);
+    _logPlayerError(ret, from: 'setMixerSnapshotVolume() result');
+    return ret;
+  }
+
+  /// Set the parameter [attributeId] of the global filter [filterType] in
+  /// the mixer snapshot [name]. The filter doesn't need to be active: a
+  /// blend skips the filters which are not.
+  PlayerErrors setMixerSnapshotFilterParam(
+    String name,
+    FilterType filterType,
+    int attributeId,
+    double value,
+  ) {
+    if (!isInitialized) {
+      _log.severe(() =>
+          'setMixerSnapshotFilterParam(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .snapshotSetValue(name, filterType.index, attributeId, value);
+    _logPlayerError(ret, from: 'setMixerSnapshotFilterParam() result');
+    return ret;
+  }
+
+  /// Remove the mixer snapshot [name]. The snapshots inheriting from it
+  /// lose their parent.
+  PlayerErrors removeMixerSnapshot(String name) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'removeMixerSnapshot(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController().soLoudFFI.snapshotRemove(name);
+    _logPlayerError(ret, from: 'removeMixerSnapshot() result');
+    return ret;
+  }
+
+  /// Move the mixer from its current state to the snapshot [name] over
+  /// [time], replacing the blend in progress if any.
+  ///
+  /// All the values are interpolated together by the audio thread, once
+  /// every 128 samples, with no further call from Dart. Filter parameters
+  /// modulated by [addModFilterRoute] keep oscillating around the blended
+  /// value.
+  PlayerErrors blendToMixerSnapshot(
+    String name, {
+    Duration time = Duration.zero,
+  }) {
+    if (!isInitialized) {
+      _log.severe(
+          () => 'blendToMixerSnapshot(): ${PlayerErrors.engineNotInited}');
+      return PlayerErrors.engineNotInited;
+    }
+    final ret = SoLoudController()
+        .soLoudFFI
+        .snapshotBlend(name, time.inMicroseconds / 1e6);
+    _logPlayerError(ret, from: 'blendToMixerSnapshot() result');
+    return ret;
+  }
+
   // ////////////////////////////////////////////////
   // Below all the methods implemented with FFI for the 3D audio
   // more info: https://solhsa.com/soloud/core3d.html
@@ -1688,6 +3782,10 @@ interface class SoLoud {
       ),
     )) as ({PlayerErrors error, int newHandle});
     _logPlayerError(ret.error, from: 'play3d() result');
+    // dropped by the instance limit, see [setInstanceLimit]
+    if (ret.newHandle == 0) {
+      return (error: ret.error, sound: sound, newHandle: 0);
+    }
     try {
       /// add the new handle to the sound
       activeSounds
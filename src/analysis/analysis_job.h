@@ -0,0 +1,55 @@
+#ifndef ANALYSIS_JOB_H
+#define ANALYSIS_JOB_H
+
+#include "sound_reader.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+
+/// An offline analysis of a sound run on a worker thread, not to block the
+/// isolate calling it.
+///
+/// The job reads the sound through its own [SoundReader], so the sound must
+/// outlive it: the player destroys the jobs of a sound before disposing of
+/// it. Destroying a job stops decoding a stream and waits for the worker.
+template <class T>
+class AnalysisJob
+{
+public:
+    /// @param analysis run on the worker, returns the result read by [get].
+    AnalysisJob(std::unique_ptr<SoundReader> reader,
+                std::function<std::unique_ptr<T>(SoundReader &)> analysis)
+        : mReader(std::move(reader))
+    {
+        mJob = std::async(std::launch::async, [this, analysis]()
+                          { mResult = analysis(*mReader); });
+    }
+
+    ~AnalysisJob()
+    {
+        mReader->cancel();
+        mJob.wait();
+    }
+
+    /// @return true once the analysis is done.
+    bool isReady() const
+    {
+        return mJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// @return the result. Waits for the analysis.
+    const T &get()
+    {
+        mJob.wait();
+        return *mResult;
+    }
+
+private:
+    std::unique_ptr<SoundReader> mReader;
+    std::future<void> mJob;
+    std::unique_ptr<T> mResult;
+};
+
+#endif // ANALYSIS_JOB_H
@@ -0,0 +1,200 @@
+#include "loudness_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    const double kLoudnessPi = 3.14159265358979323846;
+
+    /// the blocks are 4 steps of 100 ms
+    const unsigned int kLoudnessStepsPerBlock = 4;
+    const float kLoudnessAbsoluteGate = -70.0f;
+    const float kLoudnessRelativeGate = -10.0f;
+
+    /// taps of each phase of the 4 times upsampling of BS.1770-4 Annex 2
+    const int kTruePeakTaps = 12;
+    const float kTruePeakPhases[4][kTruePeakTaps] = {
+        {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f,
+         -0.0594482421875f, 0.1373291015625f, 0.9721679687500f, -0.1022949218750f,
+         0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+        {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f,
+         -0.1665039062500f, 0.4650878906250f, 0.7797851562500f, -0.2003173828125f,
+         0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+        {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f,
+         -0.2003173828125f, 0.7797851562500f, 0.4650878906250f, -0.1665039062500f,
+         0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+        {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f,
+         -0.1022949218750f, 0.9721679687500f, 0.1373291015625f, -0.0594482421875f,
+         0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f}};
+
+    struct LoudnessBiquad
+    {
+        double b0, b1, b2, a1, a2;
+        double z1, z2;
+
+        double process(double x)
+        {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    /// the two stages of the K-weighting at [samplerate]: a high shelf
+    /// modelling the head, then a high pass
+    void kWeighting(double samplerate, LoudnessBiquad &shelf, LoudnessBiquad &highPass)
+    {
+        double k = tan(kLoudnessPi * 1681.974450955533 / samplerate);
+        const double q = 0.7071752369554196;
+        const double vh = pow(10.0, 3.999843853973347 / 20.0);
+        const double vb = pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+        shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0, 0.0, 0.0};
+
+        k = tan(kLoudnessPi * 38.13547087602444 / samplerate);
+        const double q2 = 0.5003270373238773;
+        a0 = 1.0 + k / q2 + k * k;
+        highPass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q2 + k * k) / a0, 0.0, 0.0};
+    }
+
+    /// the weight of [channel] in the SoLoud channel order: 0 for the LFE,
+    /// 1.41 for the surrounds
+    double loudnessChannelWeight(unsigned int channel, unsigned int channels)
+    {
+        if ((channels == 6 || channels == 8) && channel == 3)
+            return 0.0;
+        if ((channels == 4 && channel >= 2) || ((channels == 6 || channels == 8) && channel >= 4))
+            return 1.41;
+        return 1.0;
+    }
+
+    float loudnessDb(double power)
+    {
+        return power > 0.0 ? (float)(-0.691 + 10.0 * log10(power)) : -std::numeric_limits<float>::infinity();
+    }
+}
+
+LoudnessMeter::LoudnessMeter(SoundReader &reader)
+    : mIntegrated(-std::numeric_limits<float>::infinity()),
+      mTruePeak(-std::numeric_limits<float>::infinity())
+{
+    const unsigned int channels = reader.getChannels() > 0 ? reader.getChannels() : 1;
+    const double samplerate = reader.getSamplerate() > 0.0f ? reader.getSamplerate() : 44100.0;
+    const unsigned int stepFrames = std::max(1u, (unsigned int)lround(samplerate / 10.0));
+
+    std::vector<LoudnessBiquad> shelves(channels), highPasses(channels);
+    std::vector<double> weights(channels);
+    for (unsigned int c = 0; c < channels; c++)
+    {
+        kWeighting(samplerate, shelves[c], highPasses[c]);
+        weights[c] = loudnessChannelWeight(c, channels);
+    }
+
+    // each channel keeps its last samples before the block for the upsampling
+    const unsigned int history = kTruePeakTaps - 1;
+    std::vector<float> block(SOUND_READER_BLOCK * channels);
+    std::vector<float> upsampling((history + SOUND_READER_BLOCK) * channels, 0.0f);
+
+    std::vector<double> steps;
+    double stepEnergy = 0.0, totalEnergy = 0.0;
+    unsigned int stepPosition = 0, totalFrames = 0;
+    float peak = 0.0f;
+
+    unsigned int n;
+    while ((n = reader.read(block.data(), SOUND_READER_BLOCK)) > 0)
+    {
+        for (unsigned int i = 0; i < n;)
+        {
+            // up to the end of the current step
+            const unsigned int count = std::min(n - i, stepFrames - stepPosition);
+            for (unsigned int c = 0; c < channels; c++)
+            {
+                if (weights[c] == 0.0)
+                    continue;
+                const float *samples = block.data() + c * SOUND_READER_BLOCK + i;
+                double squares = 0.0;
+                for (unsigned int j = 0; j < count; j++)
+                {
+                    const double y = highPasses[c].process(shelves[c].process(samples[j]));
+                    squares += y * y;
+                }
+                stepEnergy += weights[c] * squares;
+            }
+            i += count;
+            stepPosition += count;
+            if (stepPosition == stepFrames)
+            {
+                steps.push_back(stepEnergy / stepFrames);
+                totalEnergy += stepEnergy;
+                stepEnergy = 0.0;
+                stepPosition = 0;
+            }
+        }
+        totalFrames += n;
+
+        for (unsigned int c = 0; c < channels; c++)
+        {
+            float *buffer = upsampling.data() + c * (history + SOUND_READER_BLOCK);
+            std::copy(block.begin() + c * SOUND_READER_BLOCK, block.begin() + c * SOUND_READER_BLOCK + n,
+                      buffer + history);
+            for (unsigned int j = 0; j < n; j++)
+            {
+                peak = std::max(peak, fabsf(buffer[history + j]));
+                for (int p = 0; p < 4; p++)
+                {
+                    float y = 0.0f;
+                    for (int t = 0; t < kTruePeakTaps; t++)
+                        y += kTruePeakPhases[p][t] * buffer[j + t];
+                    peak = std::max(peak, fabsf(y));
+                }
+            }
+            std::copy(buffer + n, buffer + n + history, buffer);
+        }
+    }
+    if (reader.isCancelled())
+        return;
+
+    totalEnergy += stepEnergy;
+    std::vector<double> blocks;
+    for (size_t b = 0; b + kLoudnessStepsPerBlock <= steps.size(); b++)
+    {
+        double power = 0.0;
+        for (unsigned int s = 0; s < kLoudnessStepsPerBlock; s++)
+            power += steps[b + s];
+        blocks.push_back(power / kLoudnessStepsPerBlock);
+    }
+    if (blocks.empty() && totalFrames > 0)
+        blocks.push_back(totalEnergy / totalFrames);
+
+    // absolute then relative gating
+    double sum = 0.0;
+    unsigned int count = 0;
+    for (double power : blocks)
+        if (loudnessDb(power) > kLoudnessAbsoluteGate)
+        {
+            sum += power;
+            count++;
+        }
+    if (count > 0)
+    {
+        const float relativeGate = loudnessDb(sum / count) + kLoudnessRelativeGate;
+        double gated = 0.0;
+        unsigned int gatedCount = 0;
+        for (double power : blocks)
+        {
+            const float loudness = loudnessDb(power);
+            if (loudness > kLoudnessAbsoluteGate && loudness > relativeGate)
+            {
+                gated += power;
+                gatedCount++;
+            }
+        }
+        mIntegrated = loudnessDb(gated / gatedCount);
+    }
+    mTruePeak = peak > 0.0f ? 20.0f * log10f(peak) : -std::numeric_limits<float>::infinity();
+}
@@ -0,0 +1,30 @@
+#ifndef LOUDNESS_METER_H
+#define LOUDNESS_METER_H
+
+#include "sound_reader.h"
+
+/// EBU R128 integrated loudness and true peak of a whole sound, computed
+/// offline.
+///
+/// The channels are K-weighted as in ITU-R BS.1770-4 and their power is
+/// gated in 400 ms blocks overlapping by 75%, first at -70 LUFS and then
+/// 10 LU below the loudness of the remaining blocks. A sound shorter than a
+/// block is measured as a single block. The true peak is the highest sample
+/// of the signal upsampled 4 times.
+class LoudnessMeter
+{
+public:
+    explicit LoudnessMeter(SoundReader &reader);
+
+    /// @return the integrated loudness in LUFS, -infinity if the sound is
+    /// silent.
+    float getIntegrated() const { return mIntegrated; }
+    /// @return the true peak in dBTP, -infinity if the sound is silent.
+    float getTruePeak() const { return mTruePeak; }
+
+private:
+    float mIntegrated;
+    float mTruePeak;
+};
+
+#endif // LOUDNESS_METER_H
@@ -0,0 +1,318 @@
+#include "rhythm_analysis.h"
+#include "spectrogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+
+namespace
+{
+    /// onset strength frames per second
+    const float kRhythmFrameRate = 100.0f;
+
+    /// frames computed by each thread at least
+    const unsigned int kRhythmRowsPerThread = 256;
+
+    /// spectrogram rows computed at once by a thread
+    const unsigned int kRhythmChunkRows = 64;
+
+    /// log(1 + k * magnitude) compression of the bands before the flux
+    const float kFluxCompression = 1000.0f;
+
+    /// the bands of the flux, 4 per octave from the lowest one, so that a
+    /// kick weighs as much as a hi-hat spread over hundreds of bins
+    const float kFluxLowestBand = 30.0f;
+    const float kFluxBandsPerOctave = 4.0f;
+
+    /// onset peak picking, in frames: a peak is the maximum from [pre] frames
+    /// before to [post] frames after, and at least [delta] above the average
+    /// of the same neighbourhood widened to [avg] frames
+    const int kOnsetPreMax = 3;
+    const int kOnsetPostMax = 1;
+    const int kOnsetAvg = 10;
+    const float kOnsetDelta = 0.07f;
+    /// frames after an onset before the next one
+    const int kOnsetWait = 3;
+
+    /// tempo range and prior, centred on 120 BPM with a 1 octave deviation
+    const float kTempoMinBpm = 40.0f;
+    const float kTempoMaxBpm = 240.0f;
+    const float kTempoPriorBpm = 120.0f;
+
+    /// how strictly the beats keep the tempo
+    const float kBeatTightness = 100.0f;
+}
+
+RhythmAnalysis::RhythmAnalysis(SoundReader &reader)
+    : mSamplerate(reader.getSamplerate() > 0.0f ? reader.getSamplerate() : 44100.0f),
+      mPeriod(0.0f),
+      mBpm(0.0f)
+{
+    // about 23 ms frames every 10 ms
+    mHop = std::max(1u, (unsigned int)lroundf(mSamplerate / kRhythmFrameRate));
+    mSize = 64;
+    while (mSize < 16384 && mSize * 2 <= mSamplerate / 32.0f)
+        mSize *= 2;
+    mSize = std::max(mSize, mHop);
+
+    const unsigned int bins = mSize / 2 + 1;
+    const float binWidth = mSamplerate / mSize;
+    mBandEdges.push_back(1);
+    for (float f = kFluxLowestBand * 2.0f; f < mSamplerate / 2.0f; f *= powf(2.0f, 1.0f / kFluxBandsPerOctave))
+    {
+        const unsigned int edge = (unsigned int)ceilf(f / binWidth);
+        if (edge > mBandEdges.back() && edge < bins)
+            mBandEdges.push_back(edge);
+    }
+    mBandEdges.push_back(bins);
+
+    const unsigned int frames = reader.getFrames();
+    const unsigned int channels = reader.getChannels() > 0 ? reader.getChannels() : 1;
+    const float *data = reader.getData();
+    std::vector<float> mono;
+    if (data == nullptr)
+        reader.readMono(mono);
+
+    const unsigned int rows = Spectrogram::rowCount(frames, mHop);
+    if (rows == 0 || reader.isCancelled())
+        return;
+    mStrength.assign(rows, 0.0f);
+
+    const Spectrogram spectrogram(mSize, mHop, SPECTROGRAM_HANN);
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, rows / kRhythmRowsPerThread + 1);
+    const unsigned int perThread = (rows + threads - 1) / threads;
+    std::vector<std::future<void>> jobs;
+    for (unsigned int first = 0; first < rows; first += perThread)
+        jobs.push_back(std::async(std::launch::async, &RhythmAnalysis::computeFlux, this,
+                                  std::cref(spectrogram),
+                                  data != nullptr ? data : mono.data(), frames,
+                                  data != nullptr ? channels : 1,
+                                  first, std::min(first + perThread, rows)));
+    for (auto &job : jobs)
+        job.wait();
+
+    // normalized from 0 to 1
+    const auto range = std::minmax_element(mStrength.begin(), mStrength.end());
+    const float min = *range.first;
+    const float span = *range.second - min;
+    for (float &s : mStrength)
+        s = span > 0.0f ? (s - min) / span : 0.0f;
+
+    detectOnsets();
+    estimateTempo();
+    trackBeats();
+}
+
+void RhythmAnalysis::computeFlux(const Spectrogram &spectrogram,
+                                 const float *data, unsigned int frames, unsigned int channels,
+                                 unsigned int first, unsigned int last)
+{
+    const unsigned int bins = spectrogram.getBins();
+    const unsigned int bands = (unsigned int)mBandEdges.size() - 1;
+    std::vector<float> block(kRhythmChunkRows * bins);
+    std::vector<float> previous(bands);
+
+    // the frame before [first] is only needed for its bands, silence
+    // before the first one
+    unsigned int row = first > 0 ? first - 1 : 0;
+    while (row < last)
+    {
+        const unsigned int end = std::min(row + kRhythmChunkRows, last);
+        spectrogram.computeRows(data, frames, channels, row, end, block.data(), nullptr, 0.0f);
+        for (unsigned int r = row; r < end; r++)
+        {
+            const float *magnitudes = block.data() + (size_t)(r - row) * bins;
+            float flux = 0.0f;
+            for (unsigned int b = 0; b < bands; b++)
+            {
+                float sum = 0.0f;
+                for (unsigned int k = mBandEdges[b]; k < mBandEdges[b + 1]; k++)
+                    sum += magnitudes[k];
+                const float level = logf(1.0f + kFluxCompression * sum);
+                if (level > previous[b])
+                    flux += level - previous[b];
+                previous[b] = level;
+            }
+            if (r >= first)
+                mStrength[r] = flux;
+        }
+        row = end;
+    }
+}
+
+void RhythmAnalysis::detectOnsets()
+{
+    const int count = (int)mStrength.size();
+    std::vector<double> sums(count + 1, 0.0);
+    for (int i = 0; i < count; i++)
+        sums[i + 1] = sums[i] + mStrength[i];
+
+    int lastOnset = -kOnsetWait - 1;
+    for (int n = 0; n < count; n++)
+    {
+        const float s = mStrength[n];
+        if (n - lastOnset <= kOnsetWait)
+            continue;
+
+        bool isPeak = true;
+        for (int i = std::max(0, n - kOnsetPreMax); i <= std::min(count - 1, n + kOnsetPostMax) && isPeak; i++)
+            isPeak = mStrength[i] <= s;
+        if (!isPeak)
+            continue;
+
+        const int from = std::max(0, n - kOnsetAvg);
+        const int to = std::min(count, n + kOnsetAvg + 1);
+        const float average = (float)((sums[to] - sums[from]) / (to - from));
+        if (s >= average + kOnsetDelta)
+        {
+            mOnsets.push_back(frameTime(n));
+            lastOnset = n;
+        }
+    }
+}
+
+void RhythmAnalysis::estimateTempo()
+{
+    const float frameRate = mSamplerate / mHop;
+    const int count = (int)mStrength.size();
+    const int minLag = std::max(1, (int)floorf(frameRate * 60.0f / kTempoMaxBpm));
+    const int maxLag = std::min(count - 2, (int)ceilf(frameRate * 60.0f / kTempoMinBpm));
+    if (maxLag <= minLag)
+        return;
+
+    double mean = 0.0;
+    for (float s : mStrength)
+        mean += s;
+    mean /= count;
+
+    // autocorrelation weighted by a log-normal prior on the period
+    const float priorLag = frameRate * 60.0f / kTempoPriorBpm;
+    std::vector<float> weighted(maxLag + 2, 0.0f);
+    for (int lag = minLag - 1; lag <= maxLag + 1; lag++)
+    {
+        if (lag < 1)
+            continue;
+        double sum = 0.0;
+        for (int i = 0; i + lag < count; i++)
+            sum += (mStrength[i] - mean) * (mStrength[i + lag] - mean);
+        const float octaves = log2f(lag / priorLag);
+        weighted[lag] = (float)(sum / count) * expf(-0.5f * octaves * octaves);
+    }
+
+    int best = minLag;
+    for (int lag = minLag + 1; lag <= maxLag; lag++)
+        if (weighted[lag] > weighted[best])
+            best = lag;
+    if (weighted[best] <= 0.0f)
+        return;
+
+    // refine the period between the frames
+    float period = (float)best;
+    const float a = weighted[best - 1], b = weighted[best], c = weighted[best + 1];
+    const float curvature = a - 2.0f * b + c;
+    if (curvature < 0.0f)
+        period += 0.5f * (a - c) / curvature;
+
+    mPeriod = period;
+    mBpm = frameRate * 60.0f / period;
+}
+
+void RhythmAnalysis::trackBeats()
+{
+    if (mPeriod <= 0.0f)
+        return;
+    const int count = (int)mStrength.size();
+
+    double mean = 0.0, squares = 0.0;
+    for (float s : mStrength)
+    {
+        mean += s;
+        squares += s * s;
+    }
+    mean /= count;
+    const float deviation = (float)sqrt(std::max(0.0, squares / count - mean * mean));
+    if (deviation <= 0.0f)
+        return;
+
+    // the onset strength smoothed around each frame, in deviations
+    const int radius = (int)lroundf(mPeriod);
+    std::vector<float> kernel(radius * 2 + 1);
+    for (int j = -radius; j <= radius; j++)
+    {
+        const float x = j * 32.0f / mPeriod;
+        kernel[j + radius] = expf(-0.5f * x * x);
+    }
+    std::vector<float> local(count, 0.0f);
+    for (int t = 0; t < count; t++)
+    {
+        float sum = 0.0f;
+        for (int j = std::max(-radius, -t); j <= radius && t + j < count; j++)
+            sum += mStrength[t + j] * kernel[j + radius];
+        local[t] = sum / deviation;
+    }
+
+    // the best score of a path of beats ending at each frame
+    const int minGap = std::max(1, (int)lroundf(mPeriod / 2.0f));
+    const int maxGap = std::max(minGap, (int)lroundf(mPeriod * 2.0f));
+    std::vector<float> penalty(maxGap + 1, 0.0f);
+    for (int gap = minGap; gap <= maxGap; gap++)
+    {
+        const float x = logf(gap / mPeriod);
+        penalty[gap] = -kBeatTightness * x * x;
+    }
+    std::vector<float> score(count);
+    std::vector<int> backlink(count, -1);
+    for (int t = 0; t < count; t++)
+    {
+        float best = 0.0f;
+        for (int gap = minGap; gap <= maxGap && gap <= t; gap++)
+        {
+            const float candidate = score[t - gap] + penalty[gap];
+            if (backlink[t] < 0 || candidate > best)
+            {
+                best = candidate;
+                backlink[t] = t - gap;
+            }
+        }
+        score[t] = local[t] + (backlink[t] >= 0 ? best : 0.0f);
+    }
+
+    // end on the last peak of the score above half the median peak
+    std::vector<float> peaks;
+    for (int t = 1; t + 1 < count; t++)
+        if (score[t] >= score[t - 1] && score[t] > score[t + 1])
+            peaks.push_back(score[t]);
+    if (peaks.empty())
+        return;
+    std::nth_element(peaks.begin(), peaks.begin() + peaks.size() / 2, peaks.end());
+    const float threshold = 0.5f * peaks[peaks.size() / 2];
+    int last = -1;
+    for (int t = count - 2; t >= 1 && last < 0; t--)
+        if (score[t] >= score[t - 1] && score[t] > score[t + 1] && score[t] >= threshold)
+            last = t;
+
+    std::vector<int> beats;
+    for (int t = last; t >= 0; t = backlink[t])
+        beats.push_back(t);
+    std::reverse(beats.begin(), beats.end());
+
+    // drop the weak beats before the music starts and after it ends
+    double beatSquares = 0.0;
+    for (int b : beats)
+        beatSquares += local[b] * local[b];
+    const float weak = beats.empty() ? 0.0f : 0.5f * (float)sqrt(beatSquares / beats.size());
+    size_t from = 0, to = beats.size();
+    while (from < to && local[beats[from]] < weak)
+        from++;
+    while (to > from && local[beats[to - 1]] < weak)
+        to--;
+    for (size_t i = from; i < to; i++)
+        mBeats.push_back(frameTime(beats[i]));
+}
+
+float RhythmAnalysis::frameTime(unsigned int frame) const
+{
+    return (frame * mHop + mSize / 2) / mSamplerate;
+}
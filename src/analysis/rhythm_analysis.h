@@ -0,0 +1,57 @@
+#ifndef RHYTHM_ANALYSIS_H
+#define RHYTHM_ANALYSIS_H
+
+#include "sound_reader.h"
+
+#include <vector>
+
+class Spectrogram;
+
+/// Onsets, tempo and beats of a whole sound, computed offline.
+///
+/// The onset strength is the spectral flux of the log magnitudes in quarter
+/// octave bands, 100 frames per second. Its peaks above a moving average are the onsets, its
+/// autocorrelation weighted around 120 BPM gives the tempo, and the beats
+/// are the path through its peaks spaced closest to that tempo, found by
+/// dynamic programming.
+class RhythmAnalysis
+{
+public:
+    explicit RhythmAnalysis(SoundReader &reader);
+
+    /// @return the tempo in beats per minute, 0 if none was found.
+    float getBpm() const { return mBpm; }
+    /// @return the onset times in seconds.
+    const std::vector<float> &getOnsets() const { return mOnsets; }
+    /// @return the beat times in seconds.
+    const std::vector<float> &getBeats() const { return mBeats; }
+
+private:
+    /// @brief fill [mStrength] with the spectral flux of the frames
+    /// [first, last) of the planar [data].
+    void computeFlux(const Spectrogram &spectrogram,
+                     const float *data, unsigned int frames, unsigned int channels,
+                     unsigned int first, unsigned int last);
+    void detectOnsets();
+    void estimateTempo();
+    void trackBeats();
+
+    /// @return the time in seconds of the onset strength at [frame].
+    float frameTime(unsigned int frame) const;
+
+    unsigned int mSize;
+    unsigned int mHop;
+    float mSamplerate;
+    /// the first bin of each band of the flux, then the number of bins
+    std::vector<unsigned int> mBandEdges;
+    /// onset strength per frame, from 0 to 1
+    std::vector<float> mStrength;
+    /// the beat period in frames
+    float mPeriod;
+
+    float mBpm;
+    std::vector<float> mOnsets;
+    std::vector<float> mBeats;
+};
+
+#endif // RHYTHM_ANALYSIS_H
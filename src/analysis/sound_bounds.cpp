@@ -0,0 +1,206 @@
+#include "sound_bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /// independent accumulators of the scans, a multiple of the SIMD width
+    const unsigned int kBoundsLanes = 8;
+
+    /// frames scanned at once before looking for the exact frame
+    const unsigned int kSilenceBlock = 256;
+
+    /// kept before and after the audible part, not to cut a soft attack
+    const float kSilencePadSeconds = 0.005f;
+
+    /// the zero crossings are searched this close to the bounds
+    const float kZeroCrossingWindowSeconds = 0.05f;
+
+    /// the start of the loop compared with each candidate end
+    const float kCorrelationWindowSeconds = 0.05f;
+    /// the candidate ends are at most this far from the end
+    const float kCorrelationRangeSeconds = 2.0f;
+
+    float boundsDot(const float *a, const float *b, unsigned int count)
+    {
+        float lanes[kBoundsLanes] = {0.0f};
+        unsigned int i = 0;
+        for (; i + kBoundsLanes <= count; i += kBoundsLanes)
+            for (unsigned int l = 0; l < kBoundsLanes; l++)
+                lanes[l] += a[i + l] * b[i + l];
+        for (; i < count; i++)
+            lanes[0] += a[i] * b[i];
+        float sum = 0.0f;
+        for (unsigned int l = 0; l < kBoundsLanes; l++)
+            sum += lanes[l];
+        return sum;
+    }
+}
+
+SoundBounds::SoundBounds(const float *data, unsigned int frames, unsigned int channels, float samplerate)
+    : mData(data),
+      mFrames(frames),
+      mChannels(channels > 0 ? channels : 1),
+      mSamplerate(samplerate),
+      mStart(0),
+      mEnd(frames),
+      mLoopStart(0),
+      mLoopEnd(frames)
+{
+}
+
+float SoundBounds::peak(unsigned int from, unsigned int to) const
+{
+    float lanes[kBoundsLanes] = {0.0f};
+    const unsigned int count = to - from;
+    for (unsigned int c = 0; c < mChannels; c++)
+    {
+        const float *samples = mData + (size_t)c * mFrames + from;
+        unsigned int i = 0;
+        for (; i + kBoundsLanes <= count; i += kBoundsLanes)
+            for (unsigned int l = 0; l < kBoundsLanes; l++)
+                lanes[l] = std::max(lanes[l], fabsf(samples[i + l]));
+        for (; i < count; i++)
+            lanes[0] = std::max(lanes[0], fabsf(samples[i]));
+    }
+    return *std::max_element(lanes, lanes + kBoundsLanes);
+}
+
+std::vector<float> SoundBounds::mix(unsigned int from, unsigned int to) const
+{
+    std::vector<float> mono(to - from, 0.0f);
+    const float gain = 1.0f / mChannels;
+    for (unsigned int c = 0; c < mChannels; c++)
+    {
+        const float *samples = mData + (size_t)c * mFrames + from;
+        for (unsigned int i = 0; i < to - from; i++)
+            mono[i] += samples[i] * gain;
+    }
+    return mono;
+}
+
+void SoundBounds::trimSilence(float thresholdDb)
+{
+    const float threshold = powf(10.0f, thresholdDb / 20.0f);
+
+    // the first block above the threshold, then its first frame above it
+    unsigned int first = mFrames;
+    for (unsigned int block = 0; block < mFrames && first == mFrames; block += kSilenceBlock)
+    {
+        const unsigned int end = std::min(block + kSilenceBlock, mFrames);
+        if (peak(block, end) > threshold)
+            for (unsigned int i = block; i < end && first == mFrames; i++)
+                if (peak(i, i + 1) > threshold)
+                    first = i;
+    }
+    if (first == mFrames)
+    {
+        mStart = 0;
+        mEnd = std::min(1u, mFrames);
+        mLoopStart = mStart;
+        mLoopEnd = mEnd;
+        return;
+    }
+
+    unsigned int last = first;
+    for (unsigned int blockEnd = mFrames; blockEnd > first && last == first; blockEnd -= std::min(blockEnd, kSilenceBlock))
+    {
+        const unsigned int start = blockEnd > kSilenceBlock ? blockEnd - kSilenceBlock : 0;
+        if (peak(start, blockEnd) > threshold)
+            for (unsigned int i = blockEnd; i > start && last == first; i--)
+                if (peak(i - 1, i) > threshold)
+                    last = i - 1;
+    }
+
+    const unsigned int pad = (unsigned int)lroundf(kSilencePadSeconds * mSamplerate);
+    mStart = first > pad ? first - pad : 0;
+    mEnd = std::min(mFrames, last + 1 + pad);
+    mLoopStart = mStart;
+    mLoopEnd = mEnd;
+}
+
+bool SoundBounds::findLoop(LoopSearch search)
+{
+    mLoopStart = mStart;
+    mLoopEnd = mEnd;
+    switch (search)
+    {
+    case LOOP_SEARCH_ZERO_CROSSING:
+        return findZeroCrossingLoop();
+    case LOOP_SEARCH_CORRELATION:
+        return findCorrelationLoop();
+    case LOOP_SEARCH_NONE:
+        break;
+    }
+    return true;
+}
+
+bool SoundBounds::findZeroCrossingLoop()
+{
+    const unsigned int window = std::min((unsigned int)lroundf(kZeroCrossingWindowSeconds * mSamplerate),
+                                         (mEnd - mStart) / 4);
+    if (window < 2)
+        return false;
+
+    // both on a rising crossing: the jump continues the waveform
+    const std::vector<float> head = mix(mStart, mStart + window);
+    const std::vector<float> tail = mix(mEnd - window, mEnd);
+    unsigned int start = 0, end = 0;
+    for (unsigned int i = 1; i < window && start == 0; i++)
+        if (head[i - 1] < 0.0f && head[i] >= 0.0f)
+            start = i;
+    for (unsigned int i = window - 1; i >= 1 && end == 0; i--)
+        if (tail[i - 1] < 0.0f && tail[i] >= 0.0f)
+            end = i;
+    if (start == 0 || end == 0)
+        return false;
+
+    mLoopStart = mStart + start;
+    mLoopEnd = mEnd - window + end;
+    return true;
+}
+
+bool SoundBounds::findCorrelationLoop()
+{
+    const unsigned int length = mEnd - mStart;
+    const unsigned int window = (unsigned int)lroundf(kCorrelationWindowSeconds * mSamplerate);
+    const unsigned int range = std::min((unsigned int)lroundf(kCorrelationRangeSeconds * mSamplerate), length / 2);
+    if (window == 0 || range <= window || length < window * 4)
+        return false;
+
+    const std::vector<float> reference = mix(mStart, mStart + window);
+    const double referenceEnergy = boundsDot(reference.data(), reference.data(), window);
+    if (referenceEnergy <= 0.0)
+        return false;
+
+    // the candidate ends [first, last], each followed by [window] frames,
+    // the latest of equal ones for the longest loop
+    const unsigned int first = mEnd - range;
+    const unsigned int last = mEnd - window;
+    const std::vector<float> region = mix(first, mEnd);
+    double energy = boundsDot(region.data(), region.data(), window);
+
+    unsigned int best = 0;
+    float bestScore = -2.0f;
+    for (unsigned int k = 0; k <= last - first; k++)
+    {
+        if (energy > 0.0)
+        {
+            const float score = (float)(boundsDot(region.data() + k, reference.data(), window) /
+                                        sqrt(energy * referenceEnergy));
+            if (score >= bestScore)
+            {
+                bestScore = score;
+                best = k;
+            }
+        }
+        if (k + window < region.size())
+            energy += (double)region[k + window] * region[k + window] - (double)region[k] * region[k];
+    }
+    if (bestScore <= -2.0f)
+        return false;
+
+    mLoopEnd = first + best;
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef SOUND_BOUNDS_H
+#define SOUND_BOUNDS_H
+
+#include <vector>
+
+typedef enum LoopSearch
+{
+    /// keep the whole sound as the loop
+    LOOP_SEARCH_NONE,
+    /// start and end the loop on rising zero crossings near the bounds
+    LOOP_SEARCH_ZERO_CROSSING,
+    /// end the loop where the sound best matches its start
+    LOOP_SEARCH_CORRELATION
+} LoopSearch_t;
+
+/// Finds where the audible part of a sound starts and ends, and where a
+/// seamless loop can be cut, scanning its planar data once loaded.
+///
+/// The scans run over blocks of independent lanes which the compiler turns
+/// into SIMD, without intrinsics.
+class SoundBounds
+{
+public:
+    SoundBounds(const float *data, unsigned int frames, unsigned int channels, float samplerate);
+
+    /// @brief move the bounds to the first and the last frame above
+    /// [thresholdDb] in any channel, keeping a few milliseconds around
+    /// them. A silent sound keeps a single frame.
+    void trimSilence(float thresholdDb);
+
+    /// @brief find the loop inside the bounds.
+    /// @return false if the sound is too short for [search], the loop is
+    /// then the whole sound.
+    bool findLoop(LoopSearch search);
+
+    /// @return the first frame kept.
+    unsigned int getStart() const { return mStart; }
+    /// @return the frame after the last one kept.
+    unsigned int getEnd() const { return mEnd; }
+    unsigned int getLoopStart() const { return mLoopStart; }
+    unsigned int getLoopEnd() const { return mLoopEnd; }
+
+private:
+    /// @brief mix the frames [from, to) to mono.
+    std::vector<float> mix(unsigned int from, unsigned int to) const;
+    /// @return the peak of all channels in the frames [from, to).
+    float peak(unsigned int from, unsigned int to) const;
+
+    bool findZeroCrossingLoop();
+    bool findCorrelationLoop();
+
+    const float *mData;
+    unsigned int mFrames;
+    unsigned int mChannels;
+    float mSamplerate;
+    unsigned int mStart;
+    unsigned int mEnd;
+    unsigned int mLoopStart;
+    unsigned int mLoopEnd;
+};
+
+#endif // SOUND_BOUNDS_H
@@ -0,0 +1,66 @@
+#include "sound_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+SoundReader::SoundReader(SoLoud::AudioSource *sound, bool stream)
+    : mChannels(sound->mChannels),
+      mSamplerate(sound->mBaseSamplerate),
+      mFrames(0),
+      mData(nullptr),
+      mPosition(0),
+      mCancel(false)
+{
+    if (stream)
+    {
+        SoLoud::WavStream *wavStream = static_cast<SoLoud::WavStream *>(sound);
+        mFrames = wavStream->mSampleCount;
+        mInstance.reset(wavStream->createInstance());
+        mInstance->init(*sound, 0);
+    }
+    else
+    {
+        SoLoud::Wav *wav = static_cast<SoLoud::Wav *>(sound);
+        mFrames = wav->mSampleCount;
+        mData = wav->mData;
+    }
+}
+
+unsigned int SoundReader::read(float *buffer, unsigned int count)
+{
+    if (mCancel)
+        return 0;
+    if (mInstance)
+    {
+        if (count > SOUND_READER_BLOCK)
+            count = SOUND_READER_BLOCK;
+        if (mInstance->hasEnded())
+            return 0;
+        return mInstance->getAudio(buffer, count, count);
+    }
+
+    if (mData == nullptr || mPosition >= mFrames)
+        return 0;
+    const unsigned int n = std::min(count, mFrames - mPosition);
+    for (unsigned int c = 0; c < mChannels; c++)
+        memcpy(buffer + c * count, mData + c * mFrames + mPosition, n * sizeof(float));
+    mPosition += n;
+    return n;
+}
+
+void SoundReader::readMono(std::vector<float> &mono)
+{
+    const unsigned int channels = mChannels > 0 ? mChannels : 1;
+    mono.assign(mFrames, 0.0f);
+    std::vector<float> block(SOUND_READER_BLOCK * channels);
+    unsigned int position = 0;
+    unsigned int n;
+    while (position < mFrames && (n = read(block.data(), SOUND_READER_BLOCK)) > 0)
+    {
+        n = std::min(n, mFrames - position);
+        for (unsigned int c = 0; c < channels; c++)
+            for (unsigned int i = 0; i < n; i++)
+                mono[position + i] += block[c * SOUND_READER_BLOCK + i] / channels;
+        position += n;
+    }
+}
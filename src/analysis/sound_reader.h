@@ -0,0 +1,64 @@
+#ifndef SOUND_READER_H
+#define SOUND_READER_H
+
+#include "soloud.h"
+#include "soloud_wav.h"
+#include "soloud_wavstream.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// Frames decoded at once from a stream.
+#define SOUND_READER_BLOCK 4096
+
+/// Reads the PCM of a loaded sound for the offline analyses: straight from
+/// the decoded data of a [SoLoud::Wav], or by decoding a [SoLoud::WavStream]
+/// with its own instance, which doesn't disturb the voices playing it.
+///
+/// The frames are planar: the samples of each channel follow each other.
+class SoundReader
+{
+public:
+    /// @param sound a [SoLoud::Wav], or a [SoLoud::WavStream] if [stream].
+    SoundReader(SoLoud::AudioSource *sound, bool stream);
+
+    unsigned int getChannels() const { return mChannels; }
+    float getSamplerate() const { return mSamplerate; }
+    /// @return the number of frames. For a stream it is the length declared
+    /// by the file, [read] may return a few more or less.
+    unsigned int getFrames() const { return mFrames; }
+
+    /// @return the planar data of a [SoLoud::Wav], each channel [getFrames]
+    /// long, or nullptr for a stream.
+    const float *getData() const { return mData; }
+
+    /// @brief read the next frames.
+    /// @param buffer receives channel c of frame i at [c * count + i], also
+    /// when fewer frames are left.
+    /// @param count frames to read, at most [SOUND_READER_BLOCK] for a
+    /// stream.
+    /// @return the frames read, 0 at the end.
+    unsigned int read(float *buffer, unsigned int count);
+
+    /// @brief read the remaining frames mixed to mono.
+    /// @param mono receives exactly [getFrames] frames, padded with silence
+    /// if the sound ends early.
+    void readMono(std::vector<float> &mono);
+
+    /// @brief make [read] return 0 from now on, to stop the analysis of a
+    /// sound being disposed. Can be called from any thread.
+    void cancel() { mCancel = true; }
+    bool isCancelled() const { return mCancel; }
+
+private:
+    unsigned int mChannels;
+    float mSamplerate;
+    unsigned int mFrames;
+    const float *mData;
+    unsigned int mPosition;
+    std::atomic<bool> mCancel;
+    std::unique_ptr<SoLoud::AudioSourceInstance> mInstance;
+};
+
+#endif // SOUND_READER_H
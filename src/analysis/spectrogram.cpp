@@ -0,0 +1,178 @@
+#include "spectrogram.h"
+#include "soloud_fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace
+{
+    const double kSpectrogramPi = 3.14159265358979323846;
+
+    /// rows computed by each thread at least
+    const unsigned int kSpectrogramRowsPerThread = 32;
+
+    float spectrogramWindow(SpectrogramWindow window, unsigned int i, unsigned int size)
+    {
+        const double x = 2.0 * kSpectrogramPi * i / size;
+        switch (window)
+        {
+        case SPECTROGRAM_HANN:
+            return (float)(0.5 - 0.5 * cos(x));
+        case SPECTROGRAM_HAMMING:
+            return (float)(0.54 - 0.46 * cos(x));
+        case SPECTROGRAM_BLACKMAN:
+            return (float)(0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x));
+        case SPECTROGRAM_RECTANGULAR:
+            break;
+        }
+        return 1.0f;
+    }
+
+    /// log2 of a positive [x] from its exponent and a series of its
+    /// mantissa, within 1e-5: far below a level of the quantized output.
+    inline float spectrogramLog2(float x)
+    {
+        uint32_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        const float exponent = (float)((int)((bits >> 23) & 255) - 127);
+        bits = (bits & 0x7FFFFF) | 0x3F800000;
+        float m;
+        memcpy(&m, &bits, sizeof(m));
+        // log2(m) = 2 / ln(2) * atanh(t), t = (m - 1) / (m + 1) <= 1 / 3
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+        return exponent + 2.8853901f * t * (1.0f + t2 * (1.0f / 3.0f + t2 * (0.2f + t2 * (1.0f / 7.0f))));
+    }
+}
+
+bool Spectrogram::isValid(unsigned int size, unsigned int hop)
+{
+    return size >= 64 && size <= 16384 && (size & (size - 1)) == 0 &&
+           hop >= 1 && hop <= size;
+}
+
+unsigned int Spectrogram::rowCount(unsigned int frames, unsigned int hop)
+{
+    return frames == 0 ? 0 : (frames + hop - 1) / hop;
+}
+
+Spectrogram::Spectrogram(unsigned int size, unsigned int hop, SpectrogramWindow window)
+    : mSize(size),
+      mHop(hop),
+      mWindow(size)
+{
+    double sum = 0.0;
+    for (unsigned int i = 0; i < size; i++)
+    {
+        mWindow[i] = spectrogramWindow(window, i, size);
+        sum += mWindow[i];
+    }
+    mScale = (float)(2.0 / sum);
+}
+
+void Spectrogram::compute(SoundReader &reader, float *magnitudes, unsigned char *decibels, float minDb)
+{
+    const unsigned int frames = reader.getFrames();
+    const unsigned int channels = reader.getChannels() > 0 ? reader.getChannels() : 1;
+    const float *data = reader.getData();
+
+    // a stream is decoded to mono first
+    std::vector<float> mono;
+    if (data == nullptr)
+        reader.readMono(mono);
+    if (reader.isCancelled())
+        return;
+
+    const unsigned int rows = rowCount(frames, mHop);
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, rows / kSpectrogramRowsPerThread + 1);
+    // an even number of rows per thread, transformed in pairs
+    unsigned int perThread = (rows + threads - 1) / threads;
+    perThread += perThread & 1;
+
+    const size_t bins = getBins();
+    std::vector<std::future<void>> jobs;
+    for (unsigned int first = 0; first < rows; first += perThread)
+        jobs.push_back(std::async(std::launch::async, &Spectrogram::computeRows, this,
+                                  data != nullptr ? data : mono.data(), frames,
+                                  data != nullptr ? channels : 1,
+                                  first, std::min(first + perThread, rows),
+                                  magnitudes != nullptr ? magnitudes + first * bins : nullptr,
+                                  decibels != nullptr ? decibels + first * bins : nullptr,
+                                  minDb));
+    for (auto &job : jobs)
+        job.wait();
+}
+
+void Spectrogram::computeRows(const float *data, unsigned int frames, unsigned int channels,
+                              unsigned int first, unsigned int last,
+                              float *magnitudes, unsigned char *decibels, float minDb) const
+{
+    const unsigned int n = mSize;
+    const unsigned int bins = getBins();
+    const float channelGain = 1.0f / channels;
+    std::vector<float> spectrum(n * 2);
+    // 10 * log10(power) = dbPerLog2 * log2(power), mapped to 0..255
+    const float dbPerLog2 = 3.0102999f;
+    const float levelsPerDb = 255.0f / -minDb;
+
+    // fill the real or the imaginary part with a windowed frame
+    auto fill = [&](unsigned int row, unsigned int part)
+    {
+        const unsigned int start = row * mHop;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            float s = 0.0f;
+            if (row < last && start + i < frames)
+            {
+                for (unsigned int c = 0; c < channels; c++)
+                    s += data[c * frames + start + i];
+                s *= channelGain;
+            }
+            spectrum[i * 2 + part] = s * mWindow[i];
+        }
+    };
+
+    // [power] is the squared magnitude
+    const float scale = 0.25f * mScale * mScale;
+    auto store = [&](unsigned int row, unsigned int k, float power)
+    {
+        const size_t index = (size_t)(row - first) * bins + k;
+        power *= scale;
+        if (magnitudes != nullptr)
+            magnitudes[index] = sqrtf(power);
+        if (decibels != nullptr)
+        {
+            const float db = power > 0.0f ? dbPerLog2 * spectrogramLog2(power) : minDb;
+            const float level = (db - minDb) * levelsPerDb;
+            decibels[index] = (unsigned char)std::min(255.0f, std::max(0.0f, level + 0.5f));
+        }
+    };
+
+    for (unsigned int row = first; row < last; row += 2)
+    {
+        fill(row, 0);
+        fill(row + 1, 1);
+        SoLoud::FFT::fft(spectrum.data(), n * 2);
+
+        // split the transforms of the two real frames:
+        // A[k] = (Z[k] + conj(Z[n-k])) / 2, B[k] = (Z[k] - conj(Z[n-k])) / 2i
+        for (unsigned int k = 0; k < bins; k++)
+        {
+            const unsigned int m = (n - k) % n;
+            const float zr = spectrum[k * 2], zi = spectrum[k * 2 + 1];
+            const float wr = spectrum[m * 2], wi = spectrum[m * 2 + 1];
+            const float ar = zr + wr, ai = zi - wi;
+            store(row, k, ar * ar + ai * ai);
+            if (row + 1 < last)
+            {
+                const float br = zi + wi, bi = zr - wr;
+                store(row + 1, k, br * br + bi * bi);
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include "sound_reader.h"
+
+#include <vector>
+
+typedef enum SpectrogramWindow
+{
+    SPECTROGRAM_HANN,
+    SPECTROGRAM_HAMMING,
+    SPECTROGRAM_BLACKMAN,
+    SPECTROGRAM_RECTANGULAR
+} SpectrogramWindow_t;
+
+/// Short-time Fourier transform of a whole sound, computed offline.
+///
+/// The channels are mixed to mono and cut in frames of [size] samples every
+/// [hop] samples, the last ones padded with silence. Each row of the result
+/// holds the [size] / 2 + 1 bins of a frame. The rows are split across the
+/// cores, and two real frames are transformed by each complex FFT.
+class Spectrogram
+{
+public:
+    /// @return true if [size] is a power of two from 64 to 16384 and [hop]
+    /// from 1 to [size].
+    static bool isValid(unsigned int size, unsigned int hop);
+
+    /// @return the rows of the spectrogram of [frames] frames.
+    static unsigned int rowCount(unsigned int frames, unsigned int hop);
+
+    Spectrogram(unsigned int size, unsigned int hop, SpectrogramWindow window);
+
+    unsigned int getBins() const { return mSize / 2 + 1; }
+
+    /// @brief compute the spectrogram of [reader] into one of [magnitudes]
+    /// or [decibels], each [rowCount] * [getBins] values.
+    /// @param magnitudes if not null, the magnitudes, 1 for a full scale
+    /// sine.
+    /// @param decibels if not null, the levels from [minDb] to 0 dB
+    /// quantized from 0 to 255.
+    void compute(SoundReader &reader, float *magnitudes, unsigned char *decibels, float minDb);
+
+    /// @brief compute the rows [first, last) of the planar [data] of
+    /// [frames] frames, mixing its [channels]. Row [first] is written at the
+    /// start of [magnitudes] or [decibels].
+    void computeRows(const float *data, unsigned int frames, unsigned int channels,
+                     unsigned int first, unsigned int last,
+                     float *magnitudes, unsigned char *decibels, float minDb) const;
+
+private:
+    unsigned int mSize;
+    unsigned int mHop;
+    std::vector<float> mWindow;
+    /// scales the magnitudes to 1 for a full scale sine
+    float mScale;
+};
+
+#endif // SPECTROGRAM_H
@@ -0,0 +1,172 @@
+#include "waveform_peaks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+
+namespace
+{
+    const unsigned int kPeakBucketFrames[WAVEFORM_PEAK_LEVELS] = {256, 1024, 4096};
+
+    /// finest buckets computed by each thread at least
+    const unsigned int kPeakBucketsPerThread = 64;
+
+    void peakBucket(const float *data, unsigned int stride, unsigned int frames, unsigned int channels,
+                    float &min, float &max, float &rms)
+    {
+        min = 0.0f;
+        max = 0.0f;
+        double squares = 0.0;
+        for (unsigned int c = 0; c < channels; c++)
+        {
+            const float *samples = data + c * stride;
+            for (unsigned int i = 0; i < frames; i++)
+            {
+                const float s = samples[i];
+                if (s < min)
+                    min = s;
+                if (s > max)
+                    max = s;
+                squares += s * s;
+            }
+        }
+        rms = frames > 0 ? (float)sqrt(squares / (frames * channels)) : 0.0f;
+    }
+}
+
+WaveformPeaks::WaveformPeaks(SoundReader &reader)
+    : mFrames(0),
+      mSamplerate(reader.getSamplerate())
+{
+    for (unsigned int l = 0; l < WAVEFORM_PEAK_LEVELS; l++)
+        mLevels[l].framesPerBucket = kPeakBucketFrames[l];
+
+    const unsigned int channels = reader.getChannels() > 0 ? reader.getChannels() : 1;
+    const unsigned int bucketFrames = kPeakBucketFrames[0];
+    Level &finest = mLevels[0];
+
+    if (reader.getData() != nullptr)
+    {
+        mFrames = reader.getFrames();
+        const unsigned int buckets = (mFrames + bucketFrames - 1) / bucketFrames;
+        finest.min.resize(buckets);
+        finest.max.resize(buckets);
+        finest.rms.resize(buckets);
+
+        unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, buckets / kPeakBucketsPerThread + 1);
+        const unsigned int perThread = (buckets + threads - 1) / threads;
+        std::vector<std::future<void>> jobs;
+        for (unsigned int first = 0; first < buckets; first += perThread)
+            jobs.push_back(std::async(std::launch::async, &WaveformPeaks::computeBuckets, this,
+                                      reader.getData(), mFrames, channels,
+                                      first, std::min(first + perThread, buckets)));
+        for (auto &job : jobs)
+            job.wait();
+    }
+    else
+    {
+        // the blocks are a multiple of the bucket size until the last one
+        std::vector<float> block(SOUND_READER_BLOCK * channels);
+        unsigned int n;
+        while ((n = reader.read(block.data(), SOUND_READER_BLOCK)) > 0)
+        {
+            for (unsigned int offset = 0; offset < n; offset += bucketFrames)
+                addBucket(block.data() + offset, SOUND_READER_BLOCK, std::min(bucketFrames, n - offset), channels);
+            mFrames += n;
+        }
+    }
+
+    for (unsigned int l = 1; l < WAVEFORM_PEAK_LEVELS; l++)
+        reduce(l);
+}
+
+void WaveformPeaks::computeBuckets(const float *data, unsigned int frames, unsigned int channels,
+                                   unsigned int first, unsigned int last)
+{
+    const unsigned int bucketFrames = kPeakBucketFrames[0];
+    Level &finest = mLevels[0];
+    for (unsigned int b = first; b < last; b++)
+    {
+        const unsigned int start = b * bucketFrames;
+        const unsigned int count = std::min(bucketFrames, frames - start);
+        peakBucket(data + start, frames, count, channels, finest.min[b], finest.max[b], finest.rms[b]);
+    }
+}
+
+void WaveformPeaks::addBucket(const float *block, unsigned int stride, unsigned int frames, unsigned int channels)
+{
+    float min, max, rms;
+    peakBucket(block, stride, frames, channels, min, max, rms);
+    mLevels[0].min.push_back(min);
+    mLevels[0].max.push_back(max);
+    mLevels[0].rms.push_back(rms);
+}
+
+void WaveformPeaks::reduce(unsigned int level)
+{
+    const Level &source = mLevels[level - 1];
+    Level &target = mLevels[level];
+    const unsigned int ratio = target.framesPerBucket / source.framesPerBucket;
+    const unsigned int count = ((unsigned int)source.min.size() + ratio - 1) / ratio;
+    target.min.resize(count);
+    target.max.resize(count);
+    target.rms.resize(count);
+    for (unsigned int b = 0; b < count; b++)
+    {
+        const unsigned int first = b * ratio;
+        const unsigned int last = std::min(first + ratio, (unsigned int)source.min.size());
+        float min = 0.0f, max = 0.0f, squares = 0.0f;
+        for (unsigned int i = first; i < last; i++)
+        {
+            min = std::min(min, source.min[i]);
+            max = std::max(max, source.max[i]);
+            squares += source.rms[i] * source.rms[i];
+        }
+        target.min[b] = min;
+        target.max[b] = max;
+        target.rms[b] = sqrtf(squares / (last - first));
+    }
+}
+
+void WaveformPeaks::query(double startFrame, double endFrame, unsigned int buckets,
+                          float *min, float *max, float *rms) const
+{
+    if (buckets == 0)
+        return;
+    const double framesPerBucket = std::max(0.0, endFrame - startFrame) / buckets;
+
+    // the coarsest level with at most one bucket per output bucket
+    unsigned int l = 0;
+    while (l + 1 < WAVEFORM_PEAK_LEVELS && mLevels[l + 1].framesPerBucket <= framesPerBucket)
+        l++;
+    const Level &level = mLevels[l];
+    const double size = level.framesPerBucket;
+    const long long count = (long long)level.min.size();
+
+    for (unsigned int i = 0; i < buckets; i++)
+    {
+        const double from = startFrame + i * framesPerBucket;
+        long long first = (long long)floor(from / size);
+        long long last = (long long)ceil((from + framesPerBucket) / size);
+        if (last <= first)
+            last = first + 1;
+        first = std::max(first, 0LL);
+        last = std::min(last, count);
+
+        min[i] = 0.0f;
+        max[i] = 0.0f;
+        rms[i] = 0.0f;
+        if (from >= mFrames || first >= last)
+            continue;
+        float squares = 0.0f;
+        for (long long b = first; b < last; b++)
+        {
+            min[i] = std::min(min[i], level.min[b]);
+            max[i] = std::max(max[i], level.max[b]);
+            squares += level.rms[b] * level.rms[b];
+        }
+        rms[i] = sqrtf(squares / (float)(last - first));
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef WAVEFORM_PEAKS_H
+#define WAVEFORM_PEAKS_H
+
+#include "sound_reader.h"
+
+#include <vector>
+
+/// Levels of the pyramid, with 256, 1024 and 4096 frames per bucket.
+#define WAVEFORM_PEAK_LEVELS 3
+
+/// A waveform overview of a sound: the min, max and RMS of its frames in
+/// buckets of 256, 1024 and 4096 frames, all channels together.
+///
+/// Any range is then drawn from the coarsest level that still has a bucket
+/// per pixel, without touching the samples again.
+class WaveformPeaks
+{
+public:
+    /// @brief compute the pyramid. The decoded data of a [SoLoud::Wav] is
+    /// split across the cores, a stream is decoded in one pass.
+    explicit WaveformPeaks(SoundReader &reader);
+
+    /// @return the frames covered.
+    unsigned int getFrames() const { return mFrames; }
+    float getSamplerate() const { return mSamplerate; }
+
+    /// @brief get [buckets] values covering the frames from [startFrame] to
+    /// [endFrame]. The buckets past the end of the sound are 0.
+    void query(double startFrame, double endFrame, unsigned int buckets,
+               float *min, float *max, float *rms) const;
+
+private:
+    struct Level
+    {
+        unsigned int framesPerBucket;
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<float> rms;
+    };
+
+    /// @brief fill the buckets [first, last) of the finest level from the
+    /// planar [data] of [frames] frames.
+    void computeBuckets(const float *data, unsigned int frames, unsigned int channels,
+                        unsigned int first, unsigned int last);
+    /// @brief add a bucket to the finest level from a block read from a
+    /// stream.
+    void addBucket(const float *block, unsigned int stride, unsigned int frames, unsigned int channels);
+    /// @brief build [mLevels[level]] from the previous one.
+    void reduce(unsigned int level);
+
+    unsigned int mFrames;
+    float mSamplerate;
+    Level mLevels[WAVEFORM_PEAK_LEVELS];
+};
+
+#endif // WAVEFORM_PEAKS_H
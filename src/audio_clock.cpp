@@ -0,0 +1,142 @@
+#include "audio_clock.h"
+
+#include <chrono>
+
+namespace
+{
+    int64_t monotonicNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+}
+
+AudioClock::AudioClock(SoLoud::Soloud *soloud)
+    : mSoloud(soloud),
+      mLatencyOffset(0.0),
+      mBlockSamples(0),
+      mSequence(0),
+      mAnchorNanos(0),
+      mAnchorEnd(0),
+      mAnchorSamples(0),
+      mLastOutput(0.0)
+{
+}
+
+void AudioClock::postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd)
+{
+    static_cast<AudioClock *>(aUserData)->onPostMix(aSamples, aBlockEnd);
+}
+
+void AudioClock::reset()
+{
+    mBlockSamples = 0;
+    mSequence.fetch_add(1);
+    mAnchorEnd.store(0);
+    mAnchorSamples.store(0);
+    mSequence.fetch_add(1);
+    mLastOutput.store(0.0);
+}
+
+void AudioClock::setLatencyOffset(double seconds)
+{
+    mLatencyOffset.store(seconds);
+    // the heard time jumps with the latency, let it go back too
+    mLastOutput.store(0.0);
+}
+
+double AudioClock::getLatency() const
+{
+    const double samplerate = mSoloud->getBackendSamplerate();
+    if (samplerate <= 0.0)
+        return mLatencyOffset.load();
+    return mSoloud->getBackendLatency() / samplerate + mLatencyOffset.load();
+}
+
+void AudioClock::onPostMix(unsigned int aSamples, bool aBlockEnd)
+{
+    mBlockSamples += aSamples;
+    if (!aBlockEnd)
+        return;
+
+    // the whole buffer is handed to the device now: its first sample is
+    // heard once the samples already queued are played
+    const uint32_t seq = mSequence.load(std::memory_order_relaxed);
+    mSequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    mAnchorNanos.store(monotonicNanos(), std::memory_order_relaxed);
+    mAnchorEnd.store(mSoloud->getMixedSamples(), std::memory_order_relaxed);
+    mAnchorSamples.store(mBlockSamples, std::memory_order_relaxed);
+    mSequence.store(seq + 2, std::memory_order_release);
+    mBlockSamples = 0;
+}
+
+double AudioClock::getOutputSamples()
+{
+    int64_t anchorNanos;
+    unsigned long long anchorEnd;
+    unsigned int anchorSamples;
+    uint32_t seq;
+    do
+    {
+        seq = mSequence.load(std::memory_order_acquire);
+        anchorNanos = mAnchorNanos.load(std::memory_order_relaxed);
+        anchorEnd = mAnchorEnd.load(std::memory_order_relaxed);
+        anchorSamples = mAnchorSamples.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != mSequence.load(std::memory_order_relaxed));
+
+    if (anchorEnd == 0)
+        return 0.0;
+
+    const double samplerate = mSoloud->getBackendSamplerate();
+    const double latency = getLatency() * samplerate;
+    const double elapsed = (monotonicNanos() - anchorNanos) * 1e-9 * samplerate;
+    // a late callback must not run the clock past the samples mixed
+    const double end = (double)anchorEnd - latency;
+    double output = (double)anchorEnd - anchorSamples - latency + elapsed;
+    if (output > end)
+        output = end;
+    if (output < 0.0)
+        output = 0.0;
+
+    double last = mLastOutput.load();
+    while (output > last && !mLastOutput.compare_exchange_weak(last, output))
+    {
+    }
+    return output > last ? output : last;
+}
+
+bool AudioClock::getVoicePosition(SoLoud::handle handle, double &position)
+{
+    const double output = getOutputSamples();
+    const double samplerate = mSoloud->getBackendSamplerate();
+
+    // the voices and the mixed samples are updated together under the mutex
+    mSoloud->lockAudioMutex_internal();
+    int voice = mSoloud->getVoiceFromHandle_internal(handle);
+    if (voice < 0)
+    {
+        mSoloud->unlockAudioMutex_internal();
+        return false;
+    }
+    SoLoud::AudioSourceInstance *instance = mSoloud->mVoice[voice];
+    position = instance->mStreamPosition;
+    if (!(instance->mFlags & SoLoud::AudioSourceInstance::PAUSED) && samplerate > 0.0)
+    {
+        const double queued = ((double)mSoloud->getMixedSamples() - output) / samplerate;
+        if (queued > 0.0)
+        {
+            // a time stretched voice reads its source at its tempo
+            const double tempo = instance->mProcessor ? instance->mProcessor->getTempo() : 1.0;
+            position -= queued * instance->mOverallRelativePlaySpeed * tempo;
+        }
+    }
+    mSoloud->unlockAudioMutex_internal();
+
+    // a voice started less than the latency ago is not heard yet
+    if (position < 0.0)
+        position = 0.0;
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef AUDIO_CLOCK_H
+#define AUDIO_CLOCK_H
+
+#include "soloud.h"
+
+#include <atomic>
+#include <stdint.h>
+
+/// A high resolution clock of what is being heard, for A/V and lyrics sync.
+///
+/// The engine time and the voices positions only advance once per mixed
+/// buffer, and they are ahead of the speakers by the samples queued in the
+/// device. Each mixed buffer anchors the engine time to the monotonic
+/// clock: in between, the time is interpolated from the monotonic clock,
+/// minus the output latency of the backend and of [setLatencyOffset].
+class AudioClock
+{
+public:
+    AudioClock(SoLoud::Soloud *soloud);
+
+    /// @brief the function to pass to [Soloud::setPostMixCallback]
+    static void postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd);
+
+    /// @brief forget the anchors of a previous engine session.
+    void reset();
+
+    /// @brief extra latency in seconds added to the backend one, ie for
+    /// bluetooth headphones. Can be negative.
+    void setLatencyOffset(double seconds);
+
+    /// @brief the output latency in seconds, offset included.
+    double getLatency() const;
+
+    /// @brief the engine time in samples being heard now. Never goes back.
+    double getOutputSamples();
+
+    /// @brief the position in seconds of the voice [handle] being heard now.
+    /// @return false if the handle is not valid.
+    bool getVoicePosition(SoLoud::handle handle, double &position);
+
+private:
+    void onPostMix(unsigned int aSamples, bool aBlockEnd);
+
+    SoLoud::Soloud *mSoloud;
+    std::atomic<double> mLatencyOffset;
+
+    /// samples of the parts of the current buffer
+    unsigned int mBlockSamples;
+
+    /// last anchor, written by the audio thread under the [mSequence]
+    /// seqlock: odd while being written
+    std::atomic<uint32_t> mSequence;
+    std::atomic<int64_t> mAnchorNanos;
+    std::atomic<unsigned long long> mAnchorEnd;
+    std::atomic<unsigned int> mAnchorSamples;
+
+    /// last time returned, to stay monotonic with the callbacks jitter
+    std::atomic<double> mLastOutput;
+};
+
+#endif // AUDIO_CLOCK_H
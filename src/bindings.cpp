@@ -202,429 +202,1727 @@ extern "C"
         player.setWaveform(hash, newWaveform);
     }
 
+    /////////////////////////////////////////
+    /// push streams
+    /////////////////////////////////////////
+
+    /// Create a new sound which plays PCM data pushed from the caller
+    ///
+    /// [sampleRate] sample rate of the data
+    /// [channels] number of interleaved channels, 1 to 8
+    /// [format]    PCM_F32LE = 0,
+    ///             PCM_S16LE
+    /// [bufferFrames] size of the ring buffer in frames
+    /// [prebufferFrames] frames to buffer before starting the playback and
+    ///     after every underrun
+    /// [hash] return hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors loadPushStream(
+        unsigned int sampleRate,
+        unsigned int channels,
+        int format,
+        unsigned int bufferFrames,
+        unsigned int prebufferFrames,
+        unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadPushStream(
+            sampleRate, channels, format, bufferFrames, prebufferFrames, *hash);
+    }
+
+    /// Get the contiguous free region of the push stream ring buffer.
+    /// Write interleaved frames directly into [data] and then
+    /// call [pushStreamCommit] to make them playable.
+    ///
+    /// [hash] the unique sound hash of a push stream
+    /// [data] return the pointer to write to
+    /// Returns the number of frames which can be written into [data]
+    FFI_PLUGIN_EXPORT unsigned int pushStreamGetWriteSpan(unsigned int hash, void **data)
+    {
+        *data = nullptr;
+        if (!player.isInited())
+            return 0;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return 0;
+        return stream->getWriteSpan(data);
+    }
+
+    /// Commit [frames] frames written into the span given by [pushStreamGetWriteSpan]
+    ///
+    /// [hash] the unique sound hash of a push stream
+    /// [frames] number of frames written
+    /// Returns the number of frames committed
+    FFI_PLUGIN_EXPORT unsigned int pushStreamCommit(unsigned int hash, unsigned int frames)
+    {
+        if (!player.isInited())
+            return 0;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return 0;
+        return stream->commit(frames);
+    }
+
+    /// Copy [frames] interleaved frames from [data] into the push stream
+    ///
+    /// [hash] the unique sound hash of a push stream
+    /// [data] interleaved samples in the format given to [loadPushStream]
+    /// [frames] number of frames in [data]
+    /// Returns the number of frames written. Less than [frames] if the ring is full
+    FFI_PLUGIN_EXPORT unsigned int pushStreamWrite(unsigned int hash, void *data, unsigned int frames)
+    {
+        if (!player.isInited())
+            return 0;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return 0;
+        return stream->write(data, frames);
+    }
+
+    /// Set the number of frames to buffer before starting the playback
+    ///
+    /// [hash] the unique sound hash of a push stream
+    /// [frames]
+    FFI_PLUGIN_EXPORT enum PlayerErrors pushStreamSetPrebuffer(unsigned int hash, unsigned int frames)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return invalidParameter;
+        stream->setPrebufferFrames(frames);
+        return noError;
+    }
+
+    /// Signal that no more data will be pushed. The sound ends when
+    /// the buffered data has been played
+    ///
+    /// [hash] the unique sound hash of a push stream
+    FFI_PLUGIN_EXPORT enum PlayerErrors pushStreamEnd(unsigned int hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return invalidParameter;
+        stream->endOfStream();
+        return noError;
+    }
+
+    /// Get the state of a push stream
+    ///
+    /// [hash] the unique sound hash of a push stream
+    /// [bufferedFrames] return the frames waiting to be played
+    /// [capacityFrames] return the ring buffer size
+    /// [underruns] return how many times the player ran out of data
+    /// [silentFrames] return the frames of silence played because of underruns
+    FFI_PLUGIN_EXPORT enum PlayerErrors getPushStreamInfo(
+        unsigned int hash,
+        unsigned int *bufferedFrames,
+        unsigned int *capacityFrames,
+        unsigned int *underruns,
+        unsigned int *silentFrames)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PushStream *stream = player.getPushStream(hash);
+        if (stream == nullptr)
+            return invalidParameter;
+        *bufferedFrames = stream->getBufferedFrames();
+        *capacityFrames = stream->getCapacityFrames();
+        *underruns = stream->getUnderrunCount();
+        *silentFrames = stream->getSilentFrames();
+        return noError;
+    }
+
+    /////////////////////////////////////////
+    /// playlists
+    /////////////////////////////////////////
+
+    /// Create a new empty playlist. Play it with [play] after adding items
+    ///
+    /// [sampleRate] sample rate the items are converted to
+    /// [channels] number of channels, 1 to 8
+    /// [hash] return hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors loadPlaylist(
+        unsigned int sampleRate,
+        unsigned int channels,
+        unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadPlaylist(sampleRate, channels, *hash);
+    }
+
+    /// Append a file to the playlist. Files are opened and pre-decoded
+    /// shortly before they are needed, so a missing file is only skipped
+    ///
+    /// [hash] the unique sound hash of a playlist
+    /// [completeFileName] the complete file path
+    /// Returns the index of the new item or -1 if [hash] is not a playlist
+    FFI_PLUGIN_EXPORT int playlistAddItem(unsigned int hash, char *completeFileName)
+    {
+        if (!player.isInited())
+            return -1;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return -1;
+        return (int)playlist->addItem(completeFileName);
+    }
+
+    /// Remove all the items. The item playing goes on to its end and the
+    /// items added afterwards play from the first one
+    ///
+    /// [hash] the unique sound hash of a playlist
+    FFI_PLUGIN_EXPORT enum PlayerErrors playlistClear(unsigned int hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return invalidParameter;
+        playlist->clear();
+        return noError;
+    }
+
+    /// Set the crossfade between items
+    ///
+    /// [hash] the unique sound hash of a playlist
+    /// [seconds] length of the equal-power crossfade. 0 for a gapless splice
+    FFI_PLUGIN_EXPORT enum PlayerErrors playlistSetCrossfade(unsigned int hash, float seconds)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return invalidParameter;
+        playlist->setCrossfade(seconds);
+        return noError;
+    }
+
+    /// Restart from the first item after the last one
+    ///
+    /// [hash] the unique sound hash of a playlist
+    /// [loop] whether to loop the playlist
+    FFI_PLUGIN_EXPORT enum PlayerErrors playlistSetLoop(unsigned int hash, bool loop)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return invalidParameter;
+        playlist->setLoop(loop);
+        return noError;
+    }
+
+    /// Jump to the next item, crossfading if a crossfade is set
+    ///
+    /// [hash] the unique sound hash of a playlist
+    FFI_PLUGIN_EXPORT enum PlayerErrors playlistSkip(unsigned int hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return invalidParameter;
+        playlist->skip();
+        return noError;
+    }
+
+    /// Get the index of the item currently playing
+    ///
+    /// [hash] the unique sound hash of a playlist
+    /// Returns the item index or -1 if nothing is playing
+    FFI_PLUGIN_EXPORT int playlistGetCurrentIndex(unsigned int hash)
+    {
+        if (!player.isInited())
+            return -1;
+        Playlist *playlist = player.getPlaylist(hash);
+        if (playlist == nullptr)
+            return -1;
+        return playlist->getCurrentIndex();
+    }
+
+    /// Create a new polyphonic instrument. Play it once, then send it notes
+    ///
+    /// [waveform] WAVE_SQUARE = 0, WAVE_SAW, WAVE_SIN, WAVE_TRIANGLE,
+    ///     WAVE_BOUNCE, WAVE_JAWS, WAVE_HUMPS, WAVE_FSQUARE, WAVE_FSAW
+    /// [maxVoices] notes playing at once, 1 to 32
+    /// [hash] return hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors loadPolySynth(
+        int waveform,
+        unsigned int maxVoices,
+        unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadPolySynth(waveform, maxVoices, *hash);
+    }
+
+    /// Start a note
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// [note] MIDI note number, can be fractional. It identifies the note
+    /// [velocity] 0 to 1
+    /// [glide] if > 0, seconds to glide from the pitch of the previous note
+    /// Returns [PlayerErrors.noError] if success, [PlayerErrors.outOfMemory]
+    /// if too many events are waiting for the audio thread
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthNoteOn(
+        unsigned int hash, float note, float velocity, float glide)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return invalidParameter;
+        return synth->noteOn(note, velocity, glide) ? noError : outOfMemory;
+    }
+
+    /// Release a note
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// [note] the note given to [polySynthNoteOn]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthNoteOff(unsigned int hash, float note)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return invalidParameter;
+        return synth->noteOff(note) ? noError : outOfMemory;
+    }
+
+    /// Glide a playing note to a new pitch
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// [note] the note given to [polySynthNoteOn]
+    /// [pitch] the new MIDI note number
+    /// [glide] seconds to reach [pitch], 0 to jump
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthSetNotePitch(
+        unsigned int hash, float note, float pitch, float glide)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return invalidParameter;
+        return synth->setNotePitch(note, pitch, glide) ? noError : outOfMemory;
+    }
+
+    /// Release all the notes
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthAllNotesOff(unsigned int hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return invalidParameter;
+        return synth->allNotesOff() ? noError : outOfMemory;
+    }
+
+    /// Set the waveform of all the notes
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// [waveform] see [loadPolySynth]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthSetWaveform(unsigned int hash, int waveform)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr || waveform < 0 || waveform > SoLoud::Soloud::WAVE_FSAW)
+            return invalidParameter;
+        synth->setWaveform(waveform);
+        return noError;
+    }
+
+    /// Set the envelope of the notes. Playing notes change from the next sample
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// [attack] [decay] [release] times in seconds
+    /// [sustain] level 0 to 1
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors polySynthSetADSR(
+        unsigned int hash, float attack, float decay, float sustain, float release)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return invalidParameter;
+        synth->setADSR(attack, decay, sustain, release);
+        return noError;
+    }
+
+    /// Get the number of notes sounding, releasing ones included
+    ///
+    /// [hash] the unique sound hash of a polyphonic instrument
+    /// Returns the number of voices or -1 if [hash] is not a polyphonic instrument
+    FFI_PLUGIN_EXPORT int polySynthGetActiveVoices(unsigned int hash)
+    {
+        if (!player.isInited())
+            return -1;
+        PolySynth *synth = player.getPolySynth(hash);
+        if (synth == nullptr)
+            return -1;
+        return (int)synth->getActiveVoices();
+    }
+
+    /// Create a new polyphonic FM instrument. Its notes are played with the
+    /// polySynth* functions
+    ///
+    /// [operators] 4 or 6
+    /// [maxVoices] notes playing at once, 1 to 32
+    /// [hash] return hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors loadFmSynth(
+        unsigned int operators,
+        unsigned int maxVoices,
+        unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadFmSynth(operators, maxVoices, *hash);
+    }
+
+    /// Use one of the preset algorithms
+    ///
+    /// [hash] the unique sound hash of an FM instrument
+    /// [algorithm] 0 to 7
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors fmSynthSetAlgorithm(unsigned int hash, unsigned int algorithm)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        FmSynth *synth = player.getFmSynth(hash);
+        if (synth == nullptr || !synth->setAlgorithm(algorithm))
+            return invalidParameter;
+        return noError;
+    }
+
+    /// Set a custom algorithm
+    ///
+    /// [hash] the unique sound hash of an FM instrument
+    /// [modulators] for each operator, the bit mask of the operators modulating
+    ///     it. Only operators with a higher index can modulate an operator
+    /// [carriers] bit mask of the operators summed to the output
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors fmSynthSetRouting(
+        unsigned int hash, unsigned int *modulators, unsigned int carriers)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        FmSynth *synth = player.getFmSynth(hash);
+        if (synth == nullptr || !synth->setRouting(modulators, carriers))
+            return invalidParameter;
+        return noError;
+    }
+
+    /// Set the parameters of an operator
+    ///
+    /// [hash] the unique sound hash of an FM instrument
+    /// [op] the operator index
+    /// [ratio] frequency ratio to the note
+    /// [detune] fixed frequency offset in Hz
+    /// [level] amplitude of a carrier, modulation index of a modulator
+    /// [feedback] self modulation, 0 to 1
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors fmSynthSetOperator(
+        unsigned int hash, unsigned int op, float ratio, float detune, float level, float feedback)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        FmSynth *synth = player.getFmSynth(hash);
+        if (synth == nullptr || !synth->setOperator(op, ratio, detune, level, feedback))
+            return invalidParameter;
+        return noError;
+    }
+
+    /// Set the envelope of an operator
+    ///
+    /// [hash] the unique sound hash of an FM instrument
+    /// [op] the operator index
+    /// [attack] [decay] [release] times in seconds
+    /// [sustain] level 0 to 1
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors fmSynthSetOperatorEnvelope(
+        unsigned int hash, unsigned int op, float attack, float decay, float sustain, float release)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        FmSynth *synth = player.getFmSynth(hash);
+        if (synth == nullptr || !synth->setOperatorEnvelope(op, attack, decay, sustain, release))
+            return invalidParameter;
+        return noError;
+    }
+
+    /// Create a variation container: playing its hash plays one of the
+    /// given sounds, picked by [mode], with a random pitch and volume.
+    ///
+    /// [soundHashes] the sounds to pick from
+    /// [count] the number of sounds
+    /// [mode] 0 random without repeating the last one, 1 shuffle, 2 sequential
+    /// [hash] return the hash of the container
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors createVariationContainer(unsigned int *soundHashes, unsigned int count, int mode, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.createVariationContainer(soundHashes, count, (VariationMode)mode, *hash);
+    }
+
+    /// Set the ranges of the random pitch and volume of each trigger.
+    ///
+    /// [hash] the hash of a variation container
+    /// [minPitch] [maxPitch] transposition in semitones
+    /// [minVolume] [maxVolume] volume multiplier
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors variationSetRandomization(unsigned int hash, float minPitch, float maxPitch, float minVolume, float maxVolume)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        VariationContainer *container = player.findContainer(hash);
+        if (container == nullptr)
+            return invalidParameter;
+        container->setRandomization(minPitch, maxPitch, minVolume, maxVolume);
+        return noError;
+    }
+
+    /// Render an sfxr preset to a new sound on a worker thread.
+    /// Equal parameters return the same sound.
+    ///
+    /// [preset] 0 coin, 1 laser, 2 explosion, 3 powerup, 4 hurt, 5 jump, 6 blip
+    /// [seed] randomizes the preset
+    /// [hash] return the hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors sfxrLoadPreset(int preset, int seed, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadSfxrPreset(preset, seed, *hash);
+    }
+
+    /// Render an sfxr parameter set to a new sound on a worker thread.
+    /// Equal parameters return the same sound.
+    ///
+    /// [waveType] 0 square, 1 sawtooth, 2 sine, 3 noise
+    /// [values] 24 values: base freq, freq limit, freq ramp, freq delta ramp,
+    /// duty, duty ramp, vibrato strength, speed and delay, envelope attack,
+    /// sustain, decay and punch, low-pass resonance, freq and ramp, high-pass
+    /// freq and ramp, phaser offset and ramp, repeat speed, arpeggio speed
+    /// and mod, volume
+    /// [hash] return the hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors sfxrLoadParams(int waveType, float *values, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadSfxrParams(waveType, values, *hash);
+    }
+
+    /// Render the content of an sfxr .sfs file to a new sound on a worker
+    /// thread. Equal parameters return the same sound.
+    ///
+    /// [mem] the file content
+    /// [length] its length in bytes
+    /// [hash] return the hash of the sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors sfxrLoadMem(unsigned char *mem, unsigned int length, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadSfxrMem(mem, length, *hash);
+    }
+
+    /// Create a granular synthesis sound reading a loaded sound
+    ///
+    /// [wavHash] the unique sound hash of a sound loaded in memory
+    /// [hash] return the hash of the granular sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors loadGranular(unsigned int wavHash, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.loadGranular(wavHash, *hash);
+    }
+
+    /// Set how many grains start per second
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [density] grains per second
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetDensity(unsigned int hash, float density)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr)
+            return invalidParameter;
+        granular->setDensity(density);
+        return noError;
+    }
+
+    /// Set where the grains are read
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [position] 0 for the start of the sound, 1 for the end
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetPosition(unsigned int hash, float position)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr)
+            return invalidParameter;
+        granular->setPosition(position);
+        return noError;
+    }
+
+    /// Set the random offset of the grains around the position
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [spray] the maximum offset in seconds
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetSpray(unsigned int hash, float spray)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr)
+            return invalidParameter;
+        granular->setSpray(spray);
+        return noError;
+    }
+
+    /// Set the transposition of the grains
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [pitch] semitones
+    /// [pitchSpray] maximum random transposition added to each grain, in
+    /// semitones
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetPitch(unsigned int hash, float pitch, float pitchSpray)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr)
+            return invalidParameter;
+        granular->setPitch(pitch, pitchSpray);
+        return noError;
+    }
+
+    /// Set the length of the grains
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [size] seconds
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetSize(unsigned int hash, float size)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr)
+            return invalidParameter;
+        granular->setSize(size);
+        return noError;
+    }
+
+    /// Set the window of the grains
+    ///
+    /// [hash] the unique sound hash of a granular sound
+    /// [window] one of [GrainWindow]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors granularSetWindow(unsigned int hash, enum GrainWindow window)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        Granular *granular = player.getGranular(hash);
+        if (granular == nullptr || window < GRAIN_WINDOW_HANN || window > GRAIN_WINDOW_TRAPEZOID)
+            return invalidParameter;
+        granular->setWindow(window);
+        return noError;
+    }
+
     /// Speech the text given
     ///
-    /// [textToSpeech]
-    /// Returns [PlayerErrors.noError] if success and [handle] sound identifier
-    /// TODO(me): add other T2S parameters
-    FFI_PLUGIN_EXPORT enum PlayerErrors speechText(char *textToSpeech, unsigned int *handle)
+    /// [textToSpeech]
+    /// Returns [PlayerErrors.noError] if success and [handle] sound identifier
+    /// TODO(me): add other T2S parameters
+    FFI_PLUGIN_EXPORT enum PlayerErrors speechText(char *textToSpeech, unsigned int *handle)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return (PlayerErrors)player.textToSpeech(textToSpeech, *handle);
+    }
+
+    /// Speak a text as a new sound, overlapping the other utterances.
+    /// The first phrase plays while the next ones are being converted.
+    ///
+    /// [text] the text to speak
+    /// [hash] return the new sound, or the sound cached by [speechCache]
+    /// [handle] return the voice speaking
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors speechSpeak(char *text, unsigned int *hash, unsigned int *handle)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.speak(text, *hash, *handle);
+    }
+
+    /// Set the voice of the next utterances.
+    ///
+    /// [baseFrequency] base pitch, 1330 by default
+    /// [baseSpeed] 10 by default
+    /// [baseDeclination] fall of the pitch along a phrase, 0.5 by default
+    /// [baseWaveform] 0 saw, 1 triangle, 2 sin, 3 square (default), 4 pulse,
+    /// 5 noise, 6 warble
+    /// [engineRate] synthesize at the rate of the engine instead of 11025 Hz
+    FFI_PLUGIN_EXPORT void speechSetParams(unsigned int baseFrequency, float baseSpeed, float baseDeclination, int baseWaveform, bool engineRate)
+    {
+        if (!player.isInited())
+            return;
+        player.setSpeechParams(baseFrequency, baseSpeed, baseDeclination, baseWaveform, engineRate);
+    }
+
+    /// Synthesize a text now and keep it as a sound played by [speechSpeak].
+    ///
+    /// [text] the text to cache
+    /// [hash] return the cached sound
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors speechCache(char *text, unsigned int *hash)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.cacheSpeech(text, *hash);
+    }
+
+    /// Switch pause state for an already loaded sound identified by [handle]
+    ///
+    /// [handle] the sound handle
+    FFI_PLUGIN_EXPORT void pauseSwitch(unsigned int handle)
+    {
+        if (!player.isInited())
+            return;
+        player.pauseSwitch(handle);
+    }
+
+    /// Pause or unpause already loaded sound identified by [handle]
+    ///
+    /// [handle] the sound handle
+    /// [pause] the sound handle
+    FFI_PLUGIN_EXPORT void setPause(unsigned int handle, bool pause)
+    {
+        if (!player.isInited())
+            return;
+        player.setPause(handle, pause);
+    }
+
+    /// Gets the pause state
+    ///
+    /// [handle] the sound handle
+    /// Return true if paused
+    FFI_PLUGIN_EXPORT int getPause(unsigned int handle)
+    {
+        if (!player.isInited())
+            return false;
+        return player.getPause(handle) ? 1 : 0;
+    }
+
+    /// Set a sound's relative play speed.
+    /// Setting the value to 0 will cause undefined behavior, likely a crash.
+    /// Change the relative play speed of a sample. This changes the effective
+    /// sample rate while leaving the base sample rate alone.
+    ///
+    /// Note that playing a sound at a higher sample rate will require SoLoud
+    /// to request more samples from the sound source, which will require more
+    /// memory and more processing power. Playing at a slower sample rate
+    /// is cheaper.
+    ///
+    /// [handle] the sound handle
+    /// [speed] the new speed
+    FFI_PLUGIN_EXPORT void setRelativePlaySpeed(unsigned int handle, float speed)
+    {
+        if (!player.isInited())
+            return;
+        player.setRelativePlaySpeed(handle, speed);
+    }
+
+    /// Get a sound's relative play speed.
+    /// If an invalid handle is given to getRelativePlaySpeed, it will return 1.
+
+    /// Return the current play speed.
+    /// [handle] the sound handle
+    FFI_PLUGIN_EXPORT float getRelativePlaySpeed(unsigned int handle)
+    {
+        if (!player.isInited())
+            return 1;
+        return player.getRelativePlaySpeed(handle);
+    }
+
+    /// Play a voice at [tempo] times its speed keeping its pitch, and
+    /// transposed by [pitch] semitones keeping its tempo.
+    ///
+    /// [handle] the sound handle
+    /// [mode] 0 WSOLA, for speech, 1 phase vocoder, for music
+    /// [tempo] from 0.25 to 4
+    /// [pitch] semitones from -24 to 24
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors setTimeStretch(unsigned int handle, int mode, float tempo, float pitch)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.setTimeStretch(handle, (TimeStretchMode)mode, tempo, pitch);
+    }
+
+    /// Play a voice without time stretch again.
+    ///
+    /// [handle] the sound handle
+    FFI_PLUGIN_EXPORT void removeTimeStretch(unsigned int handle)
+    {
+        if (!player.isInited())
+            return;
+        player.removeTimeStretch(handle);
+    }
+
+    /// Get the share of a core spent stretching a voice, 0.01 being 1%.
+    ///
+    /// [handle] the sound handle
+    /// Returns 0 if the voice is not stretched
+    FFI_PLUGIN_EXPORT float getTimeStretchLoad(unsigned int handle)
+    {
+        if (!player.isInited())
+            return 0;
+        return player.getTimeStretchLoad(handle);
+    }
+
+    /// Play already loaded sound identified by [handle]
+    ///
+    /// [hash] the unique sound hash of a sound
+    /// [volume] 1.0f full volume
+    /// [pan] 0.0f centered
+    /// [paused] 0 not pause
+    /// Return the handle of the sound, 0 if error
+    FFI_PLUGIN_EXPORT unsigned int play(
+        unsigned int hash,
+        float volume,
+        float pan,
+        bool paused)
+    {
+        if (!player.isInited())
+            return -1;
+        return player.play(hash, volume, pan, paused);
+    }
+
+    /// Limit the voices of a sound playing at once and how often it can be
+    /// triggered. Every play of the sound is checked, including the scheduled
+    /// ones; [play] and [play3d] return 0 for a rejected trigger.
+    ///
+    /// [soundHash] the unique sound hash of a sound
+    /// [maxInstances] 0 for no limit
+    /// [policy] when the limit is reached: 0 stop the oldest voice, 1 stop
+    /// the quietest voice, 2 reject the trigger
+    /// [minRetriggerInterval] seconds of engine time, triggers closer than
+    /// this are rejected
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors setInstanceLimit(unsigned int soundHash, unsigned int maxInstances, int policy, float minRetriggerInterval)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.setInstanceLimit(soundHash, maxInstances, (StealPolicy)policy, minRetriggerInterval);
+    }
+
+    /// Stop already loaded sound identified by [handle] and clear it
+    ///
+    /// [handle]
+    FFI_PLUGIN_EXPORT void stop(unsigned int handle)
+    {
+        if (!player.isInited())
+            return;
+        player.stop(handle);
+    }
+
+    /// Stop all handles of the already loaded sound identified by [hash] and dispose it
+    ///
+    /// [soundHash]
+    FFI_PLUGIN_EXPORT void disposeSound(unsigned int soundHash)
+    {
+        if (!player.isInited())
+            return;
+        player.disposeSound(soundHash);
+    }
+
+    /// Dispose all sounds already loaded
+    ///
+    FFI_PLUGIN_EXPORT void disposeAllSound()
+    {
+        if (!player.isInited())
+            return;
+        player.disposeAllSound();
+    }
+
+    /// This function can be used to set a sample to play on repeat,
+    /// instead of just playing once
+    ///
+    /// [soundHash]
+    /// [enable]
+    FFI_PLUGIN_EXPORT void setLooping(unsigned int handle, bool enable)
+    {
+        if (!player.isInited())
+            return;
+        player.setLooping(handle, enable);
+    }
+
+    /// Enable or disable visualization
+    ///
+    /// [enabled] enable or disable it
+    FFI_PLUGIN_EXPORT void setVisualizationEnabled(bool enabled)
+    {
+        if (!player.isInited())
+            return;
+        player.setVisualizationEnabled(enabled);
+    }
+
+    /// Returns valid data only if VisualizationEnabled is true
+    ///
+    /// [fft]
+    /// Return a 256 float array containing FFT data.
+    FFI_PLUGIN_EXPORT void getFft(float *fft)
+    {
+        fft = player.calcFFT();
+    }
+
+    /// Returns valid data only if VisualizationEnabled is true
+    ///
+    /// fft
+    /// Return a 256 float array containing wave data.
+    FFI_PLUGIN_EXPORT void getWave(float *wave)
+    {
+        wave = player.getWave();
+    }
+
+    /// Smooth FFT data.
+    /// When new data is read and the values are decreasing, the new value will be
+    /// decreased with an amplitude between the old and the new value.
+    /// This will result on a less shaky visualization.
+    ///
+    /// [smooth] must be in the [0.0 ~ 1.0] range.
+    /// 0 = no smooth
+    /// 1 = full smooth
+    /// the new value is calculated with:
+    /// newFreq = smooth * oldFreq + (1 - smooth) * newFreq
+    FFI_PLUGIN_EXPORT void setFftSmoothing(float smooth)
+    {
+        if (!player.isInited())
+            return;
+        analyzer.get()->setSmoothing(smooth);
+    }
+
+    /// Return in [samples] a 512 float array.
+    /// The first 256 floats represent the FFT frequencies data [>=0.0].
+    /// The other 256 floats represent the wave data (amplitude) [-1.0~1.0].
+    ///
+    /// [samples] should be allocated and freed in dart side
+    FFI_PLUGIN_EXPORT void getAudioTexture(float *samples)
+    {
+        if (analyzer.get() == nullptr)
+        {
+            memset(samples, 0, sizeof(float) * 512);
+            return;
+        }
+        float *wave = player.getWave();
+        float *fft = analyzer.get()->calcFFT(wave);
+
+        memcpy(samples, fft, sizeof(float) * 256);
+        memcpy(samples + 256, wave, sizeof(float) * 256);
+    }
+
+    /// Return a floats matrix of 512x256
+    /// Every row are composed of 256 FFT values plus 256 of wave data
+    /// Every time is called, a new row is stored in the
+    /// first row and all the previous rows are shifted
+    /// up (the last one will be lost).
+    ///
+    /// [samples]
+    float texture2D[512][256];
+    FFI_PLUGIN_EXPORT enum PlayerErrors getAudioTexture2D(float **samples)
+    {
+        if (analyzer.get() == nullptr || !player.isVisualizationEnabled())
+        {
+            if (*samples == nullptr)
+                return unknownError;
+            memset(samples, 0, sizeof(float) * 512 * 256);
+            return backendNotInited;
+        }
+        /// shift up 1 row
+        memmove(*texture2D + 512, texture2D, sizeof(float) * 512 * 255);
+        /// store the new 1st row
+        getAudioTexture(texture2D[0]);
+        *samples = *texture2D;
+        return noError;
+    }
+
+    /// Get the sound length in seconds
+    ///
+    /// [soundHash] the sound hash
+    /// Returns sound length in seconds
+    FFI_PLUGIN_EXPORT double getLength(unsigned int soundHash)
+    {
+        if (!player.isInited())
+            return 0.0;
+        return player.getLength(soundHash);
+    }
+
+    /// Seek playing in [time] seconds
+    /// [time]
+    /// [handle] the sound handle
+    /// Returns [PlayerErrors.noError] if success
+    ///
+    /// NOTE: when seeking an mp3 file loaded using `loadIntoMem`=false
+    /// the seek operation is not performed due to lags. This occurs because the
+    /// mp3 codec must compute each frame length to gain a new position.
+    /// The problem is explained in souloud_wavstream.cpp
+    /// in `WavStreamInstance::seek` function.
+    ///
+    /// This mode is useful ie for background music, not for a music player
+    /// where a seek slider for mp3s is a must.
+    /// If you need seeking mp3, please, use `loadIntoMem`=true instead
+    /// or other audio formats!
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors seek(unsigned int handle, float time)
     {
         if (!player.isInited())
             return backendNotInited;
-        return (PlayerErrors)player.textToSpeech(textToSpeech, *handle);
+        return (PlayerErrors)player.seek(handle, time);
     }
 
-    /// Switch pause state for an already loaded sound identified by [handle]
+    /// Get current sound position  in seconds
     ///
     /// [handle] the sound handle
-    FFI_PLUGIN_EXPORT void pauseSwitch(unsigned int handle)
+    /// Returns time in seconds
+    FFI_PLUGIN_EXPORT double getPosition(unsigned int handle)
+    {
+        if (!player.isInited() || player.getSoundsCount() == 0)
+            return 0.0f;
+        return player.getPosition(handle);
+    }
+
+    /// Get current Global volume
+    ///
+    /// Returns the volume
+    FFI_PLUGIN_EXPORT double getGlobalVolume()
     {
         if (!player.isInited())
-            return;
-        player.pauseSwitch(handle);
+            return 0.0f;
+        return player.getGlobalVolume();
     }
 
-    /// Pause or unpause already loaded sound identified by [handle]
+    /// Set current Global volume
     ///
-    /// [handle] the sound handle
-    /// [pause] the sound handle
-    FFI_PLUGIN_EXPORT void setPause(unsigned int handle, bool pause)
+    /// Returns the volume
+    FFI_PLUGIN_EXPORT enum PlayerErrors setGlobalVolume(float volume)
     {
         if (!player.isInited())
-            return;
-        player.setPause(handle, pause);
+            return backendNotInited;
+        player.setGlobalVolume(volume);
+        return noError;
+    }
+
+    /// Get current [handle] volume
+    ///
+    /// Returns the volume
+    FFI_PLUGIN_EXPORT double getVolume(unsigned int handle)
+    {
+        if (!player.isInited() || player.getSoundsCount() == 0)
+            return 0.0f;
+        return player.getVolume(handle);
+    }
+
+    /// Set current [handle] volume
+    ///
+    /// Returns the volume
+    FFI_PLUGIN_EXPORT enum PlayerErrors setVolume(unsigned int handle, float volume)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.setVolume(handle, volume);
+        return noError;
+    }
+
+    /// Check if a handle is still valid.
+    ///
+    /// [handle] handle to check
+    /// Return true if it still exists
+    FFI_PLUGIN_EXPORT int getIsValidVoiceHandle(unsigned int handle)
+    {
+        if (!player.isInited() || player.getSoundsCount() == 0)
+            return false;
+        return player.getIsValidVoiceHandle(handle) ? 1 : 0;
+    }
+
+    /// Set current [handle] pan
+    ///
+    /// [handle] the sound or voice group handle
+    /// [pan] from -1 left to 1 right
+    FFI_PLUGIN_EXPORT enum PlayerErrors setPan(unsigned int handle, float pan)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.setPan(handle, pan);
+        return noError;
+    }
+
+    /// Protect [handle] from being stopped or made virtual when more voices
+    /// than the maximum of active voices play
+    ///
+    /// [handle] the sound or voice group handle
+    FFI_PLUGIN_EXPORT enum PlayerErrors setProtectVoice(unsigned int handle, bool protect)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.setProtectVoice(handle, protect);
+        return noError;
+    }
+
+    /////////////////////////////////////////
+    /// voice groups
+    /////////////////////////////////////////
+
+    /// Create a voice group. Its handle can be passed to [stop], [setPause],
+    /// [setVolume], [setPan], [setRelativePlaySpeed], [setLooping],
+    /// [setProtectVoice], the faders, the oscillators and the 3D source
+    /// setters, which then apply to all its voices in one call.
+    ///
+    /// [group] return the group handle
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors createVoiceGroup(unsigned int *group)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *group = player.createVoiceGroup();
+        return *group == 0 ? outOfMemory : noError;
+    }
+
+    /// Destroy a voice group. Its voices keep playing.
+    ///
+    /// [group] the voice group handle
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors destroyVoiceGroup(unsigned int group)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.destroyVoiceGroup(group);
+    }
+
+    /// Add [count] voices to a voice group. The voices already ended are
+    /// skipped.
+    ///
+    /// [group] the voice group handle
+    /// [handles] the voice handles
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors addVoicesToGroup(unsigned int group, unsigned int *handles, unsigned int count)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.addVoicesToGroup(group, handles, count);
+    }
+
+    /// Check if [handle] is a voice group
+    ///
+    /// Return 1 if it is
+    FFI_PLUGIN_EXPORT int isVoiceGroup(unsigned int handle)
+    {
+        if (!player.isInited())
+            return 0;
+        return player.isVoiceGroup(handle) ? 1 : 0;
+    }
+
+    /// Check if all the voices of [group] have ended
+    ///
+    /// Return 1 if the group is empty or is not a voice group
+    FFI_PLUGIN_EXPORT int isVoiceGroupEmpty(unsigned int group)
+    {
+        if (!player.isInited())
+            return 1;
+        return player.isVoiceGroupEmpty(group) ? 1 : 0;
+    }
+
+    /////////////////////////////////////////
+    /// faders
+    /////////////////////////////////////////
+
+    /// Smoothly change the global volume over specified time.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors fadeGlobalVolume(float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.fadeGlobalVolume(to, time);
+        return noError;
+    }
+
+    /// Smoothly change a channel's volume over specified time.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors fadeVolume(SoLoud::handle handle, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.fadeVolume(handle, to, time);
+        return noError;
+    }
+
+    /// Smoothly change a channel's pan setting over specified time.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors fadePan(SoLoud::handle handle, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.fadePan(handle, to, time);
+        return noError;
+    }
+
+    /// Smoothly change a channel's relative play speed over specified time.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors fadeRelativePlaySpeed(SoLoud::handle handle, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.fadeRelativePlaySpeed(handle, to, time);
+        return noError;
+    }
+
+    /// After specified time, pause the channel.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors schedulePause(SoLoud::handle handle, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.schedulePause(handle, time);
+        return noError;
+    }
+
+    /// After specified time, stop the channel.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors scheduleStop(SoLoud::handle handle, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.scheduleStop(handle, time);
+        return noError;
+    }
+
+    /// Set fader to oscillate the volume at specified frequency.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateVolume(SoLoud::handle handle, float from, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.oscillateVolume(handle, from, to, time);
+        return noError;
+    }
+
+    /// Set fader to oscillate the panning at specified frequency.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors oscillatePan(SoLoud::handle handle, float from, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.oscillatePan(handle, from, to, time);
+        return noError;
+    }
+
+    /// Set fader to oscillate the relative play speed at specified frequency.
+    ///
+    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateRelativePlaySpeed(SoLoud::handle handle, float from, float to, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        player.oscillateRelativePlaySpeed(handle, from, to, time);
+        return noError;
     }
 
-    /// Gets the pause state
+    /// Set fader to oscillate the global volume at specified frequency.
     ///
-    /// [handle] the sound handle
-    /// Return true if paused
-    FFI_PLUGIN_EXPORT int getPause(unsigned int handle)
+    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateGlobalVolume(float from, float to, float time)
     {
         if (!player.isInited())
-            return false;
-        return player.getPause(handle) ? 1 : 0;
+            return backendNotInited;
+        player.oscillateGlobalVolume(from, to, time);
+        return noError;
     }
 
-    /// Set a sound's relative play speed.
-    /// Setting the value to 0 will cause undefined behavior, likely a crash.
-    /// Change the relative play speed of a sample. This changes the effective
-    /// sample rate while leaving the base sample rate alone.
-    ///
-    /// Note that playing a sound at a higher sample rate will require SoLoud
-    /// to request more samples from the sound source, which will require more
-    /// memory and more processing power. Playing at a slower sample rate
-    /// is cheaper.
+    /////////////////////////////////////////
+    /// timeline
+    /////////////////////////////////////////
+
+    /// Get the engine time: the number of samples mixed since the
+    /// engine has been initialized. Scheduled events use this clock
     ///
-    /// [handle] the sound handle
-    /// [speed] the new speed
-    FFI_PLUGIN_EXPORT void setRelativePlaySpeed(unsigned int handle, float speed)
+    /// Returns the engine time in samples
+    FFI_PLUGIN_EXPORT unsigned long long getEngineTime()
     {
         if (!player.isInited())
-            return;
-        player.setRelativePlaySpeed(handle, speed);
+            return 0;
+        return player.getEngineTime();
     }
 
-    /// Get a sound's relative play speed.
-    /// If an invalid handle is given to getRelativePlaySpeed, it will return 1.
-
-    /// Return the current play speed.
-    /// [handle] the sound handle
-    FFI_PLUGIN_EXPORT float getRelativePlaySpeed(unsigned int handle)
+    /// Get the engine sample rate, to convert the engine time to seconds
+    ///
+    /// Returns the sample rate or 0 if the engine is not initialized
+    FFI_PLUGIN_EXPORT unsigned int getEngineSampleRate()
     {
         if (!player.isInited())
-            return 1;
-        return player.getRelativePlaySpeed(handle);
+            return 0;
+        return player.soloud.getBackendSamplerate();
     }
 
-    /// Play already loaded sound identified by [handle]
+    /// Play a sound at an exact engine time
     ///
-    /// [hash] the unique sound hash of a sound
+    /// [soundHash] the unique sound hash of a sound
+    /// [time] engine time in samples. Times already passed play right away
     /// [volume] 1.0f full volume
-    /// [pan] 0.0f centered
-    /// [paused] 0 not pause
-    /// Return the handle of the sound, 0 if error
-    FFI_PLUGIN_EXPORT unsigned int play(
-        unsigned int hash,
+    /// [pan] -1 left, 0 center, 1 right
+    /// [eventId] return the id of the event
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors schedulePlayAt(
+        unsigned int soundHash,
+        unsigned long long time,
         float volume,
         float pan,
-        bool paused)
+        unsigned int *eventId)
     {
         if (!player.isInited())
-            return -1;
-        return player.play(hash, volume, pan, paused);
+            return backendNotInited;
+        return player.schedulePlayAt(soundHash, time, volume, pan, *eventId);
     }
 
-    /// Stop already loaded sound identified by [handle] and clear it
+    /// Change a voice at an exact engine time
     ///
-    /// [handle]
-    FFI_PLUGIN_EXPORT void stop(unsigned int handle)
+    /// [handle] the voice to change
+    /// [playEventId] if not 0, [handle] is ignored and the event applies to
+    ///     the voice started by this [schedulePlayAt] event
+    /// [time] engine time in samples
+    /// [action]    TIMELINE_STOP = 1,
+    ///             TIMELINE_PAUSE,
+    ///             TIMELINE_VOLUME,
+    ///             TIMELINE_PAN,
+    ///             TIMELINE_RELATIVE_SPEED,
+    ///             TIMELINE_SEEK
+    /// [value] the new value. Seconds for seek, not 0 to pause
+    /// [eventId] return the id of the event
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors scheduleVoiceEventAt(
+        unsigned int handle,
+        unsigned int playEventId,
+        unsigned long long time,
+        int action,
+        float value,
+        unsigned int *eventId)
     {
         if (!player.isInited())
-            return;
-        player.stop(handle);
+            return backendNotInited;
+        return player.scheduleVoiceEventAt(handle, playEventId, time, action, value, *eventId);
     }
 
-    /// Stop all handles of the already loaded sound identified by [hash] and dispose it
+    /// Set a parameter of an active global filter at an exact engine time
     ///
-    /// [soundHash]
-    FFI_PLUGIN_EXPORT void disposeSound(unsigned int soundHash)
+    /// [filterType] filter to change
+    /// [attributeId] the attribute index
+    /// [value] the new value
+    /// [time] engine time in samples
+    /// [eventId] return the id of the event
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors scheduleFilterParamAt(
+        enum FilterType filterType,
+        int attributeId,
+        float value,
+        unsigned long long time,
+        unsigned int *eventId)
     {
         if (!player.isInited())
-            return;
-        player.disposeSound(soundHash);
+            return backendNotInited;
+        return player.scheduleFilterParamAt(filterType, attributeId, value, time, *eventId);
     }
 
-    /// Dispose all sounds already loaded
+    /// Remove a scheduled event not yet run
     ///
-    FFI_PLUGIN_EXPORT void disposeAllSound()
+    /// [eventId] the id returned when scheduling
+    /// Returns true if the event was pending
+    FFI_PLUGIN_EXPORT bool cancelScheduledEvent(unsigned int eventId)
     {
         if (!player.isInited())
-            return;
-        player.disposeAllSound();
+            return false;
+        return player.cancelScheduledEvent(eventId);
     }
 
-    /// This function can be used to set a sample to play on repeat,
-    /// instead of just playing once
+    /// Remove all the scheduled events not yet run
     ///
-    /// [soundHash]
-    /// [enable]
-    FFI_PLUGIN_EXPORT void setLooping(unsigned int handle, bool enable)
+    FFI_PLUGIN_EXPORT void cancelAllScheduledEvents()
     {
         if (!player.isInited())
             return;
-        player.setLooping(handle, enable);
+        player.cancelAllScheduledEvents();
     }
 
-    /// Enable or disable visualization
+    /// Get the voice started by a [schedulePlayAt] event
     ///
-    /// [enabled] enable or disable it
-    FFI_PLUGIN_EXPORT void setVisualizationEnabled(bool enabled)
+    /// [eventId] the id returned by [schedulePlayAt]
+    /// Returns the handle or 0 if the event has not been run yet
+    FFI_PLUGIN_EXPORT unsigned int getScheduledHandle(unsigned int eventId)
     {
         if (!player.isInited())
-            return;
-        player.setVisualizationEnabled(enabled);
+            return 0;
+        return player.getScheduledHandle(eventId);
     }
 
-    /// Returns valid data only if VisualizationEnabled is true
+    /////////////////////////////////////////
+    /// sequencers
+    /////////////////////////////////////////
+
+    /// Create a new stopped step sequencer with an empty pattern
     ///
-    /// [fft]
-    /// Return a 256 float array containing FFT data.
-    FFI_PLUGIN_EXPORT void getFft(float *fft)
+    /// [bpm] tempo in beats per minute
+    /// [stepsPerBeat] ie 4 for 16th notes
+    /// [steps] pattern length
+    /// [tracks] number of rows of the pattern
+    /// [id] return the id of the sequencer
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors createSequencer(
+        float bpm,
+        unsigned int stepsPerBeat,
+        unsigned int steps,
+        unsigned int tracks,
+        unsigned int *id)
     {
-        fft = player.calcFFT();
+        if (!player.isInited())
+            return backendNotInited;
+        return player.createSequencer(bpm, stepsPerBeat, steps, tracks, *id);
     }
 
-    /// Returns valid data only if VisualizationEnabled is true
+    /// Stop and remove a sequencer. Sounds already triggered keep playing
     ///
-    /// fft
-    /// Return a 256 float array containing wave data.
-    FFI_PLUGIN_EXPORT void getWave(float *wave)
+    /// [id] the sequencer id
+    FFI_PLUGIN_EXPORT void destroySequencer(unsigned int id)
     {
-        wave = player.getWave();
+        if (!player.isInited())
+            return;
+        player.destroySequencer(id);
     }
 
-    /// Smooth FFT data.
-    /// When new data is read and the values are decreasing, the new value will be
-    /// decreased with an amplitude between the old and the new value.
-    /// This will result on a less shaky visualization.
+    /// Change the tempo. It takes effect from the next step
     ///
-    /// [smooth] must be in the [0.0 ~ 1.0] range.
-    /// 0 = no smooth
-    /// 1 = full smooth
-    /// the new value is calculated with:
-    /// newFreq = smooth * oldFreq + (1 - smooth) * newFreq
-    FFI_PLUGIN_EXPORT void setFftSmoothing(float smooth)
+    /// [id] the sequencer id
+    /// [bpm] tempo in beats per minute
+    /// [stepsPerBeat] ie 4 for 16th notes
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerSetTempo(
+        unsigned int id,
+        float bpm,
+        unsigned int stepsPerBeat)
     {
         if (!player.isInited())
-            return;
-        analyzer.get()->setSmoothing(smooth);
+            return backendNotInited;
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr || bpm <= 0.0f || stepsPerBeat == 0)
+            return invalidParameter;
+        sequencer->setTempo(bpm, stepsPerBeat);
+        return noError;
     }
 
-    /// Return in [samples] a 512 float array.
-    /// The first 256 floats represent the FFT frequencies data [>=0.0].
-    /// The other 256 floats represent the wave data (amplitude) [-1.0~1.0].
+    /// Delay the odd steps
     ///
-    /// [samples] should be allocated and freed in dart side
-    FFI_PLUGIN_EXPORT void getAudioTexture(float *samples)
+    /// [id] the sequencer id
+    /// [swing] delay as a fraction of a step, 0 to 0.9
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerSetSwing(unsigned int id, float swing)
     {
-        if (analyzer.get() == nullptr)
-        {
-            memset(samples, 0, sizeof(float) * 512);
-            return;
-        }
-        float *wave = player.getWave();
-        float *fft = analyzer.get()->calcFFT(wave);
-
-        memcpy(samples, fft, sizeof(float) * 256);
-        memcpy(samples + 256, wave, sizeof(float) * 256);
+        if (!player.isInited())
+            return backendNotInited;
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr)
+            return invalidParameter;
+        sequencer->setSwing(swing);
+        return noError;
     }
 
-    /// Return a floats matrix of 512x256
-    /// Every row are composed of 256 FFT values plus 256 of wave data
-    /// Every time is called, a new row is stored in the
-    /// first row and all the previous rows are shifted
-    /// up (the last one will be lost).
+    /// Resize the pattern. The cells inside the new size are kept
     ///
-    /// [samples]
-    float texture2D[512][256];
-    FFI_PLUGIN_EXPORT enum PlayerErrors getAudioTexture2D(float **samples)
+    /// [id] the sequencer id
+    /// [steps] pattern length
+    /// [tracks] number of rows of the pattern
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerSetSize(
+        unsigned int id,
+        unsigned int steps,
+        unsigned int tracks)
     {
-        if (analyzer.get() == nullptr || !player.isVisualizationEnabled())
-        {
-            if (*samples == nullptr)
-                return unknownError;
-            memset(samples, 0, sizeof(float) * 512 * 256);
+        if (!player.isInited())
             return backendNotInited;
-        }
-        /// shift up 1 row
-        memmove(*texture2D + 512, texture2D, sizeof(float) * 512 * 255);
-        /// store the new 1st row
-        getAudioTexture(texture2D[0]);
-        *samples = *texture2D;
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr || steps == 0 || tracks == 0)
+            return invalidParameter;
+        sequencer->setSize(steps, tracks);
         return noError;
     }
 
-    /// Get the sound length in seconds
+    /// Change many pattern cells at once, also while playing
     ///
-    /// [soundHash] the sound hash
-    /// Returns sound length in seconds
-    FFI_PLUGIN_EXPORT double getLength(unsigned int soundHash)
+    /// [id] the sequencer id
+    /// [edits] the cells to change. A 0 sound hash empties the cell
+    /// [count] number of [edits]
+    /// Returns [PlayerErrors.invalidParameter] if a sound or a cell is not
+    /// found. The other edits are applied anyway
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerSetSteps(
+        unsigned int id,
+        SequencerStepEdit *edits,
+        unsigned int count)
     {
         if (!player.isInited())
-            return 0.0;
-        return player.getLength(soundHash);
+            return backendNotInited;
+        return player.sequencerSetSteps(id, edits, count);
     }
 
-    /// Seek playing in [time] seconds
-    /// [time]
-    /// [handle] the sound handle
-    /// Returns [PlayerErrors.noError] if success
-    ///
-    /// NOTE: when seeking an mp3 file loaded using `loadIntoMem`=false
-    /// the seek operation is not performed due to lags. This occurs because the
-    /// mp3 codec must compute each frame length to gain a new position.
-    /// The problem is explained in souloud_wavstream.cpp
-    /// in `WavStreamInstance::seek` function.
-    ///
-    /// This mode is useful ie for background music, not for a music player
-    /// where a seek slider for mp3s is a must.
-    /// If you need seeking mp3, please, use `loadIntoMem`=true instead
-    /// or other audio formats!
+    /// Start the sequencer
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors seek(unsigned int handle, float time)
+    /// [id] the sequencer id
+    /// [time] engine time in samples of the first step, see [getEngineTime]
+    /// [step] the first step to play
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerStart(
+        unsigned int id,
+        unsigned long long time,
+        unsigned int step)
     {
         if (!player.isInited())
             return backendNotInited;
-        return (PlayerErrors)player.seek(handle, time);
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr)
+            return invalidParameter;
+        sequencer->start(time, step);
+        return noError;
     }
 
-    /// Get current sound position  in seconds
+    /// Stop the sequencer. Sounds already triggered keep playing
     ///
-    /// [handle] the sound handle
-    /// Returns time in seconds
-    FFI_PLUGIN_EXPORT double getPosition(unsigned int handle)
+    /// [id] the sequencer id
+    FFI_PLUGIN_EXPORT enum PlayerErrors sequencerStop(unsigned int id)
     {
-        if (!player.isInited() || player.getSoundsCount() == 0)
-            return 0.0f;
-        return player.getPosition(handle);
+        if (!player.isInited())
+            return backendNotInited;
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr)
+            return invalidParameter;
+        sequencer->stop();
+        return noError;
     }
 
-    /// Get current Global volume
+    /// Get the last step played
     ///
-    /// Returns the volume
-    FFI_PLUGIN_EXPORT double getGlobalVolume()
+    /// [id] the sequencer id
+    /// Returns the step or -1 if stopped
+    FFI_PLUGIN_EXPORT int sequencerGetCurrentStep(unsigned int id)
     {
         if (!player.isInited())
-            return 0.0f;
-        return player.getGlobalVolume();
+            return -1;
+        Sequencer *sequencer = player.getSequencer(id);
+        if (sequencer == nullptr)
+            return -1;
+        return sequencer->getCurrentStep();
     }
 
-    /// Set current Global volume
+    /////////////////////////////////////////
+    /// samplers
+    /////////////////////////////////////////
+
+    /// Create a new multi-sample instrument without zones
     ///
-    /// Returns the volume
-    FFI_PLUGIN_EXPORT enum PlayerErrors setGlobalVolume(float volume)
+    /// [id] return the id of the sampler
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors createSampler(unsigned int *id)
     {
         if (!player.isInited())
             return backendNotInited;
-        player.setGlobalVolume(volume);
-        return noError;
+        return player.createSampler(*id);
     }
 
-    /// Get current [handle] volume
+    /// Release the notes and remove a sampler
     ///
-    /// Returns the volume
-    FFI_PLUGIN_EXPORT double getVolume(unsigned int handle)
+    /// [id] the sampler id
+    FFI_PLUGIN_EXPORT void destroySampler(unsigned int id)
     {
-        if (!player.isInited() || player.getSoundsCount() == 0)
-            return 0.0f;
-        return player.getVolume(handle);
+        if (!player.isInited())
+            return;
+        player.destroySampler(id);
     }
 
-    /// Set current [handle] volume
+    /// Add zones to a sampler
     ///
-    /// Returns the volume
-    FFI_PLUGIN_EXPORT enum PlayerErrors setVolume(unsigned int handle, float volume)
+    /// [id] the sampler id
+    /// [zones] the zones to add
+    /// [count] number of [zones]
+    /// Returns [PlayerErrors.invalidParameter] if a sound is not a loaded
+    /// Wav or a zone is not valid. The other zones are added anyway
+    FFI_PLUGIN_EXPORT enum PlayerErrors samplerAddZones(
+        unsigned int id,
+        SamplerZone *zones,
+        unsigned int count)
     {
         if (!player.isInited())
             return backendNotInited;
-        player.setVolume(handle, volume);
-        return noError;
+        return player.samplerAddZones(id, zones, count);
     }
 
-    /// Check if a handle is still valid.
+    /// Remove all the zones of a sampler
     ///
-    /// [handle] handle to check
-    /// Return true if it still exists
-    FFI_PLUGIN_EXPORT int getIsValidVoiceHandle(unsigned int handle)
+    /// [id] the sampler id
+    FFI_PLUGIN_EXPORT enum PlayerErrors samplerClearZones(unsigned int id)
     {
-        if (!player.isInited() || player.getSoundsCount() == 0)
-            return false;
-        return player.getIsValidVoiceHandle(handle) ? 1 : 0;
+        if (!player.isInited())
+            return backendNotInited;
+        Sampler *sampler = player.getSampler(id);
+        if (sampler == nullptr)
+            return invalidParameter;
+        sampler->clearZones();
+        return noError;
     }
 
-    /////////////////////////////////////////
-    /// faders
-    /////////////////////////////////////////
-
-    /// Smoothly change the global volume over specified time.
+    /// Start the zones of a note
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors fadeGlobalVolume(float to, float time)
+    /// [id] the sampler id
+    /// [note] MIDI note number, can be fractional
+    /// [velocity] 0 to 1
+    /// [handle] return the handle of the first voice started, 0 if no zone
+    /// matches
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors samplerNoteOn(
+        unsigned int id, float note, float velocity, unsigned int *handle)
     {
         if (!player.isInited())
             return backendNotInited;
-        player.fadeGlobalVolume(to, time);
+        Sampler *sampler = player.getSampler(id);
+        if (sampler == nullptr)
+            return invalidParameter;
+        *handle = sampler->noteOn(note, velocity);
         return noError;
     }
 
-    /// Smoothly change a channel's volume over specified time.
+    /// Release a note and start its release zones
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors fadeVolume(SoLoud::handle handle, float to, float time)
+    /// [id] the sampler id
+    /// [note] the note given to [samplerNoteOn]
+    FFI_PLUGIN_EXPORT enum PlayerErrors samplerNoteOff(unsigned int id, float note)
     {
         if (!player.isInited())
             return backendNotInited;
-        player.fadeVolume(handle, to, time);
+        Sampler *sampler = player.getSampler(id);
+        if (sampler == nullptr)
+            return invalidParameter;
+        sampler->noteOff(note);
         return noError;
     }
 
-    /// Smoothly change a channel's pan setting over specified time.
+    /// Release all the notes
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors fadePan(SoLoud::handle handle, float to, float time)
+    /// [id] the sampler id
+    FFI_PLUGIN_EXPORT enum PlayerErrors samplerAllNotesOff(unsigned int id)
     {
         if (!player.isInited())
             return backendNotInited;
-        player.fadePan(handle, to, time);
+        Sampler *sampler = player.getSampler(id);
+        if (sampler == nullptr)
+            return invalidParameter;
+        sampler->allNotesOff();
         return noError;
     }
 
-    /// Smoothly change a channel's relative play speed over specified time.
+    /// Get how many notes are playing
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors fadeRelativePlaySpeed(SoLoud::handle handle, float to, float time)
+    /// [id] the sampler id
+    /// Returns the notes held and still sounding
+    FFI_PLUGIN_EXPORT int samplerGetActiveNotes(unsigned int id)
     {
         if (!player.isInited())
-            return backendNotInited;
-        player.fadeRelativePlaySpeed(handle, to, time);
-        return noError;
+            return 0;
+        Sampler *sampler = player.getSampler(id);
+        if (sampler == nullptr)
+            return 0;
+        return sampler->getActiveNotes();
     }
 
-    /// After specified time, pause the channel.
+    /////////////////////////////////////////
+    /// status block
+    /////////////////////////////////////////
+
+    /// Start or stop publishing the engine state after every mixed block
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors schedulePause(SoLoud::handle handle, float time)
+    /// [enabled] whether to publish
+    FFI_PLUGIN_EXPORT void setStatusBlockEnabled(bool enabled)
     {
-        if (!player.isInited())
-            return backendNotInited;
-        player.schedulePause(handle, time);
-        return noError;
+        player.mStatusBlock.setEnabled(enabled);
     }
 
-    /// After specified time, stop the channel.
+    /// Get the memory where the engine state is published. It starts with a
+    /// StatusHeader followed by StatusHeader.voiceCount StatusVoice, and it
+    /// is protected by a seqlock on StatusHeader.sequence
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors scheduleStop(SoLoud::handle handle, float time)
+    /// [size] return the size of the memory in bytes
+    /// Returns the memory pointer, valid until the plugin is unloaded
+    FFI_PLUGIN_EXPORT void *getStatusBlock(unsigned int *size)
     {
-        if (!player.isInited())
-            return backendNotInited;
-        player.scheduleStop(handle, time);
-        return noError;
+        *size = player.mStatusBlock.getSize();
+        return player.mStatusBlock.getData();
     }
 
-    /// Set fader to oscillate the volume at specified frequency.
+    /////////////////////////////////////////
+    /// audio clock
+    /////////////////////////////////////////
+
+    /// Get the engine time being heard now, interpolated between the mixed
+    /// buffers and corrected by the output latency
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateVolume(SoLoud::handle handle, float from, float to, float time)
+    /// Returns the time in seconds
+    FFI_PLUGIN_EXPORT double getOutputTime()
     {
         if (!player.isInited())
-            return backendNotInited;
-        player.oscillateVolume(handle, from, to, time);
-        return noError;
+            return 0.0;
+        return player.mAudioClock.getOutputSamples() / player.soloud.getBackendSamplerate();
     }
 
-    /// Set fader to oscillate the panning at specified frequency.
+    /// Get the position of a voice being heard now, interpolated between
+    /// the mixed buffers and corrected by the output latency
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors oscillatePan(SoLoud::handle handle, float from, float to, float time)
+    /// [handle] the voice handle
+    /// Returns the position in seconds, or -1 if the handle is not valid
+    FFI_PLUGIN_EXPORT double getOutputPosition(unsigned int handle)
     {
         if (!player.isInited())
-            return backendNotInited;
-        player.oscillatePan(handle, from, to, time);
-        return noError;
+            return -1.0;
+        double position;
+        if (!player.mAudioClock.getVoicePosition(handle, position))
+            return -1.0;
+        return position;
     }
 
-    /// Set fader to oscillate the relative play speed at specified frequency.
+    /// Set an extra output latency, ie for bluetooth headphones
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateRelativePlaySpeed(SoLoud::handle handle, float from, float to, float time)
+    /// [seconds] latency added to the one of the backend. Can be negative
+    FFI_PLUGIN_EXPORT void setOutputLatencyOffset(double seconds)
     {
-        if (!player.isInited())
-            return backendNotInited;
-        player.oscillateRelativePlaySpeed(handle, from, to, time);
-        return noError;
+        player.mAudioClock.setLatencyOffset(seconds);
     }
 
-    /// Set fader to oscillate the global volume at specified frequency.
+    /// Get the output latency
     ///
-    FFI_PLUGIN_EXPORT enum PlayerErrors oscillateGlobalVolume(float from, float to, float time)
+    /// Returns the latency of the backend plus the offset, in seconds
+    FFI_PLUGIN_EXPORT double getOutputLatency()
     {
         if (!player.isInited())
-            return backendNotInited;
-        player.oscillateGlobalVolume(from, to, time);
-        return noError;
+            return 0.0;
+        return player.mAudioClock.getLatency();
     }
 
     /////////////////////////////////////////
@@ -679,6 +1977,8 @@ extern "C"
             return backendNotInited;
         if (player.mFilters.addGlobalFilter(filterType) == -1)
             return filterNotFound;
+        player.mModMatrix.refreshFilters();
+        player.mSnapshots.refreshFilters();
         return noError;
     }
 
@@ -693,6 +1993,8 @@ extern "C"
             return backendNotInited;
         if (player.mFilters.removeGlobalFilter(filterType) == -1)
             return filterNotFound;
+        player.mModMatrix.refreshFilters();
+        player.mSnapshots.refreshFilters();
         return noError;
     }
 
@@ -706,7 +2008,10 @@ extern "C"
     {
         if (!player.isInited())
             return backendNotInited;
-        player.mFilters.setFxParams(filterType, attributeId, value);
+        // a modulated parameter keeps oscillating around the new value
+        if (attributeId < 0 ||
+            !player.mModMatrix.setFilterBase(filterType, attributeId, value))
+            player.mFilters.setFxParams(filterType, attributeId, value);
         return noError;
     }
 
@@ -720,6 +2025,233 @@ extern "C"
         return player.mFilters.getFxParams(filterType, attributeId);
     }
 
+    /////////////////////////////////////////
+    /// Modulation
+    /////////////////////////////////////////
+
+    /// Set the tempo of the modulation sources synced to beats
+    ///
+    /// [bpm] beats per minute
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modSetTempo(float bpm)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        if (bpm <= 0.0f)
+            return invalidParameter;
+        player.mModMatrix.setTempo(bpm);
+        return noError;
+    }
+
+    /// Create an LFO from -1 to 1
+    ///
+    /// [shape] one of [ModShape]
+    /// [rate] cycles per second
+    /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+    /// [id] return the id of the source
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modCreateLfo(
+        enum ModShape shape, float rate, float syncBeats, unsigned int *id)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *id = player.mModMatrix.createLfo(shape, rate, syncBeats);
+        return *id == 0 ? invalidParameter : noError;
+    }
+
+    /// Create an envelope from 0 to 1, opened and closed by [modSetGate]
+    ///
+    /// [attack] [decay] [release] times in seconds
+    /// [sustain] level 0 to 1
+    /// [id] return the id of the source
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modCreateEnvelope(
+        float attack, float decay, float sustain, float release, unsigned int *id)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *id = player.mModMatrix.createEnvelope(attack, decay, sustain, release);
+        return *id == 0 ? invalidParameter : noError;
+    }
+
+    /// Create a source with a new random value from -1 to 1 every cycle
+    ///
+    /// [rate] cycles per second
+    /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+    /// [smooth] glide from a value to the next instead of jumping
+    /// [id] return the id of the source
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modCreateRandom(
+        float rate, float syncBeats, bool smooth, unsigned int *id)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *id = player.mModMatrix.createRandom(rate, syncBeats, smooth);
+        return *id == 0 ? invalidParameter : noError;
+    }
+
+    /// Change the speed of an LFO or of a random source
+    ///
+    /// [id] the source id
+    /// [shape] one of [ModShape], not used by random sources
+    /// [rate] cycles per second
+    /// [syncBeats] if > 0, the cycle length in beats, [rate] is ignored
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modSetSourceRate(
+        unsigned int id, enum ModShape shape, float rate, float syncBeats)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mModMatrix.setSourceRate(id, shape, rate, syncBeats) ? noError : invalidParameter;
+    }
+
+    /// Open or close the gate of an envelope
+    ///
+    /// [id] the source id
+    /// [gate] true to start the attack, false to start the release
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modSetGate(unsigned int id, bool gate)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mModMatrix.setGate(id, gate) ? noError : invalidParameter;
+    }
+
+    /// Remove a source and its routes
+    ///
+    /// [id] the source id
+    FFI_PLUGIN_EXPORT void modRemoveSource(unsigned int id)
+    {
+        if (!player.isInited())
+            return;
+        player.mModMatrix.removeSource(id);
+    }
+
+    /// Route a source to a parameter of a waveform sound
+    ///
+    /// [sourceId] the source id
+    /// [hash] the unique sound hash of a waveform
+    /// [param] one of [ModWaveformParam]
+    /// [depth] the change when the source is 1, in semitones for the
+    /// frequency
+    /// [routeId] return the id of the route
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modAddWaveformRoute(
+        unsigned int sourceId,
+        unsigned int hash,
+        enum ModWaveformParam param,
+        float depth,
+        unsigned int *routeId)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *routeId = 0;
+        ActiveSound *sound = player.findByHash(hash);
+        if (sound == nullptr || sound->soundType != TYPE_SYNTH)
+            return invalidParameter;
+        *routeId = player.mModMatrix.addWaveformRoute(
+            sourceId, static_cast<Basicwave *>(sound->sound.get()), param, depth);
+        return *routeId == 0 ? invalidParameter : noError;
+    }
+
+    /// Route a source to a parameter of a global filter
+    ///
+    /// [sourceId] the source id
+    /// [filterType] the filter, it can be added later
+    /// [attributeId] the parameter
+    /// [depth] the change when the source is 1
+    /// [routeId] return the id of the route
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modAddFilterRoute(
+        unsigned int sourceId,
+        enum FilterType filterType,
+        int attributeId,
+        float depth,
+        unsigned int *routeId)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        *routeId = 0;
+        if (attributeId < 0)
+            return invalidParameter;
+        *routeId = player.mModMatrix.addFilterRoute(sourceId, filterType, attributeId, depth);
+        return *routeId == 0 ? invalidParameter : noError;
+    }
+
+    /// Change the depth of a route
+    ///
+    /// [routeId] the route id
+    /// [depth] the change when the source is 1
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors modSetRouteDepth(unsigned int routeId, float depth)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mModMatrix.setRouteDepth(routeId, depth) ? noError : invalidParameter;
+    }
+
+    /// Remove a route. A parameter without routes gets back its value
+    ///
+    /// [routeId] the route id
+    FFI_PLUGIN_EXPORT void modRemoveRoute(unsigned int routeId)
+    {
+        if (!player.isInited())
+            return;
+        player.mModMatrix.removeRoute(routeId);
+    }
+
+    /////////////////////////////////////////
+    /// Mixer snapshots
+    /////////////////////////////////////////
+
+    /// Create or replace the mixer snapshot [name]
+    ///
+    /// [parent] the snapshot to inherit the values not set from, empty for none
+    /// [capture] store the global volume and the parameters of the active
+    /// filters, only those differing from [parent] when there is one
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors snapshotCreate(char *name, char *parent, bool capture)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mSnapshots.create(name, parent, capture) ? noError : invalidParameter;
+    }
+
+    /// Set a value of the mixer snapshot [name]
+    ///
+    /// [filterType] the filter of the parameter, -1 for the global volume
+    /// [attributeId] the parameter of the filter, 0 for the global volume
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors snapshotSetValue(char *name, int filterType, int attributeId, float value)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        if (attributeId < 0)
+            return invalidParameter;
+        return player.mSnapshots.setValue(name, filterType, attributeId, value) ? noError : invalidParameter;
+    }
+
+    /// Remove the mixer snapshot [name]
+    ///
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors snapshotRemove(char *name)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mSnapshots.remove(name) ? noError : invalidParameter;
+    }
+
+    /// Blend the mixer from its current state to the snapshot [name]
+    ///
+    /// [time] the length of the blend in seconds
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors snapshotBlend(char *name, float time)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.mSnapshots.blend(name, time) ? noError : invalidParameter;
+    }
+
     /////////////////////////////////////////
     /// 3D audio methods
     /////////////////////////////////////////
@@ -927,6 +2459,263 @@ extern "C"
         player.update3dAudio();
     }
 
+    /////////////////////////////////////////
+    /// Offline analysis
+    /////////////////////////////////////////
+
+    /// Start computing the peak pyramid of a sound loaded as a Wav or a
+    /// WavStream on a worker, cached until the sound is disposed
+    ///
+    /// [soundHash] the sound hash
+    /// [ready] return 1 once [getWaveformPeaks] doesn't wait, else 0
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors prepareWaveformPeaks(unsigned int soundHash, int *ready)
+    {
+        *ready = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        bool isReady;
+        PlayerErrors e = player.prepareWaveformPeaks(soundHash, isReady);
+        *ready = isReady ? 1 : 0;
+        return e;
+    }
+
+    /// Get the waveform overview of a sound loaded as a Wav or a WavStream,
+    /// waiting for its peak pyramid if still computed
+    ///
+    /// [soundHash] the sound hash
+    /// [startTime] [endTime] the range in seconds, [endTime] 0 for the end
+    /// [buckets] the number of values of [min], [max] and [rms]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors getWaveformPeaks(
+        unsigned int soundHash,
+        float startTime,
+        float endTime,
+        unsigned int buckets,
+        float *min,
+        float *max,
+        float *rms)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.getWaveformPeaks(soundHash, startTime, endTime, buckets, min, max, rms);
+    }
+
+    /// Get the dimensions of the spectrogram of a sound
+    ///
+    /// [size] the FFT size, a power of two from 64 to 16384
+    /// [hop] the samples between two frames, from 1 to [size]
+    /// [rows] return the number of frames
+    /// [bins] return the values per frame
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors getSpectrogramSize(
+        unsigned int soundHash,
+        unsigned int size,
+        unsigned int hop,
+        unsigned int *rows,
+        unsigned int *bins)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.getSpectrogramSize(soundHash, size, hop, *rows, *bins);
+    }
+
+    /// Start computing the magnitude spectrogram of a sound on a worker into
+    /// [matrix], of [rows] * [bins] floats given by [getSpectrogramSize]
+    ///
+    /// [window] one of [SpectrogramWindow]
+    /// [job] return the job to pass to [pollSpectrogram]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors computeSpectrogram(
+        unsigned int soundHash,
+        unsigned int size,
+        unsigned int hop,
+        int window,
+        float *matrix,
+        unsigned int *job)
+    {
+        *job = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        return player.computeSpectrogram(soundHash, size, hop, (SpectrogramWindow)window, matrix, nullptr, -100.0f, *job);
+    }
+
+    /// Start computing the spectrogram of a sound on a worker into [matrix],
+    /// of [rows] * [bins] bytes given by [getSpectrogramSize], the levels
+    /// from [minDb] to 0 dB quantized from 0 to 255
+    ///
+    /// [window] one of [SpectrogramWindow]
+    /// [job] return the job to pass to [pollSpectrogram]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors computeSpectrogramDb(
+        unsigned int soundHash,
+        unsigned int size,
+        unsigned int hop,
+        int window,
+        unsigned char *matrix,
+        float minDb,
+        unsigned int *job)
+    {
+        *job = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        return player.computeSpectrogram(soundHash, size, hop, (SpectrogramWindow)window, nullptr, matrix, minDb, *job);
+    }
+
+    /// Check whether a spectrogram started by [computeSpectrogram] or
+    /// [computeSpectrogramDb] is done, forgetting the job once it is
+    ///
+    /// [done] return 1 once the matrix is filled, else 0
+    /// Returns [PlayerErrors.invalidParameter] if the job was stopped by
+    /// disposing of its sound
+    FFI_PLUGIN_EXPORT enum PlayerErrors pollSpectrogram(unsigned int job, int *done)
+    {
+        *done = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        bool isDone;
+        PlayerErrors e = player.pollSpectrogram(job, isDone);
+        *done = isDone ? 1 : 0;
+        return e;
+    }
+
+    /// Start detecting the onsets, the tempo and the beats of a sound on a
+    /// worker, cached until the sound is disposed
+    ///
+    /// [soundHash] the sound hash
+    /// [ready] return 1 once [analyzeRhythm] doesn't wait, else 0
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors prepareRhythmAnalysis(unsigned int soundHash, int *ready)
+    {
+        *ready = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        bool isReady;
+        PlayerErrors e = player.prepareRhythmAnalysis(soundHash, isReady);
+        *ready = isReady ? 1 : 0;
+        return e;
+    }
+
+    /// Detect the onsets, the tempo and the beats of a sound, waiting for
+    /// the analysis if still running. It is cached until the sound is
+    /// disposed
+    ///
+    /// [bpm] return the tempo, 0 if none was found
+    /// [onsets] [beats] return the number of onsets and beats to pass to
+    /// [getRhythmEvents]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors analyzeRhythm(
+        unsigned int soundHash,
+        float *bpm,
+        unsigned int *onsets,
+        unsigned int *beats)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.analyzeRhythm(soundHash, *bpm, *onsets, *beats);
+    }
+
+    /// Get the onset and beat times in seconds found by [analyzeRhythm]
+    ///
+    /// [onsets] [beats] the lists to fill, of the sizes given by
+    /// [analyzeRhythm]
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors getRhythmEvents(
+        unsigned int soundHash,
+        float *onsets,
+        float *beats)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.getRhythmEvents(soundHash, onsets, beats);
+    }
+
+    /// Measure the loudness of the sounds loaded from files from now on,
+    /// each on a worker thread as soon as it is loaded
+    ///
+    /// [enabled] whether to measure
+    FFI_PLUGIN_EXPORT void setLoudnessMeasurementOnLoad(bool enabled)
+    {
+        player.setLoudnessMeasurementOnLoad(enabled);
+    }
+
+    /// Start measuring the loudness of a sound on a worker, cached until the
+    /// sound is disposed
+    ///
+    /// [soundHash] the sound hash
+    /// [ready] return 1 once [getLoudness] doesn't wait, else 0
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors prepareLoudness(unsigned int soundHash, int *ready)
+    {
+        *ready = 0;
+        if (!player.isInited())
+            return backendNotInited;
+        bool isReady;
+        PlayerErrors e = player.prepareLoudness(soundHash, isReady);
+        *ready = isReady ? 1 : 0;
+        return e;
+    }
+
+    /// Get the EBU R128 loudness of a sound, waiting for its measure if
+    /// still running
+    ///
+    /// [integrated] return the integrated loudness in LUFS
+    /// [truePeak] return the true peak in dBTP
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors getLoudness(
+        unsigned int soundHash,
+        float *integrated,
+        float *truePeak)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.getLoudness(soundHash, *integrated, *truePeak);
+    }
+
+    /// Set the gain bringing a sound to [targetLufs], folded into the
+    /// volume of its next voices
+    ///
+    /// [enabled] false to remove the gain
+    /// [truePeakLimit] the gain is lowered to keep the true peak below it
+    /// [gain] return the gain applied
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors setLoudnessNormalization(
+        unsigned int soundHash,
+        bool enabled,
+        float targetLufs,
+        float truePeakLimit,
+        float *gain)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        return player.setLoudnessNormalization(soundHash, enabled, targetLufs, truePeakLimit, *gain);
+    }
+
+    /// Cut the silence of a sound loaded into memory and find its loop
+    ///
+    /// [trimSilence] whether to cut the frames below [thresholdDb]
+    /// [loopSearch] 0 none, 1 zero crossings, 2 correlation
+    /// [start] and [end] return the part kept, in seconds of the original
+    /// [loopStart] and [loopEnd] return the loop, in seconds of the result
+    /// Returns [PlayerErrors.noError] if success
+    FFI_PLUGIN_EXPORT enum PlayerErrors trimSound(
+        unsigned int soundHash,
+        bool trimSilence,
+        float thresholdDb,
+        int loopSearch,
+        float *start,
+        float *end,
+        float *loopStart,
+        float *loopEnd)
+    {
+        if (!player.isInited())
+            return backendNotInited;
+        if (loopSearch < LOOP_SEARCH_NONE || loopSearch > LOOP_SEARCH_CORRELATION)
+            return invalidParameter;
+        return player.trimSound(soundHash, trimSilence, thresholdDb, (LoopSearch)loopSearch,
+                                *start, *end, *loopStart, *loopEnd);
+    }
+
     /////////// JUST FOR TEST //////////
     // SoLoud::Wav sound1;
     // SoLoud::Wav sound2;
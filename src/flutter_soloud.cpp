@@ -105,8 +105,31 @@
 #include "analyzer.cpp"
 #include "capture.cpp"
 #include "bindings_capture.cpp"
+#include "synth/wavetable.cpp"
 #include "synth/basic_wave.cpp"
 #include "filters/filters.cpp"
+#include "stream/push_stream.cpp"
+#include "stream/playlist.cpp"
+#include "stream/speech_stream.cpp"
+#include "timeline.cpp"
+#include "sequencer.cpp"
+#include "status_block.cpp"
+#include "audio_clock.cpp"
+#include "mod_matrix.cpp"
+#include "synth/poly_synth.cpp"
+#include "synth/fm_synth.cpp"
+#include "synth/sampler.cpp"
+#include "synth/granular.cpp"
+#include "synth/sfxr_sample.cpp"
+#include "time_stretch.cpp"
+#include "variation_container.cpp"
+#include "mixer_snapshots.cpp"
+#include "analysis/sound_reader.cpp"
+#include "analysis/waveform_peaks.cpp"
+#include "analysis/spectrogram.cpp"
+#include "analysis/rhythm_analysis.cpp"
+#include "analysis/loudness_meter.cpp"
+#include "analysis/sound_bounds.cpp"
 
 // A very short-lived native function.
 //
@@ -0,0 +1,235 @@
+#include "mixer_snapshots.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    SnapshotValue *findSnapshotValue(std::vector<SnapshotValue> &values, int filterType, unsigned int attributeId)
+    {
+        for (SnapshotValue &v : values)
+            if (v.filterType == filterType && v.attributeId == attributeId)
+                return &v;
+        return nullptr;
+    }
+}
+
+MixerSnapshots::MixerSnapshots(SoLoud::Soloud *soloud, Filters *filters, ModMatrix *modMatrix)
+    : mSoloud(soloud),
+      mFilters(filters),
+      mModMatrix(modMatrix),
+      mLength(0.0),
+      mElapsed(0.0),
+      mTime(0),
+      mStarted(false)
+{
+}
+
+void MixerSnapshots::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSnapshots.clear();
+    mTargets.clear();
+    mStarted = false;
+}
+
+/////////////////////////////////////////
+/// snapshots
+/////////////////////////////////////////
+
+bool MixerSnapshots::create(const std::string &name, const std::string &parent, bool capture)
+{
+    if (name.empty())
+        return false;
+    // the parent must exist and not descend from [name]
+    for (std::string ancestor = parent; !ancestor.empty();)
+    {
+        auto it = mSnapshots.find(ancestor);
+        if (ancestor == name || it == mSnapshots.end())
+            return false;
+        ancestor = it->second.parent;
+    }
+
+    MixerSnapshot snapshot;
+    snapshot.parent = parent;
+    if (capture)
+    {
+        std::vector<SnapshotValue> inherited;
+        if (!parent.empty())
+            inherited = resolve(parent);
+        for (const SnapshotValue &v : currentValues())
+        {
+            // a child only holds what differs from its parent
+            const SnapshotValue *p = findSnapshotValue(inherited, v.filterType, v.attributeId);
+            if (p == nullptr || fabsf(p->value - v.value) > 1e-6f)
+                snapshot.values.push_back(v);
+        }
+    }
+    mSnapshots[name] = snapshot;
+    return true;
+}
+
+bool MixerSnapshots::setValue(const std::string &name, int filterType, unsigned int attributeId, float value)
+{
+    auto it = mSnapshots.find(name);
+    if (it == mSnapshots.end())
+        return false;
+    if (filterType == SNAPSHOT_GLOBAL_VOLUME)
+    {
+        if (attributeId != 0 || value < 0.0f)
+            return false;
+    }
+    else if (filterType < BiquadResonantFilter || filterType > FreeverbFilter ||
+             attributeId >= mFilters->getFilterParamNames((FilterType)filterType).size())
+        return false;
+
+    SnapshotValue *v = findSnapshotValue(it->second.values, filterType, attributeId);
+    if (v != nullptr)
+        v->value = value;
+    else
+        it->second.values.push_back({filterType, attributeId, value});
+    return true;
+}
+
+bool MixerSnapshots::remove(const std::string &name)
+{
+    if (mSnapshots.erase(name) == 0)
+        return false;
+    for (auto &snapshot : mSnapshots)
+        if (snapshot.second.parent == name)
+            snapshot.second.parent.clear();
+    return true;
+}
+
+std::vector<SnapshotValue> MixerSnapshots::resolve(const std::string &name)
+{
+    std::vector<const MixerSnapshot *> chain;
+    for (std::string s = name; !s.empty();)
+    {
+        auto it = mSnapshots.find(s);
+        if (it == mSnapshots.end())
+            break;
+        chain.push_back(&it->second);
+        s = it->second.parent;
+    }
+
+    // from the root down, so the children override their ancestors
+    std::vector<SnapshotValue> values;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        for (const SnapshotValue &v : (*it)->values)
+        {
+            SnapshotValue *existing = findSnapshotValue(values, v.filterType, v.attributeId);
+            if (existing != nullptr)
+                existing->value = v.value;
+            else
+                values.push_back(v);
+        }
+    return values;
+}
+
+std::vector<SnapshotValue> MixerSnapshots::currentValues()
+{
+    std::vector<SnapshotValue> values;
+    values.push_back({SNAPSHOT_GLOBAL_VOLUME, 0, mSoloud->getGlobalVolume()});
+    for (int type = BiquadResonantFilter; type <= FreeverbFilter; type++)
+    {
+        if (mFilters->isFilterActive((FilterType)type) < 0)
+            continue;
+        const unsigned int count = (unsigned int)mFilters->getFilterParamNames((FilterType)type).size();
+        for (unsigned int i = 0; i < count; i++)
+            values.push_back({type, i, currentValue(type, i)});
+    }
+    return values;
+}
+
+float MixerSnapshots::currentValue(int filterType, unsigned int attributeId)
+{
+    if (filterType == SNAPSHOT_GLOBAL_VOLUME)
+        return mSoloud->getGlobalVolume();
+    float value;
+    if (mModMatrix->getFilterBase((FilterType)filterType, attributeId, value))
+        return value;
+    return mFilters->getFxParams((FilterType)filterType, attributeId);
+}
+
+/////////////////////////////////////////
+/// blending
+/////////////////////////////////////////
+
+bool MixerSnapshots::blend(const std::string &name, float time)
+{
+    if (mSnapshots.find(name) == mSnapshots.end())
+        return false;
+
+    std::vector<BlendTarget> targets;
+    for (const SnapshotValue &v : resolve(name))
+    {
+        int slot = 0;
+        if (v.filterType != SNAPSHOT_GLOBAL_VOLUME)
+        {
+            slot = mFilters->isFilterActive((FilterType)v.filterType);
+            if (slot < 0)
+                continue;
+        }
+        targets.push_back({v.filterType, v.attributeId, slot,
+                           currentValue(v.filterType, v.attributeId), v.value});
+    }
+
+    const float samplerate = mSoloud->mSamplerate > 0 ? (float)mSoloud->mSamplerate : 44100.0f;
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTargets = targets;
+    mLength = time > 0.0f ? time * samplerate : 0.0;
+    mElapsed = 0.0;
+    // start counting from the next block
+    mStarted = false;
+    return true;
+}
+
+void MixerSnapshots::refreshFilters()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (BlendTarget &target : mTargets)
+        if (target.filterType != SNAPSHOT_GLOBAL_VOLUME)
+            target.filterSlot = mFilters->isFilterActive((FilterType)target.filterType);
+}
+
+void MixerSnapshots::apply(const BlendTarget &target, float value)
+{
+    if (target.filterType == SNAPSHOT_GLOBAL_VOLUME)
+    {
+        mSoloud->setGlobalVolume(value);
+        return;
+    }
+    if (target.filterSlot < 0)
+        return;
+    // a modulated parameter keeps oscillating around the blended value
+    if (!mModMatrix->setFilterBase((FilterType)target.filterType, target.attributeId, value))
+        mSoloud->setFilterParameter(0, target.filterSlot, target.attributeId, value);
+}
+
+unsigned int MixerSnapshots::onTimeline(unsigned long long aSampleTime, unsigned int /*aSamples*/)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (!mStarted || aSampleTime < mTime)
+    {
+        mStarted = true;
+        mTime = aSampleTime;
+    }
+    mElapsed += (double)(aSampleTime - mTime);
+    mTime = aSampleTime;
+
+    if (mTargets.empty())
+        return 0;
+
+    const float t = mElapsed >= mLength ? 1.0f : (float)(mElapsed / mLength);
+    for (const BlendTarget &target : mTargets)
+        apply(target, target.from + (target.to - target.from) * t);
+
+    if (t >= 1.0f)
+    {
+        mTargets.clear();
+        return 0;
+    }
+    return SNAPSHOT_BLOCK_SAMPLES;
+}
@@ -0,0 +1,115 @@
+#ifndef MIXER_SNAPSHOTS_H
+#define MIXER_SNAPSHOTS_H
+
+#include "soloud.h"
+#include "timeline.h"
+#include "mod_matrix.h"
+#include "filters/filters.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// A blend sets the parameters once every [SNAPSHOT_BLOCK_SAMPLES].
+#define SNAPSHOT_BLOCK_SAMPLES 128
+
+/// [SnapshotValue::filterType] of the global volume
+#define SNAPSHOT_GLOBAL_VOLUME -1
+
+/// One mixer parameter of a snapshot.
+struct SnapshotValue
+{
+    /// a [FilterType] or [SNAPSHOT_GLOBAL_VOLUME]
+    int filterType;
+    unsigned int attributeId;
+    float value;
+};
+
+struct MixerSnapshot
+{
+    /// the snapshot the values not set here are taken from, empty if none
+    std::string parent;
+    std::vector<SnapshotValue> values;
+};
+
+/// Named states of the mixer, blended over a time with one call.
+///
+/// A snapshot holds the global volume and the parameters of the global
+/// filters. It can have a parent, so that a "pause" snapshot derived from
+/// "gameplay" only holds what differs from it. Blending is done by the
+/// audio thread through the [Timeline], which moves all the parameters of
+/// the blend together once per block of [SNAPSHOT_BLOCK_SAMPLES].
+class MixerSnapshots : public TimelineListener
+{
+public:
+    MixerSnapshots(SoLoud::Soloud *soloud, Filters *filters, ModMatrix *modMatrix);
+
+    /// @brief remove all the snapshots and stop the blend.
+    void clear();
+
+    /// @brief create or replace the snapshot [name].
+    /// @param parent the snapshot to inherit from, empty for none.
+    /// @param capture store the current state of the mixer, only the values
+    /// which differ from [parent] when there is one.
+    /// @return false if [parent] doesn't exist or descends from [name].
+    bool create(const std::string &name, const std::string &parent, bool capture);
+
+    /// @brief set a value of the snapshot [name].
+    /// @param filterType a [FilterType] or [SNAPSHOT_GLOBAL_VOLUME].
+    /// @return false if the snapshot doesn't exist or the parameter is not
+    /// valid.
+    bool setValue(const std::string &name, int filterType, unsigned int attributeId, float value);
+
+    /// @brief remove the snapshot [name]. Its children lose their parent.
+    bool remove(const std::string &name);
+
+    /// @brief move the mixer from its current state to [name] in [time]
+    /// seconds, replacing the blend in progress. The filters which are not
+    /// active are skipped.
+    /// @return false if the snapshot doesn't exist.
+    bool blend(const std::string &name, float time);
+
+    /// @brief find again the slots of the filters after one has been added
+    /// or removed.
+    void refreshFilters();
+
+    virtual unsigned int onTimeline(unsigned long long aSampleTime, unsigned int aSamples);
+
+private:
+    struct BlendTarget
+    {
+        int filterType;
+        unsigned int attributeId;
+        /// global filter slot of [filterType], -1 if not active
+        int filterSlot;
+        float from;
+        float to;
+    };
+
+    /// @brief the values of [name] merged with those of its ancestors.
+    std::vector<SnapshotValue> resolve(const std::string &name);
+    /// @brief the global volume and the parameters of the active filters.
+    std::vector<SnapshotValue> currentValues();
+    /// @brief the value a parameter is set to, not the modulated one.
+    float currentValue(int filterType, unsigned int attributeId);
+    void apply(const BlendTarget &target, float value);
+
+    SoLoud::Soloud *mSoloud;
+    Filters *mFilters;
+    ModMatrix *mModMatrix;
+
+    std::map<std::string, MixerSnapshot> mSnapshots;
+
+    /// also held by the audio thread while blending
+    std::mutex mMutex;
+    std::vector<BlendTarget> mTargets;
+    /// blend length and progress in samples
+    double mLength;
+    double mElapsed;
+    /// engine time of the last block
+    unsigned long long mTime;
+    bool mStarted;
+};
+
+#endif // MIXER_SNAPSHOTS_H
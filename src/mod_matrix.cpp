@@ -0,0 +1,464 @@
+#include "mod_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double kTwoPi = 6.283185307179586;
+
+    float lfoShape(ModShape shape, double phase)
+    {
+        switch (shape)
+        {
+        case MOD_SHAPE_SINE:
+            return (float)sin(phase * kTwoPi);
+        case MOD_SHAPE_TRIANGLE:
+            return (float)(phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase);
+        case MOD_SHAPE_SQUARE:
+            return phase < 0.5 ? 1.0f : -1.0f;
+        case MOD_SHAPE_SAW_UP:
+            return (float)(2.0 * phase - 1.0);
+        case MOD_SHAPE_SAW_DOWN:
+            return (float)(1.0 - 2.0 * phase);
+        }
+        return 0.0f;
+    }
+
+    bool waveParamIsValid(ModWaveformParam param)
+    {
+        return param >= MOD_WAVEFORM_FREQ && param <= MOD_WAVEFORM_SCALE;
+    }
+
+    float waveParamValue(const Basicwave *wave, ModWaveformParam param)
+    {
+        switch (param)
+        {
+        case MOD_WAVEFORM_FREQ:
+            return wave->mFreq * wave->mBaseSamplerate;
+        case MOD_WAVEFORM_DETUNE:
+            return wave->mSuperwaveDetune;
+        case MOD_WAVEFORM_SCALE:
+            return wave->mSuperwaveScale;
+        }
+        return 0.0f;
+    }
+}
+
+ModMatrix::ModMatrix(SoLoud::Soloud *soloud, Filters *filters)
+    : mSoloud(soloud),
+      mFilters(filters),
+      mNextId(1),
+      mBpm(120.0f),
+      mTime(0),
+      mStarted(false),
+      mRandom(0x9e3779b9u)
+{
+}
+
+void ModMatrix::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSources.clear();
+    mDestinations.clear();
+    mStarted = false;
+}
+
+void ModMatrix::setTempo(float bpm)
+{
+    if (bpm <= 0.0f)
+        return;
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBpm = bpm;
+}
+
+unsigned int ModMatrix::addSource(ModSource source)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    source.id = mNextId++;
+    if (mNextId == 0)
+        mNextId = 1;
+    source.phase = 0.0;
+    source.gate = false;
+    source.attacking = false;
+    source.releaseRate = 0.0f;
+    source.from = nextRandom();
+    source.to = nextRandom();
+    source.value = source.type == MOD_SOURCE_ENVELOPE ? 0.0f : (source.type == MOD_SOURCE_LFO ? lfoShape(source.shape, 0.0) : source.from);
+    mSources.push_back(source);
+    return source.id;
+}
+
+unsigned int ModMatrix::createLfo(ModShape shape, float rate, float syncBeats)
+{
+    if (shape < MOD_SHAPE_SINE || shape > MOD_SHAPE_SAW_DOWN || rate < 0.0f || syncBeats < 0.0f)
+        return 0;
+    ModSource source = {};
+    source.type = MOD_SOURCE_LFO;
+    source.shape = shape;
+    source.rate = rate;
+    source.syncBeats = syncBeats;
+    return addSource(source);
+}
+
+unsigned int ModMatrix::createEnvelope(float attack, float decay, float sustain, float release)
+{
+    if (attack < 0.0f || decay < 0.0f || release < 0.0f || sustain < 0.0f || sustain > 1.0f)
+        return 0;
+    ModSource source = {};
+    source.type = MOD_SOURCE_ENVELOPE;
+    source.attack = attack;
+    source.decay = decay;
+    source.sustain = sustain;
+    source.release = release;
+    return addSource(source);
+}
+
+unsigned int ModMatrix::createRandom(float rate, float syncBeats, bool smooth)
+{
+    if (rate < 0.0f || syncBeats < 0.0f)
+        return 0;
+    ModSource source = {};
+    source.type = MOD_SOURCE_RANDOM;
+    source.rate = rate;
+    source.syncBeats = syncBeats;
+    source.smooth = smooth;
+    return addSource(source);
+}
+
+ModSource *ModMatrix::findSource(unsigned int sourceId)
+{
+    for (ModSource &source : mSources)
+        if (source.id == sourceId)
+            return &source;
+    return nullptr;
+}
+
+bool ModMatrix::setSourceRate(unsigned int sourceId, ModShape shape, float rate, float syncBeats)
+{
+    if (shape < MOD_SHAPE_SINE || shape > MOD_SHAPE_SAW_DOWN || rate < 0.0f || syncBeats < 0.0f)
+        return false;
+    std::lock_guard<std::mutex> lock(mMutex);
+    ModSource *source = findSource(sourceId);
+    if (source == nullptr || source->type == MOD_SOURCE_ENVELOPE)
+        return false;
+    source->shape = shape;
+    source->rate = rate;
+    source->syncBeats = syncBeats;
+    return true;
+}
+
+bool ModMatrix::setGate(unsigned int sourceId, bool gate)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    ModSource *source = findSource(sourceId);
+    if (source == nullptr || source->type != MOD_SOURCE_ENVELOPE)
+        return false;
+    if (gate)
+    {
+        // restart the attack from the current level
+        source->attacking = true;
+    }
+    else if (source->gate)
+    {
+        source->releaseRate = source->release > 0.0f ? source->value / source->release : 1e9f;
+    }
+    source->gate = gate;
+    return true;
+}
+
+bool ModMatrix::removeSource(unsigned int sourceId)
+{
+    std::vector<unsigned int> routes;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = std::find_if(mSources.begin(), mSources.end(),
+                               [sourceId](const ModSource &s)
+                               { return s.id == sourceId; });
+        if (it == mSources.end())
+            return false;
+        mSources.erase(it);
+        for (const ModDestination &destination : mDestinations)
+            for (const ModRoute &route : destination.routes)
+                if (route.sourceId == sourceId)
+                    routes.push_back(route.id);
+    }
+    for (unsigned int routeId : routes)
+        removeRoute(routeId);
+    return true;
+}
+
+unsigned int ModMatrix::addRoute(const ModDestination &destination, unsigned int sourceId, float depth)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (findSource(sourceId) == nullptr)
+        return 0;
+
+    ModRoute route = {mNextId++, sourceId, depth};
+    if (mNextId == 0)
+        mNextId = 1;
+
+    for (ModDestination &d : mDestinations)
+    {
+        if (d.wave == destination.wave &&
+            (d.wave != nullptr ? d.waveParam == destination.waveParam
+                               : d.filterType == destination.filterType && d.attributeId == destination.attributeId))
+        {
+            d.routes.push_back(route);
+            return route.id;
+        }
+    }
+    mDestinations.push_back(destination);
+    mDestinations.back().routes.push_back(route);
+    return route.id;
+}
+
+unsigned int ModMatrix::addWaveformRoute(unsigned int sourceId, Basicwave *wave, ModWaveformParam param, float depth)
+{
+    if (wave == nullptr || !waveParamIsValid(param))
+        return 0;
+    ModDestination destination = {};
+    destination.wave = wave;
+    destination.waveParam = param;
+    destination.filterSlot = -1;
+    destination.base = waveParamValue(wave, param);
+    return addRoute(destination, sourceId, depth);
+}
+
+unsigned int ModMatrix::addFilterRoute(unsigned int sourceId, FilterType filterType, unsigned int attributeId, float depth)
+{
+    ModDestination destination = {};
+    destination.wave = nullptr;
+    destination.filterType = filterType;
+    destination.attributeId = attributeId;
+    destination.filterSlot = mFilters->isFilterActive(filterType);
+    destination.base = mFilters->getFxParams(filterType, attributeId);
+    return addRoute(destination, sourceId, depth);
+}
+
+bool ModMatrix::setRouteDepth(unsigned int routeId, float depth)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (ModDestination &destination : mDestinations)
+        for (ModRoute &route : destination.routes)
+            if (route.id == routeId)
+            {
+                route.depth = depth;
+                return true;
+            }
+    return false;
+}
+
+bool ModMatrix::removeRoute(unsigned int routeId)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto d = mDestinations.begin(); d != mDestinations.end(); ++d)
+    {
+        auto it = std::find_if(d->routes.begin(), d->routes.end(),
+                               [routeId](const ModRoute &r)
+                               { return r.id == routeId; });
+        if (it == d->routes.end())
+            continue;
+        d->routes.erase(it);
+        if (d->routes.empty())
+        {
+            apply(*d, d->base);
+            mDestinations.erase(d);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool ModMatrix::setWaveformBase(Basicwave *wave, ModWaveformParam param, float value)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (ModDestination &destination : mDestinations)
+        if (destination.wave == wave && destination.waveParam == param)
+        {
+            destination.base = value;
+            return true;
+        }
+    return false;
+}
+
+bool ModMatrix::setFilterBase(FilterType filterType, unsigned int attributeId, float value)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (ModDestination &destination : mDestinations)
+        if (destination.wave == nullptr &&
+            destination.filterType == filterType &&
+            destination.attributeId == attributeId)
+        {
+            destination.base = value;
+            return true;
+        }
+    return false;
+}
+
+bool ModMatrix::getFilterBase(FilterType filterType, unsigned int attributeId, float &value)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const ModDestination &destination : mDestinations)
+        if (destination.wave == nullptr &&
+            destination.filterType == filterType &&
+            destination.attributeId == attributeId)
+        {
+            value = destination.base;
+            return true;
+        }
+    return false;
+}
+
+void ModMatrix::refreshFilters()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (ModDestination &destination : mDestinations)
+    {
+        if (destination.wave != nullptr)
+            continue;
+        const int slot = mFilters->isFilterActive(destination.filterType);
+        // a filter just added starts from its default values
+        if (destination.filterSlot < 0 && slot >= 0)
+            destination.base = mFilters->getFxParams(destination.filterType, destination.attributeId);
+        destination.filterSlot = slot;
+    }
+}
+
+void ModMatrix::removeSound(SoLoud::AudioSource *source)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDestinations.erase(std::remove_if(mDestinations.begin(), mDestinations.end(),
+                                       [source](const ModDestination &d)
+                                       { return d.wave != nullptr && d.wave == source; }),
+                        mDestinations.end());
+}
+
+float ModMatrix::nextRandom()
+{
+    // xorshift32
+    mRandom ^= mRandom << 13;
+    mRandom ^= mRandom >> 17;
+    mRandom ^= mRandom << 5;
+    return (float)(mRandom >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+void ModMatrix::advance(double seconds)
+{
+    for (ModSource &source : mSources)
+    {
+        if (source.type == MOD_SOURCE_ENVELOPE)
+        {
+            float level = source.value;
+            const float dt = (float)seconds;
+            if (source.gate)
+            {
+                if (source.attacking)
+                {
+                    level = source.attack > 0.0f ? level + dt / source.attack : 1.0f;
+                    if (level >= 1.0f)
+                    {
+                        level = 1.0f;
+                        source.attacking = false;
+                    }
+                }
+                else if (level > source.sustain)
+                {
+                    level = source.decay > 0.0f ? level - dt * (1.0f - source.sustain) / source.decay : source.sustain;
+                    if (level < source.sustain)
+                        level = source.sustain;
+                }
+            }
+            else
+            {
+                level -= dt * source.releaseRate;
+                if (level < 0.0f)
+                    level = 0.0f;
+            }
+            source.value = level;
+            continue;
+        }
+
+        const double rate = source.syncBeats > 0.0f ? mBpm / 60.0 / source.syncBeats : source.rate;
+        source.phase += seconds * rate;
+        if (source.phase >= 1.0)
+        {
+            source.phase -= floor(source.phase);
+            if (source.type == MOD_SOURCE_RANDOM)
+            {
+                source.from = source.to;
+                source.to = nextRandom();
+            }
+        }
+
+        if (source.type == MOD_SOURCE_LFO)
+            source.value = lfoShape(source.shape, source.phase);
+        else
+            source.value = source.smooth
+                               ? source.from + (source.to - source.from) * (float)source.phase
+                               : source.to;
+    }
+}
+
+void ModMatrix::apply(const ModDestination &destination, float value)
+{
+    if (destination.wave == nullptr)
+    {
+        if (destination.filterSlot >= 0)
+            mSoloud->setFilterParameter(0, destination.filterSlot, destination.attributeId, value);
+        return;
+    }
+
+    switch (destination.waveParam)
+    {
+    case MOD_WAVEFORM_FREQ:
+        destination.wave->setFreq(value);
+        break;
+    case MOD_WAVEFORM_DETUNE:
+        destination.wave->setDetune(value);
+        break;
+    case MOD_WAVEFORM_SCALE:
+        destination.wave->setScale(value);
+        break;
+    }
+}
+
+unsigned int ModMatrix::onTimeline(unsigned long long aSampleTime, unsigned int aSamples)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (!mStarted || aSampleTime < mTime)
+    {
+        mStarted = true;
+        mTime = aSampleTime;
+    }
+    const float samplerate = mSoloud->mSamplerate > 0 ? (float)mSoloud->mSamplerate : 44100.0f;
+    advance((double)(aSampleTime - mTime) / samplerate);
+    mTime = aSampleTime;
+
+    if (mDestinations.empty())
+        return 0;
+
+    for (const ModDestination &destination : mDestinations)
+    {
+        float sum = 0.0f;
+        for (const ModRoute &route : destination.routes)
+        {
+            const ModSource *source = findSource(route.sourceId);
+            if (source != nullptr)
+                sum += route.depth * source->value;
+        }
+
+        float value = destination.base + sum;
+        if (destination.wave != nullptr && destination.waveParam == MOD_WAVEFORM_FREQ)
+        {
+            // the depth is in semitones
+            value = destination.base * powf(2.0f, sum / 12.0f);
+            const float nyquist = destination.wave->mBaseSamplerate * 0.5f;
+            if (value > nyquist)
+                value = nyquist;
+        }
+        apply(destination, value);
+    }
+    return MOD_BLOCK_SAMPLES;
+}
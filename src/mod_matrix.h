@@ -0,0 +1,189 @@
+#ifndef MOD_MATRIX_H
+#define MOD_MATRIX_H
+
+#include "soloud.h"
+#include "timeline.h"
+#include "filters/filters.h"
+#include "synth/basic_wave.h"
+
+#include <mutex>
+#include <vector>
+
+/// The modulation is evaluated once every [MOD_BLOCK_SAMPLES] while some
+/// parameter is modulated.
+#define MOD_BLOCK_SAMPLES 128
+
+typedef enum ModSourceType
+{
+    /// periodic wave from -1 to 1
+    MOD_SOURCE_LFO,
+    /// ADSR from 0 to 1 driven by a gate
+    MOD_SOURCE_ENVELOPE,
+    /// a new random value from -1 to 1 every cycle
+    MOD_SOURCE_RANDOM
+} ModSourceType_t;
+
+typedef enum ModShape
+{
+    MOD_SHAPE_SINE,
+    MOD_SHAPE_TRIANGLE,
+    MOD_SHAPE_SQUARE,
+    MOD_SHAPE_SAW_UP,
+    MOD_SHAPE_SAW_DOWN
+} ModShape_t;
+
+typedef enum ModWaveformParam
+{
+    /// frequency, the depth is in semitones
+    MOD_WAVEFORM_FREQ,
+    MOD_WAVEFORM_DETUNE,
+    MOD_WAVEFORM_SCALE
+} ModWaveformParam_t;
+
+struct ModSource
+{
+    unsigned int id;
+    ModSourceType type;
+    ModShape shape;
+    /// cycles per second when [syncBeats] is 0
+    float rate;
+    /// cycle length in beats of the matrix tempo, 0 to use [rate]
+    float syncBeats;
+    double phase;
+    /// the output for the current block
+    float value;
+
+    /// envelope
+    float attack;
+    float decay;
+    float sustain;
+    float release;
+    bool gate;
+    bool attacking;
+    /// level lost per second after the gate is closed
+    float releaseRate;
+
+    /// random: [value] goes from [from] to [to] during the cycle
+    bool smooth;
+    float from;
+    float to;
+};
+
+struct ModRoute
+{
+    unsigned int id;
+    unsigned int sourceId;
+    float depth;
+};
+
+/// A parameter changed by one or more routes.
+struct ModDestination
+{
+    /// null for a filter parameter
+    Basicwave *wave;
+    ModWaveformParam waveParam;
+    FilterType filterType;
+    unsigned int attributeId;
+    /// global filter slot of [filterType], -1 if the filter is not active
+    int filterSlot;
+    /// the value set by the user, which the routes are added to
+    float base;
+    std::vector<ModRoute> routes;
+};
+
+/// Native modulation of synth and filter parameters.
+///
+/// LFOs, envelopes and random sources are routed with a depth to the
+/// parameters of waveform sounds and of the global filters. It is driven
+/// by the [Timeline], so the sources are evaluated and the parameters set
+/// by the audio thread once per block of [MOD_BLOCK_SAMPLES], without any
+/// call from Dart after the setup.
+class ModMatrix : public TimelineListener
+{
+public:
+    ModMatrix(SoLoud::Soloud *soloud, Filters *filters);
+
+    /// @brief remove all sources and routes.
+    void clear();
+
+    /// @brief set the tempo used by the synced sources.
+    void setTempo(float bpm);
+
+    /// @brief add an LFO.
+    /// @return the id of the source or 0 if a parameter is not valid.
+    unsigned int createLfo(ModShape shape, float rate, float syncBeats);
+
+    /// @brief add an envelope. Times in seconds, [sustain] from 0 to 1.
+    unsigned int createEnvelope(float attack, float decay, float sustain, float release);
+
+    /// @brief add a random source, [smooth] to glide between the values.
+    unsigned int createRandom(float rate, float syncBeats, bool smooth);
+
+    /// @brief change the shape and speed of an LFO or a random source.
+    bool setSourceRate(unsigned int sourceId, ModShape shape, float rate, float syncBeats);
+
+    /// @brief open or close the gate of an envelope.
+    bool setGate(unsigned int sourceId, bool gate);
+
+    /// @brief remove a source and its routes.
+    bool removeSource(unsigned int sourceId);
+
+    /// @brief route [sourceId] to a parameter of [wave].
+    /// @return the id of the route or 0 if [sourceId] doesn't exist.
+    unsigned int addWaveformRoute(unsigned int sourceId, Basicwave *wave, ModWaveformParam param, float depth);
+
+    /// @brief route [sourceId] to a parameter of a global filter.
+    unsigned int addFilterRoute(unsigned int sourceId, FilterType filterType, unsigned int attributeId, float depth);
+
+    bool setRouteDepth(unsigned int routeId, float depth);
+
+    /// @brief remove a route. A parameter left without routes gets back its
+    /// base value.
+    bool removeRoute(unsigned int routeId);
+
+    /// @brief set the value a modulated waveform parameter oscillates around.
+    /// @return false if the parameter is not modulated.
+    bool setWaveformBase(Basicwave *wave, ModWaveformParam param, float value);
+
+    /// @brief set the value a modulated filter parameter oscillates around.
+    /// @return false if the parameter is not modulated.
+    bool setFilterBase(FilterType filterType, unsigned int attributeId, float value);
+
+    /// @brief get the value a modulated filter parameter oscillates around.
+    /// @return false if the parameter is not modulated.
+    bool getFilterBase(FilterType filterType, unsigned int attributeId, float &value);
+
+    /// @brief find again the slots of the filters after one has been added
+    /// or removed.
+    void refreshFilters();
+
+    /// @brief remove the routes to [source]. Used when it is disposed.
+    void removeSound(SoLoud::AudioSource *source);
+
+    virtual unsigned int onTimeline(unsigned long long aSampleTime, unsigned int aSamples);
+
+private:
+    unsigned int addSource(ModSource source);
+    unsigned int addRoute(const ModDestination &destination, unsigned int sourceId, float depth);
+    ModSource *findSource(unsigned int sourceId);
+    /// @brief move the sources [seconds] forward.
+    void advance(double seconds);
+    void apply(const ModDestination &destination, float value);
+    float nextRandom();
+
+    SoLoud::Soloud *mSoloud;
+    Filters *mFilters;
+
+    /// also held by the audio thread while modulating
+    std::mutex mMutex;
+    std::vector<ModSource> mSources;
+    std::vector<ModDestination> mDestinations;
+    unsigned int mNextId;
+    float mBpm;
+    /// engine time of the last evaluation
+    unsigned long long mTime;
+    bool mStarted;
+    unsigned int mRandom;
+};
+
+#endif // MOD_MATRIX_H
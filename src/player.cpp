@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cstdarg>
+#include <climits>
 #include <random> 
 #ifdef _IS_WIN_
 #include <stddef.h> // for size_t
@@ -15,7 +16,12 @@
 #include <unistd.h>
 #endif
 
-Player::Player() : mInited(false), mFilters(&soloud){};
+Player::Player() : mInited(false), mFilters(&soloud), mTimeline(&soloud), mNextSequencerId(1), mNextSamplerId(1), mStatusBlock(&soloud), mAudioClock(&soloud), mModMatrix(&soloud, &mFilters), mSnapshots(&soloud, &mFilters, &mModMatrix)
+{
+    // the modulation is idle until a route is added
+    mTimeline.addListener(&mModMatrix);
+    mTimeline.addListener(&mSnapshots);
+}
 Player::~Player()
 {
     dispose();
@@ -26,6 +32,11 @@ PlayerErrors Player::init()
     if (mInited)
         dispose();
 
+    // the timeline runs its events from the audio thread before each mix
+    soloud.setMixCallback(&Timeline::mixCallback, &mTimeline);
+    soloud.setPostMixCallback(&Player::postMixCallback, this);
+    mAudioClock.reset();
+
     // initialize SoLoud.
     SoLoud::result result = soloud.init(
         SoLoud::Soloud::CLIP_ROUNDOFF,
@@ -44,7 +55,22 @@ void Player::dispose()
 {
     // Clean up SoLoud
     soloud.deinit();
+    for (auto &sequencer : sequencers)
+        mTimeline.removeListener(sequencer.get());
+    sequencers.clear();
+    samplers.clear();
+    mModMatrix.clear();
+    mSnapshots.clear();
+    mTimeline.clear();
     mInited = false;
+    mSpeechCache.clear();
+    mLegacySpeech.clear();
+    mSfxrCache.clear();
+    mPeakCache.clear();
+    mSpectrogramJobs.clear();
+    mRhythmCache.clear();
+    mLoudnessCache.clear();
+    containers.clear();
     sounds.clear();
 }
 
@@ -130,6 +156,10 @@ PlayerErrors Player::loadFile(
     {
         sounds.pop_back();
     }
+    else if (mMeasureLoudnessOnLoad)
+    {
+        loudnessMeter(hash);
+    }
     return (PlayerErrors)result;
 }
 
@@ -176,13 +206,7 @@ PlayerErrors Player::loadWaveform(
     if (!mInited)
         return backendNotInited;
 
-    hash = 0;
-
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::uniform_int_distribution<unsigned int> dist(0, INT64_MAX);
-
-    hash = dist(g);
+    hash = newSoundHash();
     
     sounds.push_back(std::make_unique<ActiveSound>());
     sounds.back().get()->completeFileName = "";
@@ -194,6 +218,266 @@ PlayerErrors Player::loadWaveform(
     return noError;
 }
 
+PlayerErrors Player::loadPushStream(
+    unsigned int sampleRate,
+    unsigned int channels,
+    int format,
+    unsigned int bufferFrames,
+    unsigned int prebufferFrames,
+    unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if (sampleRate == 0 || channels == 0 || channels > MAX_CHANNELS ||
+        bufferFrames == 0 || (format != PCM_F32LE && format != PCM_S16LE))
+        return invalidParameter;
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<PushStream>(
+        (float)sampleRate, channels, (PushStreamFormat)format,
+        bufferFrames, prebufferFrames);
+    sounds.back().get()->soundType = TYPE_PUSHSTREAM;
+
+    return noError;
+}
+
+PushStream *Player::getPushStream(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || sound->soundType != TYPE_PUSHSTREAM)
+        return nullptr;
+    return static_cast<PushStream *>(sound->sound.get());
+}
+
+PlayerErrors Player::loadPlaylist(
+    unsigned int sampleRate,
+    unsigned int channels,
+    unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if (sampleRate == 0 || channels == 0 || channels > MAX_CHANNELS)
+        return invalidParameter;
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<Playlist>((float)sampleRate, channels);
+    sounds.back().get()->soundType = TYPE_PLAYLIST;
+
+    return noError;
+}
+
+Playlist *Player::getPlaylist(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || sound->soundType != TYPE_PLAYLIST)
+        return nullptr;
+    return static_cast<Playlist *>(sound->sound.get());
+}
+
+PlayerErrors Player::loadPolySynth(
+    int waveform,
+    unsigned int maxVoices,
+    unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if (waveform < 0 || waveform > SoLoud::Soloud::WAVE_FSAW ||
+        maxVoices == 0 || maxVoices > POLY_SYNTH_MAX_VOICES)
+        return invalidParameter;
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<PolySynth>(
+        (float)soloud.getBackendSamplerate(), waveform, maxVoices);
+    sounds.back().get()->soundType = TYPE_POLYSYNTH;
+
+    return noError;
+}
+
+PolySynth *Player::getPolySynth(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr ||
+        (sound->soundType != TYPE_POLYSYNTH && sound->soundType != TYPE_FMSYNTH))
+        return nullptr;
+    return static_cast<PolySynth *>(sound->sound.get());
+}
+
+PlayerErrors Player::loadFmSynth(
+    unsigned int operators,
+    unsigned int maxVoices,
+    unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if ((operators != 4 && operators != 6) ||
+        maxVoices == 0 || maxVoices > POLY_SYNTH_MAX_VOICES)
+        return invalidParameter;
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<FmSynth>(
+        (float)soloud.getBackendSamplerate(), operators, maxVoices);
+    sounds.back().get()->soundType = TYPE_FMSYNTH;
+
+    return noError;
+}
+
+FmSynth *Player::getFmSynth(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || sound->soundType != TYPE_FMSYNTH)
+        return nullptr;
+    return static_cast<FmSynth *>(sound->sound.get());
+}
+
+PlayerErrors Player::loadGranular(unsigned int wavHash, unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    ActiveSound *wav = findByHash(wavHash);
+    if (wav == nullptr || wav->soundType != TYPE_WAV)
+        return invalidParameter;
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<Granular>(
+        static_cast<SoLoud::Wav *>(wav->sound.get()));
+    sounds.back().get()->soundType = TYPE_GRANULAR;
+
+    return noError;
+}
+
+PlayerErrors Player::loadSfxr(const SoLoud::SfxrParams &params, unsigned int &hash)
+{
+    const uint64_t key = SfxrSample::hashParams(params);
+    auto cached = mSfxrCache.find(key);
+    if (cached != mSfxrCache.end())
+    {
+        hash = cached->second;
+        return noError;
+    }
+
+    hash = newSoundHash();
+
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = hash;
+    sounds.back().get()->sound = std::make_unique<SfxrSample>(params);
+    sounds.back().get()->soundType = TYPE_SFXR;
+    mSfxrCache[key] = hash;
+
+    return noError;
+}
+
+PlayerErrors Player::loadSfxrPreset(int preset, int seed, unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    SoLoud::Sfxr sfxr;
+    if (sfxr.loadPreset(preset, seed) != SoLoud::SO_NO_ERROR)
+        return invalidParameter;
+    return loadSfxr(sfxr.mParams, hash);
+}
+
+PlayerErrors Player::loadSfxrParams(int waveType, const float *values, unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if (values == nullptr || waveType < 0 || waveType > 3)
+        return invalidParameter;
+    return loadSfxr(SfxrSample::paramsFromValues(waveType, values), hash);
+}
+
+PlayerErrors Player::loadSfxrMem(unsigned char *mem, unsigned int length, unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    SoLoud::Sfxr sfxr;
+    if (mem == nullptr || sfxr.loadParamsMem(mem, length, false, false) != SoLoud::SO_NO_ERROR)
+        return invalidParameter;
+    return loadSfxr(sfxr.mParams, hash);
+}
+
+PlayerErrors Player::createVariationContainer(const unsigned int *soundHashes,
+                                              unsigned int count,
+                                              VariationMode mode,
+                                              unsigned int &hash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    hash = 0;
+    if (soundHashes == nullptr || count == 0 ||
+        mode < VARIATION_RANDOM_NO_REPEAT || mode > VARIATION_SEQUENTIAL)
+        return invalidParameter;
+    for (unsigned int i = 0; i < count; i++)
+        if (findByHash(soundHashes[i]) == nullptr)
+            return invalidParameter;
+
+    hash = newSoundHash();
+    containers.push_back(std::make_unique<VariationContainer>(hash, mode));
+    containers.back()->setSounds(soundHashes, count);
+    return noError;
+}
+
+VariationContainer *Player::findContainer(unsigned int hash)
+{
+    for (auto &container : containers)
+        if (container->getHash() == hash)
+            return container.get();
+    return nullptr;
+}
+
+ActiveSound *Player::nextVariation(VariationContainer *container, float &volume, float &speed)
+{
+    unsigned int soundHash;
+    if (!container->next(soundHash, volume, speed))
+        return nullptr;
+    return findByHash(soundHash);
+}
+
+Granular *Player::getGranular(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || sound->soundType != TYPE_GRANULAR)
+        return nullptr;
+    return static_cast<Granular *>(sound->sound.get());
+}
+
 void Player::setWaveformScale(unsigned int soundHash, float newScale)
 {
     auto const &s = std::find_if(sounds.begin(), sounds.end(),
@@ -203,7 +487,10 @@ void Player::setWaveformScale(unsigned int soundHash, float newScale)
     if (s == sounds.end() || s->get()->soundType != TYPE_SYNTH)
         return;
 
-    static_cast<Basicwave*>(s->get()->sound.get())->setScale(newScale);
+    Basicwave *wave = static_cast<Basicwave*>(s->get()->sound.get());
+    // a modulated parameter keeps oscillating around the new value
+    if (!mModMatrix.setWaveformBase(wave, MOD_WAVEFORM_SCALE, newScale))
+        wave->setScale(newScale);
 }
 
 void Player::setWaveformDetune(unsigned int soundHash, float newDetune)
@@ -215,7 +502,10 @@ void Player::setWaveformDetune(unsigned int soundHash, float newDetune)
     if (s == sounds.end() || s->get()->soundType != TYPE_SYNTH)
         return;
 
-    static_cast<Basicwave*>(s->get()->sound.get())->setDetune(newDetune);
+    Basicwave *wave = static_cast<Basicwave*>(s->get()->sound.get());
+    // a modulated parameter keeps oscillating around the new value
+    if (!mModMatrix.setWaveformBase(wave, MOD_WAVEFORM_DETUNE, newDetune))
+        wave->setDetune(newDetune);
 }
 
 void Player::setWaveform(unsigned int soundHash, int newWaveform)
@@ -240,7 +530,10 @@ void Player::setWaveformFreq(unsigned int soundHash, float newFreq)
     if (s == sounds.end() || s->get()->soundType != TYPE_SYNTH)
         return;
 
-    static_cast<Basicwave*>(s->get()->sound.get())->setFreq(newFreq);
+    Basicwave *wave = static_cast<Basicwave*>(s->get()->sound.get());
+    // a modulated parameter keeps oscillating around the new value
+    if (!mModMatrix.setWaveformBase(wave, MOD_WAVEFORM_FREQ, newFreq))
+        wave->setFreq(newFreq);
 }
 
 void Player::setWaveformSuperwave(unsigned int soundHash, bool superwave)
@@ -283,6 +576,59 @@ float Player::getRelativePlaySpeed(unsigned int handle)
     return soloud.getRelativePlaySpeed(handle);
 }
 
+PlayerErrors Player::setTimeStretch(SoLoud::handle handle, TimeStretchMode mode, float tempo, float pitch)
+{
+    if (mode != TIME_STRETCH_WSOLA && mode != TIME_STRETCH_PHASE_VOCODER)
+        return invalidParameter;
+
+    // the stretchers are the only voice processors set here
+    soloud.lockAudioMutex_internal();
+    int voice = soloud.getVoiceFromHandle_internal(handle);
+    if (voice < 0)
+    {
+        soloud.unlockAudioMutex_internal();
+        return invalidParameter;
+    }
+    SoLoud::AudioSourceInstance *instance = soloud.mVoice[voice];
+    TimeStretch *current = static_cast<TimeStretch *>(instance->mProcessor);
+    if (current != nullptr && current->getMode() == mode)
+    {
+        current->setTempo(tempo);
+        current->setPitch(pitch);
+        soloud.unlockAudioMutex_internal();
+        return noError;
+    }
+    const unsigned int channels = instance->mChannels;
+    const float samplerate = instance->mBaseSamplerate;
+    soloud.unlockAudioMutex_internal();
+
+    TimeStretch *stretch = new TimeStretch(mode, channels, samplerate);
+    stretch->setTempo(tempo);
+    stretch->setPitch(pitch);
+    if (soloud.setVoiceProcessor(handle, stretch) != SoLoud::SO_NO_ERROR)
+    {
+        delete stretch;
+        return invalidParameter;
+    }
+    return noError;
+}
+
+void Player::removeTimeStretch(SoLoud::handle handle)
+{
+    soloud.setVoiceProcessor(handle, nullptr);
+}
+
+float Player::getTimeStretchLoad(SoLoud::handle handle)
+{
+    float load = 0.0f;
+    soloud.lockAudioMutex_internal();
+    int voice = soloud.getVoiceFromHandle_internal(handle);
+    if (voice >= 0 && soloud.mVoice[voice]->mProcessor != nullptr)
+        load = static_cast<TimeStretch *>(soloud.mVoice[voice]->mProcessor)->getLoad();
+    soloud.unlockAudioMutex_internal();
+    return load;
+}
+
 unsigned int Player::play(
     unsigned int soundHash,
     float volume,
@@ -294,16 +640,62 @@ unsigned int Player::play(
                                  { return f->soundHash == soundHash; });
 
     if (s == sounds.end())
-        return 0;
+    {
+        VariationContainer *container = findContainer(soundHash);
+        if (container == nullptr)
+            return 0;
+        float variationVolume, speed;
+        ActiveSound *sound = nextVariation(container, variationVolume, speed);
+        if (sound == nullptr)
+            return 0;
+        // start paused so the speed is set before the first sample
+        SoLoud::handle newHandle = soloud.play(*sound->sound.get(), volume * variationVolume, pan, true, 0);
+        if (newHandle == 0)
+            return 0;
+        soloud.setRelativePlaySpeed(newHandle, speed);
+        if (!paused)
+            soloud.setPause(newHandle, false);
+        sound->handle.emplace_back(newHandle);
+        return newHandle;
+    }
 
     ActiveSound *sound = s->get();
     SoLoud::handle newHandle = soloud.play(*sound->sound.get(), volume, pan, paused, 0);
+    if (newHandle == 0)
+        return 0;
     sound->handle.emplace_back(newHandle);
     return newHandle;
 }
 
+PlayerErrors Player::setInstanceLimit(unsigned int soundHash,
+                                      unsigned int maxInstances,
+                                      StealPolicy policy,
+                                      double minRetriggerInterval)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || policy < STEAL_OLDEST || policy > STEAL_REJECT)
+        return invalidParameter;
+    // read by the plays made on the audio thread
+    soloud.lockAudioMutex_internal();
+    sound->sound->setInstanceLimit(maxInstances, policy, minRetriggerInterval);
+    soloud.unlockAudioMutex_internal();
+    return noError;
+}
+
 void Player::stop(unsigned int handle)
 {
+    if (soloud.isVoiceGroup(handle))
+    {
+        soloud.stop(handle);
+        // forget the handles of the voices just stopped
+        for (auto &sound : sounds)
+            sound->handle.erase(std::remove_if(sound->handle.begin(), sound->handle.end(),
+                                               [this](SoLoud::handle &h)
+                                               { return !soloud.isValidVoiceHandle(h); }),
+                                sound->handle.end());
+        return;
+    }
+
     int handleId;
     ActiveSound *sound = findByHandle(handle, &handleId);
     if (sound == nullptr)
@@ -322,8 +714,35 @@ void Player::disposeSound(unsigned int soundHash)
                                  { return f->soundHash == soundHash; });
 
     if (s == sounds.end())
+    {
+        containers.erase(std::remove_if(containers.begin(), containers.end(),
+                                        [soundHash](std::unique_ptr<VariationContainer> &c)
+                                        { return c->getHash() == soundHash; }),
+                         containers.end());
         return;
+    }
 
+    for (auto &container : containers)
+        container->removeSound(soundHash);
+    mTimeline.cancelSource(s->get()->sound.get());
+    for (auto &sequencer : sequencers)
+        sequencer->removeSource(s->get()->sound.get());
+    mModMatrix.removeSound(s->get()->sound.get());
+    for (auto &sampler : samplers)
+        sampler->removeSource(s->get()->sound.get());
+    // the granular sounds reading this Wav go silent
+    for (auto &sound : sounds)
+        if (sound->soundType == TYPE_GRANULAR &&
+            static_cast<Granular *>(sound->sound.get())->mWav == s->get()->sound.get())
+            static_cast<Granular *>(sound->sound.get())->detach();
+    for (auto it = mSpeechCache.begin(); it != mSpeechCache.end();)
+        it = it->second == soundHash ? mSpeechCache.erase(it) : std::next(it);
+    for (auto it = mSfxrCache.begin(); it != mSfxrCache.end();)
+        it = it->second == soundHash ? mSfxrCache.erase(it) : std::next(it);
+    mPeakCache.erase(soundHash);
+    eraseSpectrogramJobs(soundHash);
+    mRhythmCache.erase(soundHash);
+    mLoudnessCache.erase(soundHash);
     s->get()->sound.get()->stop();
     // remove the sound from the list
     sounds.erase(std::remove_if(sounds.begin(), sounds.end(),
@@ -333,7 +752,23 @@ void Player::disposeSound(unsigned int soundHash)
 
 void Player::disposeAllSound()
 {
+    mTimeline.clear();
+    for (auto &sequencer : sequencers)
+        for (auto &sound : sounds)
+            sequencer->removeSource(sound->sound.get());
+    for (auto &sound : sounds)
+        mModMatrix.removeSound(sound->sound.get());
+    for (auto &sampler : samplers)
+        sampler->clearZones();
     soloud.stopAll();
+    mSpeechCache.clear();
+    mLegacySpeech.clear();
+    mSfxrCache.clear();
+    mPeakCache.clear();
+    mSpectrogramJobs.clear();
+    mRhythmCache.clear();
+    mLoudnessCache.clear();
+    containers.clear();
     sounds.clear();
 }
 
@@ -347,19 +782,109 @@ PlayerErrors Player::textToSpeech(const std::string &textToSpeech, unsigned int
     if (!mInited)
         return backendNotInited;
 
-    sounds.push_back(std::make_unique<ActiveSound>());
-    sounds.back().get()->completeFileName = std::string("");
-    SoLoud::result result = speech.setText(textToSpeech.c_str());
-    if (result == SoLoud::SO_NO_ERROR)
+    // this API does not return the sounds, so they are disposed here
+    std::vector<unsigned int> playing;
+    for (unsigned int hash : mLegacySpeech)
     {
-        handle = soloud.play(speech);
-        sounds.back().get()->handle.push_back(handle);
+        ActiveSound *sound = findByHash(hash);
+        if (sound == nullptr)
+            continue;
+        if (soloud.countAudioSource(*sound->sound) > 0)
+            playing.push_back(hash);
+        else
+            disposeSound(hash);
     }
-    else
+    mLegacySpeech.swap(playing);
+
+    unsigned int soundHash = 0;
+    PlayerErrors result = speak(textToSpeech, soundHash, handle);
+    if (result == noError && findByHash(soundHash)->soundType == TYPE_SPEECH)
+        mLegacySpeech.push_back(soundHash);
+    return result;
+}
+
+static std::string speechCacheKey(const SpeechParams &params, const std::string &text)
+{
+    return std::to_string(params.baseFrequency) + ' ' +
+           std::to_string(params.baseSpeed) + ' ' +
+           std::to_string(params.baseDeclination) + ' ' +
+           std::to_string(params.baseWaveform) + ' ' +
+           std::to_string(params.sampleRate) + '\n' + text;
+}
+
+PlayerErrors Player::speak(const std::string &text, unsigned int &soundHash, SoLoud::handle &handle)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    soundHash = 0;
+    handle = 0;
+    auto cached = mSpeechCache.find(speechCacheKey(mSpeechParams, text));
+    if (cached != mSpeechCache.end())
     {
-        sounds.emplace_back();
+        soundHash = cached->second;
+        handle = play(soundHash);
+        return handle == 0 ? invalidParameter : noError;
     }
-    return (PlayerErrors)result;
+
+    auto speech = std::make_unique<SpeechStream>(text, mSpeechParams);
+    speech->speak();
+    handle = soloud.play(*speech);
+    if (handle == 0)
+        return invalidParameter;
+
+    soundHash = newSoundHash();
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = soundHash;
+    sounds.back().get()->sound = std::move(speech);
+    sounds.back().get()->soundType = TYPE_SPEECH;
+    sounds.back().get()->handle.push_back(handle);
+    return noError;
+}
+
+void Player::setSpeechParams(unsigned int baseFrequency, float baseSpeed, float baseDeclination, int baseWaveform, bool engineRate)
+{
+    mSpeechParams.baseFrequency = baseFrequency;
+    mSpeechParams.baseSpeed = baseSpeed;
+    mSpeechParams.baseDeclination = baseDeclination;
+    mSpeechParams.baseWaveform = baseWaveform;
+    mSpeechParams.sampleRate = engineRate && mInited ? soloud.getBackendSamplerate() : 11025;
+}
+
+PlayerErrors Player::cacheSpeech(const std::string &text, unsigned int &soundHash)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    const std::string key = speechCacheKey(mSpeechParams, text);
+    auto cached = mSpeechCache.find(key);
+    if (cached != mSpeechCache.end())
+    {
+        soundHash = cached->second;
+        return noError;
+    }
+
+    soundHash = 0;
+    SpeechStream speech(text, mSpeechParams);
+    std::vector<float> samples = speech.render();
+    if (samples.empty())
+        return invalidParameter;
+
+    auto wav = std::make_unique<SoLoud::Wav>();
+    SoLoud::result result = wav->loadRawWave(samples.data(), (unsigned int)samples.size(),
+                                             speech.mBaseSamplerate, 1, true, true);
+    if (result != SoLoud::SO_NO_ERROR)
+        return (PlayerErrors)result;
+
+    soundHash = newSoundHash();
+    sounds.push_back(std::make_unique<ActiveSound>());
+    sounds.back().get()->completeFileName = "";
+    sounds.back().get()->soundHash = soundHash;
+    sounds.back().get()->sound = std::move(wav);
+    sounds.back().get()->soundType = TYPE_WAV;
+    mSpeechCache[key] = soundHash;
+    return noError;
 }
 
 void Player::setVisualizationEnabled(bool enabled)
@@ -388,15 +913,334 @@ double Player::getLength(unsigned int soundHash)
     auto const &s = std::find_if(sounds.begin(), sounds.end(),
                                  [&](std::unique_ptr<ActiveSound> const &f)
                                  { return f->soundHash == soundHash; });
-    if (s == sounds.end() || s->get()->soundType == TYPE_SYNTH)
+    if (s == sounds.end() || s->get()->soundType == TYPE_SYNTH ||
+        s->get()->soundType == TYPE_PUSHSTREAM ||
+        s->get()->soundType == TYPE_PLAYLIST ||
+        s->get()->soundType == TYPE_POLYSYNTH ||
+        s->get()->soundType == TYPE_FMSYNTH ||
+        s->get()->soundType == TYPE_GRANULAR ||
+        s->get()->soundType == TYPE_SPEECH)
         return 0.0;
     if (s->get()->soundType == TYPE_WAV)
         return static_cast<SoLoud::Wav*>(s->get()->sound.get())->getLength();
+    if (s->get()->soundType == TYPE_SFXR)
+        return static_cast<SfxrSample *>(s->get()->sound.get())->getLength();
     
     // if (s->get()->soundType == TYPE_WAVSTREAM)
     return static_cast<SoLoud::WavStream*>(s->get()->sound.get())->getLength();
 }
 
+/////////////////////////////////////////
+/// offline analysis
+/////////////////////////////////////////
+
+std::unique_ptr<SoundReader> Player::openReader(unsigned int soundHash)
+{
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr ||
+        (sound->soundType != TYPE_WAV && sound->soundType != TYPE_WAVSTREAM))
+        return nullptr;
+    return std::make_unique<SoundReader>(sound->sound.get(), sound->soundType == TYPE_WAVSTREAM);
+}
+
+AnalysisJob<LoudnessMeter> *Player::loudnessMeter(unsigned int soundHash)
+{
+    auto cached = mLoudnessCache.find(soundHash);
+    if (cached == mLoudnessCache.end())
+    {
+        std::unique_ptr<SoundReader> reader = openReader(soundHash);
+        if (!reader)
+            return nullptr;
+        auto job = std::make_unique<AnalysisJob<LoudnessMeter>>(
+            std::move(reader),
+            [](SoundReader &r) { return std::make_unique<LoudnessMeter>(r); });
+        cached = mLoudnessCache.emplace(soundHash, std::move(job)).first;
+    }
+    return cached->second.get();
+}
+
+PlayerErrors Player::prepareWaveformPeaks(unsigned int soundHash, bool &ready)
+{
+    ready = false;
+    auto cached = mPeakCache.find(soundHash);
+    if (cached == mPeakCache.end())
+    {
+        std::unique_ptr<SoundReader> reader = openReader(soundHash);
+        if (!reader)
+            return invalidParameter;
+        auto job = std::make_unique<AnalysisJob<WaveformPeaks>>(
+            std::move(reader),
+            [](SoundReader &r) { return std::make_unique<WaveformPeaks>(r); });
+        cached = mPeakCache.emplace(soundHash, std::move(job)).first;
+    }
+    ready = cached->second->isReady();
+    return noError;
+}
+
+PlayerErrors Player::getWaveformPeaks(
+    unsigned int soundHash,
+    float startTime,
+    float endTime,
+    unsigned int buckets,
+    float *min,
+    float *max,
+    float *rms)
+{
+    if (startTime < 0.0f || (endTime > 0.0f && endTime <= startTime))
+        return invalidParameter;
+
+    bool ready;
+    if (prepareWaveformPeaks(soundHash, ready) != noError)
+        return invalidParameter;
+
+    const WaveformPeaks &peaks = mPeakCache[soundHash]->get();
+    const double samplerate = peaks.getSamplerate();
+    const double end = endTime > 0.0f ? endTime * samplerate : (double)peaks.getFrames();
+    peaks.query(startTime * samplerate, end, buckets, min, max, rms);
+    return noError;
+}
+
+PlayerErrors Player::getSpectrogramSize(
+    unsigned int soundHash,
+    unsigned int size,
+    unsigned int hop,
+    unsigned int &rows,
+    unsigned int &bins)
+{
+    rows = 0;
+    bins = 0;
+    ActiveSound *sound = findByHash(soundHash);
+    if (!Spectrogram::isValid(size, hop) || sound == nullptr)
+        return invalidParameter;
+    if (sound->soundType == TYPE_WAV)
+        rows = Spectrogram::rowCount(static_cast<SoLoud::Wav *>(sound->sound.get())->mSampleCount, hop);
+    else if (sound->soundType == TYPE_WAVSTREAM)
+        rows = Spectrogram::rowCount(static_cast<SoLoud::WavStream *>(sound->sound.get())->mSampleCount, hop);
+    else
+        return invalidParameter;
+    bins = size / 2 + 1;
+    return noError;
+}
+
+PlayerErrors Player::computeSpectrogram(
+    unsigned int soundHash,
+    unsigned int size,
+    unsigned int hop,
+    SpectrogramWindow window,
+    float *magnitudes,
+    unsigned char *decibels,
+    float minDb,
+    unsigned int &job)
+{
+    job = 0;
+    if (!Spectrogram::isValid(size, hop) || window < SPECTROGRAM_HANN ||
+        window > SPECTROGRAM_RECTANGULAR || minDb >= 0.0f ||
+        (magnitudes == nullptr && decibels == nullptr))
+        return invalidParameter;
+    std::unique_ptr<SoundReader> reader = openReader(soundHash);
+    if (!reader)
+        return invalidParameter;
+    job = ++mNextSpectrogramJob;
+    mSpectrogramJobs[job] = {
+        soundHash,
+        std::make_unique<AnalysisJob<Spectrogram>>(
+            std::move(reader),
+            [=](SoundReader &r)
+            {
+                auto spectrogram = std::make_unique<Spectrogram>(size, hop, window);
+                spectrogram->compute(r, magnitudes, decibels, minDb);
+                return spectrogram;
+            })};
+    return noError;
+}
+
+PlayerErrors Player::pollSpectrogram(unsigned int job, bool &done)
+{
+    done = false;
+    auto running = mSpectrogramJobs.find(job);
+    if (running == mSpectrogramJobs.end())
+        return invalidParameter;
+    done = running->second.job->isReady();
+    if (done)
+        mSpectrogramJobs.erase(running);
+    return noError;
+}
+
+void Player::eraseSpectrogramJobs(unsigned int soundHash)
+{
+    for (auto it = mSpectrogramJobs.begin(); it != mSpectrogramJobs.end();)
+        it = it->second.soundHash == soundHash ? mSpectrogramJobs.erase(it) : std::next(it);
+}
+
+PlayerErrors Player::prepareRhythmAnalysis(unsigned int soundHash, bool &ready)
+{
+    ready = false;
+    auto cached = mRhythmCache.find(soundHash);
+    if (cached == mRhythmCache.end())
+    {
+        std::unique_ptr<SoundReader> reader = openReader(soundHash);
+        if (!reader)
+            return invalidParameter;
+        auto job = std::make_unique<AnalysisJob<RhythmAnalysis>>(
+            std::move(reader),
+            [](SoundReader &r) { return std::make_unique<RhythmAnalysis>(r); });
+        cached = mRhythmCache.emplace(soundHash, std::move(job)).first;
+    }
+    ready = cached->second->isReady();
+    return noError;
+}
+
+PlayerErrors Player::analyzeRhythm(
+    unsigned int soundHash,
+    float &bpm,
+    unsigned int &onsets,
+    unsigned int &beats)
+{
+    bpm = 0.0f;
+    onsets = 0;
+    beats = 0;
+    bool ready;
+    if (prepareRhythmAnalysis(soundHash, ready) != noError)
+        return invalidParameter;
+
+    const RhythmAnalysis &rhythm = mRhythmCache[soundHash]->get();
+    bpm = rhythm.getBpm();
+    onsets = (unsigned int)rhythm.getOnsets().size();
+    beats = (unsigned int)rhythm.getBeats().size();
+    return noError;
+}
+
+PlayerErrors Player::getRhythmEvents(unsigned int soundHash, float *onsets, float *beats)
+{
+    auto cached = mRhythmCache.find(soundHash);
+    if (cached == mRhythmCache.end())
+        return invalidParameter;
+    const RhythmAnalysis &rhythm = cached->second->get();
+    if (onsets != nullptr)
+        std::copy(rhythm.getOnsets().begin(), rhythm.getOnsets().end(), onsets);
+    if (beats != nullptr)
+        std::copy(rhythm.getBeats().begin(), rhythm.getBeats().end(), beats);
+    return noError;
+}
+
+void Player::setLoudnessMeasurementOnLoad(bool enabled)
+{
+    mMeasureLoudnessOnLoad = enabled;
+}
+
+PlayerErrors Player::prepareLoudness(unsigned int soundHash, bool &ready)
+{
+    ready = false;
+    AnalysisJob<LoudnessMeter> *job = loudnessMeter(soundHash);
+    if (job == nullptr)
+        return invalidParameter;
+    ready = job->isReady();
+    return noError;
+}
+
+PlayerErrors Player::getLoudness(unsigned int soundHash, float &integrated, float &truePeak)
+{
+    AnalysisJob<LoudnessMeter> *job = loudnessMeter(soundHash);
+    if (job == nullptr)
+        return invalidParameter;
+    const LoudnessMeter &meter = job->get();
+    integrated = meter.getIntegrated();
+    truePeak = meter.getTruePeak();
+    return noError;
+}
+
+PlayerErrors Player::setLoudnessNormalization(
+    unsigned int soundHash,
+    bool enabled,
+    float targetLufs,
+    float truePeakLimit,
+    float &gain)
+{
+    gain = 1.0f;
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr)
+        return invalidParameter;
+    if (enabled)
+    {
+        AnalysisJob<LoudnessMeter> *job = loudnessMeter(soundHash);
+        if (job == nullptr)
+            return invalidParameter;
+        const float integrated = job->get().getIntegrated();
+        const float truePeak = job->get().getTruePeak();
+        if (std::isfinite(integrated))
+        {
+            float gainDb = targetLufs - integrated;
+            if (std::isfinite(truePeak))
+                gainDb = std::min(gainDb, truePeakLimit - truePeak);
+            gain = powf(10.0f, gainDb / 20.0f);
+        }
+    }
+    sound->sound->setNormalizationGain(gain);
+    return noError;
+}
+
+PlayerErrors Player::trimSound(
+    unsigned int soundHash,
+    bool trimSilence,
+    float thresholdDb,
+    LoopSearch loopSearch,
+    float &start,
+    float &end,
+    float &loopStart,
+    float &loopEnd)
+{
+    start = end = loopStart = loopEnd = 0.0f;
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr || sound->soundType != TYPE_WAV)
+        return invalidParameter;
+    SoLoud::Wav *wav = static_cast<SoLoud::Wav *>(sound->sound.get());
+    if (wav->mData == nullptr || wav->mSampleCount == 0)
+        return invalidParameter;
+
+    const unsigned int frames = wav->mSampleCount;
+    const unsigned int channels = wav->mChannels;
+    const float samplerate = wav->mBaseSamplerate;
+    SoundBounds bounds(wav->mData, frames, channels, samplerate);
+    if (trimSilence)
+        bounds.trimSilence(thresholdDb);
+    bounds.findLoop(loopSearch);
+
+    const unsigned int from = bounds.getStart();
+    const unsigned int to = loopSearch != LOOP_SEARCH_NONE ? bounds.getLoopEnd() : bounds.getEnd();
+    start = from / samplerate;
+    end = to / samplerate;
+    loopStart = (bounds.getLoopStart() - from) / samplerate;
+    loopEnd = (to - from) / samplerate;
+
+    if (from > 0 || to < frames)
+    {
+        // the measure reads the data being replaced
+        const bool measured = mLoudnessCache.erase(soundHash) > 0;
+        mPeakCache.erase(soundHash);
+        eraseSpectrogramJobs(soundHash);
+        mRhythmCache.erase(soundHash);
+
+        const unsigned int count = to - from;
+        float *data = new float[(size_t)count * channels];
+        for (unsigned int c = 0; c < channels; c++)
+            std::copy(wav->mData + (size_t)c * frames + from, wav->mData + (size_t)c * frames + to,
+                      data + (size_t)c * count);
+
+        // the granular sounds read the data on the audio thread
+        wav->stop();
+        soloud.lockAudioMutex_internal();
+        delete[] wav->mData;
+        wav->mData = data;
+        wav->mSampleCount = count;
+        soloud.unlockAudioMutex_internal();
+
+        if (measured)
+            loudnessMeter(soundHash);
+    }
+    wav->setLoopPoint(loopStart);
+    return noError;
+}
+
 // time in seconds
 PlayerErrors Player::seek(SoLoud::handle handle, float time)
 {
@@ -405,7 +1249,13 @@ PlayerErrors Player::seek(SoLoud::handle handle, float time)
 
     int handleId;
     ActiveSound *sound = findByHandle(handle, &handleId);
-    if (sound == nullptr || sound->soundType == TYPE_SYNTH)
+    if (sound == nullptr || sound->soundType == TYPE_SYNTH ||
+        sound->soundType == TYPE_PUSHSTREAM ||
+        sound->soundType == TYPE_PLAYLIST ||
+        sound->soundType == TYPE_POLYSYNTH ||
+        sound->soundType == TYPE_FMSYNTH ||
+        sound->soundType == TYPE_GRANULAR ||
+        sound->soundType == TYPE_SPEECH)
         return invalidParameter;
 
     SoLoud::result result = soloud.seek(handle, time);
@@ -443,6 +1293,60 @@ bool Player::getIsValidVoiceHandle(SoLoud::handle handle)
     return soloud.isValidVoiceHandle(handle);
 }
 
+void Player::setPan(SoLoud::handle handle, float pan)
+{
+    soloud.setPan(handle, pan);
+}
+
+void Player::setProtectVoice(SoLoud::handle handle, bool protect)
+{
+    soloud.setProtectVoice(handle, protect);
+}
+
+/////////////////////////////////////////
+/// voice groups
+/////////////////////////////////////////
+
+SoLoud::handle Player::createVoiceGroup()
+{
+    return soloud.createVoiceGroup();
+}
+
+PlayerErrors Player::destroyVoiceGroup(SoLoud::handle group)
+{
+    if (soloud.destroyVoiceGroup(group) != SoLoud::SO_NO_ERROR)
+        return invalidParameter;
+    return noError;
+}
+
+PlayerErrors Player::addVoicesToGroup(SoLoud::handle group, const SoLoud::handle *handles, unsigned int count)
+{
+    if (!soloud.isVoiceGroup(group))
+        return invalidParameter;
+    // SoLoud would store a group in a group, which it can't iterate. All the
+    // handles are checked first to leave the group unchanged
+    for (unsigned int i = 0; i < count; i++)
+        if (soloud.isVoiceGroup(handles[i]))
+            return invalidParameter;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        SoLoud::result result = soloud.addVoiceToGroup(group, handles[i]);
+        if (result == SoLoud::OUT_OF_MEMORY)
+            return outOfMemory;
+    }
+    return noError;
+}
+
+bool Player::isVoiceGroup(SoLoud::handle handle)
+{
+    return soloud.isVoiceGroup(handle);
+}
+
+bool Player::isVoiceGroupEmpty(SoLoud::handle group)
+{
+    return soloud.isVoiceGroupEmpty(group);
+}
+
 ActiveSound *Player::findByHandle(SoLoud::handle handle, int *handleId)
 {
     *handleId = -1;
@@ -466,6 +1370,30 @@ ActiveSound *Player::findByHandle(SoLoud::handle handle, int *handleId)
     return nullptr;
 }
 
+ActiveSound *Player::findByHash(unsigned int soundHash)
+{
+    auto const &s = std::find_if(sounds.begin(), sounds.end(),
+                                 [&](std::unique_ptr<ActiveSound> const &f)
+                                 { return f->soundHash == soundHash; });
+    if (s == sounds.end())
+        return nullptr;
+    return s->get();
+}
+
+unsigned int Player::newSoundHash()
+{
+    static std::random_device rd;
+    static std::mt19937 g(rd());
+    std::uniform_int_distribution<unsigned int> dist(1, UINT_MAX);
+
+    unsigned int hash;
+    do
+    {
+        hash = dist(g);
+    } while (findByHash(hash) != nullptr || findContainer(hash) != nullptr);
+    return hash;
+}
+
 void Player::debug()
 {
     int n = 0;
@@ -514,6 +1442,259 @@ void Player::scheduleStop(SoLoud::handle handle, float time)
     soloud.scheduleStop(handle, time);
 }
 
+void Player::postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd)
+{
+    Player *player = static_cast<Player *>(aUserData);
+    StatusBlock::postMixCallback(&player->mStatusBlock, aBuffer, aSamples, aStride, aBlockEnd);
+    AudioClock::postMixCallback(&player->mAudioClock, aBuffer, aSamples, aStride, aBlockEnd);
+}
+
+unsigned long long Player::getEngineTime()
+{
+    return mTimeline.getTime();
+}
+
+PlayerErrors Player::schedulePlayAt(
+    unsigned int soundHash,
+    unsigned long long time,
+    float volume,
+    float pan,
+    unsigned int &eventId)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    eventId = 0;
+    ActiveSound *sound = findByHash(soundHash);
+    if (sound == nullptr)
+        return invalidParameter;
+
+    TimelineEvent event = {};
+    event.time = time;
+    event.action = TIMELINE_PLAY;
+    event.source = sound->sound.get();
+    event.value = volume;
+    event.pan = pan;
+    eventId = mTimeline.schedule(event);
+    return noError;
+}
+
+PlayerErrors Player::scheduleVoiceEventAt(
+    SoLoud::handle handle,
+    unsigned int playEventId,
+    unsigned long long time,
+    int action,
+    float value,
+    unsigned int &eventId)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    eventId = 0;
+    if (action < TIMELINE_STOP || action > TIMELINE_SEEK ||
+        (handle == 0 && playEventId == 0))
+        return invalidParameter;
+
+    TimelineEvent event = {};
+    event.time = time;
+    event.action = (TimelineAction)action;
+    event.handle = handle;
+    event.playEventId = playEventId;
+    event.value = value;
+    eventId = mTimeline.schedule(event);
+    return noError;
+}
+
+PlayerErrors Player::scheduleFilterParamAt(
+    FilterType filterType,
+    int attributeId,
+    float value,
+    unsigned long long time,
+    unsigned int &eventId)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    eventId = 0;
+    int filterId = mFilters.isFilterActive(filterType);
+    if (filterId < 0)
+        return filterNotFound;
+    if (attributeId < 0)
+        return invalidParameter;
+
+    TimelineEvent event = {};
+    event.time = time;
+    event.action = TIMELINE_FILTER_PARAM;
+    event.filterId = filterId;
+    event.attributeId = attributeId;
+    event.value = value;
+    eventId = mTimeline.schedule(event);
+    return noError;
+}
+
+bool Player::cancelScheduledEvent(unsigned int eventId)
+{
+    return mTimeline.cancel(eventId);
+}
+
+void Player::cancelAllScheduledEvents()
+{
+    mTimeline.clear();
+}
+
+SoLoud::handle Player::getScheduledHandle(unsigned int eventId)
+{
+    SoLoud::AudioSource *source = nullptr;
+    SoLoud::handle handle = mTimeline.getPlayedHandle(eventId, &source);
+    if (handle == 0)
+        return 0;
+
+    // the voice was started by the audio thread: add it to its sound
+    // here, so it can be found by its handle like the others
+    int handleId;
+    if (findByHandle(handle, &handleId) == nullptr)
+    {
+        for (auto &sound : sounds)
+        {
+            if (sound->sound.get() == source)
+            {
+                sound->handle.push_back(handle);
+                break;
+            }
+        }
+    }
+    return handle;
+}
+
+PlayerErrors Player::createSequencer(
+    float bpm,
+    unsigned int stepsPerBeat,
+    unsigned int steps,
+    unsigned int tracks,
+    unsigned int &id)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    id = 0;
+    if (bpm <= 0.0f || stepsPerBeat == 0 || steps == 0 || tracks == 0)
+        return invalidParameter;
+
+    id = mNextSequencerId++;
+    sequencers.push_back(std::make_unique<Sequencer>(
+        &soloud, id, bpm, stepsPerBeat, steps, tracks));
+    mTimeline.addListener(sequencers.back().get());
+    return noError;
+}
+
+void Player::destroySequencer(unsigned int id)
+{
+    auto const &s = std::find_if(sequencers.begin(), sequencers.end(),
+                                 [&](std::unique_ptr<Sequencer> const &f)
+                                 { return f->getId() == id; });
+    if (s == sequencers.end())
+        return;
+    // the audio thread doesn't use it anymore after this
+    mTimeline.removeListener(s->get());
+    sequencers.erase(s);
+}
+
+Sequencer *Player::getSequencer(unsigned int id)
+{
+    for (auto &sequencer : sequencers)
+        if (sequencer->getId() == id)
+            return sequencer.get();
+    return nullptr;
+}
+
+PlayerErrors Player::sequencerSetSteps(
+    unsigned int id,
+    const SequencerStepEdit *edits,
+    unsigned int count)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    Sequencer *sequencer = getSequencer(id);
+    if (sequencer == nullptr)
+        return invalidParameter;
+
+    // resolve the sounds before locking the sequencer
+    bool allFound = true;
+    std::vector<SoLoud::AudioSource *> sources(count, nullptr);
+    std::vector<SequencerStepEdit> valid;
+    valid.reserve(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (edits[i].soundHash != 0)
+        {
+            ActiveSound *sound = findByHash(edits[i].soundHash);
+            if (sound == nullptr)
+            {
+                allFound = false;
+                continue;
+            }
+            sources[valid.size()] = sound->sound.get();
+        }
+        valid.push_back(edits[i]);
+    }
+
+    bool allInside = sequencer->setCells(valid.data(), sources.data(), (unsigned int)valid.size());
+    return allFound && allInside ? noError : invalidParameter;
+}
+
+PlayerErrors Player::createSampler(unsigned int &id)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    id = mNextSamplerId++;
+    samplers.push_back(std::make_unique<Sampler>(&soloud, id));
+    return noError;
+}
+
+void Player::destroySampler(unsigned int id)
+{
+    auto const &s = std::find_if(samplers.begin(), samplers.end(),
+                                 [&](std::unique_ptr<Sampler> const &f)
+                                 { return f->getId() == id; });
+    if (s == samplers.end())
+        return;
+    s->get()->allNotesOff();
+    samplers.erase(s);
+}
+
+Sampler *Player::getSampler(unsigned int id)
+{
+    for (auto &sampler : samplers)
+        if (sampler->getId() == id)
+            return sampler.get();
+    return nullptr;
+}
+
+PlayerErrors Player::samplerAddZones(
+    unsigned int id,
+    const SamplerZone *zones,
+    unsigned int count)
+{
+    if (!mInited)
+        return backendNotInited;
+
+    Sampler *sampler = getSampler(id);
+    if (sampler == nullptr)
+        return invalidParameter;
+
+    std::vector<SoLoud::AudioSource *> sources(count, nullptr);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        ActiveSound *sound = findByHash(zones[i].soundHash);
+        if (sound != nullptr && sound->soundType == TYPE_WAV)
+            sources[i] = sound->sound.get();
+    }
+    // the zones without a source are rejected
+    return sampler->addZones(zones, sources.data(), count) ? noError : invalidParameter;
+}
+
 void Player::oscillateVolume(SoLoud::handle handle, float from, float to, float time)
 {
     soloud.oscillateVolume(handle, from, to, time);
@@ -560,7 +1741,29 @@ unsigned int Player::play3d(
                                  [&](std::unique_ptr<ActiveSound> const &f)
                                  { return f->soundHash == soundHash; });
     if (s == sounds.end())
-        return 0;
+    {
+        VariationContainer *container = findContainer(soundHash);
+        if (container == nullptr)
+            return 0;
+        float variationVolume, speed;
+        ActiveSound *sound = nextVariation(container, variationVolume, speed);
+        if (sound == nullptr)
+            return 0;
+        SoLoud::handle newHandle = soloud.play3d(
+            *sound->sound.get(),
+            aPosX, aPosY, aPosZ,
+            aVelX, aVelY, aVelZ,
+            aVolume * variationVolume,
+            true,
+            aBus);
+        if (newHandle == 0)
+            return 0;
+        soloud.setRelativePlaySpeed(newHandle, speed);
+        if (!aPaused)
+            soloud.setPause(newHandle, false);
+        sound->handle.emplace_back(newHandle);
+        return newHandle;
+    }
 
     ActiveSound *sound = s->get();
     SoLoud::handle newHandle = soloud.play3d(
@@ -570,6 +1773,8 @@ unsigned int Player::play3d(
         aVolume,
         aPaused,
         aBus);
+    if (newHandle == 0)
+        return 0;
     sound->handle.emplace_back(newHandle);
     return newHandle;
 }
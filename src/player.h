@@ -6,8 +6,30 @@
 #include "enums.h"
 #include "soloud.h"
 #include "soloud_wav.h"
-#include "soloud_speech.h"
 #include "filters/filters.h"
+#include "stream/push_stream.h"
+#include "stream/playlist.h"
+#include "stream/speech_stream.h"
+#include "synth/sfxr_sample.h"
+#include "synth/poly_synth.h"
+#include "synth/fm_synth.h"
+#include "synth/sampler.h"
+#include "synth/granular.h"
+#include "timeline.h"
+#include "sequencer.h"
+#include "status_block.h"
+#include "audio_clock.h"
+#include "mod_matrix.h"
+#include "mixer_snapshots.h"
+#include "time_stretch.h"
+#include "variation_container.h"
+#include "analysis/sound_reader.h"
+#include "analysis/analysis_job.h"
+#include "analysis/waveform_peaks.h"
+#include "analysis/spectrogram.h"
+#include "analysis/rhythm_analysis.h"
+#include "analysis/loudness_meter.h"
+#include "analysis/sound_bounds.h"
 
 #include <iostream>
 #include <vector>
@@ -21,9 +43,28 @@ typedef enum SoundType
 {
     TYPE_WAV,
     TYPE_WAVSTREAM,
-    TYPE_SYNTH
+    TYPE_SYNTH,
+    TYPE_PUSHSTREAM,
+    TYPE_PLAYLIST,
+    TYPE_POLYSYNTH,
+    TYPE_FMSYNTH,
+    TYPE_GRANULAR,
+    TYPE_SPEECH,
+    TYPE_SFXR
 } SoundType_t;
 
+/// What a play does when a sound already plays its maximum number
+/// of instances
+typedef enum StealPolicy
+{
+    /// stop the voice started first
+    STEAL_OLDEST,
+    /// stop the voice with the lowest volume
+    STEAL_QUIETEST,
+    /// don't start the new voice
+    STEAL_REJECT
+} StealPolicy_t;
+
 /// The default number of concurrent voices - maximum number of "streams" - is 16,
 /// but this can be adjusted at runtime
 struct ActiveSound
@@ -36,7 +77,6 @@ struct ActiveSound
 
     // unique identifier of this sound based on the file name
     unsigned int soundHash;
-    
 };
 
 class Player
@@ -100,6 +140,113 @@ public:
     void setWaveformSuperwave(unsigned int soundHash, bool superwave);
     void setWaveform(unsigned int soundHash, int newWaveform);
 
+    /// @brief Create a new sound fed with PCM data pushed by the caller.
+    /// @param sampleRate sample rate of the data which will be pushed.
+    /// @param channels number of interleaved channels (1 to 8).
+    /// @param format see [PushStreamFormat].
+    /// @param bufferFrames size of the ring buffer in frames.
+    /// @param prebufferFrames frames to buffer before starting the playback
+    /// and after each underrun. Used to absorb jitter of the producer.
+    /// @param hash return the hash of the sound.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors loadPushStream(
+        unsigned int sampleRate,
+        unsigned int channels,
+        int format,
+        unsigned int bufferFrames,
+        unsigned int prebufferFrames,
+        unsigned int &hash);
+
+    /// @brief Get the push stream with the given [soundHash].
+    /// @return nullptr if not found or if it is not a push stream.
+    PushStream *getPushStream(unsigned int soundHash);
+
+    /// @brief Create a new empty playlist. Its items are played back to back
+    /// without gaps, optionally with a crossfade.
+    /// @param sampleRate sample rate the items are converted to.
+    /// @param channels number of channels (1 to 8).
+    /// @param hash return the hash of the sound.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors loadPlaylist(
+        unsigned int sampleRate,
+        unsigned int channels,
+        unsigned int &hash);
+
+    /// @brief Get the playlist with the given [soundHash].
+    /// @return nullptr if not found or if it is not a playlist.
+    Playlist *getPlaylist(unsigned int soundHash);
+
+    /// @brief Create a new polyphonic instrument playing one of the waveforms.
+    /// Play it once and then send it notes.
+    /// @param waveform one of [SoLoud::Soloud::WAVEFORM].
+    /// @param maxVoices notes playing at once, 1 to [POLY_SYNTH_MAX_VOICES].
+    /// @param hash return the hash of the sound.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors loadPolySynth(
+        int waveform,
+        unsigned int maxVoices,
+        unsigned int &hash);
+
+    /// @brief Get the polyphonic instrument with the given [soundHash].
+    /// FM instruments are polyphonic instruments too.
+    /// @return nullptr if not found or if it is not a polyphonic instrument.
+    PolySynth *getPolySynth(unsigned int soundHash);
+
+    /// @brief Create a new polyphonic FM instrument.
+    /// Play it once and then send it notes like to [loadPolySynth] ones.
+    /// @param operators 4 or 6.
+    /// @param maxVoices notes playing at once, 1 to [POLY_SYNTH_MAX_VOICES].
+    /// @param hash return the hash of the sound.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors loadFmSynth(
+        unsigned int operators,
+        unsigned int maxVoices,
+        unsigned int &hash);
+
+    /// @brief Get the FM instrument with the given [soundHash].
+    /// @return nullptr if not found or if it is not an FM instrument.
+    FmSynth *getFmSynth(unsigned int soundHash);
+
+    /// @brief Create a granular synthesis sound reading the data of a
+    /// loaded Wav. It plays until stopped.
+    /// @param wavHash the hash of a sound loaded in memory.
+    /// @param hash return the hash of the sound.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors loadGranular(unsigned int wavHash, unsigned int &hash);
+
+    /// @brief Render an sfxr preset on a worker thread and load it as a
+    /// sound. Effects with the same parameters are rendered once: the
+    /// sound of an equal parameter set is returned while it is loaded.
+    /// @param preset [SoLoud::Sfxr::SFXR_PRESETS].
+    /// @param seed randomizes the preset, equal seeds give equal effects.
+    /// @param hash return the hash of the sound.
+    /// @return [noError] if success.
+    PlayerErrors loadSfxrPreset(int preset, int seed, unsigned int &hash);
+
+    /// @brief Like [loadSfxrPreset], with a parameter set. See
+    /// [SfxrSample::paramsFromValues] for [values].
+    PlayerErrors loadSfxrParams(int waveType, const float *values, unsigned int &hash);
+
+    /// @brief Like [loadSfxrPreset], with the content of an sfxr .sfs file.
+    PlayerErrors loadSfxrMem(unsigned char *mem, unsigned int length, unsigned int &hash);
+
+    /// @brief Create a variation container: playing its hash plays one of
+    /// [soundHashes], picked by [mode], with a random pitch and volume.
+    /// @param hash return the hash of the container, shared with the sounds.
+    /// @return [invalidParameter] if a sound is not loaded.
+    PlayerErrors createVariationContainer(const unsigned int *soundHashes,
+                                          unsigned int count,
+                                          VariationMode mode,
+                                          unsigned int &hash);
+
+    /// @brief Get the variation container with the given [hash].
+    /// @return nullptr if not found.
+    VariationContainer *findContainer(unsigned int hash);
+
+    /// @brief Get the granular sound with the given [soundHash].
+    /// @return nullptr if not found or if it is not a granular sound.
+    Granular *getGranular(unsigned int soundHash);
+
     /// @brief Switch pause state for an already loaded sound identified by [handle].
     /// @param handle the sound handle
     void pauseSwitch(unsigned int handle);
@@ -130,7 +277,27 @@ public:
     /// @return the current play speed.
     float getRelativePlaySpeed(unsigned int handle);
 
+    /// @brief Play the voice [handle] at [tempo] times its speed without
+    /// changing its pitch, transposed by [pitch] semitones without changing
+    /// its tempo. Both stack on the relative play speed.
+    /// Changing only [tempo] or [pitch] keeps the stretcher of the voice,
+    /// changing [mode] starts a new one.
+    /// @param mode [TIME_STRETCH_WSOLA] for speech, [TIME_STRETCH_PHASE_VOCODER]
+    /// for music.
+    /// @param tempo from 0.25 to 4.
+    /// @param pitch from -24 to 24.
+    /// @return [invalidParameter] if the handle is not a playing voice.
+    PlayerErrors setTimeStretch(SoLoud::handle handle, TimeStretchMode mode, float tempo, float pitch);
+
+    /// @brief Play the voice [handle] without time stretch again.
+    void removeTimeStretch(SoLoud::handle handle);
+
+    /// @brief Get the share of a core spent stretching the voice [handle].
+    /// @return 0 if the voice is not stretched.
+    float getTimeStretchLoad(SoLoud::handle handle);
+
     /// @brief Play already loaded sound identified by [soundHash].
+    /// If it is a variation container, play the sound it picks.
     /// @param soundHash
     /// @param volume 1.0f full volume.
     /// @param pan 0.0f centered.
@@ -142,6 +309,22 @@ public:
         float pan = 0.0f,
         bool paused = 0);
 
+    /// @brief Limit the voices of [soundHash] playing at once, and how
+    /// often it can be triggered. Enforced by SoLoud before a voice is
+    /// created, so it covers [play], [play3d] and the plays of the timeline,
+    /// the sequencer, the samplers and the variation containers alike. A
+    /// rejected trigger returns handle 0.
+    /// @param maxInstances 0 for no limit.
+    /// @param policy the voice to stop when the limit is reached, or
+    /// [STEAL_REJECT] to drop the trigger.
+    /// @param minRetriggerInterval seconds of engine time, triggers closer
+    /// than this to the previous accepted one are dropped.
+    /// @return [invalidParameter] if the sound is not found.
+    PlayerErrors setInstanceLimit(unsigned int soundHash,
+                                  unsigned int maxInstances,
+                                  StealPolicy policy,
+                                  double minRetriggerInterval);
+
     /// @brief Stop already loaded sound identified by [handle] and clear it.
     /// @param handle
     void stop(unsigned int handle);
@@ -164,9 +347,33 @@ public:
     /// @param textToSpeech
     /// @param handle handle of the sound. -1 if error.
     /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
-    /// TODO: add other T2S parameters
+    /// The utterances started here are disposed by the next call once they
+    /// have ended. Use [speak] to keep them.
     PlayerErrors textToSpeech(const std::string &textToSpeech, unsigned int &handle);
 
+    /// @brief Speak [text] as a new sound, which can overlap the others.
+    /// The text is converted phrase by phrase on a new thread and the first
+    /// phrase plays as soon as it is converted. If [text] was cached by
+    /// [cacheSpeech] with the same parameters, the cached sound is played.
+    /// @param soundHash the new sound, or the cached one.
+    /// @param handle the voice speaking.
+    /// @return [noError] if success.
+    PlayerErrors speak(const std::string &text, unsigned int &soundHash, SoLoud::handle &handle);
+
+    /// @brief Set the voice of the next utterances.
+    /// See [SoLoud::Speech::setParams].
+    /// @param engineRate synthesize at the rate of the engine instead of
+    /// 11025 Hz and resampling: brighter, but more work per utterance.
+    void setSpeechParams(unsigned int baseFrequency, float baseSpeed, float baseDeclination, int baseWaveform, bool engineRate);
+
+    /// @brief Synthesize [text] now with the current parameters and load it
+    /// as a new sound. [speak] plays it instead of synthesizing the same
+    /// text again, until it is disposed.
+    /// @param soundHash the cached sound. If [text] was cached already, the
+    /// same sound.
+    /// @return [noError] if success.
+    PlayerErrors cacheSpeech(const std::string &text, unsigned int &soundHash);
+
     /// @brief Enable or disable visualization
     /// @param enabled
     /// @return
@@ -223,12 +430,51 @@ public:
     /// @return true if it still exists.
     bool getIsValidVoiceHandle(SoLoud::handle handle);
 
+    /// @brief set the [handle] pan.
+    /// @param handle the sound or voice group handle.
+    /// @param pan from -1 left to 1 right.
+    void setPan(SoLoud::handle handle, float pan);
+
+    /// @brief protect the [handle] from being stopped or made virtual when
+    /// more voices play than the maximum of active voices.
+    /// @param handle the sound or voice group handle.
+    void setProtectVoice(SoLoud::handle handle, bool protect);
+
+    /// @brief create a voice group. Its handle is accepted in place of a
+    /// voice handle by [stop], [setPause], [setVolume], the faders and the
+    /// other setters, which then apply to all its voices under one lock.
+    /// @return the group handle, 0 if no more groups can be created.
+    SoLoud::handle createVoiceGroup();
+
+    /// @brief destroy a voice group. Its voices keep playing.
+    /// @return [invalidParameter] if [group] is not a voice group.
+    PlayerErrors destroyVoiceGroup(SoLoud::handle group);
+
+    /// @brief add voices to a group. The voices already ended are skipped.
+    /// @param group the voice group handle.
+    /// @param handles the voice handles to add.
+    /// @param count the number of [handles].
+    /// @return [invalidParameter] if [group] is not a voice group or a
+    /// handle is a voice group.
+    PlayerErrors addVoicesToGroup(SoLoud::handle group, const SoLoud::handle *handles, unsigned int count);
+
+    /// @return true if [handle] is a voice group.
+    bool isVoiceGroup(SoLoud::handle handle);
+
+    /// @return true if no voice of [group] is playing anymore.
+    bool isVoiceGroupEmpty(SoLoud::handle group);
+
     /// @brief Find a sound by its handle.
     /// @param handle
     /// @return If not found, return nullptr.
     ///    [handleId] is the index of the handles of the sound found.
     ActiveSound *findByHandle(SoLoud::handle handle, int *handleId);
 
+    /// @brief Find a sound by its hash.
+    /// @param soundHash
+    /// @return If not found, return nullptr.
+    ActiveSound *findByHash(unsigned int soundHash);
+
     void debug();
 
     /////////////////////////////////////////
@@ -246,6 +492,117 @@ public:
     void oscillateRelativePlaySpeed(SoLoud::handle handle, float from, float to, float time);
     void oscillateGlobalVolume(float from, float to, float time);
 
+    /////////////////////////////////////////
+    /// timeline
+    /////////////////////////////////////////
+
+    /// @brief get the engine time: the number of samples mixed since init.
+    unsigned long long getEngineTime();
+
+    /// @brief play [soundHash] when the engine time reaches [time].
+    /// @param time engine time in samples.
+    /// @param eventId return the id of the event.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors schedulePlayAt(
+        unsigned int soundHash,
+        unsigned long long time,
+        float volume,
+        float pan,
+        unsigned int &eventId);
+
+    /// @brief change the voice [handle] when the engine time reaches [time].
+    /// @param playEventId if not 0, [handle] is ignored and the event applies
+    /// to the voice started by this [schedulePlayAt] event.
+    /// @param action one of [TimelineAction] but [TIMELINE_PLAY] and
+    /// [TIMELINE_FILTER_PARAM].
+    /// @param value the new value. Seconds for [TIMELINE_SEEK], not 0 to
+    /// pause for [TIMELINE_PAUSE].
+    /// @param eventId return the id of the event.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors scheduleVoiceEventAt(
+        SoLoud::handle handle,
+        unsigned int playEventId,
+        unsigned long long time,
+        int action,
+        float value,
+        unsigned int &eventId);
+
+    /// @brief set a parameter of the active global [filterType] filter when
+    /// the engine time reaches [time].
+    /// @param eventId return the id of the event.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors scheduleFilterParamAt(
+        FilterType filterType,
+        int attributeId,
+        float value,
+        unsigned long long time,
+        unsigned int &eventId);
+
+    /// @brief remove a pending event.
+    /// @return false if it has already been run.
+    bool cancelScheduledEvent(unsigned int eventId);
+
+    /// @brief remove all the pending events.
+    void cancelAllScheduledEvents();
+
+    /// @brief get the voice started by a [schedulePlayAt] event.
+    /// @return the handle or 0 if the event has not been run yet.
+    SoLoud::handle getScheduledHandle(unsigned int eventId);
+
+    /////////////////////////////////////////
+    /// sequencers
+    /////////////////////////////////////////
+
+    /// @brief create a new stopped step sequencer with an empty pattern.
+    /// @param bpm tempo in beats per minute.
+    /// @param stepsPerBeat ie 4 for 16th notes.
+    /// @param steps pattern length.
+    /// @param tracks number of rows of the pattern.
+    /// @param id return the id of the sequencer.
+    /// @return Returns [PlayerErrors.SO_NO_ERROR] if success.
+    PlayerErrors createSequencer(
+        float bpm,
+        unsigned int stepsPerBeat,
+        unsigned int steps,
+        unsigned int tracks,
+        unsigned int &id);
+
+    /// @brief stop and remove the sequencer [id].
+    void destroySequencer(unsigned int id);
+
+    /// @brief get the sequencer [id] or nullptr if not found.
+    Sequencer *getSequencer(unsigned int id);
+
+    /// @brief change [count] cells of the sequencer [id] at once.
+    /// @return [invalidParameter] if a sound hash is not found or a cell
+    /// is outside the pattern. The valid edits are applied anyway.
+    PlayerErrors sequencerSetSteps(
+        unsigned int id,
+        const SequencerStepEdit *edits,
+        unsigned int count);
+
+    /////////////////////////////////////////
+    /// samplers
+    /////////////////////////////////////////
+
+    /// @brief create a new multi-sample instrument without zones.
+    /// @param id return the id of the sampler.
+    PlayerErrors createSampler(unsigned int &id);
+
+    /// @brief release the notes and remove the sampler [id].
+    void destroySampler(unsigned int id);
+
+    /// @brief get the sampler [id] or nullptr if not found.
+    Sampler *getSampler(unsigned int id);
+
+    /// @brief add [count] zones to the sampler [id].
+    /// @return [invalidParameter] if a sound hash is not a loaded Wav or a
+    /// zone is not valid. The valid zones are added anyway.
+    PlayerErrors samplerAddZones(
+        unsigned int id,
+        const SamplerZone *zones,
+        unsigned int count);
+
 
     /////////////////////////////////////////
     /// 3D audio
@@ -323,6 +680,180 @@ public:
     void set3dSourceDopplerFactor(unsigned int handle,
                                   float dopplerFactor);
 
+    /////////////////////////////////////////
+    /// offline analysis
+    /////////////////////////////////////////
+
+    /// @brief start computing the peak pyramid of a sound loaded as a Wav or
+    /// a WavStream on a worker, if not done yet. It is cached until the sound
+    /// is disposed.
+    /// @param ready return true once the pyramid can be queried without
+    /// waiting.
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors prepareWaveformPeaks(unsigned int soundHash, bool &ready);
+
+    /// @brief get the waveform overview of a sound loaded as a Wav or a
+    /// WavStream, waiting for the peak pyramid if still computed (see
+    /// [prepareWaveformPeaks]).
+    /// @param startTime @param endTime the range in seconds, [endTime] 0 for
+    /// the end of the sound.
+    /// @param buckets the number of values of [min], [max] and [rms].
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors getWaveformPeaks(
+        unsigned int soundHash,
+        float startTime,
+        float endTime,
+        unsigned int buckets,
+        float *min,
+        float *max,
+        float *rms);
+
+    /// @brief get the dimensions of the spectrogram of a sound, to allocate
+    /// the matrix passed to [computeSpectrogram].
+    /// @param size the FFT size, a power of two from 64 to 16384.
+    /// @param hop the samples between two frames, from 1 to [size].
+    /// @param rows return the number of frames.
+    /// @param bins return the values per frame, [size] / 2 + 1.
+    /// @return [invalidParameter] if the sound can't be read or [size] or
+    /// [hop] are not valid.
+    PlayerErrors getSpectrogramSize(
+        unsigned int soundHash,
+        unsigned int size,
+        unsigned int hop,
+        unsigned int &rows,
+        unsigned int &bins);
+
+    /// @brief start computing the spectrogram of a sound loaded as a Wav or
+    /// a WavStream on a worker, row by row into [magnitudes] or [decibels].
+    /// Disposing of the sound stops the job.
+    /// @param magnitudes if not null, receives the magnitudes.
+    /// @param decibels if not null, receives the levels from [minDb] to
+    /// 0 dB quantized from 0 to 255.
+    /// @param job return the job to pass to [pollSpectrogram].
+    PlayerErrors computeSpectrogram(
+        unsigned int soundHash,
+        unsigned int size,
+        unsigned int hop,
+        SpectrogramWindow window,
+        float *magnitudes,
+        unsigned char *decibels,
+        float minDb,
+        unsigned int &job);
+
+    /// @brief check whether a spectrogram started by [computeSpectrogram]
+    /// is done, forgetting the job once it is.
+    /// @param done return true once the matrix is filled.
+    /// @return [invalidParameter] if the job doesn't exist, or was stopped
+    /// by disposing of its sound.
+    PlayerErrors pollSpectrogram(unsigned int job, bool &done);
+
+    /// @brief start detecting the onsets, the tempo and the beats of a sound
+    /// loaded as a Wav or a WavStream on a worker, if not done yet. The
+    /// analysis is cached until the sound is disposed.
+    /// @param ready return true once [analyzeRhythm] doesn't wait.
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors prepareRhythmAnalysis(unsigned int soundHash, bool &ready);
+
+    /// @brief get the rhythm of a sound loaded as a Wav or a WavStream,
+    /// waiting for its analysis if still running (see
+    /// [prepareRhythmAnalysis]).
+    /// @param bpm return the tempo, 0 if none was found.
+    /// @param onsets @param beats return the number of onsets and beats, to
+    /// allocate the lists passed to [getRhythmEvents].
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors analyzeRhythm(
+        unsigned int soundHash,
+        float &bpm,
+        unsigned int &onsets,
+        unsigned int &beats);
+
+    /// @brief copy the onset and beat times in seconds found by
+    /// [analyzeRhythm].
+    /// @return [invalidParameter] if the sound hasn't been analyzed.
+    PlayerErrors getRhythmEvents(unsigned int soundHash, float *onsets, float *beats);
+
+    /// @brief measure the loudness of the sounds loaded from files from now
+    /// on, each on a worker thread as soon as it is loaded.
+    void setLoudnessMeasurementOnLoad(bool enabled);
+
+    /// @brief start measuring the loudness of a sound loaded as a Wav or a
+    /// WavStream on a worker, if not done yet. The measure is cached until
+    /// the sound is disposed.
+    /// @param ready return true once [getLoudness] and
+    /// [setLoudnessNormalization] don't wait.
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors prepareLoudness(unsigned int soundHash, bool &ready);
+
+    /// @brief get the EBU R128 loudness of a sound loaded as a Wav or a
+    /// WavStream, waiting for its measure if still running. The measure is
+    /// cached until the sound is disposed.
+    /// @param integrated return the integrated loudness in LUFS.
+    /// @param truePeak return the true peak in dBTP.
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors getLoudness(unsigned int soundHash, float &integrated, float &truePeak);
+
+    /// @brief set the gain bringing a sound to [targetLufs], folded into
+    /// the volume of the voices played from now on.
+    /// @param enabled false to remove the gain.
+    /// @param truePeakLimit the gain is lowered to keep the true peak below
+    /// this level in dBTP.
+    /// @param gain return the gain applied, 1 for a silent sound.
+    /// @return [invalidParameter] if the sound can't be read.
+    PlayerErrors setLoudnessNormalization(
+        unsigned int soundHash,
+        bool enabled,
+        float targetLufs,
+        float truePeakLimit,
+        float &gain);
+
+    /// @brief cut the silence of a sound loaded as a Wav and find where it
+    /// loops. The data after the loop end is dropped since the sound loops
+    /// at its end, and the loop point is set to the loop start. The voices
+    /// of the sound are stopped and its analyses computed again when asked.
+    /// @param trimSilence whether to cut the frames below [thresholdDb] at
+    /// both ends.
+    /// @param loopSearch how to find the loop.
+    /// @param start return the time kept from in the original sound.
+    /// @param end return the time kept to in the original sound.
+    /// @param loopStart return the loop start in the trimmed sound.
+    /// @param loopEnd return the loop end in the trimmed sound, its length.
+    /// @return [invalidParameter] if the sound is not a Wav.
+    PlayerErrors trimSound(
+        unsigned int soundHash,
+        bool trimSilence,
+        float thresholdDb,
+        LoopSearch loopSearch,
+        float &start,
+        float &end,
+        float &loopStart,
+        float &loopEnd);
+
+private:
+    /// @brief return a new random hash not used by any loaded sound.
+    unsigned int newSoundHash();
+
+    /// @brief pick the sound of the next trigger of [container].
+    /// @return nullptr if the container is empty.
+    ActiveSound *nextVariation(VariationContainer *container, float &volume, float &speed);
+
+    /// @brief load [params] with [loadSfxrPreset], or return the sound
+    /// rendering the same parameters.
+    PlayerErrors loadSfxr(const SoLoud::SfxrParams &params, unsigned int &hash);
+
+    /// @brief open the PCM of a sound loaded as a Wav or a WavStream.
+    /// @return nullptr if the sound doesn't exist or is of another type.
+    std::unique_ptr<SoundReader> openReader(unsigned int soundHash);
+
+    /// @brief stop the spectrograms of a sound, waiting for their workers.
+    void eraseSpectrogramJobs(unsigned int soundHash);
+
+    /// @brief get the loudness measure of a sound, starting it if needed.
+    /// @return nullptr if the sound can't be read.
+    AnalysisJob<LoudnessMeter> *loudnessMeter(unsigned int soundHash);
+
+    /// @brief feeds the mixed blocks to [mStatusBlock] and [mAudioClock].
+    static void postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd);
+
 public:
     /// all the sounds loaded
     std::vector<std::unique_ptr<ActiveSound>> sounds;
@@ -333,11 +864,68 @@ public:
     /// main SoLoud engine
     SoLoud::Soloud soloud;
 
-    /// speech object
-    SoLoud::Speech speech;
+    /// voice of the next utterances
+    SpeechParams mSpeechParams;
+
+    /// synthesized utterances by parameters and text, see [cacheSpeech]
+    std::map<std::string, unsigned int> mSpeechCache;
+
+    /// utterances started by [textToSpeech], to dispose once ended
+    std::vector<unsigned int> mLegacySpeech;
+
+    /// sfxr sounds by [SfxrSample::hashParams]
+    std::map<uint64_t, unsigned int> mSfxrCache;
+
+    /// waveform overviews by sound hash, see [getWaveformPeaks]
+    std::map<unsigned int, std::unique_ptr<AnalysisJob<WaveformPeaks>>> mPeakCache;
+
+    /// a spectrogram computed on a worker, see [computeSpectrogram]
+    struct SpectrogramJob
+    {
+        unsigned int soundHash;
+        std::unique_ptr<AnalysisJob<Spectrogram>> job;
+    };
+    /// spectrograms being computed by job, see [pollSpectrogram]
+    std::map<unsigned int, SpectrogramJob> mSpectrogramJobs;
+    unsigned int mNextSpectrogramJob = 0;
+
+    /// onsets and beats by sound hash, see [analyzeRhythm]
+    std::map<unsigned int, std::unique_ptr<AnalysisJob<RhythmAnalysis>>> mRhythmCache;
+
+    /// loudness measures by sound hash, see [getLoudness]
+    std::map<unsigned int, std::unique_ptr<AnalysisJob<LoudnessMeter>>> mLoudnessCache;
+
+    /// whether [loadFile] starts measuring the loudness
+    bool mMeasureLoudnessOnLoad = false;
+
+    /// variation containers, played by their hash like the sounds
+    std::vector<std::unique_ptr<VariationContainer>> containers;
 
     /// Filters
     Filters mFilters;
+
+    /// events scheduled at an exact engine time
+    Timeline mTimeline;
+
+    /// step sequencers driven by [mTimeline]
+    std::vector<std::unique_ptr<Sequencer>> sequencers;
+    unsigned int mNextSequencerId;
+
+    /// multi-sample instruments
+    std::vector<std::unique_ptr<Sampler>> samplers;
+    unsigned int mNextSamplerId;
+
+    /// engine state published after every mixed block
+    StatusBlock mStatusBlock;
+
+    /// interpolated clock of what is being heard
+    AudioClock mAudioClock;
+
+    /// LFOs, envelopes and random sources driven by [mTimeline]
+    ModMatrix mModMatrix;
+
+    /// named mixer states blended by [mTimeline]
+    MixerSnapshots mSnapshots;
 };
 
 #endif // PLAYER_H
@@ -0,0 +1,150 @@
+#include "sequencer.h"
+
+#include <cmath>
+
+Sequencer::Sequencer(SoLoud::Soloud *soloud,
+                     unsigned int id,
+                     float bpm,
+                     unsigned int stepsPerBeat,
+                     unsigned int steps,
+                     unsigned int tracks)
+    : mSoloud(soloud),
+      mId(id),
+      mSamplerate((float)soloud->getBackendSamplerate()),
+      mSteps(steps),
+      mTracks(tracks),
+      mBpm(bpm),
+      mStepsPerBeat(stepsPerBeat),
+      mSwing(0.0f),
+      mPlaying(false),
+      mCurrentStep(-1),
+      mNextStep(0),
+      mNextStepTime(0.0)
+{
+    SequencerCell empty = {nullptr, 1.0f, 0.0f, 1.0f};
+    mCells.assign(steps * tracks, empty);
+}
+
+void Sequencer::setTempo(float bpm, unsigned int stepsPerBeat)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBpm = bpm;
+    mStepsPerBeat = stepsPerBeat;
+}
+
+void Sequencer::setSwing(float swing)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSwing = swing < 0.0f ? 0.0f : (swing > 0.9f ? 0.9f : swing);
+}
+
+void Sequencer::setSize(unsigned int steps, unsigned int tracks)
+{
+    SequencerCell empty = {nullptr, 1.0f, 0.0f, 1.0f};
+    std::vector<SequencerCell> cells(steps * tracks, empty);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (unsigned int t = 0; t < tracks && t < mTracks; t++)
+        for (unsigned int s = 0; s < steps && s < mSteps; s++)
+            cells[t * steps + s] = mCells[t * mSteps + s];
+    mCells.swap(cells);
+    mSteps = steps;
+    mTracks = tracks;
+    if (mNextStep >= mSteps)
+        mNextStep = 0;
+}
+
+bool Sequencer::setCells(const SequencerStepEdit *edits,
+                         SoLoud::AudioSource *const *sources,
+                         unsigned int count)
+{
+    bool allInside = true;
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const SequencerStepEdit &edit = edits[i];
+        if (edit.track >= mTracks || edit.step >= mSteps)
+        {
+            allInside = false;
+            continue;
+        }
+        SequencerCell &cell = mCells[edit.track * mSteps + edit.step];
+        cell.source = edit.soundHash == 0 ? nullptr : sources[i];
+        cell.volume = edit.volume;
+        cell.pan = edit.pan;
+        cell.pitch = edit.pitch;
+    }
+    return allInside;
+}
+
+void Sequencer::removeSource(SoLoud::AudioSource *source)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (SequencerCell &cell : mCells)
+        if (cell.source == source)
+            cell.source = nullptr;
+}
+
+void Sequencer::start(unsigned long long time, unsigned int step)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNextStep = step < mSteps ? step : 0;
+    mNextStepTime = (double)time;
+    mCurrentStep.store(-1);
+    mPlaying.store(true);
+}
+
+void Sequencer::stop()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPlaying.store(false);
+    mCurrentStep.store(-1);
+}
+
+unsigned long long Sequencer::nextTriggerTime() const
+{
+    double time = mNextStepTime;
+    if (mNextStep % 2 == 1)
+        time += mSwing * mSamplerate * 60.0 / (mBpm * mStepsPerBeat);
+    return (unsigned long long)llround(time);
+}
+
+void Sequencer::fireStep(unsigned int step)
+{
+    for (unsigned int t = 0; t < mTracks; t++)
+    {
+        const SequencerCell &cell = mCells[t * mSteps + step];
+        if (cell.source == nullptr)
+            continue;
+        // start paused to set the pitch before the first sample is mixed
+        SoLoud::handle handle = mSoloud->play(*cell.source, cell.volume, cell.pan, true);
+        if (cell.pitch != 1.0f)
+            mSoloud->setRelativePlaySpeed(handle, cell.pitch);
+        mSoloud->setPause(handle, false);
+    }
+}
+
+unsigned int Sequencer::onTimeline(unsigned long long aSampleTime, unsigned int aSamples)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mPlaying.load() || mSteps == 0 || mBpm <= 0.0f || mStepsPerBeat == 0)
+        return 0;
+
+    // a start time already passed is moved to now
+    if (mNextStepTime < (double)aSampleTime && mCurrentStep.load() < 0)
+        mNextStepTime = (double)aSampleTime;
+
+    unsigned long long trigger = nextTriggerTime();
+    while (trigger <= aSampleTime)
+    {
+        fireStep(mNextStep);
+        mCurrentStep.store((int)mNextStep);
+        mNextStepTime += mSamplerate * 60.0 / (mBpm * mStepsPerBeat);
+        mNextStep = (mNextStep + 1) % mSteps;
+        trigger = nextTriggerTime();
+    }
+
+    if (trigger < aSampleTime + aSamples)
+        return (unsigned int)(trigger - aSampleTime);
+    return 0;
+}
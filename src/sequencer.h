@@ -0,0 +1,108 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include "soloud.h"
+#include "timeline.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/// One change of a sequencer cell, as sent in batches through FFI.
+/// The layout is shared with Dart.
+typedef struct SequencerStepEdit
+{
+    unsigned int track;
+    unsigned int step;
+    /// sound to play on this step, 0 to clear the step
+    unsigned int soundHash;
+    float volume;
+    float pan;
+    /// relative play speed, 1 is the original pitch
+    float pitch;
+} SequencerStepEdit_t;
+
+struct SequencerCell
+{
+    /// nullptr when the step is empty
+    SoLoud::AudioSource *source;
+    float volume;
+    float pan;
+    float pitch;
+};
+
+/// A step sequencer which triggers sounds on exact engine samples.
+///
+/// The pattern is a grid of [tracks] x [steps] cells. It is driven by the
+/// [Timeline], so steps are fired by the audio thread, and it can be
+/// edited while playing: edits and tempo changes take effect from the next
+/// step.
+class Sequencer : public TimelineListener
+{
+public:
+    Sequencer(SoLoud::Soloud *soloud,
+              unsigned int id,
+              float bpm,
+              unsigned int stepsPerBeat,
+              unsigned int steps,
+              unsigned int tracks);
+
+    unsigned int getId() const { return mId; }
+
+    void setTempo(float bpm, unsigned int stepsPerBeat);
+
+    /// @brief delay the odd steps by [swing] (0 to 0.9) of a step length.
+    void setSwing(float swing);
+
+    /// @brief resize the pattern. Cells inside the new size are kept.
+    void setSize(unsigned int steps, unsigned int tracks);
+
+    /// @brief change some cells at once. [sources] are the sounds of
+    /// [edits], resolved by the caller.
+    /// @return false if some cell is outside the pattern. The others are
+    /// applied anyway.
+    bool setCells(const SequencerStepEdit *edits,
+                  SoLoud::AudioSource *const *sources,
+                  unsigned int count);
+
+    /// @brief empty the cells playing [source]. Used when it is disposed.
+    void removeSource(SoLoud::AudioSource *source);
+
+    /// @brief start from [step] at the engine time [time]. A time already
+    /// passed starts with the next mix.
+    void start(unsigned long long time, unsigned int step);
+    void stop();
+    bool isPlaying() const { return mPlaying.load(); }
+
+    /// @brief the last step fired, for the UI playhead. -1 when stopped.
+    int getCurrentStep() const { return mCurrentStep.load(); }
+
+    virtual unsigned int onTimeline(unsigned long long aSampleTime, unsigned int aSamples);
+
+private:
+    /// engine time of the next step, swing included
+    unsigned long long nextTriggerTime() const;
+    void fireStep(unsigned int step);
+
+    SoLoud::Soloud *mSoloud;
+    unsigned int mId;
+    float mSamplerate;
+
+    /// also held by the audio thread while firing the steps
+    std::mutex mMutex;
+    std::vector<SequencerCell> mCells;
+    unsigned int mSteps;
+    unsigned int mTracks;
+    float mBpm;
+    unsigned int mStepsPerBeat;
+    float mSwing;
+
+    std::atomic<bool> mPlaying;
+    std::atomic<int> mCurrentStep;
+    unsigned int mNextStep;
+    /// unswung engine time of the next step. Kept fractional so long
+    /// patterns don't drift
+    double mNextStepTime;
+};
+
+#endif // SEQUENCER_H
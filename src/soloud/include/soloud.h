@@ -109,6 +109,8 @@ namespace SoLoud
 	typedef result (*soloudResultFunction)(Soloud *aSoloud);
 	typedef unsigned int handle;
 	typedef double time;
+	typedef unsigned int (*mixCallFunction)(void *aUserData, unsigned long long aSampleTime, unsigned int aSamples);
+	typedef void (*postMixCallFunction)(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd);
 };
 
 namespace SoLoud
@@ -251,6 +253,20 @@ namespace SoLoud
 		unsigned int getBackendSamplerate();
 		// Returns current backend buffer size
 		unsigned int getBackendBufferSize();
+		// Returns the samples buffered by the backend before they are heard, 0 if unknown
+		unsigned int getBackendLatency();
+		// Set a function called by the audio thread, outside the audio mutex, before mixing
+		// each part of the output buffer. It gets the engine time in samples and the samples
+		// left in the buffer, and returns how many of them to mix before it is called again.
+		// Set it before init, it is read by the audio thread without locking.
+		void setMixCallback(mixCallFunction aCallback, void *aUserData);
+		// Set a function called by the audio thread after mixing each part of the output buffer,
+		// with the clipped non-interleaved samples. aBlockEnd is set for the last part of the buffer.
+		// Set it before init, it is read by the audio thread without locking.
+		void setPostMixCallback(postMixCallFunction aCallback, void *aUserData);
+		// Returns the number of samples mixed since init. Updated under the audio mutex,
+		// together with the voices positions.
+		unsigned long long getMixedSamples();
 
 		// Set speaker position in 3d space
 		result setSpeakerPosition(unsigned int aChannel, float aX, float aY, float aZ);
@@ -349,6 +365,10 @@ namespace SoLoud
 		void setPauseAll(bool aPause);
 		// Set the relative play speed
 		result setRelativePlaySpeed(handle aVoiceHandle, float aSpeed);
+		// Set the processor of the source data of a single voice, e.g. a time stretcher. The voice
+		// owns it and deletes it when it ends or when it is replaced. NULL removes it. Returns
+		// INVALID_PARAMETER if the handle is not a playing voice, aProcessor is then not owned.
+		result setVoiceProcessor(handle aVoiceHandle, VoiceProcessor *aProcessor);
 		// Set the voice protection state
 		void setProtectVoice(handle aVoiceHandle, bool aProtect);
 		// Set the sample rate
@@ -458,6 +478,10 @@ namespace SoLoud
 	public:
 		// Mix N samples * M channels. Called by other mix_ functions.
 		void mix_internal(unsigned int aSamples, unsigned int aStride);
+		// Capture the visualization data from a segment of aSamples mixed at aOffset of the output buffer
+		void visualize_internal(unsigned int aOffset, unsigned int aSamples, unsigned int aStride, unsigned int aBufferSamples);
+		// Ask the mix callback how many samples to mix next, up to aSamples
+		unsigned int mixSegment_internal(unsigned int aSamples);
 
 		// Handle rest of initialization (called from backend)
 		void postinit_internal(unsigned int aSamplerate, unsigned int aBufferSize, unsigned int aFlags, unsigned int aChannels);
@@ -468,8 +492,12 @@ namespace SoLoud
 		void mapResampleBuffers_internal();
 		// Perform mixing for a specific bus
 		void mixBus_internal(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize, float *aScratch, unsigned int aBus, float aSamplerate, unsigned int aChannels, unsigned int aResampler);
+		// Read source data of a voice, looping it if needed. Returns samples read.
+		unsigned int getVoiceAudio_internal(AudioSourceInstance *aVoice, float *aBuffer, unsigned int aSamples, unsigned int aBufferSize);
 		// Find a free voice, stopping the oldest if no free voice is found.
 		int findFreeVoice_internal();
+		// Apply the instance limit and the retrigger interval of the audio source, stopping one of its voices if needed. Returns false if the play is rejected.
+		bool admitInstance_internal(AudioSource &aSound);
 		// Converts handle to voice, if the handle is valid. Returns -1 if not.
 		int getVoiceFromHandle_internal(handle aVoiceHandle) const;
 		// Converts voice + playindex into handle
@@ -548,6 +576,16 @@ namespace SoLoud
 		time mStreamTime;
 		// Last time seen by the playClocked call
 		time mLastClockedTime;
+		// Samples mixed since init
+		unsigned long long mMixedSamples;
+		// Samples buffered by the backend before they are heard, 0 if unknown
+		unsigned int mBackendLatency;
+		// Called before mixing each part of the output buffer
+		mixCallFunction mMixCallback;
+		void *mMixCallbackUserData;
+		// Called after mixing each part of the output buffer
+		postMixCallFunction mPostMixCallback;
+		void *mPostMixCallbackUserData;
 		// Global filter
 		Filter *mFilter[FILTERS_PER_STREAM];
 		// Global filter instance
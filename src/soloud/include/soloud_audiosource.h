@@ -98,6 +98,26 @@ namespace SoLoud
 		handle mHandle;
 	};
 
+	class Soloud;
+
+	// Processes the source data of a voice before its filters, e.g. to stretch it in time.
+	// It can read more or less source data than it writes.
+	class VoiceProcessor
+	{
+	public:
+		virtual ~VoiceProcessor() {}
+		// Write aSamples samples of each channel of aVoice to aBuffer, channels aBufferSize apart,
+		// reading the source with Soloud::getVoiceAudio_internal. Called in the audio thread,
+		// with the audio mutex locked. Report samples written.
+		virtual unsigned int process(Soloud *aSoloud, AudioSourceInstance *aVoice, float *aBuffer, unsigned int aSamples, unsigned int aBufferSize) = 0;
+		// Play speed of the processed data, applied by the resampler on top of the voice play speed
+		virtual float getPitch() { return 1.0f; }
+		// Source seconds played per second of processed data at a pitch of 1
+		virtual float getTempo() { return 1.0f; }
+		// Forget the source data read so far. Called after the voice is seeked.
+		virtual void reset() {}
+	};
+
 	// Base class for audio instances
 	class AudioSourceInstance
 	{
@@ -139,7 +159,9 @@ namespace SoLoud
 		float mChannelVolume[MAX_CHANNELS];
 		// Set volume
 		float mSetVolume;
-		// Overall volume overall = set * 3d
+		// Loudness normalization gain of the source
+		float mNormalizationGain;
+		// Overall volume overall = set * 3d * normalization
 		float mOverallVolume;
 		// Base samplerate; samplerate = base samplerate * relative play speed
 		float mBaseSamplerate;
@@ -187,6 +209,8 @@ namespace SoLoud
 		unsigned int mDelaySamples;
 		// When looping, start playing from this time
 		time mLoopPoint;
+		// Processor of the source data, owned by the instance. NULL if none.
+		VoiceProcessor *mProcessor;
 
 		// Get N samples from the stream to the buffer. Report samples written.
 		virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize) = 0;
@@ -200,8 +224,6 @@ namespace SoLoud
 		virtual float getInfo(unsigned int aInfoKey);
 	};
 
-	class Soloud;
-
 	// Base class for audio sources
 	class AudioSource
 	{
@@ -238,6 +260,15 @@ namespace SoLoud
 			// Exponential distance attenuation model
 			EXPONENTIAL_DISTANCE = 3
 		};
+		enum STEAL_POLICY
+		{
+			// Stop the instance started first
+			STEAL_OLDEST = 0,
+			// Stop the instance with the lowest volume
+			STEAL_QUIETEST = 1,
+			// Don't start the new instance
+			STEAL_REJECT = 2
+		};
 
 		// Flags. See AudioSource::FLAGS
 		unsigned int mFlags;
@@ -245,6 +276,16 @@ namespace SoLoud
 		float mBaseSamplerate;
 		// Default volume for created instances
 		float mVolume;
+		// Loudness normalization gain, applied on top of the volume of the instances
+		float mNormalizationGain;
+		// Instances of this audio source playing at once, 0 for no limit
+		unsigned int mMaxInstances;
+		// What play does when mMaxInstances instances play. See AudioSource::STEAL_POLICY
+		unsigned int mStealPolicy;
+		// Engine time in seconds before this audio source can be played again
+		time mMinRetriggerInterval;
+		// Engine time of the last play, negative before the first one
+		time mLastTrigger;
 		// Number of channels this audio source produces
 		unsigned int mChannels;
 		// Sound source ID. Assigned by SoLoud the first time it's played.
@@ -276,6 +317,10 @@ namespace SoLoud
 		AudioSource();
 		// Set default volume for instances
 		void setVolume(float aVolume);
+		// Set the loudness normalization gain of the instances created from now on
+		void setNormalizationGain(float aGain);
+		// Limit the instances playing at once and how often they can be started, enforced by every play
+		void setInstanceLimit(unsigned int aMaxInstances, unsigned int aStealPolicy, time aMinRetriggerInterval);
 		// Set the looping of the instances created from this audio source
 		void setLooping(bool aLoop);
 		// Set whether only one instance of this sound should ever be playing at the same time
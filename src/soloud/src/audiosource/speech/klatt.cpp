@@ -1,9 +1,14 @@
 #include <math.h>
 #include <stdlib.h>
+#include "soloud.h"
 #include "klatt.h"
 #include "darray.h"
 #include "resonator.h"
 
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #ifndef PI
 #define PI 3.1415926535897932384626433832795f
 #endif
@@ -295,6 +300,10 @@ klatt::klatt() :
 	mDecay(0),
 	mOneMd(0),
 	mSeed(5),
+	mRateScale(1),
+	mPeriodScale(1),
+	mNoisePole(0.75f),
+	mNoiseGain(1),
 	mElementCount(0),
 	mElement(0),
 	mElementIndex(0),
@@ -336,12 +345,15 @@ float klatt::natural_source(int aNper)
 	// See if glottis open 
 	if (aNper < mNOpen)
 	{
+		// the waveforms are shaped in samples at 4 * 11025 Hz
+		float pos = aNper * mPeriodScale;
+		aNper = (int)pos;
 		switch (mBaseWaveform)
 		{
 		case KW_TRIANGLE:
 			return ((aNper % 200) - 100) * 81.92f; // triangle
 		case KW_SIN:
-			return (float)(sin(aNper * 0.0314) * 8192); // sin
+			return (float)(sin(pos * 0.0314) * 8192); // sin
 		case KW_SQUARE:
 			return ((aNper % 200) - 100) > 0 ? 8192.0f : -8192.0f; // square
 		case KW_PULSE:
@@ -389,16 +401,16 @@ void klatt::pitch_synch_par_reset(int ns)
 		/* Set open phase of glottal period */
 		/* where  40 <= open phase <= 263 */
 
-		mNOpen = 4 * mFrame.mNoSamplesInOpenPeriod;
+		mNOpen = (int)(4 * mFrame.mNoSamplesInOpenPeriod * mRateScale);
 
 		if (mNOpen >= (mT0 - 1))
 		{
 			mNOpen = mT0 - 2;
 		}
 
-		if (mNOpen < 40)
+		if (mNOpen < (int)(40 * mRateScale))
 		{
-			mNOpen = 40;                  /* F0 max = 1000 Hz */
+			mNOpen = (int)(40 * mRateScale);                  /* F0 max = 1000 Hz */
 		}
 
 		int temp;
@@ -453,6 +465,11 @@ void klatt::pitch_synch_par_reset(int ns)
 
 		if (mDecay > 0.0f)
 		{
+			/* Same cutoff at any sample rate */
+			if (mRateScale != 1.0f)
+			{
+				mDecay = (float)pow(mDecay, mPeriodScale);
+			}
 			mOneMd = 1.0f - mDecay;
 		}
 		else
@@ -471,7 +488,6 @@ void klatt::frame_init()
 {
 	int mOverallGaindb;                       /* Overall gain, 60 dB is unity  0 to   60  */
 	float amp_parF1;                 /* mFormant1Ampdb converted to linear gain  */
-	float amp_parFN;                 /* mParallelNasalPoleAmpdb converted to linear gain  */
 	float amp_parF2;                 /* mFormant2Ampdb converted to linear gain  */
 	float amp_parF3;                 /* mFormant3Ampdb converted to linear gain  */
 	float amp_parF4;                 /* mFormant4Ampdb converted to linear gain  */
@@ -504,7 +520,6 @@ void klatt::frame_init()
 	amp_parF4 = DBtoLIN(mFrame.mFormant4Ampdb) * 0.04f;	/* -28.0 dB */
 	amp_parF5 = DBtoLIN(mFrame.mFormant5Ampdb) * 0.022f;	/* -33.2 dB */
 	amp_parF6 = DBtoLIN(mFrame.mFormant6Ampdb) * 0.03f;	/* -30.5 dB */
-	amp_parFN = DBtoLIN(mFrame.mParallelNasalPoleAmpdb) * 0.6f;	/* -4.44 dB */
 	mAmpBypas = DBtoLIN(mFrame.mBypassFricationAmpdb) * 0.05f;	/* -26.0 db */
 
 	// Set coeficients of nasal resonator and zero antiresonator 
@@ -512,27 +527,24 @@ void klatt::frame_init()
 
 	mNasalZero.initAntiresonator(mFrame.mNasalZeroFreq, mFrame.mNasalZeroBandwidth, mSampleRate);
 
-	// Set coefficients of parallel resonators, and amplitude of outputs 
-	mParallelFormant1.initResonator(mFrame.mFormant1Freq, mFrame.mFormant1ParallelBandwidth, mSampleRate);
-	mParallelFormant1.setGain(amp_parF1);
-
-	mParallelResoNasalPole.initResonator(mFrame.mNasalPoleFreq, mFrame.mNasalPoleBandwidth, mSampleRate);
-	mParallelResoNasalPole.setGain(amp_parFN);
-
-	mParallelFormant2.initResonator(mFrame.mFormant2Freq, mFrame.mFormant2ParallelBandwidth, mSampleRate);
-	mParallelFormant2.setGain(amp_parF2);
-
-	mParallelFormant3.initResonator(mFrame.mFormant3Freq, mFrame.mFormant3ParallelBandwidth, mSampleRate);
-	mParallelFormant3.setGain(amp_parF3);
-
-	mParallelFormant4.initResonator(mFrame.mFormant4Freq, mFrame.mFormant4ParallelBandwidth, mSampleRate);
-	mParallelFormant4.setGain(amp_parF4);
-
-	mParallelFormant5.initResonator(mFrame.mFormant5Freq, mFrame.mFormant5ParallelBandwidth, mSampleRate);
-	mParallelFormant5.setGain(amp_parF5);
-
-	mParallelFormant6.initResonator(mFrame.mFormant6Freq, mFrame.mFormant6ParallelBandwidth, mSampleRate);
-	mParallelFormant6.setGain(amp_parF6);
+	// Set coefficients of parallel resonators, and amplitude of outputs.
+	// The outputs are summed with alternating signs, folded into the gains:
+	// F2 - F3 + F4 - F5 + F6 - F1
+	// The parallel nasal pole is not used, F1 is fed through mNasalPole instead.
+	const int parallelFreq[6] = { mFrame.mFormant1Freq, mFrame.mFormant2Freq, mFrame.mFormant3Freq,
+		mFrame.mFormant4Freq, mFrame.mFormant5Freq, mFrame.mFormant6Freq };
+	const int parallelBandwidth[6] = { mFrame.mFormant1ParallelBandwidth, mFrame.mFormant2ParallelBandwidth,
+		mFrame.mFormant3ParallelBandwidth, mFrame.mFormant4ParallelBandwidth,
+		mFrame.mFormant5ParallelBandwidth, mFrame.mFormant6ParallelBandwidth };
+	const float parallelGain[6] = { -amp_parF1, amp_parF2, -amp_parF3, amp_parF4, -amp_parF5, amp_parF6 };
+	int i;
+	for (i = 0; i < 6; i++)
+	{
+		resonator formant;
+		formant.initResonator(parallelFreq[i], parallelBandwidth[i], mSampleRate);
+		formant.setGain(parallelGain[i]);
+		mParallelFormants.setLane(i, formant);
+	}
 
 
 	/* fold overall gain into output resonator */
@@ -571,6 +583,15 @@ void klatt::parwave(short int *jwave)
 		flutter();       /* add f0 flutter */
 	}
 
+#ifdef SOLOUD_SSE_INTRINSICS
+	/* The resonators decay into denormals during silences, which are very
+	slow on x86; more so at high sample rates where the poles are closer to 1.
+	Flush them to zero for this frame, as the audio thread does.
+	*/
+	unsigned int csr = _mm_getcsr();
+	_mm_setcsr(csr | 0x8040);
+#endif
+
 	/* MAIN LOOP, for each output sample of current frame: */
 
 	int ns;
@@ -603,7 +624,7 @@ void klatt::parwave(short int *jwave)
 		*    a pole near the origin in the z-plane, i.e.
 		*    output = input + (0.75 * lastoutput) */
 
-		noise = nrand + (0.75f * mNLast);	/* Function of samp_rate ? */
+		noise = nrand * mNoiseGain + (mNoisePole * mNLast);
 
 		mNLast = noise;
 
@@ -659,7 +680,7 @@ void klatt::parwave(short int *jwave)
 		{
 			/* Amount of breathiness determined by parameter mVoicingBreathiness */
 			/* Use nrand rather than noise because noise is ELM_FEATURE_LOW-passed */
-			voice += mAmpBreth * nrand;
+			voice += mAmpBreth * nrand * mNoiseGain;
 		}
 
 		/* Set amplitude of voicing */
@@ -679,28 +700,26 @@ void klatt::parwave(short int *jwave)
 		*/
 		par_glotout = mNasalZero.antiresonate(par_glotout);
 		par_glotout = mNasalPole.resonate(par_glotout);
-		/* And just use mParallelFormant1 NOT mParallelResoNasalPole */		
-		float out = mParallelFormant1.resonate(par_glotout);
 		/* Sound sourc for other parallel resonators is frication
 		plus first difference of voicing waveform.
 		*/
-		sourc += (par_glotout - mGlotLast);
+		sourc += (par_glotout - mGlotLast) * mRateScale;
 		mGlotLast = par_glotout;
 
 		/* Standard parallel vocal tract
-		Formants F6,F5,F4,F3,F2, outputs added with alternating sign
+		F1 on the nasal output (NOT mParallelResoNasalPole),
+		F2 to F6 on sourc, outputs added with alternating sign
 		*/
-		out = mParallelFormant6.resonate(sourc) - out;
-		out = mParallelFormant5.resonate(sourc) - out;
-		out = mParallelFormant4.resonate(sourc) - out;
-		out = mParallelFormant3.resonate(sourc) - out;
-		out = mParallelFormant2.resonate(sourc) - out;
-
-		out = mAmpBypas * sourc - out;
+		float formantIn[RESONATOR_BANK_SIZE] = { par_glotout, sourc, sourc, sourc, sourc, sourc, 0, 0 };
+		float out = mAmpBypas * sourc - mParallelFormants.resonate(formantIn);
 		out = mOutputLowPassFilter.resonate(out);
 
 		*jwave++ = clip(out); /* Convert back to integer */
 	}
+
+#ifdef SOLOUD_SSE_INTRINSICS
+	_mm_setcsr(csr);
+#endif
 }
 
 
@@ -1047,14 +1066,19 @@ int klatt::synth(int /* aSampleCount */, short *aSamplePointer)
 }
 
 
-void klatt::init(int aBaseFrequency, float aBaseSpeed, float aBaseDeclination, int aBaseWaveform)
+void klatt::init(int aBaseFrequency, float aBaseSpeed, float aBaseDeclination, int aBaseWaveform, int aSampleRate)
 {
 	mBaseF0 = aBaseFrequency;
 	mBaseSpeed = aBaseSpeed;
 	mBaseDeclination = aBaseDeclination;
 	mBaseWaveform = aBaseWaveform;
 
-    mSampleRate = 11025;
+	mSampleRate = aSampleRate > 0 ? aSampleRate : 11025;
+	mRateScale = mSampleRate / 11025.0f;
+	mPeriodScale = 11025.0f / mSampleRate;
+	// keep the noise tilt and the noise level per Hz of the original rate
+	mNoisePole = mSampleRate == 11025 ? 0.75f : (float)pow(0.75, mPeriodScale);
+	mNoiseGain = (float)sqrt(mRateScale);
     mF0Flutter = 0;
 	mF0FundamentalFreq = mBaseF0;
 	mFrame.mF0FundamentalFreq = mBaseF0;
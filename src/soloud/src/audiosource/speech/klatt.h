@@ -83,10 +83,10 @@ enum KLATT_WAVEFORM
 class klatt
 {
 	// resonators
-	resonator mParallelFormant1, mParallelFormant2, mParallelFormant3, 
-		      mParallelFormant4, mParallelFormant5, mParallelFormant6,
-		      mParallelResoNasalPole, mNasalPole, mNasalZero, 
+	resonator mNasalPole, mNasalZero, 
 			  mCritDampedGlotLowPassFilter, mDownSampLowPassFilter, mOutputLowPassFilter;
+	// parallel formants F1 to F6, one per lane
+	resonator_bank mParallelFormants;
 public:
 	int mBaseF0;
 	float mBaseSpeed;
@@ -124,6 +124,13 @@ public:
 
 	unsigned int mSeed;			// random seed
 
+	// Constants that keep the voice the same at any sample rate,
+	// all 1 or the original values at 11025 Hz
+	float mRateScale;           // mSampleRate / 11025
+	float mPeriodScale;         // 11025 / mSampleRate, for the source waveforms
+	float mNoisePole;           // pole of the noise tilt filter
+	float mNoiseGain;           // keeps the noise density
+
 
 
 	float natural_source(int aNper);
@@ -132,7 +139,7 @@ public:
 	void flutter();
 	void pitch_synch_par_reset(int ns);
 	void parwave(short int *jwave);
-	void init(int aBaseFrequency = 1330, float aBaseSpeed = 10.0f, float aBaseDeclination = 0.5f, int aBaseWaveform = KW_SAW);
+	void init(int aBaseFrequency = 1330, float aBaseSpeed = 10.0f, float aBaseDeclination = 0.5f, int aBaseWaveform = KW_SAW, int aSampleRate = 11025);
 	static int phone_to_elm(char *aPhoneme, int aCount, darray *aElement);
 
 	int mElementCount;
@@ -1,6 +1,11 @@
 #include <math.h>
+#include "soloud.h"
 #include "resonator.h"
 
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #ifndef PI
 #define PI 3.1415926535897932384626433832795f
 #endif
@@ -72,3 +77,52 @@ void resonator::setGain(float aG)
 	mA *= aG;
 }
 
+
+resonator_bank::resonator_bank()
+{
+	int i;
+	for (i = 0; i < RESONATOR_BANK_SIZE; i++)
+	{
+		mA[i] = mB[i] = mC[i] = mP1[i] = mP2[i] = 0;
+	}
+}
+
+void resonator_bank::setLane(int aLane, const resonator &aResonator)
+{
+	mA[aLane] = aResonator.mA;
+	mB[aLane] = aResonator.mB;
+	mC[aLane] = aResonator.mC;
+}
+
+float resonator_bank::resonate(const float *aInput)
+{
+#ifdef SOLOUD_SSE_INTRINSICS
+	__m128 sum = _mm_setzero_ps();
+	int i;
+	for (i = 0; i < RESONATOR_BANK_SIZE; i += 4)
+	{
+		__m128 p1 = _mm_loadu_ps(mP1 + i);
+		__m128 x = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_loadu_ps(mA + i), _mm_loadu_ps(aInput + i)),
+			_mm_mul_ps(_mm_loadu_ps(mB + i), p1)),
+			_mm_mul_ps(_mm_loadu_ps(mC + i), _mm_loadu_ps(mP2 + i)));
+		_mm_storeu_ps(mP2 + i, p1);
+		_mm_storeu_ps(mP1 + i, x);
+		sum = _mm_add_ps(sum, x);
+	}
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+#else
+	float sum = 0;
+	int i;
+	for (i = 0; i < RESONATOR_BANK_SIZE; i++)
+	{
+		float x = mA[i] * aInput[i] + mB[i] * mP1[i] + mC[i] * mP2[i];
+		mP2[i] = mP1[i];
+		mP1[i] = x;
+		sum += x;
+	}
+	return sum;
+#endif
+}
@@ -3,6 +3,7 @@
 
 class resonator
 {
+	friend class resonator_bank;
 	float mA, mB, mC, mP1, mP2;
 public:
 
@@ -41,4 +42,29 @@ public:
 	~resonator();
 };
 
+#define RESONATOR_BANK_SIZE 8
+
+/* Resonators fed in parallel and summed, such as the parallel formants.
+   The coefficients and the state are stored lane by lane so that all the
+   resonators advance together, 4 lanes at a time with SSE. Unused lanes
+   have zero coefficients and output nothing.
+ */
+class resonator_bank
+{
+	float mA[RESONATOR_BANK_SIZE];
+	float mB[RESONATOR_BANK_SIZE];
+	float mC[RESONATOR_BANK_SIZE];
+	float mP1[RESONATOR_BANK_SIZE];
+	float mP2[RESONATOR_BANK_SIZE];
+public:
+
+	/* Set the coefficients of a lane from an initialized resonator, keeping its state */
+	void setLane(int aLane, const resonator &aResonator);
+
+	/* Run every lane on its input and return the sum of the outputs */
+	float resonate(const float *aInput);
+
+	resonator_bank();
+};
+
 #endif
\ No newline at end of file
@@ -79,6 +79,10 @@ namespace SoLoud
         aSoloud->postinit_internal(gDevice.sampleRate, gDevice.playback.internalPeriodSizeInFrames, aFlags, gDevice.playback.channels);
 
         aSoloud->mBackendCleanupFunc = soloud_miniaudio_deinit;
+        // all the periods of the device buffer are queued before a new one is heard
+        aSoloud->mBackendLatency = (unsigned int)((unsigned long long)gDevice.playback.internalPeriodSizeInFrames *
+                                                  gDevice.playback.internalPeriods * gDevice.sampleRate /
+                                                  (gDevice.playback.internalSampleRate ? gDevice.playback.internalSampleRate : gDevice.sampleRate));
 
         ma_device_start(&gDevice);
         aSoloud->mBackendString = "MiniAudio";
@@ -121,6 +121,12 @@ namespace SoLoud
 		mChannels = 2;		
 		mStreamTime = 0;
 		mLastClockedTime = 0;
+		mMixedSamples = 0;
+		mBackendLatency = 0;
+		mMixCallback = NULL;
+		mMixCallbackUserData = NULL;
+		mPostMixCallback = NULL;
+		mPostMixCallbackUserData = NULL;
 		mAudioSourceID = 1;
 		mBackendString = 0;
 		mBackendID = 0;
@@ -212,6 +218,8 @@ namespace SoLoud
 		deinit();
 
 		mAudioThreadMutex = Thread::createMutex();
+		mMixedSamples = 0;
+		mBackendLatency = 0;
 
 		mBackendID = 0;
 		mBackendString = 0;
@@ -1599,6 +1607,29 @@ namespace SoLoud
 			aVoice->mCurrentChannelVolume[k] = pand[k];
 	}
 
+	unsigned int Soloud::getVoiceAudio_internal(AudioSourceInstance *aVoice, float *aBuffer, unsigned int aSamples, unsigned int aBufferSize)
+	{
+		unsigned int readcount = 0;
+		if (!aVoice->hasEnded() || aVoice->mFlags & AudioSourceInstance::LOOPING)
+		{
+			readcount = aVoice->getAudio(aBuffer, aSamples, aBufferSize);
+			if (readcount < aSamples)
+			{
+				if (aVoice->mFlags & AudioSourceInstance::LOOPING)
+				{
+					while (readcount < aSamples && aVoice->seek(aVoice->mLoopPoint, mScratch.mData, mScratchSize) == SO_NO_ERROR)
+					{
+						aVoice->mLoopCount++;
+						unsigned int inc = aVoice->getAudio(aBuffer + readcount, aSamples - readcount, aBufferSize);
+						readcount += inc;
+						if (inc == 0) break;
+					}
+				}
+			}
+		}
+		return readcount;
+	}
+
 	void Soloud::mixBus_internal(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize, float *aScratch, unsigned int aBus, float aSamplerate, unsigned int aChannels, unsigned int aResampler)
 	{
 		unsigned int i, j;
@@ -1621,6 +1652,8 @@ namespace SoLoud
 				!(voice->mFlags & AudioSourceInstance::INAUDIBLE))
 			{
 				float step = voice->mSamplerate / aSamplerate;
+				if (voice->mProcessor)
+					step *= voice->mProcessor->getPitch();
 				// avoid step overflow
 				if (step > (1 << (32 - FIXPOINT_FRAC_BITS)))
 					step = 0;
@@ -1659,24 +1692,11 @@ namespace SoLoud
 
 						// Get a block of source data
 
-						int readcount = 0;
-						if (!voice->hasEnded() || voice->mFlags & AudioSourceInstance::LOOPING)
-						{
-							readcount = voice->getAudio(voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
-							if (readcount < SAMPLE_GRANULARITY)
-							{
-								if (voice->mFlags & AudioSourceInstance::LOOPING)
-								{
-									while (readcount < SAMPLE_GRANULARITY && voice->seek(voice->mLoopPoint, mScratch.mData, mScratchSize) == SO_NO_ERROR)
-									{
-										voice->mLoopCount++;
-										int inc = voice->getAudio(voice->mResampleData[0] + readcount, SAMPLE_GRANULARITY - readcount, SAMPLE_GRANULARITY);
-										readcount += inc;
-										if (inc == 0) break;
-									}
-								}
-							}
-						}
+						unsigned int readcount;
+						if (voice->mProcessor)
+							readcount = voice->mProcessor->process(this, voice, voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
+						else
+							readcount = getVoiceAudio_internal(voice, voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
 
                         // Clear remaining of the resample data if the full scratch wasn't used
 						if (readcount < SAMPLE_GRANULARITY)
@@ -1808,6 +1828,8 @@ namespace SoLoud
 			{
 				// Inaudible but needs ticking. Do minimal work (keep counters up to date and ask audiosource for data)
 				float step = voice->mSamplerate / aSamplerate;
+				if (voice->mProcessor)
+					step *= voice->mProcessor->getPitch();
 				int step_fixed = (int)floor(step * FIXPOINT_FRAC_MUL);
 				unsigned int outofs = 0;
 
@@ -1836,22 +1858,10 @@ namespace SoLoud
 
 						// Get a block of source data
 
-						int readcount = 0;
-						if (!voice->hasEnded() || voice->mFlags & AudioSourceInstance::LOOPING)
-						{
-							readcount = voice->getAudio(voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
-							if (readcount < SAMPLE_GRANULARITY)
-							{
-								if (voice->mFlags & AudioSourceInstance::LOOPING)
-								{
-									while (readcount < SAMPLE_GRANULARITY && voice->seek(voice->mLoopPoint, mScratch.mData, mScratchSize) == SO_NO_ERROR)
-									{
-										voice->mLoopCount++;
-										readcount += voice->getAudio(voice->mResampleData[0] + readcount, SAMPLE_GRANULARITY - readcount, SAMPLE_GRANULARITY);
-									}
-								}
-							}
-						}
+						if (voice->mProcessor)
+							voice->mProcessor->process(this, voice, voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
+						else
+							getVoiceAudio_internal(voice, voice->mResampleData[0], SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
 
 						// If we go past zero, crop to zero (a bit of a kludge)
 						if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
@@ -2113,6 +2123,8 @@ namespace SoLoud
 
 		lockAudioMutex_internal();
 
+		mMixedSamples += aSamples;
+
 		// Process faders. May change scratch size.
 		int i;
 		for (i = 0; i < (signed)mHighestVoice; i++)
@@ -2129,7 +2141,9 @@ namespace SoLoud
 				}
 
 				mVoice[i]->mStreamTime += buffertime;
-				mVoice[i]->mStreamPosition += (double)buffertime * (double)mVoice[i]->mOverallRelativePlaySpeed;
+				// a processed voice reads its source at the tempo of the processor
+				mVoice[i]->mStreamPosition += (double)buffertime * (double)mVoice[i]->mOverallRelativePlaySpeed *
+					(mVoice[i]->mProcessor ? (double)mVoice[i]->mProcessor->getTempo() : 1.0);
 
 				// TODO: this is actually unstable, because mStreamTime depends on the relative
 				// play speed. 
@@ -2196,61 +2210,89 @@ namespace SoLoud
 		// Note: clipping channels*aStride, not channels*aSamples, so we're possibly clipping some unused data.
 		// The buffers should be large enough for it, we just may do a few bytes of unneccessary work.
 		clip_internal(mOutputScratch, mScratch, aStride, globalVolume[0], globalVolume[1]);
+	}
 
-		if (mFlags & ENABLE_VISUALIZATION)
+	void Soloud::visualize_internal(unsigned int aOffset, unsigned int aSamples, unsigned int aStride, unsigned int aBufferSamples)
+	{
+		// The first 256 samples of the output buffer, which may have been
+		// mixed in several segments
+		if (!(mFlags & ENABLE_VISUALIZATION))
+			return;
+		unsigned int i;
+		if (aOffset == 0)
 		{
 			for (i = 0; i < MAX_CHANNELS; i++)
 			{
 				mVisualizationChannelVolume[i] = 0;
 			}
-			if (aSamples > 255)
+		}
+		for (i = aOffset; i < 256 && i < aOffset + aSamples; i++)
+		{
+			int j;
+			mVisualizationWaveData[i] = 0;
+			for (j = 0; j < (signed)mChannels; j++)
 			{
-				for (i = 0; i < 256; i++)
-				{
-					int j;
-					mVisualizationWaveData[i] = 0;
-					for (j = 0; j < (signed)mChannels; j++)
-					{
-						float sample = mScratch.mData[i + j * aStride];
-						float absvol = (float)fabs(sample);
-						if (mVisualizationChannelVolume[j] < absvol)
-							mVisualizationChannelVolume[j] = absvol;
-						mVisualizationWaveData[i] += sample;
-					}
-				}
+				float sample = mScratch.mData[(i - aOffset) + j * aStride];
+				float absvol = (float)fabs(sample);
+				if (mVisualizationChannelVolume[j] < absvol)
+					mVisualizationChannelVolume[j] = absvol;
+				mVisualizationWaveData[i] += sample;
 			}
-			else
+		}
+		// Very unlikely failsafe: a buffer shorter than 256 samples is repeated
+		if (aOffset + aSamples == aBufferSamples && aBufferSamples < 256)
+		{
+			for (i = aBufferSamples; i < 256; i++)
 			{
-				// Very unlikely failsafe branch
-				for (i = 0; i < 256; i++)
-				{
-					int j;
-					mVisualizationWaveData[i] = 0;
-					for (j = 0; j < (signed)mChannels; j++)
-					{
-						float sample = mScratch.mData[(i % aSamples) + j * aStride];
-						float absvol = (float)fabs(sample);
-						if (mVisualizationChannelVolume[j] < absvol)
-							mVisualizationChannelVolume[j] = absvol;
-						mVisualizationWaveData[i] += sample;
-					}
-				}
+				mVisualizationWaveData[i] = mVisualizationWaveData[i % aBufferSamples];
 			}
 		}
 	}
 
+	unsigned int Soloud::mixSegment_internal(unsigned int aSamples)
+	{
+		unsigned int samples = aSamples;
+		if (mMixCallback)
+		{
+			samples = mMixCallback(mMixCallbackUserData, mMixedSamples, aSamples);
+			if (samples == 0 || samples > aSamples)
+				samples = aSamples;
+		}
+		return samples;
+	}
+
 	void Soloud::mix(float *aBuffer, unsigned int aSamples)
 	{
-		unsigned int stride = (aSamples + 15) & ~0xf;
-		mix_internal(aSamples, stride);
-		interlace_samples_float(mScratch.mData, aBuffer, aSamples, mChannels, stride);
+		// The buffer is mixed in parts when the mix callback asks to stop
+		// at an exact sample, ie to start a scheduled sound
+		unsigned int done = 0;
+		while (done < aSamples)
+		{
+			unsigned int samples = mixSegment_internal(aSamples - done);
+			unsigned int stride = (samples + 15) & ~0xf;
+			mix_internal(samples, stride);
+			visualize_internal(done, samples, stride, aSamples);
+			interlace_samples_float(mScratch.mData, aBuffer + done * mChannels, samples, mChannels, stride);
+			done += samples;
+			if (mPostMixCallback)
+				mPostMixCallback(mPostMixCallbackUserData, mScratch.mData, samples, stride, done == aSamples);
+		}
 	}
 
 	void Soloud::mixSigned16(short *aBuffer, unsigned int aSamples)
 	{
-		unsigned int stride = (aSamples + 15) & ~0xf;
-		mix_internal(aSamples, stride);
-		interlace_samples_s16(mScratch.mData, aBuffer, aSamples, mChannels, stride);
+		unsigned int done = 0;
+		while (done < aSamples)
+		{
+			unsigned int samples = mixSegment_internal(aSamples - done);
+			unsigned int stride = (samples + 15) & ~0xf;
+			mix_internal(samples, stride);
+			visualize_internal(done, samples, stride, aSamples);
+			interlace_samples_s16(mScratch.mData, aBuffer + done * mChannels, samples, mChannels, stride);
+			done += samples;
+			if (mPostMixCallback)
+				mPostMixCallback(mPostMixCallbackUserData, mScratch.mData, samples, stride, done == aSamples);
+		}
 	}
 
 	void interlace_samples_float(const float *aSourceBuffer, float *aDestBuffer, unsigned int aSamples, unsigned int aChannels, unsigned int aStride)
@@ -75,6 +75,7 @@ namespace SoLoud
 		for (i = 0; i < MAX_CHANNELS; i++)
 			mChannelVolume[i] = 1.0f;		
 		mSetVolume = 1.0f;
+		mNormalizationGain = 1.0f;
 		mBaseSamplerate = 44100.0f;
 		mSamplerate = 44100.0f;
 		mSetRelativePlaySpeed = 1.0f;
@@ -86,6 +87,7 @@ namespace SoLoud
 		mBusHandle = ~0u;
 		mLoopCount = 0;
 		mLoopPoint = 0;
+		mProcessor = NULL;
 		for (i = 0; i < FILTERS_PER_STREAM; i++)
 		{
 			mFilter[i] = NULL;
@@ -111,6 +113,7 @@ namespace SoLoud
 		{
 			delete mFilter[i];
 		}		
+		delete mProcessor;
 	}
 
 	void AudioSourceInstance::init(AudioSource &aSource, int aPlayIndex)
@@ -122,6 +125,7 @@ namespace SoLoud
 		mStreamTime = 0.0f;
 		mStreamPosition = 0.0f;
 		mLoopPoint = aSource.mLoopPoint;
+		mNormalizationGain = aSource.mNormalizationGain;
 
 		if (aSource.mFlags & AudioSource::SHOULD_LOOP)
 		{
@@ -202,6 +206,11 @@ namespace SoLoud
 		mAttenuator = 0;
 		mColliderData = 0;
 		mVolume = 1;
+		mNormalizationGain = 1;
+		mMaxInstances = 0;
+		mStealPolicy = STEAL_OLDEST;
+		mMinRetriggerInterval = 0;
+		mLastTrigger = -1;
 		mLoopPoint = 0;
 	}
 
@@ -215,6 +224,18 @@ namespace SoLoud
 		mVolume = aVolume;
 	}
 
+	void AudioSource::setNormalizationGain(float aGain)
+	{
+		mNormalizationGain = aGain;
+	}
+
+	void AudioSource::setInstanceLimit(unsigned int aMaxInstances, unsigned int aStealPolicy, time aMinRetriggerInterval)
+	{
+		mMaxInstances = aMaxInstances;
+		mStealPolicy = aStealPolicy;
+		mMinRetriggerInterval = aMinRetriggerInterval < 0 ? 0 : aMinRetriggerInterval;
+	}
+
 	void AudioSource::setLoopPoint(time aLoopPoint)
 	{
 		mLoopPoint = aLoopPoint;
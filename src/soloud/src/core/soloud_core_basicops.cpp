@@ -43,6 +43,13 @@ namespace SoLoud
 		SoLoud::AudioSourceInstance *instance = aSound.createInstance();
 
 		lockAudioMutex_internal();
+		// Checked here, under the mutex, so the plays from the audio thread are limited too
+		if (!admitInstance_internal(aSound))
+		{
+			unlockAudioMutex_internal();
+			delete instance;
+			return 0;
+		}
 		int ch = findFreeVoice_internal();
 		if (ch < 0) 
 		{
@@ -109,6 +116,50 @@ namespace SoLoud
 		return handle;
 	}
 
+	bool Soloud::admitInstance_internal(AudioSource &aSound)
+	{
+		// The engine time of the mixed samples, exact for the plays from the mix callback
+		time now = mSamplerate > 0 ? (time)mMixedSamples / mSamplerate : 0;
+		// The time goes back after a deinit
+		if (aSound.mMinRetriggerInterval > 0 && aSound.mLastTrigger >= 0 && now >= aSound.mLastTrigger &&
+			now - aSound.mLastTrigger < aSound.mMinRetriggerInterval)
+		{
+			return false;
+		}
+
+		if (aSound.mMaxInstances > 0 && aSound.mAudioSourceID)
+		{
+			for (;;)
+			{
+				unsigned int count = 0;
+				int victim = -1;
+				unsigned int i;
+				for (i = 0; i < mHighestVoice; i++)
+				{
+					if (mVoice[i] && mVoice[i]->mAudioSourceID == aSound.mAudioSourceID)
+					{
+						count++;
+						if (victim < 0 ||
+							(aSound.mStealPolicy == AudioSource::STEAL_QUIETEST
+								 ? mVoice[i]->mOverallVolume < mVoice[victim]->mOverallVolume
+								 : mVoice[i]->mPlayIndex < mVoice[victim]->mPlayIndex))
+						{
+							victim = i;
+						}
+					}
+				}
+				if (count < aSound.mMaxInstances)
+					break;
+				if (aSound.mStealPolicy == AudioSource::STEAL_REJECT)
+					return false;
+				stopVoice_internal(victim);
+			}
+		}
+
+		aSound.mLastTrigger = now;
+		return true;
+	}
+
 	handle Soloud::playClocked(time aSoundTime, AudioSource &aSound, float aVolume, float aPan, unsigned int aBus)
 	{
 		handle h = play(aSound, aVolume, aPan, 1, aBus);
@@ -143,6 +194,8 @@ namespace SoLoud
 		result singleres = SO_NO_ERROR;
 		FOR_ALL_VOICES_PRE
 			singleres = mVoice[ch]->seek(aSeconds, mScratch.mData, mScratchSize);
+			if (mVoice[ch]->mProcessor)
+				mVoice[ch]->mProcessor->reset();
 		if (singleres != SO_NO_ERROR)
 			res = singleres;
 		FOR_ALL_VOICES_POST
@@ -382,6 +382,17 @@ namespace SoLoud
 		return mBufferSize;
 	}
 
+	// Returns the samples buffered by the backend before they are heard
+	unsigned int Soloud::getBackendLatency()
+	{
+		return mBackendLatency;
+	}
+
+	unsigned long long Soloud::getMixedSamples()
+	{
+		return mMixedSamples;
+	}
+
 	// Get speaker position in 3d space
 	result Soloud::getSpeakerPosition(unsigned int aChannel, float &aX, float &aY, float &aZ)
 	{
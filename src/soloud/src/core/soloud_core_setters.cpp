@@ -55,6 +55,21 @@ namespace SoLoud
 		return retVal;
 	}
 
+	result Soloud::setVoiceProcessor(handle aVoiceHandle, VoiceProcessor *aProcessor)
+	{
+		lockAudioMutex_internal();
+		int ch = getVoiceFromHandle_internal(aVoiceHandle);
+		if (ch == -1)
+		{
+			unlockAudioMutex_internal();
+			return INVALID_PARAMETER;
+		}
+		delete mVoice[ch]->mProcessor;
+		mVoice[ch]->mProcessor = aProcessor;
+		unlockAudioMutex_internal();
+		return SO_NO_ERROR;
+	}
+
 	void Soloud::setSamplerate(handle aVoiceHandle, float aSamplerate)
 	{
 		FOR_ALL_VOICES_PRE
@@ -228,6 +243,18 @@ namespace SoLoud
 		FOR_ALL_VOICES_POST
 	}
 
+	void Soloud::setMixCallback(mixCallFunction aCallback, void *aUserData)
+	{
+		mMixCallback = aCallback;
+		mMixCallbackUserData = aUserData;
+	}
+
+	void Soloud::setPostMixCallback(postMixCallFunction aCallback, void *aUserData)
+	{
+		mPostMixCallback = aCallback;
+		mPostMixCallbackUserData = aUserData;
+	}
+
 	void Soloud::setVisualizationEnable(bool aEnable)
 	{
 		if (aEnable)
@@ -149,7 +149,7 @@ namespace SoLoud
 	{
 		SOLOUD_ASSERT(aVoice < VOICE_COUNT);
 		SOLOUD_ASSERT(mInsideAudioThreadMutex);
-		mVoice[aVoice]->mOverallVolume = mVoice[aVoice]->mSetVolume * m3dData[aVoice].m3dVolume;
+		mVoice[aVoice]->mOverallVolume = mVoice[aVoice]->mSetVolume * m3dData[aVoice].m3dVolume * mVoice[aVoice]->mNormalizationGain;
 		if (mVoice[aVoice]->mFlags & AudioSourceInstance::PAUSED)
 		{
 			int i;
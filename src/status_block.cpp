@@ -0,0 +1,129 @@
+#include "status_block.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+// lib/src/engine_status.dart reads the block at these offsets
+static_assert(sizeof(StatusHeader) == 104, "update _headerSize in engine_status.dart");
+static_assert(offsetof(StatusHeader, engineTime) == 8 &&
+                  offsetof(StatusHeader, channels) == 20 &&
+                  offsetof(StatusHeader, globalVolume) == 32 &&
+                  offsetof(StatusHeader, peak) == 40 &&
+                  offsetof(StatusHeader, rms) == 72,
+              "update EngineStatusReader._parse in engine_status.dart");
+static_assert(sizeof(StatusVoice) == 32, "update _voiceSize in engine_status.dart");
+static_assert(offsetof(StatusVoice, handle) == 8 &&
+                  offsetof(StatusVoice, volume) == 16 &&
+                  offsetof(StatusVoice, loopCount) == 28,
+              "update EngineStatusReader._parse in engine_status.dart");
+
+StatusBlock::StatusBlock(SoLoud::Soloud *soloud)
+    : mSoloud(soloud),
+      mEnabled(false),
+      mMeteredSamples(0)
+{
+    mData = new unsigned char[getSize()];
+    memset(mData, 0, getSize());
+    mHeader = reinterpret_cast<StatusHeader *>(mData);
+    mVoices = reinterpret_cast<StatusVoice *>(mData + sizeof(StatusHeader));
+    mHeader->version = STATUS_BLOCK_VERSION;
+    mHeader->voiceCapacity = VOICE_COUNT;
+    memset(mPeak, 0, sizeof(mPeak));
+    memset(mSquares, 0, sizeof(mSquares));
+}
+
+StatusBlock::~StatusBlock()
+{
+    delete[] mData;
+}
+
+unsigned int StatusBlock::getSize() const
+{
+    return sizeof(StatusHeader) + sizeof(StatusVoice) * VOICE_COUNT;
+}
+
+void StatusBlock::setEnabled(bool enabled)
+{
+    mEnabled.store(enabled);
+}
+
+void StatusBlock::postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd)
+{
+    static_cast<StatusBlock *>(aUserData)->onPostMix(aBuffer, aSamples, aStride, aBlockEnd);
+}
+
+void StatusBlock::onPostMix(const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd)
+{
+    if (!mEnabled.load())
+        return;
+
+    const unsigned int channels = mSoloud->mChannels;
+    for (unsigned int ch = 0; ch < channels; ch++)
+    {
+        const float *data = aBuffer + ch * aStride;
+        float peak = mPeak[ch];
+        double squares = 0.0;
+        for (unsigned int i = 0; i < aSamples; i++)
+        {
+            float v = fabsf(data[i]);
+            if (v > peak)
+                peak = v;
+            squares += (double)data[i] * data[i];
+        }
+        mPeak[ch] = peak;
+        mSquares[ch] += squares;
+    }
+    mMeteredSamples += aSamples;
+
+    if (aBlockEnd)
+        publish();
+}
+
+void StatusBlock::publish()
+{
+    std::atomic<uint32_t> &sequence = *reinterpret_cast<std::atomic<uint32_t> *>(&mHeader->sequence);
+    const uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const unsigned int channels = mSoloud->mChannels;
+    mHeader->engineTime = mSoloud->getMixedSamples();
+    mHeader->sampleRate = mSoloud->mSamplerate;
+    mHeader->channels = channels;
+    mHeader->globalVolume = mSoloud->mGlobalVolume;
+    for (unsigned int ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        const bool used = ch < channels && mMeteredSamples > 0;
+        mHeader->peak[ch] = used ? mPeak[ch] : 0.0f;
+        mHeader->rms[ch] = used ? (float)sqrt(mSquares[ch] / mMeteredSamples) : 0.0f;
+        mPeak[ch] = 0.0f;
+        mSquares[ch] = 0.0;
+    }
+    mMeteredSamples = 0;
+
+    // the voices are changed by the other threads under the audio mutex
+    unsigned int count = 0;
+    mSoloud->lockAudioMutex_internal();
+    for (unsigned int i = 0; i < mSoloud->mHighestVoice; i++)
+    {
+        SoLoud::AudioSourceInstance *voice = mSoloud->mVoice[i];
+        if (voice == nullptr)
+            continue;
+        StatusVoice &status = mVoices[count++];
+        status.position = voice->mStreamPosition;
+        status.handle = mSoloud->getHandleFromVoice_internal(i);
+        status.flags =
+            (voice->mFlags & SoLoud::AudioSourceInstance::PAUSED ? STATUS_VOICE_PAUSED : 0) |
+            (voice->mFlags & SoLoud::AudioSourceInstance::LOOPING ? STATUS_VOICE_LOOPING : 0) |
+            (voice->mFlags & SoLoud::AudioSourceInstance::PROTECTED ? STATUS_VOICE_PROTECTED : 0);
+        status.volume = voice->mSetVolume;
+        status.pan = voice->mPan;
+        status.relativeSpeed = voice->mSetRelativePlaySpeed;
+        status.loopCount = voice->mLoopCount;
+    }
+    mSoloud->unlockAudioMutex_internal();
+    mHeader->voiceCount = count;
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
@@ -0,0 +1,91 @@
+#ifndef STATUS_BLOCK_H
+#define STATUS_BLOCK_H
+
+#include "soloud.h"
+
+#include <atomic>
+#include <stdint.h>
+
+/// Layout version of [StatusHeader] and [StatusVoice], increased when
+/// they change so a reader can check it is compatible.
+#define STATUS_BLOCK_VERSION 1
+
+/// Flags of [StatusVoice]
+#define STATUS_VOICE_PAUSED 1
+#define STATUS_VOICE_LOOPING 2
+#define STATUS_VOICE_PROTECTED 4
+
+/// Engine state at the head of the status block. The layout is shared
+/// with Dart, which reads it directly from memory.
+typedef struct StatusHeader
+{
+    /// seqlock counter: odd while the block is being written
+    uint32_t sequence;
+    uint32_t version;
+    /// engine time in samples at the end of the last block
+    uint64_t engineTime;
+    uint32_t sampleRate;
+    uint32_t channels;
+    /// number of [StatusVoice] following the header
+    uint32_t voiceCount;
+    uint32_t voiceCapacity;
+    float globalVolume;
+    uint32_t reserved;
+    /// per channel peak and RMS of the last block
+    float peak[MAX_CHANNELS];
+    float rms[MAX_CHANNELS];
+} StatusHeader_t;
+
+/// State of a playing voice, following the [StatusHeader].
+typedef struct StatusVoice
+{
+    /// position in seconds
+    double position;
+    uint32_t handle;
+    /// STATUS_VOICE_* flags
+    uint32_t flags;
+    float volume;
+    float pan;
+    float relativeSpeed;
+    uint32_t loopCount;
+} StatusVoice_t;
+
+/// Publishes the engine and voices state into a block of memory once per
+/// mixed block, so it can be polled without locks or FFI calls.
+///
+/// The block is protected by a seqlock: the writer makes [sequence] odd,
+/// writes, then makes it even again. A reader copies the block and retries
+/// if [sequence] was odd or has changed meanwhile.
+class StatusBlock
+{
+public:
+    StatusBlock(SoLoud::Soloud *soloud);
+    ~StatusBlock();
+
+    /// @brief the function to pass to [Soloud::setPostMixCallback]
+    static void postMixCallback(void *aUserData, const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd);
+
+    /// @brief start or stop publishing. Disabled by default.
+    void setEnabled(bool enabled);
+
+    /// @brief the memory to read. Valid until this object is destroyed.
+    void *getData() const { return mData; }
+    unsigned int getSize() const;
+
+private:
+    void onPostMix(const float *aBuffer, unsigned int aSamples, unsigned int aStride, bool aBlockEnd);
+    void publish();
+
+    SoLoud::Soloud *mSoloud;
+    std::atomic<bool> mEnabled;
+    unsigned char *mData;
+    StatusHeader *mHeader;
+    StatusVoice *mVoices;
+
+    /// meters accumulated over the parts of the current block
+    float mPeak[MAX_CHANNELS];
+    double mSquares[MAX_CHANNELS];
+    unsigned int mMeteredSamples;
+};
+
+#endif // STATUS_BLOCK_H
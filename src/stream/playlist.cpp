@@ -0,0 +1,494 @@
+#include "playlist.h"
+
+#include <chrono>
+#include <cmath>
+#include <string.h>
+#include <thread>
+
+/////////////////////////////////////////
+/// PlaylistSlot
+/////////////////////////////////////////
+
+PlaylistSlot::PlaylistSlot()
+    : itemIndex(0),
+      channels(1),
+      step(1.0),
+      totalFrames(0),
+      chunkStartFrame(0),
+      chunkFrames(0),
+      pos(1.0),
+      prerollRead(0),
+      ended(false),
+      nextRetired(nullptr)
+{
+    memset(chunk, 0, sizeof(chunk));
+}
+
+bool PlaylistSlot::refill()
+{
+    if (ended)
+        return false;
+
+    const unsigned int stride = SAMPLE_GRANULARITY + 1;
+    // keep the last frame to interpolate with the new chunk
+    for (unsigned int ch = 0; ch < channels; ch++)
+        chunk[ch * stride] = chunk[ch * stride + chunkFrames];
+    pos -= chunkFrames;
+    chunkStartFrame += chunkFrames;
+
+    unsigned int n;
+    if (prerollRead < prerollFrames.size())
+    {
+        n = prerollFrames[prerollRead];
+        const float *src = preroll.data() + prerollRead * channels * SAMPLE_GRANULARITY;
+        for (unsigned int ch = 0; ch < channels; ch++)
+            memcpy(chunk + ch * stride + 1, src + ch * SAMPLE_GRANULARITY, sizeof(float) * n);
+        prerollRead++;
+        if (n < SAMPLE_GRANULARITY)
+            ended = true;
+    }
+    else
+    {
+        // WavStream ignores the buffer size for most formats and packs the
+        // channels, so decode into a separate buffer
+        n = instance->getAudio(decoded, SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
+        for (unsigned int ch = 0; ch < channels; ch++)
+            memcpy(chunk + ch * stride + 1, decoded + ch * SAMPLE_GRANULARITY, sizeof(float) * n);
+        if (n < SAMPLE_GRANULARITY || instance->hasEnded())
+            ended = true;
+    }
+    chunkFrames = n;
+    return n > 0;
+}
+
+unsigned int PlaylistSlot::read(float *aOut, unsigned int aFrames, unsigned int aStride, unsigned int aChannels)
+{
+    const unsigned int stride = SAMPLE_GRANULARITY + 1;
+    unsigned int produced = 0;
+    while (produced < aFrames)
+    {
+        unsigned int i0 = (unsigned int)pos;
+        if (i0 + 1 > chunkFrames)
+        {
+            if (!refill())
+                break;
+            continue;
+        }
+        const float frac = (float)(pos - i0);
+        for (unsigned int ch = 0; ch < aChannels; ch++)
+        {
+            const float *c = chunk + (ch < channels ? ch : channels - 1) * stride;
+            aOut[ch * aStride + produced] = c[i0] + (c[i0 + 1] - c[i0]) * frac;
+        }
+        produced++;
+        pos += step;
+    }
+    return produced;
+}
+
+double PlaylistSlot::remainingFrames() const
+{
+    const double sourcePos = chunkStartFrame + pos - 1.0;
+    if (sourcePos >= totalFrames)
+        return 0.0;
+    return (totalFrames - sourcePos) / step;
+}
+
+/////////////////////////////////////////
+/// PlaylistState
+/////////////////////////////////////////
+
+PlaylistState::PlaylistState()
+    : generation(0),
+      loop(false),
+      crossfade(0.0f),
+      preroll(0.5f),
+      currentIndex(-1),
+      failedItems(0),
+      skipRequests(0)
+{
+}
+
+/////////////////////////////////////////
+/// PlaylistWorker
+/////////////////////////////////////////
+
+PlaylistWorker::PlaylistWorker(std::shared_ptr<PlaylistState> aState, float aSamplerate)
+    : state(aState),
+      samplerate(aSamplerate),
+      quit(false),
+      exhausted(false),
+      next(nullptr),
+      retired(nullptr),
+      prepareIndex(0)
+{
+}
+
+PlaylistWorker::~PlaylistWorker()
+{
+    delete next.exchange(nullptr);
+    PlaylistSlot *slot = retired.exchange(nullptr);
+    while (slot != nullptr)
+    {
+        PlaylistSlot *n = slot->nextRetired;
+        delete slot;
+        slot = n;
+    }
+}
+
+void PlaylistWorker::run()
+{
+    unsigned int failuresInARow = 0;
+    while (!quit.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(10), [this]
+                        { return quit.load(); });
+        }
+        if (quit.load())
+            break;
+
+        // free the items finished by the audio thread
+        PlaylistSlot *slot = retired.exchange(nullptr);
+        while (slot != nullptr)
+        {
+            PlaylistSlot *n = slot->nextRetired;
+            delete slot;
+            slot = n;
+        }
+
+        if (next.load() != nullptr)
+            continue;
+
+        std::string path;
+        unsigned int index, generation;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            const unsigned int count = (unsigned int)state->items.size();
+            if (prepareIndex >= count && state->loop.load() &&
+                count > 0 && failuresInARow < count)
+                prepareIndex = 0;
+            if (prepareIndex >= count)
+            {
+                exhausted.store(true);
+                continue;
+            }
+            exhausted.store(false);
+            index = prepareIndex++;
+            path = state->items[index];
+            generation = state->generation;
+        }
+
+        slot = open(index, path);
+        if (slot == nullptr)
+        {
+            state->failedItems.fetch_add(1);
+            failuresInARow++;
+            continue;
+        }
+        failuresInARow = 0;
+
+        // an item opened while the playlist was cleared is dropped
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (generation != state->generation)
+            delete slot;
+        else
+            next.store(slot);
+    }
+}
+
+PlaylistSlot *PlaylistWorker::open(unsigned int aIndex, const std::string &aCompleteFileName)
+{
+    std::unique_ptr<PlaylistSlot> slot(new PlaylistSlot());
+    slot->itemIndex = aIndex;
+    slot->source.reset(new SoLoud::WavStream());
+    if (slot->source->load(aCompleteFileName.c_str()) != SoLoud::SO_NO_ERROR)
+        return nullptr;
+
+    // opening the instance opens the codec
+    slot->instance.reset(slot->source->createInstance());
+    slot->instance->init(*slot->source, 0);
+    slot->channels = slot->source->mChannels;
+    if (slot->channels == 0 || slot->channels > MAX_CHANNELS)
+        return nullptr;
+    slot->step = slot->source->mBaseSamplerate / samplerate;
+    slot->totalFrames = slot->source->mSampleCount;
+
+    // decode the beginning, so the audio thread can start it right away
+    unsigned int chunks = (unsigned int)ceilf(
+        state->preroll.load() * slot->source->mBaseSamplerate / SAMPLE_GRANULARITY);
+    if (chunks == 0)
+        chunks = 1;
+    slot->preroll.resize(chunks * slot->channels * SAMPLE_GRANULARITY);
+    for (unsigned int i = 0; i < chunks; i++)
+    {
+        unsigned int n = slot->instance->getAudio(
+            slot->preroll.data() + i * slot->channels * SAMPLE_GRANULARITY,
+            SAMPLE_GRANULARITY,
+            SAMPLE_GRANULARITY);
+        slot->prerollFrames.push_back(n);
+        if (n < SAMPLE_GRANULARITY)
+            break;
+    }
+    return slot.release();
+}
+
+void PlaylistWorker::retire(PlaylistSlot *aSlot)
+{
+    if (aSlot == nullptr)
+        return;
+    PlaylistSlot *head = retired.load();
+    do
+    {
+        aSlot->nextRetired = head;
+    } while (!retired.compare_exchange_weak(head, aSlot));
+}
+
+/////////////////////////////////////////
+/// PlaylistInstance
+/////////////////////////////////////////
+
+PlaylistInstance::PlaylistInstance(Playlist *aParent)
+{
+    mWorker = std::make_shared<PlaylistWorker>(aParent->mState, aParent->mBaseSamplerate);
+    mState = aParent->mState;
+    mCurrent = nullptr;
+    mIncoming = nullptr;
+    mFadeLength = 0.0;
+    mFadePos = 0.0;
+    mSkipRequests = mState->skipRequests.load();
+    mPlayedAny = false;
+    mEnded = false;
+    mState->currentIndex.store(-1);
+    {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        mState->worker = mWorker;
+    }
+
+    // the thread keeps the worker alive until it quits, so the instance
+    // never has to wait for it
+    std::shared_ptr<PlaylistWorker> worker = mWorker;
+    std::thread([worker]()
+                { worker->run(); })
+        .detach();
+}
+
+PlaylistInstance::~PlaylistInstance()
+{
+    mWorker->retire(mCurrent);
+    mWorker->retire(mIncoming);
+    mWorker->quit.store(true);
+    mWorker->cv.notify_one();
+    mState->currentIndex.store(-1);
+}
+
+void PlaylistInstance::setCurrent(PlaylistSlot *aSlot)
+{
+    mCurrent = aSlot;
+    if (aSlot != nullptr)
+    {
+        mPlayedAny = true;
+        mState->currentIndex.store((int)aSlot->itemIndex);
+    }
+}
+
+void PlaylistInstance::startFade(PlaylistSlot *aIncoming, double aLength)
+{
+    mIncoming = aIncoming;
+    mFadeLength = aLength < 1.0 ? 1.0 : aLength;
+    mFadePos = 0.0;
+}
+
+void PlaylistInstance::promoteIncoming()
+{
+    mWorker->retire(mCurrent);
+    setCurrent(mIncoming);
+    mIncoming = nullptr;
+}
+
+unsigned int PlaylistInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+    const unsigned int channels = mChannels;
+    for (unsigned int ch = 0; ch < channels; ch++)
+        memset(aBuffer + ch * aBufferSize, 0, sizeof(float) * aSamplesToRead);
+
+    const double crossfade = mState->crossfade.load() * mBaseSamplerate;
+
+    const unsigned int skips = mState->skipRequests.load();
+    if (skips != mSkipRequests)
+    {
+        mSkipRequests = skips;
+        if (mIncoming != nullptr)
+            promoteIncoming();
+        if (mCurrent != nullptr)
+        {
+            PlaylistSlot *next = mWorker->next.exchange(nullptr);
+            if (next != nullptr && crossfade > 0.0)
+            {
+                startFade(next, crossfade);
+            }
+            else
+            {
+                mWorker->retire(mCurrent);
+                setCurrent(next);
+            }
+        }
+    }
+
+    unsigned int done = 0;
+    while (done < aSamplesToRead)
+    {
+        if (mCurrent == nullptr)
+        {
+            setCurrent(mWorker->next.exchange(nullptr));
+            // nothing ready yet (or anymore): the rest stays silent
+            if (mCurrent == nullptr)
+                break;
+        }
+
+        unsigned int todo = aSamplesToRead - done;
+        if (todo > SAMPLE_GRANULARITY)
+            todo = SAMPLE_GRANULARITY;
+
+        if (mIncoming == nullptr && crossfade > 0.0)
+        {
+            const double remaining = mCurrent->remainingFrames();
+            if (remaining > crossfade)
+            {
+                // stop exactly where the crossfade has to start
+                const double untilFade = remaining - crossfade;
+                if (untilFade < todo)
+                    todo = untilFade < 1.0 ? 1 : (unsigned int)untilFade;
+            }
+            else
+            {
+                PlaylistSlot *next = mWorker->next.exchange(nullptr);
+                if (next != nullptr)
+                    startFade(next, remaining);
+            }
+        }
+
+        if (mIncoming == nullptr)
+        {
+            unsigned int got = mCurrent->read(aBuffer + done, todo, aBufferSize, channels);
+            done += got;
+            // gapless splice: the next item continues in this same block
+            if (got < todo)
+            {
+                mWorker->retire(mCurrent);
+                setCurrent(nullptr);
+            }
+            continue;
+        }
+
+        // equal-power crossfade between the outgoing and the incoming item
+        unsigned int gotOut = mCurrent->read(mScratch[0], todo, SAMPLE_GRANULARITY, channels);
+        unsigned int gotIn = mIncoming->read(mScratch[1], todo, SAMPLE_GRANULARITY, channels);
+        for (unsigned int i = 0; i < todo; i++)
+        {
+            double t = (mFadePos + i) / mFadeLength;
+            if (t > 1.0)
+                t = 1.0;
+            const float gainOut = i < gotOut ? (float)cos(t * M_PI * 0.5) : 0.0f;
+            const float gainIn = i < gotIn ? (float)sin(t * M_PI * 0.5) : 0.0f;
+            for (unsigned int ch = 0; ch < channels; ch++)
+            {
+                aBuffer[ch * aBufferSize + done + i] =
+                    mScratch[0][ch * SAMPLE_GRANULARITY + i] * gainOut +
+                    mScratch[1][ch * SAMPLE_GRANULARITY + i] * gainIn;
+            }
+        }
+        mFadePos += todo;
+        done += todo;
+        if (gotOut < todo || mFadePos >= mFadeLength)
+            promoteIncoming();
+    }
+
+    // report the end only after a block without any data, so the voice
+    // isn't stopped before the last frames fetched have been mixed
+    if (done == 0 && mPlayedAny && mCurrent == nullptr &&
+        mWorker->exhausted.load() && mWorker->next.load() == nullptr)
+        mEnded = true;
+
+    return aSamplesToRead;
+}
+
+SoLoud::result PlaylistInstance::seek(SoLoud::time aSeconds, float *mScratch, unsigned int mScratchSize)
+{
+    return SoLoud::NOT_IMPLEMENTED;
+}
+
+bool PlaylistInstance::hasEnded()
+{
+    return mEnded;
+}
+
+/////////////////////////////////////////
+/// Playlist
+/////////////////////////////////////////
+
+Playlist::Playlist(float aSamplerate, unsigned int aChannels)
+{
+    mBaseSamplerate = aSamplerate;
+    mChannels = aChannels;
+    mState = std::make_shared<PlaylistState>();
+    // the worker state belongs to the single playing instance
+    setSingleInstance(true);
+}
+
+Playlist::~Playlist()
+{
+    stop();
+}
+
+unsigned int Playlist::addItem(const std::string &aCompleteFileName)
+{
+    std::lock_guard<std::mutex> lock(mState->mutex);
+    mState->items.push_back(aCompleteFileName);
+    return (unsigned int)mState->items.size() - 1;
+}
+
+void Playlist::clear()
+{
+    std::lock_guard<std::mutex> lock(mState->mutex);
+    mState->items.clear();
+    mState->generation++;
+    std::shared_ptr<PlaylistWorker> worker = mState->worker.lock();
+    if (worker)
+    {
+        worker->prepareIndex = 0;
+        worker->retire(worker->next.exchange(nullptr));
+    }
+}
+
+unsigned int Playlist::getItemCount()
+{
+    std::lock_guard<std::mutex> lock(mState->mutex);
+    return (unsigned int)mState->items.size();
+}
+
+void Playlist::setCrossfade(float aSeconds)
+{
+    mState->crossfade.store(aSeconds < 0.0f ? 0.0f : aSeconds);
+}
+
+void Playlist::setLoop(bool aLoop)
+{
+    mState->loop.store(aLoop);
+}
+
+void Playlist::skip()
+{
+    mState->skipRequests.fetch_add(1);
+}
+
+int Playlist::getCurrentIndex() const
+{
+    return mState->currentIndex.load();
+}
+
+SoLoud::AudioSourceInstance *Playlist::createInstance()
+{
+    return new PlaylistInstance(this);
+}
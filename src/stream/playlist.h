@@ -0,0 +1,174 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include "soloud.h"
+#include "soloud_wavstream.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// One opened playlist item. Created and pre-decoded by the playlist worker,
+/// then handed to the audio thread which reads it until it ends.
+struct PlaylistSlot
+{
+    std::unique_ptr<SoLoud::WavStream> source;
+    std::unique_ptr<SoLoud::AudioSourceInstance> instance;
+    /// index of the item in the playlist
+    unsigned int itemIndex;
+    unsigned int channels;
+    /// item frames per output frame
+    double step;
+    unsigned int totalFrames;
+    /// frames decoded before the start of [chunk]
+    unsigned int chunkStartFrame;
+
+    /// de-interleaved decoded frames. Frame 0 of each channel holds the
+    /// last frame of the previous chunk, used to interpolate across chunks.
+    float chunk[MAX_CHANNELS * (SAMPLE_GRANULARITY + 1)];
+    unsigned int chunkFrames;
+    /// read position inside [chunk]
+    double pos;
+
+    /// chunks decoded by the worker before the item starts to play
+    std::vector<float> preroll;
+    std::vector<unsigned int> prerollFrames;
+    unsigned int prerollRead;
+    float decoded[MAX_CHANNELS * SAMPLE_GRANULARITY];
+    /// set when the last chunk has been decoded
+    bool ended;
+
+    /// used to chain the retired slots waiting to be deleted by the worker
+    PlaylistSlot *nextRetired;
+
+    PlaylistSlot();
+
+    /// @brief decode the next chunk from the pre-decoded data or from the stream
+    bool refill();
+
+    /// @brief resample up to [aFrames] frames into [aOut]. Output channels
+    /// exceeding the item channels repeat the last item channel.
+    /// @return the frames written. Less than [aFrames] when the item ended.
+    unsigned int read(float *aOut, unsigned int aFrames, unsigned int aStride, unsigned int aChannels);
+
+    /// @brief output frames still to be read.
+    double remainingFrames() const;
+};
+
+struct PlaylistWorker;
+
+/// Items and settings of a playlist, shared with the worker thread.
+struct PlaylistState
+{
+    std::mutex mutex;
+    std::vector<std::string> items;
+    /// incremented by [Playlist::clear], under [mutex]
+    unsigned int generation;
+    /// the worker of the playing instance, under [mutex]
+    std::weak_ptr<PlaylistWorker> worker;
+    std::atomic<bool> loop;
+    /// crossfade length in seconds. 0 means gapless splice
+    std::atomic<float> crossfade;
+    /// seconds decoded in advance for the next item
+    std::atomic<float> preroll;
+    /// index of the item currently playing, -1 if none
+    std::atomic<int> currentIndex;
+    /// number of items which failed to open
+    std::atomic<unsigned int> failedItems;
+    /// incremented to request jumping to the next item
+    std::atomic<unsigned int> skipRequests;
+
+    PlaylistState();
+};
+
+/// Worker which opens and pre-decodes the next item. Shared between the
+/// instance and its thread so that the audio thread never waits for it.
+struct PlaylistWorker
+{
+    std::shared_ptr<PlaylistState> state;
+    float samplerate;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> quit;
+    /// set when there is no item left to prepare
+    std::atomic<bool> exhausted;
+    /// slot ready to be played, produced by the worker
+    std::atomic<PlaylistSlot *> next;
+    /// slots finished by the audio thread, deleted by the worker
+    std::atomic<PlaylistSlot *> retired;
+    /// next item index to open, under the state mutex
+    unsigned int prepareIndex;
+
+    PlaylistWorker(std::shared_ptr<PlaylistState> aState, float aSamplerate);
+    ~PlaylistWorker();
+    void run();
+    PlaylistSlot *open(unsigned int aIndex, const std::string &aCompleteFileName);
+    /// @brief hand a finished slot back to the worker. Lock-free, called
+    /// by the audio thread.
+    void retire(PlaylistSlot *aSlot);
+};
+
+class Playlist;
+
+class PlaylistInstance : public SoLoud::AudioSourceInstance
+{
+    std::shared_ptr<PlaylistWorker> mWorker;
+    std::shared_ptr<PlaylistState> mState;
+    PlaylistSlot *mCurrent;
+    /// slot fading in while [mCurrent] fades out
+    PlaylistSlot *mIncoming;
+    double mFadeLength;
+    double mFadePos;
+    unsigned int mSkipRequests;
+    bool mPlayedAny;
+    bool mEnded;
+    float mScratch[2][MAX_CHANNELS * SAMPLE_GRANULARITY];
+
+public:
+    PlaylistInstance(Playlist *aParent);
+    virtual ~PlaylistInstance();
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual SoLoud::result seek(SoLoud::time aSeconds, float *mScratch, unsigned int mScratchSize);
+    virtual bool hasEnded();
+
+private:
+    void setCurrent(PlaylistSlot *aSlot);
+    void startFade(PlaylistSlot *aIncoming, double aLength);
+    void promoteIncoming();
+};
+
+/// An audio source which plays a list of files back to back without gaps.
+///
+/// While an item plays, a worker thread opens the next one and decodes
+/// its beginning, so the transition doesn't cost any work on the calling
+/// thread and only a splice (or an equal-power crossfade) in the audio thread.
+/// Items with a different sample rate are resampled to the playlist one.
+/// Only one instance of this source can be played at a time.
+class Playlist : public SoLoud::AudioSource
+{
+public:
+    Playlist(float aSamplerate, unsigned int aChannels);
+    virtual ~Playlist();
+
+    /// @return the index of the new item.
+    unsigned int addItem(const std::string &aCompleteFileName);
+    /// @brief remove all the items. The item playing goes on to its end,
+    /// the next one already opened is dropped and the items added
+    /// afterwards play from the first one.
+    void clear();
+    unsigned int getItemCount();
+    void setCrossfade(float aSeconds);
+    void setLoop(bool aLoop);
+    void skip();
+    int getCurrentIndex() const;
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+public:
+    std::shared_ptr<PlaylistState> mState;
+};
+
+#endif // PLAYLIST_H
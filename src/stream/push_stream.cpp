@@ -0,0 +1,211 @@
+#include "push_stream.h"
+
+#include <string.h>
+
+PushStreamInstance::PushStreamInstance(PushStream *aParent)
+{
+    mParent = aParent;
+    mBuffering = aParent->mPrebufferFrames.load() > 0;
+    mStarved = false;
+}
+
+unsigned int PushStreamInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+    const unsigned int readFrame = mParent->mReadFrame.load(std::memory_order_relaxed);
+    const unsigned int available = mParent->mWriteFrame.load(std::memory_order_acquire) - readFrame;
+    const bool endOfStream = mParent->mEndOfStream.load(std::memory_order_acquire);
+
+    if (mBuffering)
+    {
+        if (available < mParent->mPrebufferFrames.load(std::memory_order_relaxed) && !endOfStream)
+        {
+            for (unsigned int ch = 0; ch < mChannels; ch++)
+                memset(aBuffer + ch * aBufferSize, 0, sizeof(float) * aSamplesToRead);
+            return aSamplesToRead;
+        }
+        mBuffering = false;
+    }
+
+    const unsigned int frames = available < aSamplesToRead ? available : aSamplesToRead;
+    const unsigned int mask = mParent->mCapacityFrames - 1;
+    const unsigned int channels = mChannels;
+
+    // The ring may wrap, so copy at most two spans de-interleaving them.
+    unsigned int done = 0;
+    while (done < frames)
+    {
+        const unsigned int ringPos = (readFrame + done) & mask;
+        unsigned int span = mParent->mCapacityFrames - ringPos;
+        if (span > frames - done)
+            span = frames - done;
+
+        if (mParent->mFormat == PCM_F32LE)
+        {
+            const float *src = reinterpret_cast<const float *>(mParent->mRing.data()) + ringPos * channels;
+            for (unsigned int ch = 0; ch < channels; ch++)
+            {
+                float *dst = aBuffer + ch * aBufferSize + done;
+                for (unsigned int i = 0; i < span; i++)
+                    dst[i] = src[i * channels + ch];
+            }
+        }
+        else
+        {
+            const short *src = reinterpret_cast<const short *>(mParent->mRing.data()) + ringPos * channels;
+            for (unsigned int ch = 0; ch < channels; ch++)
+            {
+                float *dst = aBuffer + ch * aBufferSize + done;
+                for (unsigned int i = 0; i < span; i++)
+                    dst[i] = src[i * channels + ch] * (1.0f / 32768.0f);
+            }
+        }
+        done += span;
+    }
+    mParent->mReadFrame.store(readFrame + frames, std::memory_order_release);
+
+    if (frames < aSamplesToRead)
+    {
+        for (unsigned int ch = 0; ch < channels; ch++)
+            memset(aBuffer + ch * aBufferSize + frames, 0, sizeof(float) * (aSamplesToRead - frames));
+
+        if (!endOfStream)
+        {
+            if (!mStarved)
+                mParent->mUnderrunCount.fetch_add(1, std::memory_order_relaxed);
+            mStarved = true;
+            mParent->mSilentFrames.fetch_add(aSamplesToRead - frames, std::memory_order_relaxed);
+            // refill the jitter buffer before starting again
+            mBuffering = mParent->mPrebufferFrames.load(std::memory_order_relaxed) > 0;
+        }
+    }
+    else
+    {
+        mStarved = false;
+    }
+
+    return aSamplesToRead;
+}
+
+SoLoud::result PushStreamInstance::seek(SoLoud::time aSeconds, float *mScratch, unsigned int mScratchSize)
+{
+    // Pushed data is consumed once: there is nothing to seek into.
+    return SoLoud::NOT_IMPLEMENTED;
+}
+
+bool PushStreamInstance::hasEnded()
+{
+    return mParent->mEndOfStream.load(std::memory_order_acquire) &&
+           mParent->getBufferedFrames() == 0;
+}
+
+PushStream::PushStream(
+    float aSamplerate,
+    unsigned int aChannels,
+    PushStreamFormat aFormat,
+    unsigned int aCapacityFrames,
+    unsigned int aPrebufferFrames)
+    : mWriteFrame(0),
+      mReadFrame(0),
+      mPrebufferFrames(0),
+      mEndOfStream(false),
+      mUnderrunCount(0),
+      mSilentFrames(0)
+{
+    mBaseSamplerate = aSamplerate;
+    mChannels = aChannels;
+    mFormat = aFormat;
+    mBytesPerFrame = aChannels * (aFormat == PCM_F32LE ? sizeof(float) : sizeof(short));
+
+    // A power of 2 capacity lets the free running counters wrap without a modulo.
+    mCapacityFrames = 1;
+    while (mCapacityFrames < aCapacityFrames && mCapacityFrames < 0x40000000)
+        mCapacityFrames <<= 1;
+    mRing.resize((size_t)mCapacityFrames * mBytesPerFrame);
+    setPrebufferFrames(aPrebufferFrames);
+
+    // The ring has only one consumer.
+    setSingleInstance(true);
+}
+
+PushStream::~PushStream()
+{
+    stop();
+}
+
+unsigned int PushStream::getWriteSpan(void **aData)
+{
+    const unsigned int writeFrame = mWriteFrame.load(std::memory_order_relaxed);
+    const unsigned int free = mCapacityFrames -
+                              (writeFrame - mReadFrame.load(std::memory_order_acquire));
+    const unsigned int ringPos = writeFrame & (mCapacityFrames - 1);
+    const unsigned int span = mCapacityFrames - ringPos;
+
+    *aData = mRing.data() + (size_t)ringPos * mBytesPerFrame;
+    return free < span ? free : span;
+}
+
+unsigned int PushStream::commit(unsigned int aFrames)
+{
+    const unsigned int writeFrame = mWriteFrame.load(std::memory_order_relaxed);
+    const unsigned int free = mCapacityFrames -
+                              (writeFrame - mReadFrame.load(std::memory_order_acquire));
+    if (aFrames > free)
+        aFrames = free;
+    mWriteFrame.store(writeFrame + aFrames, std::memory_order_release);
+    return aFrames;
+}
+
+unsigned int PushStream::write(const void *aData, unsigned int aFrames)
+{
+    const unsigned char *src = static_cast<const unsigned char *>(aData);
+    unsigned int written = 0;
+    // at most two spans when the ring wraps
+    for (int n = 0; n < 2 && written < aFrames; n++)
+    {
+        void *dst;
+        unsigned int span = getWriteSpan(&dst);
+        if (span == 0)
+            break;
+        if (span > aFrames - written)
+            span = aFrames - written;
+        memcpy(dst, src + (size_t)written * mBytesPerFrame, (size_t)span * mBytesPerFrame);
+        written += commit(span);
+    }
+    return written;
+}
+
+void PushStream::endOfStream()
+{
+    mEndOfStream.store(true, std::memory_order_release);
+}
+
+void PushStream::setPrebufferFrames(unsigned int aFrames)
+{
+    mPrebufferFrames.store(aFrames < mCapacityFrames ? aFrames : mCapacityFrames);
+}
+
+unsigned int PushStream::getBufferedFrames() const
+{
+    return mWriteFrame.load(std::memory_order_acquire) -
+           mReadFrame.load(std::memory_order_acquire);
+}
+
+unsigned int PushStream::getCapacityFrames() const
+{
+    return mCapacityFrames;
+}
+
+unsigned int PushStream::getUnderrunCount() const
+{
+    return mUnderrunCount.load(std::memory_order_relaxed);
+}
+
+unsigned int PushStream::getSilentFrames() const
+{
+    return mSilentFrames.load(std::memory_order_relaxed);
+}
+
+SoLoud::AudioSourceInstance *PushStream::createInstance()
+{
+    return new PushStreamInstance(this);
+}
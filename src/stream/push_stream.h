@@ -0,0 +1,100 @@
+#ifndef PUSH_STREAM_H
+#define PUSH_STREAM_H
+
+#include "soloud.h"
+
+#include <atomic>
+#include <vector>
+
+/// Sample formats accepted by [PushStream]
+typedef enum PushStreamFormat
+{
+    PCM_F32LE,
+    PCM_S16LE
+} PushStreamFormat_t;
+
+class PushStream;
+
+class PushStreamInstance : public SoLoud::AudioSourceInstance
+{
+    PushStream *mParent;
+    /// true while waiting for the jitter buffer to be filled
+    bool mBuffering;
+    /// true while the ring is empty and we are outputting silence
+    bool mStarved;
+
+public:
+    PushStreamInstance(PushStream *aParent);
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual SoLoud::result seek(SoLoud::time aSeconds, float *mScratch, unsigned int mScratchSize);
+    virtual bool hasEnded();
+};
+
+/// An audio source fed with PCM data pushed by the caller.
+///
+/// The data is stored in a single-producer single-consumer ring buffer
+/// allocated once at creation time: the producer is the thread which
+/// writes new data, the consumer is the audio thread. Writes never allocate
+/// and never lock the audio mutex.
+/// Only one instance of this source can be played at a time.
+class PushStream : public SoLoud::AudioSource
+{
+public:
+    /// @param aSamplerate sample rate of the pushed data.
+    /// @param aChannels number of interleaved channels of the pushed data.
+    /// @param aFormat format of the pushed samples.
+    /// @param aCapacityFrames ring size in frames. Rounded up to a power of 2.
+    /// @param aPrebufferFrames frames to accumulate before starting
+    /// (or restarting after an underrun) the playback.
+    PushStream(
+        float aSamplerate,
+        unsigned int aChannels,
+        PushStreamFormat aFormat,
+        unsigned int aCapacityFrames,
+        unsigned int aPrebufferFrames);
+    virtual ~PushStream();
+
+    /// @brief Get the first contiguous writable region of the ring.
+    /// Write up to [aFrames] interleaved frames there and then call [commit].
+    /// @param aData returns the pointer to write to.
+    /// @return the number of frames which can be written at [aData].
+    unsigned int getWriteSpan(void **aData);
+
+    /// @brief Make [aFrames] frames written into the span available to the player.
+    /// @return the number of frames committed.
+    unsigned int commit(unsigned int aFrames);
+
+    /// @brief Copy [aFrames] interleaved frames into the ring.
+    /// @return the number of frames written, less than [aFrames] if the ring is full.
+    unsigned int write(const void *aData, unsigned int aFrames);
+
+    /// @brief Signal that no more data will be pushed. The sound ends
+    /// when all the buffered data has been played.
+    void endOfStream();
+
+    void setPrebufferFrames(unsigned int aFrames);
+
+    unsigned int getBufferedFrames() const;
+    unsigned int getCapacityFrames() const;
+    unsigned int getUnderrunCount() const;
+    unsigned int getSilentFrames() const;
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+public:
+    PushStreamFormat mFormat;
+    unsigned int mBytesPerFrame;
+    unsigned int mCapacityFrames;
+    /// raw ring storage in [mFormat], interleaved
+    std::vector<unsigned char> mRing;
+    /// free running frame counters. The producer owns [mWriteFrame],
+    /// the consumer owns [mReadFrame]
+    std::atomic<unsigned int> mWriteFrame;
+    std::atomic<unsigned int> mReadFrame;
+    std::atomic<unsigned int> mPrebufferFrames;
+    std::atomic<bool> mEndOfStream;
+    std::atomic<unsigned int> mUnderrunCount;
+    std::atomic<unsigned int> mSilentFrames;
+};
+
+#endif // PUSH_STREAM_H
@@ -0,0 +1,215 @@
+#include "speech_stream.h"
+
+#include <cctype>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    const size_t kMaxPhraseLength = 80;
+
+    bool isPhraseEnd(char c)
+    {
+        return c == '.' || c == '!' || c == '?' || c == ';' || c == ':' ||
+               c == ',' || c == '\n';
+    }
+
+    bool isBlank(const std::string &s)
+    {
+        for (char c : s)
+            if (!isspace((unsigned char)c))
+                return false;
+        return true;
+    }
+}
+
+SpeechParams::SpeechParams()
+    : baseFrequency(1330),
+      baseSpeed(10.0f),
+      baseDeclination(0.5f),
+      baseWaveform(KW_SQUARE),
+      sampleRate(11025)
+{
+}
+
+/////////////////////////////////////////
+/// SpeechUtterance
+/////////////////////////////////////////
+
+SpeechUtterance::SpeechUtterance(const std::string &text)
+    : converted(0),
+      cancelled(false)
+{
+    std::string phrase;
+    for (char c : text)
+    {
+        if (phrase.empty() && isspace((unsigned char)c))
+            continue;
+        phrase += c;
+        if (isPhraseEnd(c) || (phrase.size() >= kMaxPhraseLength && c == ' '))
+        {
+            if (!isBlank(phrase))
+                phrases.push_back(phrase);
+            phrase.clear();
+        }
+    }
+    if (!isBlank(phrase))
+        phrases.push_back(phrase);
+    elements.resize(phrases.size());
+}
+
+void SpeechUtterance::convert()
+{
+    for (unsigned int i = converted.load(); i < phrases.size(); i++)
+    {
+        if (cancelled.load())
+            return;
+        darray phone;
+        darray element;
+        xlate_string(phrases[i].c_str(), &phone);
+        klatt::phone_to_elm(phone.getData(), phone.getSize(), &element);
+        elements[i].assign((unsigned char *)element.getData(),
+                           (unsigned char *)element.getData() + element.getSize());
+        converted.store(i + 1);
+    }
+}
+
+/////////////////////////////////////////
+/// SpeechStreamInstance
+/////////////////////////////////////////
+
+SpeechStreamInstance::SpeechStreamInstance(SpeechStream *aParent)
+    : mUtterance(aParent->mUtterance),
+      mParams(aParent->mParams),
+      mSampleCount(0),
+      mOffset(0),
+      mPhrase(-1),
+      mEnded(false)
+{
+    mSynth.init(mParams.baseFrequency, mParams.baseSpeed, mParams.baseDeclination, mParams.baseWaveform, mParams.sampleRate);
+    mSample = new short[mSynth.mNspFr * 100];
+}
+
+SpeechStreamInstance::~SpeechStreamInstance()
+{
+    delete[] mSample;
+}
+
+bool SpeechStreamInstance::nextPhrase()
+{
+    const unsigned int converted = mUtterance->converted.load();
+    while (mPhrase + 1 < (int)converted)
+    {
+        mPhrase++;
+        std::vector<unsigned char> &elements = mUtterance->elements[mPhrase];
+        if (elements.empty())
+            continue;
+        mSynth.initsynth((int)elements.size(), elements.data());
+        return true;
+    }
+    if (converted == mUtterance->phrases.size())
+        mEnded = true;
+    return false;
+}
+
+unsigned int SpeechStreamInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int /*aBufferSize*/)
+{
+    unsigned int written = 0;
+    while (written < aSamplesToRead && !mEnded)
+    {
+        if (mOffset < mSampleCount)
+        {
+            unsigned int n = mSampleCount - mOffset;
+            if (n > aSamplesToRead - written)
+                n = aSamplesToRead - written;
+            for (unsigned int i = 0; i < n; i++)
+                aBuffer[written + i] = mSample[mOffset + i] * (1 / (float)0x8000);
+            mOffset += n;
+            written += n;
+            continue;
+        }
+
+        mOffset = 0;
+        mSampleCount = mPhrase < 0 ? -1 : mSynth.synth(mSynth.mNspFr, mSample);
+        if (mSampleCount < 0)
+        {
+            mSampleCount = 0;
+            if (!nextPhrase())
+                break;
+        }
+    }
+
+    // the next phrase is not converted yet
+    if (!mEnded && written < aSamplesToRead)
+    {
+        memset(aBuffer + written, 0, (aSamplesToRead - written) * sizeof(float));
+        written = aSamplesToRead;
+    }
+    return written;
+}
+
+SoLoud::result SpeechStreamInstance::rewind()
+{
+    mSynth.init(mParams.baseFrequency, mParams.baseSpeed, mParams.baseDeclination, mParams.baseWaveform, mParams.sampleRate);
+    mSampleCount = 0;
+    mOffset = 0;
+    mPhrase = -1;
+    mEnded = false;
+    mStreamPosition = 0.0f;
+    return SoLoud::SO_NO_ERROR;
+}
+
+bool SpeechStreamInstance::hasEnded()
+{
+    return mEnded && mOffset >= mSampleCount;
+}
+
+/////////////////////////////////////////
+/// SpeechStream
+/////////////////////////////////////////
+
+SpeechStream::SpeechStream(const std::string &text, const SpeechParams &params)
+    : mUtterance(std::make_shared<SpeechUtterance>(text)),
+      mParams(params)
+{
+    mBaseSamplerate = (float)params.sampleRate;
+    mChannels = 1;
+}
+
+SpeechStream::~SpeechStream()
+{
+    mUtterance->cancelled.store(true);
+    stop();
+}
+
+void SpeechStream::speak()
+{
+    // the thread keeps the utterance alive until it is done
+    std::shared_ptr<SpeechUtterance> utterance = mUtterance;
+    std::thread([utterance]()
+                { utterance->convert(); })
+        .detach();
+}
+
+std::vector<float> SpeechStream::render()
+{
+    mUtterance->convert();
+
+    std::vector<float> samples;
+    std::unique_ptr<SoLoud::AudioSourceInstance> instance(createInstance());
+    instance->init(*this, 0);
+    float block[SAMPLE_GRANULARITY];
+    while (!instance->hasEnded())
+    {
+        const unsigned int n = instance->getAudio(block, SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
+        samples.insert(samples.end(), block, block + n);
+        if (n == 0)
+            break;
+    }
+    return samples;
+}
+
+SoLoud::AudioSourceInstance *SpeechStream::createInstance()
+{
+    return new SpeechStreamInstance(this);
+}
@@ -0,0 +1,102 @@
+#ifndef SPEECH_STREAM_H
+#define SPEECH_STREAM_H
+
+#include "soloud.h"
+#include "soloud_speech.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Voice of the speech synthesizer, see [SoLoud::Speech::setParams].
+struct SpeechParams
+{
+    unsigned int baseFrequency;
+    float baseSpeed;
+    float baseDeclination;
+    int baseWaveform;
+    /// rate the voice is synthesized at: 11025 Hz like [SoLoud::Speech],
+    /// or the rate of the engine to skip the resampling
+    unsigned int sampleRate;
+
+    SpeechParams();
+};
+
+/// The text of an utterance cut in phrases, and the Klatt elements of the
+/// phrases converted so far. Shared between the source, its instances and
+/// the conversion thread.
+struct SpeechUtterance
+{
+    std::vector<std::string> phrases;
+    /// elements of each phrase, written by the conversion thread before
+    /// [converted] counts it
+    std::vector<std::vector<unsigned char>> elements;
+    /// number of phrases whose [elements] can be read
+    std::atomic<unsigned int> converted;
+    /// set when the source is deleted, the conversion stops
+    std::atomic<bool> cancelled;
+
+    /// @brief cut [text] after the punctuation and the line breaks, and
+    /// at a space when a phrase gets longer than 80 characters.
+    explicit SpeechUtterance(const std::string &text);
+
+    /// @brief convert the phrases to elements in order, until all are done
+    /// or the utterance is cancelled.
+    void convert();
+};
+
+class SpeechStream;
+
+class SpeechStreamInstance : public SoLoud::AudioSourceInstance
+{
+public:
+    SpeechStreamInstance(SpeechStream *aParent);
+    virtual ~SpeechStreamInstance();
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual SoLoud::result rewind();
+    virtual bool hasEnded();
+
+private:
+    /// @brief start the next phrase if it is converted.
+    /// @return false if it is not.
+    bool nextPhrase();
+
+    std::shared_ptr<SpeechUtterance> mUtterance;
+    SpeechParams mParams;
+    klatt mSynth;
+    short *mSample;
+    int mSampleCount;
+    int mOffset;
+    /// phrase being synthesized, -1 before the first one
+    int mPhrase;
+    bool mEnded;
+};
+
+/// One utterance of the speech synthesizer.
+///
+/// Unlike [SoLoud::Speech], every utterance is its own source, so they can
+/// overlap. The text is converted to phonemes and elements phrase by phrase
+/// on a thread started by [speak], and the voice synthesizes each phrase as
+/// soon as it is converted: the first phrase plays while the next ones are
+/// being converted. Voices waiting for a phrase output silence.
+class SpeechStream : public SoLoud::AudioSource
+{
+public:
+    SpeechStream(const std::string &text, const SpeechParams &params);
+    virtual ~SpeechStream();
+
+    /// @brief start converting the text on a new thread.
+    void speak();
+
+    /// @brief convert and synthesize the whole utterance on the calling
+    /// thread, mono at [mBaseSamplerate]. Not to be used after [speak].
+    std::vector<float> render();
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+    std::shared_ptr<SpeechUtterance> mUtterance;
+    SpeechParams mParams;
+};
+
+#endif // SPEECH_STREAM_H
@@ -23,49 +23,48 @@ freely, subject to the following restrictions:
 */
 
 #include "basic_wave.h"
-#include "soloud_misc.h"
 
 BasicwaveInstance::BasicwaveInstance(Basicwave *aParent)
 {
     mParent = aParent;
-    mOffset = 0;
+    for (int i = 0; i < 4; i++)
+        mPhase[i] = 0;
     mT = 0;
 }
 
 unsigned int BasicwaveInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
 {
-    unsigned int i;
-    float d = 1.0f / mSamplerate;
+    const Wavetable *wavetable = mParent->mWavetable;
+    const float freq = mParent->mFreq;
+
     if (!mParent->mSuperwave)
     {
-        for (i = 0; i < aSamplesToRead; i++)
-        {
-            aBuffer[i] = SoLoud::Misc::generateWaveform(
-                             mParent->mWaveform,
-                             (float)fmod(mParent->mFreq * (float)mOffset, 1.0f)) *
-                         mParent->mADSR.val(mT, 10000000000000.0f);
-            mOffset++;
-            mT += d;
-        }
+        mPhase[0] = Wavetable::render(wavetable->getLevel(freq), mPhase[0], freq, aBuffer, aSamplesToRead);
     }
     else
     {
-        for (i = 0; i < aSamplesToRead; i++)
+        // the partials are 1, 2, 3 octaves up, detuned, in the other lanes
+        float steps[4];
+        const float *tables[4];
+        const float gains[4] = {1.0f, mParent->mSuperwaveScale, mParent->mSuperwaveScale, mParent->mSuperwaveScale};
+        float f = freq;
+        steps[0] = freq;
+        for (int j = 1; j < 4; j++)
         {
-            aBuffer[i] = SoLoud::Misc::generateWaveform(
-                             mParent->mWaveform, (float)fmod(mParent->mFreq * (float)mOffset, 1.0f)) *
-                         mParent->mADSR.val(mT, 10000000000000.0f);
-            float f = mParent->mFreq * (float)mOffset;
-            for (int j = 0; j < 3; j++)
-            {
-                f *= 2;
-                aBuffer[i] += SoLoud::Misc::generateWaveform(
-                                  mParent->mWaveform, (float)fmod(mParent->mSuperwaveDetune * f, 1.0f)) *
-                              mParent->mADSR.val(mT, 10000000000000.0f) * mParent->mSuperwaveScale;
-            }
-            mOffset++;
-            mT += d;
+            f *= 2;
+            steps[j] = mParent->mSuperwaveDetune * f;
         }
+        for (int j = 0; j < 4; j++)
+            tables[j] = wavetable->getLevel(steps[j]);
+        Wavetable::render4(tables, mPhase, steps, gains, aBuffer, aSamplesToRead);
+    }
+
+    // the envelope never releases, it is evaluated per sample not to step
+    const float dt = 1.0f / mSamplerate;
+    for (unsigned int i = 0; i < aSamplesToRead; i++)
+    {
+        aBuffer[i] *= mParent->mADSR.val(mT, 10000000000000.0f);
+        mT += dt;
     }
     return aSamplesToRead;
 }
@@ -122,6 +121,7 @@ void Basicwave::setSuperWave(bool aSuperwave)
 
 void Basicwave::setWaveform(int aWaveform)
 {
+    mWavetable = Wavetable::get(aWaveform);
     mWaveform = aWaveform;
 }
 
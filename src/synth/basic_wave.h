@@ -27,13 +27,15 @@ freely, subject to the following restrictions:
 
 #include "soloud.h"
 #include "soloud_adsr.h"
+#include "wavetable.h"
 
 class Basicwave;
 
 class BasicwaveInstance : public SoLoud::AudioSourceInstance
 {
 	Basicwave *mParent;
-	int mOffset;
+	// phases of the oscillator and of the 3 superwave partials
+	float mPhase[4];
 	float mT;
 
 public:
@@ -46,6 +48,8 @@ class Basicwave : public SoLoud::AudioSource
 {
 public:
 	ADSR mADSR;
+	// band-limited tables of mWaveform
+	const Wavetable *mWavetable;
 	float mFreq;
 	float mSuperwaveScale;
 	float mSuperwaveDetune;
@@ -0,0 +1,501 @@
+#include "fm_synth.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const unsigned int kSineSize = 4096;
+
+    /// one cycle of sine, plus two samples for the interpolation
+    const float *sineTable()
+    {
+        static const float *table = []()
+        {
+            float *t = new float[kSineSize + 2];
+            for (unsigned int i = 0; i < kSineSize + 2; i++)
+                t[i] = (float)sin(2.0 * M_PI * i / kSineSize);
+            return t;
+        }();
+        return table;
+    }
+
+    /// index of the lowest bit set in [mask], which is not 0
+    inline unsigned int lowestBit(unsigned int mask)
+    {
+        unsigned int bit = 0;
+        while (!(mask & (1u << bit)))
+            bit++;
+        return bit;
+    }
+
+    struct FmAlgorithm
+    {
+        unsigned int modulators[FM_MAX_OPERATORS];
+        unsigned int carriers;
+    };
+
+    // "3 > 2" means operator 3 modulates operator 2
+    const FmAlgorithm kAlgorithms4[FM_ALGORITHMS] = {
+        // 3 > 2 > 1 > 0
+        {{1 << 1, 1 << 2, 1 << 3, 0}, 1},
+        // 3 + 2 > 1 > 0
+        {{1 << 1, (1 << 3) | (1 << 2), 0, 0}, 1},
+        // 3 + (2 > 1) > 0
+        {{(1 << 3) | (1 << 1), 1 << 2, 0, 0}, 1},
+        // (3 > 2) + 1 > 0
+        {{(1 << 2) | (1 << 1), 0, 1 << 3, 0}, 1},
+        // 3 > 2, 1 > 0
+        {{1 << 1, 0, 1 << 3, 0}, (1 << 2) | 1},
+        // 3 > (2 + 1 + 0)
+        {{1 << 3, 1 << 3, 1 << 3, 0}, (1 << 2) | (1 << 1) | 1},
+        // 3 > 2, 1, 0
+        {{0, 0, 1 << 3, 0}, (1 << 2) | (1 << 1) | 1},
+        // all carriers
+        {{0, 0, 0, 0}, 0xf},
+    };
+
+    const FmAlgorithm kAlgorithms6[FM_ALGORITHMS] = {
+        // 5 > 4 > 3 > 2 > 1 > 0
+        {{1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 0}, 1},
+        // 5 > 4 > 3 > 2, 1 > 0
+        {{1 << 1, 0, 1 << 3, 1 << 4, 1 << 5, 0}, (1 << 2) | 1},
+        // 5 > 4 > 3, 2 > 1 > 0
+        {{1 << 1, 1 << 2, 0, 1 << 4, 1 << 5, 0}, (1 << 3) | 1},
+        // 5 > 4, 3 > 2, 1 > 0
+        {{1 << 1, 0, 1 << 3, 0, 1 << 5, 0}, (1 << 4) | (1 << 2) | 1},
+        // 5 > (4 + 3 + 2 + 1 + 0)
+        {{1 << 5, 1 << 5, 1 << 5, 1 << 5, 1 << 5, 0}, 0x1f},
+        // 5 + 4 + 3 + 2 + 1 > 0
+        {{0x3e, 0, 0, 0, 0, 0}, 1},
+        // 5 > 4, 3 > 2, 1, 0
+        {{0, 0, 1 << 3, 0, 1 << 5, 0}, (1 << 4) | (1 << 2) | (1 << 1) | 1},
+        // all carriers
+        {{0, 0, 0, 0, 0, 0}, 0x3f},
+    };
+}
+
+FmSynthInstance::FmSynthInstance(FmSynth *aParent)
+    : PolySynthInstance(aParent)
+{
+    mFm = aParent;
+    memset(mEnvelopes, 0, sizeof(mEnvelopes));
+    memset(mPhases, 0, sizeof(mPhases));
+    memset(mFeedback, 0, sizeof(mFeedback));
+}
+
+void FmSynthInstance::startVoice(PolySynthVoice &voice, bool wasIdle)
+{
+    const unsigned int v = (unsigned int)(&voice - mVoices);
+    for (unsigned int op = 0; op < mFm->mOperators; op++)
+    {
+        FmEnvelope &envelope = mEnvelopes[v][op];
+        // a stolen voice attacks from the level it reached
+        if (wasIdle)
+        {
+            envelope.level = 0.0f;
+            mPhases[v][op] = 0.0f;
+            mFeedback[v][op][0] = mFeedback[v][op][1] = 0.0f;
+        }
+        envelope.stage = POLY_STAGE_ATTACK;
+    }
+}
+
+void FmSynthInstance::release(PolySynthVoice &voice)
+{
+    const unsigned int v = (unsigned int)(&voice - mVoices);
+    voice.stage = POLY_STAGE_RELEASE;
+    for (unsigned int op = 0; op < mFm->mOperators; op++)
+    {
+        FmEnvelope &envelope = mEnvelopes[v][op];
+        if (envelope.stage == POLY_STAGE_IDLE)
+            continue;
+        const float release = mFm->mOpRelease[op].load(std::memory_order_relaxed);
+        envelope.stage = POLY_STAGE_RELEASE;
+        envelope.releaseStep = release > 0.0f ? envelope.level / (release * mSamplerate) : envelope.level;
+        if (envelope.releaseStep <= 0.0f)
+        {
+            envelope.level = 0.0f;
+            envelope.stage = POLY_STAGE_IDLE;
+        }
+    }
+}
+
+float FmSynthInstance::advanceEnvelope(FmEnvelope &envelope, unsigned int op, unsigned int aSamples)
+{
+    const float sustain = mFm->mOpSustain[op].load(std::memory_order_relaxed);
+    float remaining = (float)aSamples;
+    while (remaining > 0.0f)
+    {
+        switch (envelope.stage)
+        {
+        case POLY_STAGE_ATTACK:
+        {
+            const float attack = mFm->mOpAttack[op].load(std::memory_order_relaxed);
+            const float step = attack > 0.0f ? 1.0f / (attack * mSamplerate) : 1.0f;
+            const float need = (1.0f - envelope.level) / step;
+            if (need > remaining)
+            {
+                envelope.level += step * remaining;
+                remaining = 0.0f;
+            }
+            else
+            {
+                envelope.level = 1.0f;
+                envelope.stage = POLY_STAGE_DECAY;
+                remaining -= need;
+            }
+            break;
+        }
+        case POLY_STAGE_DECAY:
+        {
+            const float decay = mFm->mOpDecay[op].load(std::memory_order_relaxed);
+            const float step = decay > 0.0f ? (1.0f - sustain) / (decay * mSamplerate) : 1.0f;
+            const float need = step > 0.0f ? (envelope.level - sustain) / step : 0.0f;
+            if (need > remaining)
+            {
+                envelope.level -= step * remaining;
+                remaining = 0.0f;
+            }
+            else
+            {
+                envelope.level = sustain;
+                envelope.stage = POLY_STAGE_SUSTAIN;
+                remaining -= need > 0.0f ? need : 0.0f;
+            }
+            break;
+        }
+        case POLY_STAGE_SUSTAIN:
+            envelope.level = sustain;
+            remaining = 0.0f;
+            break;
+        case POLY_STAGE_RELEASE:
+        {
+            const float need = envelope.level / envelope.releaseStep;
+            if (need > remaining)
+            {
+                envelope.level -= envelope.releaseStep * remaining;
+                remaining = 0.0f;
+            }
+            else
+            {
+                envelope.level = 0.0f;
+                envelope.stage = POLY_STAGE_IDLE;
+                remaining = 0.0f;
+            }
+            break;
+        }
+        case POLY_STAGE_IDLE:
+            envelope.level = 0.0f;
+            remaining = 0.0f;
+            break;
+        }
+    }
+    return envelope.level;
+}
+
+void FmSynthInstance::renderLanes(unsigned int firstVoice, float *aBuffer, unsigned int aSamples)
+{
+    const unsigned int operators = mFm->mOperators;
+    const unsigned int carriers = mFm->mCarriers.load(std::memory_order_relaxed);
+    unsigned int modulators[FM_MAX_OPERATORS];
+    float level[FM_MAX_OPERATORS];
+    float feedback[FM_MAX_OPERATORS];
+    for (unsigned int op = 0; op < operators; op++)
+    {
+        modulators[op] = mFm->mModulators[op].load(std::memory_order_relaxed);
+        level[op] = mFm->mLevel[op].load(std::memory_order_relaxed);
+        // the feedback is the mean of the last two outputs
+        feedback[op] = mFm->mFeedbackAmount[op].load(std::memory_order_relaxed) * 0.5f;
+    }
+
+    // control rate values, one per lane
+    alignas(16) float phase[FM_MAX_OPERATORS][FM_LANES];
+    alignas(16) float step[FM_MAX_OPERATORS][FM_LANES];
+    alignas(16) float env[FM_MAX_OPERATORS][FM_LANES];
+    alignas(16) float envStep[FM_MAX_OPERATORS][FM_LANES];
+    alignas(16) float fb[FM_MAX_OPERATORS][2][FM_LANES];
+    alignas(16) float velocity[FM_LANES];
+
+    for (unsigned int lane = 0; lane < FM_LANES; lane++)
+    {
+        const unsigned int v = firstVoice + lane;
+        PolySynthVoice *voice = v < mParent->mMaxVoices ? &mVoices[v] : nullptr;
+        const bool active = voice != nullptr && voice->stage != POLY_STAGE_IDLE;
+        float frequency = 0.0f;
+        if (active)
+        {
+            // glide at control rate
+            if (voice->glideStep > 0.0f)
+            {
+                const float change = voice->glideStep * aSamples;
+                if (fabsf(voice->targetPitch - voice->pitch) <= change)
+                {
+                    voice->pitch = voice->targetPitch;
+                    voice->glideStep = 0.0f;
+                }
+                else
+                    voice->pitch += voice->targetPitch > voice->pitch ? change : -change;
+            }
+            frequency = pitchToFrequency(voice->pitch);
+        }
+        velocity[lane] = active ? voice->velocity : 0.0f;
+
+        float carrierLevel = 0.0f;
+        bool carrierSounding = false;
+        for (unsigned int op = 0; op < operators; op++)
+        {
+            if (!active)
+            {
+                phase[op][lane] = step[op][lane] = env[op][lane] = envStep[op][lane] = 0.0f;
+                fb[op][0][lane] = fb[op][1][lane] = 0.0f;
+                continue;
+            }
+            FmEnvelope &envelope = mEnvelopes[v][op];
+            const float start = envelope.level;
+            const float end = advanceEnvelope(envelope, op, aSamples);
+            env[op][lane] = start;
+            envStep[op][lane] = (end - start) / aSamples;
+            phase[op][lane] = mPhases[v][op];
+            step[op][lane] = (frequency * mFm->mRatio[op].load(std::memory_order_relaxed) +
+                              mFm->mDetune[op].load(std::memory_order_relaxed)) /
+                             mSamplerate;
+            fb[op][0][lane] = mFeedback[v][op][0];
+            fb[op][1][lane] = mFeedback[v][op][1];
+            if (carriers & (1 << op))
+            {
+                if (start > carrierLevel)
+                    carrierLevel = start;
+                if (envelope.stage != POLY_STAGE_IDLE)
+                    carrierSounding = true;
+            }
+        }
+        if (active)
+        {
+            voice->level = carrierLevel;
+            // the voice ends with the release of its carriers
+            if (voice->stage == POLY_STAGE_RELEASE && !carrierSounding)
+                voice->stage = POLY_STAGE_IDLE;
+        }
+    }
+
+    const float *sine = sineTable();
+#ifdef SOLOUD_SSE_INTRINSICS
+    __m128 vPhase[FM_MAX_OPERATORS], vStep[FM_MAX_OPERATORS], vEnv[FM_MAX_OPERATORS];
+    __m128 vEnvStep[FM_MAX_OPERATORS], vOut[FM_MAX_OPERATORS], vFb0[FM_MAX_OPERATORS], vFb1[FM_MAX_OPERATORS];
+    for (unsigned int op = 0; op < operators; op++)
+    {
+        vPhase[op] = _mm_load_ps(phase[op]);
+        vStep[op] = _mm_load_ps(step[op]);
+        vEnv[op] = _mm_load_ps(env[op]);
+        vEnvStep[op] = _mm_load_ps(envStep[op]);
+        vFb0[op] = _mm_load_ps(fb[op][0]);
+        vFb1[op] = _mm_load_ps(fb[op][1]);
+        vOut[op] = _mm_setzero_ps();
+    }
+    const __m128 vVelocity = _mm_load_ps(velocity);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 size = _mm_set1_ps((float)kSineSize);
+    alignas(16) int index[FM_LANES];
+    alignas(16) float a[FM_LANES], b[FM_LANES];
+
+    for (unsigned int i = 0; i < aSamples; i++)
+    {
+        __m128 sum = _mm_setzero_ps();
+        for (int op = (int)operators - 1; op >= 0; op--)
+        {
+            __m128 p = vPhase[op];
+            for (unsigned int m = modulators[op]; m != 0; m &= m - 1)
+                p = _mm_add_ps(p, vOut[lowestBit(m)]);
+            if (feedback[op] != 0.0f)
+                p = _mm_add_ps(p, _mm_mul_ps(_mm_add_ps(vFb0[op], vFb1[op]), _mm_set1_ps(feedback[op])));
+            // floor, the modulation can make the phase negative
+            __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(p));
+            whole = _mm_sub_ps(whole, _mm_and_ps(_mm_cmpgt_ps(whole, p), one));
+            const __m128 pos = _mm_mul_ps(_mm_sub_ps(p, whole), size);
+            const __m128i integer = _mm_cvttps_epi32(pos);
+            const __m128 frac = _mm_sub_ps(pos, _mm_cvtepi32_ps(integer));
+            _mm_store_si128((__m128i *)index, integer);
+            for (unsigned int lane = 0; lane < FM_LANES; lane++)
+            {
+                a[lane] = sine[index[lane]];
+                b[lane] = sine[index[lane] + 1];
+            }
+            const __m128 va = _mm_load_ps(a);
+            const __m128 s = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b), va), frac));
+            const __m128 out = _mm_mul_ps(s, _mm_mul_ps(vEnv[op], _mm_set1_ps(level[op])));
+            vFb1[op] = vFb0[op];
+            vFb0[op] = out;
+            vOut[op] = out;
+            if (carriers & (1 << op))
+                sum = _mm_add_ps(sum, out);
+
+            p = _mm_add_ps(vPhase[op], vStep[op]);
+            vPhase[op] = _mm_sub_ps(p, _mm_cvtepi32_ps(_mm_cvttps_epi32(p)));
+            vEnv[op] = _mm_add_ps(vEnv[op], vEnvStep[op]);
+        }
+        sum = _mm_mul_ps(sum, vVelocity);
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        aBuffer[i] += _mm_cvtss_f32(sum);
+    }
+
+    for (unsigned int op = 0; op < operators; op++)
+    {
+        _mm_store_ps(phase[op], vPhase[op]);
+        _mm_store_ps(fb[op][0], vFb0[op]);
+        _mm_store_ps(fb[op][1], vFb1[op]);
+    }
+#else
+    float out[FM_MAX_OPERATORS][FM_LANES];
+    memset(out, 0, sizeof(out));
+    for (unsigned int i = 0; i < aSamples; i++)
+    {
+        float sum[FM_LANES] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int op = (int)operators - 1; op >= 0; op--)
+        {
+            for (unsigned int lane = 0; lane < FM_LANES; lane++)
+            {
+                float p = phase[op][lane];
+                for (unsigned int m = modulators[op]; m != 0; m &= m - 1)
+                    p += out[lowestBit(m)][lane];
+                p += (fb[op][0][lane] + fb[op][1][lane]) * feedback[op];
+                const float pos = (p - floorf(p)) * kSineSize;
+                const int index = (int)pos;
+                const float s = sine[index] + (sine[index + 1] - sine[index]) * (pos - index);
+                const float o = s * env[op][lane] * level[op];
+                fb[op][1][lane] = fb[op][0][lane];
+                fb[op][0][lane] = o;
+                out[op][lane] = o;
+                if (carriers & (1 << op))
+                    sum[lane] += o;
+
+                phase[op][lane] += step[op][lane];
+                phase[op][lane] -= floorf(phase[op][lane]);
+                env[op][lane] += envStep[op][lane];
+            }
+        }
+        float mixed = 0.0f;
+        for (unsigned int lane = 0; lane < FM_LANES; lane++)
+            mixed += sum[lane] * velocity[lane];
+        aBuffer[i] += mixed;
+    }
+#endif
+
+    for (unsigned int lane = 0; lane < FM_LANES; lane++)
+    {
+        const unsigned int v = firstVoice + lane;
+        if (v >= mParent->mMaxVoices || mVoices[v].stage == POLY_STAGE_IDLE)
+            continue;
+        for (unsigned int op = 0; op < operators; op++)
+        {
+            mPhases[v][op] = phase[op][lane];
+            mFeedback[v][op][0] = fb[op][0][lane];
+            mFeedback[v][op][1] = fb[op][1][lane];
+        }
+    }
+}
+
+unsigned int FmSynthInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+    processEvents();
+
+    memset(aBuffer, 0, sizeof(float) * aSamplesToRead);
+    for (unsigned int done = 0; done < aSamplesToRead; done += FM_CONTROL_CHUNK)
+    {
+        const unsigned int samples = aSamplesToRead - done < FM_CONTROL_CHUNK ? aSamplesToRead - done : FM_CONTROL_CHUNK;
+        for (unsigned int first = 0; first < mParent->mMaxVoices; first += FM_LANES)
+        {
+            bool any = false;
+            for (unsigned int v = first; v < first + FM_LANES && v < mParent->mMaxVoices; v++)
+                any |= mVoices[v].stage != POLY_STAGE_IDLE;
+            if (any)
+                renderLanes(first, aBuffer + done, samples);
+        }
+    }
+
+    unsigned int active = 0;
+    for (unsigned int v = 0; v < mParent->mMaxVoices; v++)
+        if (mVoices[v].stage != POLY_STAGE_IDLE)
+            active++;
+    mParent->mActiveVoices.store(active, std::memory_order_relaxed);
+    return aSamplesToRead;
+}
+
+FmSynth::FmSynth(float aSamplerate, unsigned int aOperators, unsigned int aMaxVoices)
+    : PolySynth(aSamplerate, SoLoud::Soloud::WAVE_SIN, aMaxVoices)
+{
+    mOperators = aOperators == 6 ? 6 : 4;
+    sineTable();
+    for (unsigned int op = 0; op < FM_MAX_OPERATORS; op++)
+    {
+        mRatio[op].store(1.0f);
+        mDetune[op].store(0.0f);
+        // a plain sine until the modulators are given a level
+        mLevel[op].store(op == 0 ? 1.0f : 0.0f);
+        mFeedbackAmount[op].store(0.0f);
+        mOpAttack[op].store(0.005f);
+        mOpDecay[op].store(0.2f);
+        mOpSustain[op].store(0.7f);
+        mOpRelease[op].store(0.3f);
+    }
+    setAlgorithm(0);
+}
+
+bool FmSynth::setAlgorithm(unsigned int algorithm)
+{
+    if (algorithm >= FM_ALGORITHMS)
+        return false;
+    const FmAlgorithm &preset = mOperators == 6 ? kAlgorithms6[algorithm] : kAlgorithms4[algorithm];
+    return setRouting(preset.modulators, preset.carriers);
+}
+
+bool FmSynth::setRouting(const unsigned int *modulators, unsigned int carriers)
+{
+    const unsigned int all = (1u << mOperators) - 1;
+    if (carriers == 0 || (carriers & ~all) != 0)
+        return false;
+    for (unsigned int op = 0; op < mOperators; op++)
+    {
+        // only the operators rendered before [op] can modulate it
+        const unsigned int higher = all & ~((2u << op) - 1);
+        if ((modulators[op] & ~higher) != 0)
+            return false;
+    }
+    for (unsigned int op = 0; op < mOperators; op++)
+        mModulators[op].store(modulators[op]);
+    mCarriers.store(carriers);
+    return true;
+}
+
+bool FmSynth::setOperator(unsigned int op, float ratio, float detune, float level, float feedback)
+{
+    if (op >= mOperators || ratio < 0.0f)
+        return false;
+    mRatio[op].store(ratio);
+    mDetune[op].store(detune);
+    mLevel[op].store(level);
+    mFeedbackAmount[op].store(feedback < 0.0f ? 0.0f : (feedback > 1.0f ? 1.0f : feedback));
+    return true;
+}
+
+bool FmSynth::setOperatorEnvelope(unsigned int op, float attack, float decay, float sustain, float release)
+{
+    if (op >= mOperators)
+        return false;
+    mOpAttack[op].store(attack < 0.0f ? 0.0f : attack);
+    mOpDecay[op].store(decay < 0.0f ? 0.0f : decay);
+    mOpSustain[op].store(sustain < 0.0f ? 0.0f : (sustain > 1.0f ? 1.0f : sustain));
+    mOpRelease[op].store(release < 0.0f ? 0.0f : release);
+    return true;
+}
+
+SoLoud::AudioSourceInstance *FmSynth::createInstance()
+{
+    mActiveVoices.store(0);
+    return new FmSynthInstance(this);
+}
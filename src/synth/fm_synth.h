@@ -0,0 +1,104 @@
+#ifndef FM_SYNTH_H
+#define FM_SYNTH_H
+
+#include "poly_synth.h"
+
+/// Maximum operators of a [FmSynth]
+#define FM_MAX_OPERATORS 6
+/// Preset algorithms for each operator count
+#define FM_ALGORITHMS 8
+/// Samples between two updates of the operator envelopes and pitches
+#define FM_CONTROL_CHUNK 32
+/// Voices rendered together, one per SIMD lane
+#define FM_LANES 4
+
+/// Envelope of an operator in a voice
+struct FmEnvelope
+{
+    PolySynthStage stage;
+    float level;
+    float releaseStep;
+};
+
+class FmSynth;
+
+class FmSynthInstance : public PolySynthInstance
+{
+    FmSynth *mFm;
+    FmEnvelope mEnvelopes[POLY_SYNTH_MAX_VOICES][FM_MAX_OPERATORS];
+    float mPhases[POLY_SYNTH_MAX_VOICES][FM_MAX_OPERATORS];
+    /// last two outputs of each operator, for the feedback
+    float mFeedback[POLY_SYNTH_MAX_VOICES][FM_MAX_OPERATORS][2];
+
+    /// @brief advance the envelope by [aSamples] samples.
+    /// @return the level reached.
+    float advanceEnvelope(FmEnvelope &envelope, unsigned int op, unsigned int aSamples);
+    void renderLanes(unsigned int firstVoice, float *aBuffer, unsigned int aSamples);
+
+protected:
+    virtual void startVoice(PolySynthVoice &voice, bool wasIdle);
+    virtual void release(PolySynthVoice &voice);
+
+public:
+    FmSynthInstance(FmSynth *aParent);
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+};
+
+/// A polyphonic FM (phase modulation) instrument of 4 or 6 sine operators.
+///
+/// The notes are played like a [PolySynth]. Each operator has a frequency
+/// ratio to the note, a fixed detune, an output level, a self feedback and
+/// its own ADSR. The algorithm tells which operators modulate which ones:
+/// an operator can only be modulated by operators with a higher index, and
+/// the carriers are summed to the output. The level of a modulator is its
+/// modulation index, in cycles of phase deviation.
+///
+/// Voices are rendered 4 at a time, one per SIMD lane, and envelopes and
+/// glides are updated every [FM_CONTROL_CHUNK] samples.
+class FmSynth : public PolySynth
+{
+public:
+    /// @param aSamplerate the sample rate to render at, usually the engine one.
+    /// @param aOperators 4 or 6.
+    /// @param aMaxVoices notes playing at once, 1 to [POLY_SYNTH_MAX_VOICES].
+    FmSynth(float aSamplerate, unsigned int aOperators, unsigned int aMaxVoices);
+
+    unsigned int getOperators() const { return mOperators; }
+
+    /// @brief use one of the [FM_ALGORITHMS] presets of the operator count.
+    /// @return false if [algorithm] doesn't exist.
+    bool setAlgorithm(unsigned int algorithm);
+
+    /// @brief set a custom algorithm.
+    /// @param modulators for each operator, the bit mask of the operators
+    /// modulating it. Only higher operators can modulate an operator.
+    /// @param carriers bit mask of the operators summed to the output.
+    /// @return false if the routing is not valid.
+    bool setRouting(const unsigned int *modulators, unsigned int carriers);
+
+    /// @param ratio frequency ratio to the note.
+    /// @param detune fixed frequency offset in Hz.
+    /// @param level amplitude for a carrier, modulation index for a modulator.
+    /// @param feedback self modulation, 0 to 1.
+    bool setOperator(unsigned int op, float ratio, float detune, float level, float feedback);
+
+    /// @brief times in seconds and [sustain] level 0 to 1.
+    bool setOperatorEnvelope(unsigned int op, float attack, float decay, float sustain, float release);
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+public:
+    unsigned int mOperators;
+    std::atomic<unsigned int> mModulators[FM_MAX_OPERATORS];
+    std::atomic<unsigned int> mCarriers;
+    std::atomic<float> mRatio[FM_MAX_OPERATORS];
+    std::atomic<float> mDetune[FM_MAX_OPERATORS];
+    std::atomic<float> mLevel[FM_MAX_OPERATORS];
+    std::atomic<float> mFeedbackAmount[FM_MAX_OPERATORS];
+    std::atomic<float> mOpAttack[FM_MAX_OPERATORS];
+    std::atomic<float> mOpDecay[FM_MAX_OPERATORS];
+    std::atomic<float> mOpSustain[FM_MAX_OPERATORS];
+    std::atomic<float> mOpRelease[FM_MAX_OPERATORS];
+};
+
+#endif // FM_SYNTH_H
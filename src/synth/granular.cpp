@@ -0,0 +1,295 @@
+#include "granular.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const int kWindows = GRAIN_WINDOW_TRAPEZOID + 1;
+    std::once_flag gWindowOnce[kWindows];
+    std::unique_ptr<float[]> gWindowTables[kWindows];
+
+    void buildWindow(GrainWindow window, float *out)
+    {
+        const double pi = 3.14159265358979323846;
+        for (int i = 0; i <= GRANULAR_WINDOW_SIZE; i++)
+        {
+            const double x = (double)i / GRANULAR_WINDOW_SIZE;
+            double w = 0.0;
+            switch (window)
+            {
+            case GRAIN_WINDOW_HANN:
+                w = 0.5 - 0.5 * cos(2.0 * pi * x);
+                break;
+            case GRAIN_WINDOW_GAUSSIAN:
+            {
+                // sigma of 1/6 of the grain, shifted so the ends are 0
+                const double d = (x - 0.5) * 6.0;
+                const double edge = exp(-0.5 * 9.0);
+                w = (exp(-0.5 * d * d) - edge) / (1.0 - edge);
+                break;
+            }
+            case GRAIN_WINDOW_TRAPEZOID:
+                w = x < 0.1 ? x / 0.1 : (x > 0.9 ? (1.0 - x) / 0.1 : 1.0);
+                break;
+            }
+            out[i] = (float)w;
+        }
+    }
+}
+
+GranularInstance::GranularInstance(Granular *aParent)
+    : mParent(aParent),
+      mActive(0),
+      mNextGrain(0.0),
+      mRandom(0x2545f491u)
+{
+}
+
+float GranularInstance::random()
+{
+    // xorshift32, from -1 to 1
+    mRandom ^= mRandom << 13;
+    mRandom ^= mRandom >> 17;
+    mRandom ^= mRandom << 5;
+    return (float)(mRandom >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+void GranularInstance::spawn(unsigned int delay, const SoLoud::Wav *wav)
+{
+    if (mActive >= GRANULAR_MAX_GRAINS)
+        return;
+
+    const float wavRate = wav->mBaseSamplerate;
+    const float pitch = mParent->mPitch.load() + mParent->mPitchSpray.load() * random();
+    const float step = powf(2.0f, pitch / 12.0f) * wavRate / mSamplerate;
+
+    // the grain must fit in the sample, the last one is kept for the
+    // interpolation
+    const float available = (float)(wav->mSampleCount - 2);
+    float length = mParent->mSize.load() * mSamplerate;
+    if (length * step > available)
+        length = available / step;
+    if (length < 16.0f)
+        return;
+    const float span = length * step;
+
+    float center = mParent->mPosition.load() * wav->mSampleCount +
+                   mParent->mSpray.load() * random() * wavRate;
+    float start = center - span * 0.5f;
+    if (start > available - span)
+        start = available - span;
+    if (start < 0.0f)
+        start = 0.0f;
+
+    // keep the level even when grains overlap
+    const float overlap = mParent->mDensity.load() * mParent->mSize.load();
+
+    Grain &g = mGrains[mActive++];
+    g.start = (unsigned int)start;
+    g.offset = start - g.start;
+    g.step = step;
+    g.windowPos = 0.0f;
+    g.windowStep = GRANULAR_WINDOW_SIZE / length;
+    g.remaining = (unsigned int)length;
+    g.delay = delay;
+    g.gain = overlap > 1.0f ? 1.0f / sqrtf(overlap) : 1.0f;
+}
+
+unsigned int GranularInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+    for (unsigned int c = 0; c < mChannels; c++)
+        memset(aBuffer + c * aBufferSize, 0, aSamplesToRead * sizeof(float));
+
+    const SoLoud::Wav *wav = mParent->mWav;
+    if (wav == nullptr || wav->mData == nullptr || wav->mSampleCount < 18)
+        return aSamplesToRead;
+
+    // start the grains due in this block on their exact sample
+    const float density = mParent->mDensity.load();
+    if (density > 0.0f)
+    {
+        const double interval = mSamplerate / density;
+        if (mNextGrain > interval)
+            mNextGrain = interval;
+        while (mNextGrain < aSamplesToRead)
+        {
+            spawn((unsigned int)mNextGrain, wav);
+            mNextGrain += interval;
+        }
+        mNextGrain -= aSamplesToRead;
+    }
+    else
+    {
+        mNextGrain = 0.0;
+    }
+
+    const float *window = Granular::getWindow((GrainWindow)mParent->mWindow.load());
+    const unsigned int channels = mChannels < wav->mChannels ? mChannels : wav->mChannels;
+
+    unsigned int g = 0;
+    while (g < mActive)
+    {
+        Grain &grain = mGrains[g];
+        const unsigned int begin = grain.delay;
+        unsigned int n = aSamplesToRead - begin;
+        if (n > grain.remaining)
+            n = grain.remaining;
+
+        unsigned int i = 0;
+#ifdef SOLOUD_SSE_INTRINSICS
+        const __m128 ramp = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        const __m128 step = _mm_set1_ps(grain.step);
+        const __m128 windowStep = _mm_set1_ps(grain.windowStep);
+        const __m128 gain = _mm_set1_ps(grain.gain);
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 fi = _mm_add_ps(_mm_set1_ps((float)i), ramp);
+
+            const __m128 wpos = _mm_add_ps(_mm_set1_ps(grain.windowPos), _mm_mul_ps(fi, windowStep));
+            const __m128i wi = _mm_cvttps_epi32(wpos);
+            const __m128 wf = _mm_sub_ps(wpos, _mm_cvtepi32_ps(wi));
+            alignas(16) int wx[4];
+            _mm_store_si128((__m128i *)wx, wi);
+            const __m128 wa = _mm_set_ps(window[wx[3]], window[wx[2]], window[wx[1]], window[wx[0]]);
+            const __m128 wb = _mm_set_ps(window[wx[3] + 1], window[wx[2] + 1], window[wx[1] + 1], window[wx[0] + 1]);
+            const __m128 w = _mm_mul_ps(_mm_add_ps(wa, _mm_mul_ps(_mm_sub_ps(wb, wa), wf)), gain);
+
+            const __m128 pos = _mm_add_ps(_mm_set1_ps(grain.offset), _mm_mul_ps(fi, step));
+            const __m128i pi = _mm_cvttps_epi32(pos);
+            const __m128 pf = _mm_sub_ps(pos, _mm_cvtepi32_ps(pi));
+            alignas(16) int px[4];
+            _mm_store_si128((__m128i *)px, pi);
+
+            for (unsigned int c = 0; c < channels; c++)
+            {
+                const float *data = wav->mData + c * wav->mSampleCount + grain.start;
+                const __m128 a = _mm_set_ps(data[px[3]], data[px[2]], data[px[1]], data[px[0]]);
+                const __m128 b = _mm_set_ps(data[px[3] + 1], data[px[2] + 1], data[px[1] + 1], data[px[0] + 1]);
+                const __m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), pf));
+                float *out = aBuffer + c * aBufferSize + begin + i;
+                _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(s, w)));
+            }
+        }
+#endif
+        for (; i < n; i++)
+        {
+            const float wpos = grain.windowPos + i * grain.windowStep;
+            const int wi = (int)wpos;
+            const float w = (window[wi] + (window[wi + 1] - window[wi]) * (wpos - wi)) * grain.gain;
+            const float pos = grain.offset + i * grain.step;
+            const int pi = (int)pos;
+            const float pf = pos - pi;
+            for (unsigned int c = 0; c < channels; c++)
+            {
+                const float *data = wav->mData + c * wav->mSampleCount + grain.start;
+                aBuffer[c * aBufferSize + begin + i] += (data[pi] + (data[pi + 1] - data[pi]) * pf) * w;
+            }
+        }
+
+        grain.offset += n * grain.step;
+        grain.windowPos += n * grain.windowStep;
+        grain.remaining -= n;
+        grain.delay = 0;
+
+        if (grain.remaining == 0)
+            grain = mGrains[--mActive];
+        else
+            g++;
+    }
+
+    // a mono Wav is heard on all the channels
+    for (unsigned int c = channels; c < mChannels; c++)
+        memcpy(aBuffer + c * aBufferSize, aBuffer, aSamplesToRead * sizeof(float));
+
+    return aSamplesToRead;
+}
+
+bool GranularInstance::hasEnded()
+{
+    // This audio source never ends.
+    return 0;
+}
+
+Granular::Granular(SoLoud::Wav *wav)
+    : mWav(wav),
+      mDensity(20.0f),
+      mPosition(0.0f),
+      mSpray(0.0f),
+      mPitch(0.0f),
+      mPitchSpray(0.0f),
+      mSize(0.1f),
+      mWindow(GRAIN_WINDOW_HANN)
+{
+    mBaseSamplerate = wav->mBaseSamplerate;
+    mChannels = wav->mChannels;
+    // build the tables out of the audio thread
+    for (int i = 0; i < kWindows; i++)
+        getWindow((GrainWindow)i);
+}
+
+Granular::~Granular()
+{
+    stop();
+}
+
+const float *Granular::getWindow(GrainWindow window)
+{
+    if (window < GRAIN_WINDOW_HANN || window > GRAIN_WINDOW_TRAPEZOID)
+        window = GRAIN_WINDOW_HANN;
+    std::call_once(gWindowOnce[window], [window]()
+                   {
+                       gWindowTables[window].reset(new float[GRANULAR_WINDOW_SIZE + 1]);
+                       buildWindow(window, gWindowTables[window].get()); });
+    return gWindowTables[window].get();
+}
+
+void Granular::detach()
+{
+    stop();
+    mWav = nullptr;
+}
+
+void Granular::setDensity(float grainsPerSecond)
+{
+    mDensity = grainsPerSecond < 0.0f ? 0.0f : grainsPerSecond;
+}
+
+void Granular::setPosition(float position)
+{
+    mPosition = position < 0.0f ? 0.0f : (position > 1.0f ? 1.0f : position);
+}
+
+void Granular::setSpray(float seconds)
+{
+    mSpray = seconds < 0.0f ? 0.0f : seconds;
+}
+
+void Granular::setPitch(float semitones, float spray)
+{
+    mPitch = semitones;
+    mPitchSpray = spray < 0.0f ? 0.0f : spray;
+}
+
+void Granular::setSize(float seconds)
+{
+    mSize = seconds < 0.001f ? 0.001f : seconds;
+}
+
+void Granular::setWindow(GrainWindow window)
+{
+    if (window < GRAIN_WINDOW_HANN || window > GRAIN_WINDOW_TRAPEZOID)
+        return;
+    mWindow = window;
+}
+
+SoLoud::AudioSourceInstance *Granular::createInstance()
+{
+    return new GranularInstance(this);
+}
@@ -0,0 +1,107 @@
+#ifndef GRANULAR_H
+#define GRANULAR_H
+
+#include "soloud.h"
+#include "soloud_wav.h"
+
+#include <atomic>
+
+/// Grains playing at once in a voice
+#define GRANULAR_MAX_GRAINS 128
+/// Samples of a precomputed grain window
+#define GRANULAR_WINDOW_SIZE 1024
+
+typedef enum GrainWindow
+{
+    GRAIN_WINDOW_HANN,
+    GRAIN_WINDOW_GAUSSIAN,
+    /// 10% fade in and out
+    GRAIN_WINDOW_TRAPEZOID
+} GrainWindow_t;
+
+class Granular;
+
+struct Grain
+{
+    /// first sample of the grain in the Wav
+    unsigned int start;
+    /// position from [start], in Wav samples
+    float offset;
+    /// Wav samples per output sample
+    float step;
+    float windowPos;
+    float windowStep;
+    /// output samples left
+    unsigned int remaining;
+    /// output samples to wait in the current block before starting
+    unsigned int delay;
+    float gain;
+};
+
+class GranularInstance : public SoLoud::AudioSourceInstance
+{
+public:
+    GranularInstance(Granular *aParent);
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual bool hasEnded();
+
+private:
+    void spawn(unsigned int delay, const SoLoud::Wav *wav);
+    float random();
+
+    Granular *mParent;
+    Grain mGrains[GRANULAR_MAX_GRAINS];
+    unsigned int mActive;
+    /// output samples before the next grain, from the start of the block
+    double mNextGrain;
+    unsigned int mRandom;
+};
+
+/// Granular synthesis over the data of a loaded Wav.
+///
+/// Grains are short windowed slices of the sample, started [density]
+/// times per second around [position] and scattered by [spray] in time
+/// and by [pitchSpray] in pitch. The grains are scheduled on their exact
+/// sample inside each block and mixed 4 samples at a time with SSE where
+/// available.
+class Granular : public SoLoud::AudioSource
+{
+public:
+    Granular(SoLoud::Wav *wav);
+    virtual ~Granular();
+
+    /// @brief the window [GRANULAR_WINDOW_SIZE] + 1 samples long of [window],
+    /// built on the first call.
+    static const float *getWindow(GrainWindow window);
+
+    /// @brief stop the voices and stop reading [mWav]. Used when the Wav is
+    /// disposed.
+    void detach();
+
+    void setDensity(float grainsPerSecond);
+    /// @brief set the center of the grains, from 0 (start) to 1 (end).
+    void setPosition(float position);
+    /// @brief set the random offset of the grains around the position, in
+    /// seconds.
+    void setSpray(float seconds);
+    /// @brief set the transposition of the grains and its random spread,
+    /// in semitones.
+    void setPitch(float semitones, float spray);
+    /// @brief set the grain length in seconds.
+    void setSize(float seconds);
+    void setWindow(GrainWindow window);
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+    /// null after [detach]
+    SoLoud::Wav *mWav;
+    std::atomic<float> mDensity;
+    std::atomic<float> mPosition;
+    std::atomic<float> mSpray;
+    std::atomic<float> mPitch;
+    std::atomic<float> mPitchSpray;
+    std::atomic<float> mSize;
+    std::atomic<int> mWindow;
+};
+
+#endif // GRANULAR_H
@@ -0,0 +1,337 @@
+#include "poly_synth.h"
+
+#include <math.h>
+#include <string.h>
+
+float PolySynthInstance::pitchToFrequency(float pitch)
+{
+    return 440.0f * powf(2.0f, (pitch - 69.0f) / 12.0f);
+}
+
+PolySynthInstance::PolySynthInstance(PolySynth *aParent)
+{
+    mParent = aParent;
+    memset(mVoices, 0, sizeof(mVoices));
+    mAge = 0;
+    mLastPitch = 0.0f;
+    mHasLastPitch = false;
+
+    // the notes left by the previous instance are dropped
+    std::lock_guard<std::mutex> lock(mParent->mWriteMutex);
+    mParent->mReadIndex.store(mParent->mWriteIndex.load(std::memory_order_relaxed), std::memory_order_release);
+    mParent->mPlaying.store(true);
+}
+
+PolySynthInstance::~PolySynthInstance()
+{
+    mParent->mPlaying.store(false);
+    mParent->mActiveVoices.store(0);
+}
+
+void PolySynthInstance::processEvents()
+{
+    unsigned int read = mParent->mReadIndex.load(std::memory_order_relaxed);
+    const unsigned int write = mParent->mWriteIndex.load(std::memory_order_acquire);
+    for (; read != write; read++)
+    {
+        const PolySynthEvent &event = mParent->mQueue[read % POLY_SYNTH_QUEUE_SIZE];
+        switch (event.type)
+        {
+        case POLY_NOTE_ON:
+            noteOn(event);
+            break;
+        case POLY_NOTE_OFF:
+            for (unsigned int i = 0; i < mParent->mMaxVoices; i++)
+                if (mVoices[i].stage != POLY_STAGE_IDLE &&
+                    mVoices[i].stage != POLY_STAGE_RELEASE &&
+                    mVoices[i].note == event.note)
+                    release(mVoices[i]);
+            break;
+        case POLY_NOTE_PITCH:
+            for (unsigned int i = 0; i < mParent->mMaxVoices; i++)
+            {
+                PolySynthVoice &voice = mVoices[i];
+                if (voice.stage == POLY_STAGE_IDLE || voice.note != event.note)
+                    continue;
+                voice.targetPitch = event.pitch;
+                voice.glideStep = event.glide > 0.0f
+                                      ? fabsf(event.pitch - voice.pitch) / (event.glide * mSamplerate)
+                                      : 0.0f;
+                if (voice.glideStep == 0.0f)
+                {
+                    voice.pitch = event.pitch;
+                    voice.phaseStep = pitchToFrequency(voice.pitch) / mSamplerate;
+                }
+            }
+            break;
+        case POLY_ALL_NOTES_OFF:
+            for (unsigned int i = 0; i < mParent->mMaxVoices; i++)
+                if (mVoices[i].stage != POLY_STAGE_IDLE && mVoices[i].stage != POLY_STAGE_RELEASE)
+                    release(mVoices[i]);
+            break;
+        }
+    }
+    mParent->mReadIndex.store(read, std::memory_order_release);
+}
+
+PolySynthVoice *PolySynthInstance::allocateVoice(float note)
+{
+    PolySynthVoice *quietest = nullptr;
+    PolySynthVoice *oldest = nullptr;
+    for (unsigned int i = 0; i < mParent->mMaxVoices; i++)
+    {
+        PolySynthVoice &voice = mVoices[i];
+        // the same key pressed again restarts its own voice
+        if (voice.stage != POLY_STAGE_IDLE && voice.stage != POLY_STAGE_RELEASE && voice.note == note)
+            return &voice;
+        if (voice.stage == POLY_STAGE_IDLE)
+            return &voice;
+        if (voice.stage == POLY_STAGE_RELEASE)
+        {
+            if (quietest == nullptr || voice.level < quietest->level)
+                quietest = &voice;
+        }
+        else if (oldest == nullptr || voice.age < oldest->age)
+            oldest = &voice;
+    }
+    return quietest != nullptr ? quietest : oldest;
+}
+
+void PolySynthInstance::noteOn(const PolySynthEvent &event)
+{
+    PolySynthVoice *voice = allocateVoice(event.note);
+    if (voice == nullptr)
+        return;
+
+    // a stolen voice keeps its phase and its level, the attack starts from there
+    const bool wasIdle = voice->stage == POLY_STAGE_IDLE;
+    if (wasIdle)
+    {
+        voice->phase = 0.0f;
+        voice->level = 0.0f;
+    }
+    voice->stage = POLY_STAGE_ATTACK;
+    voice->note = event.note;
+    voice->velocity = event.velocity;
+    voice->targetPitch = event.note;
+    voice->age = mAge++;
+
+    if (event.glide > 0.0f && mHasLastPitch)
+    {
+        voice->pitch = mLastPitch;
+        voice->glideStep = fabsf(event.note - mLastPitch) / (event.glide * mSamplerate);
+    }
+    else
+    {
+        voice->pitch = event.note;
+        voice->glideStep = 0.0f;
+    }
+    voice->phaseStep = pitchToFrequency(voice->pitch) / mSamplerate;
+    mLastPitch = event.note;
+    mHasLastPitch = true;
+    startVoice(*voice, wasIdle);
+}
+
+void PolySynthInstance::release(PolySynthVoice &voice)
+{
+    const float release = mParent->mRelease.load(std::memory_order_relaxed);
+    voice.stage = POLY_STAGE_RELEASE;
+    // the release lasts the same whatever the level reached
+    voice.releaseStep = release > 0.0f ? voice.level / (release * mSamplerate) : voice.level;
+    if (voice.releaseStep <= 0.0f)
+        voice.stage = POLY_STAGE_IDLE;
+}
+
+void PolySynthInstance::renderOscillator(PolySynthVoice &voice, const Wavetable *wavetable, float *aBuffer, unsigned int aSamples)
+{
+    if (voice.glideStep == 0.0f)
+    {
+        voice.phase = Wavetable::render(wavetable->getLevel(voice.phaseStep), voice.phase, voice.phaseStep, aBuffer, aSamples);
+        return;
+    }
+
+    // the table must stay band-limited up to the highest pitch of the glide
+    const float targetStep = pitchToFrequency(voice.targetPitch) / mSamplerate;
+    const float *table = wavetable->getLevel(targetStep > voice.phaseStep ? targetStep : voice.phaseStep);
+    for (unsigned int i = 0; i < aSamples; i++)
+    {
+        if (voice.glideStep > 0.0f)
+        {
+            if (fabsf(voice.targetPitch - voice.pitch) <= voice.glideStep)
+            {
+                voice.pitch = voice.targetPitch;
+                voice.glideStep = 0.0f;
+            }
+            else
+                voice.pitch += voice.targetPitch > voice.pitch ? voice.glideStep : -voice.glideStep;
+            voice.phaseStep = pitchToFrequency(voice.pitch) / mSamplerate;
+        }
+        aBuffer[i] = Wavetable::sample(table, voice.phase);
+        voice.phase += voice.phaseStep;
+        voice.phase -= floorf(voice.phase);
+    }
+}
+
+unsigned int PolySynthInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+    processEvents();
+
+    const Wavetable *wavetable = Wavetable::get(mParent->mWaveform.load(std::memory_order_relaxed));
+    const float attack = mParent->mAttack.load(std::memory_order_relaxed);
+    const float decay = mParent->mDecay.load(std::memory_order_relaxed);
+    const float sustain = mParent->mSustain.load(std::memory_order_relaxed);
+    const float attackStep = attack > 0.0f ? 1.0f / (attack * mSamplerate) : 1.0f;
+    const float decayStep = decay > 0.0f ? (1.0f - sustain) / (decay * mSamplerate) : 1.0f;
+
+    memset(aBuffer, 0, sizeof(float) * aSamplesToRead);
+    unsigned int active = 0;
+    float oscillator[POLY_SYNTH_CHUNK];
+    for (unsigned int v = 0; v < mParent->mMaxVoices; v++)
+    {
+        PolySynthVoice &voice = mVoices[v];
+
+        for (unsigned int done = 0; done < aSamplesToRead && voice.stage != POLY_STAGE_IDLE; done += POLY_SYNTH_CHUNK)
+        {
+            const unsigned int samples = aSamplesToRead - done < POLY_SYNTH_CHUNK ? aSamplesToRead - done : POLY_SYNTH_CHUNK;
+            renderOscillator(voice, wavetable, oscillator, samples);
+
+            float *out = aBuffer + done;
+            for (unsigned int i = 0; i < samples; i++)
+            {
+                switch (voice.stage)
+                {
+                case POLY_STAGE_ATTACK:
+                    voice.level += attackStep;
+                    if (voice.level >= 1.0f)
+                    {
+                        voice.level = 1.0f;
+                        voice.stage = POLY_STAGE_DECAY;
+                    }
+                    break;
+                case POLY_STAGE_DECAY:
+                    voice.level -= decayStep;
+                    if (voice.level <= sustain)
+                    {
+                        voice.level = sustain;
+                        voice.stage = POLY_STAGE_SUSTAIN;
+                    }
+                    break;
+                case POLY_STAGE_SUSTAIN:
+                    voice.level = sustain;
+                    break;
+                case POLY_STAGE_RELEASE:
+                    voice.level -= voice.releaseStep;
+                    if (voice.level <= 0.0f)
+                    {
+                        voice.level = 0.0f;
+                        voice.stage = POLY_STAGE_IDLE;
+                    }
+                    break;
+                case POLY_STAGE_IDLE:
+                    break;
+                }
+                if (voice.stage == POLY_STAGE_IDLE)
+                    break;
+                out[i] += oscillator[i] * voice.level * voice.velocity;
+            }
+        }
+        if (voice.stage != POLY_STAGE_IDLE)
+            active++;
+    }
+    mParent->mActiveVoices.store(active, std::memory_order_relaxed);
+    return aSamplesToRead;
+}
+
+bool PolySynthInstance::hasEnded()
+{
+    // An instrument waits for notes until it is stopped.
+    return false;
+}
+
+PolySynth::PolySynth(float aSamplerate, int aWaveform, unsigned int aMaxVoices)
+    : mWaveform(aWaveform),
+      mAttack(0.01f),
+      mDecay(0.1f),
+      mSustain(0.7f),
+      mRelease(0.3f),
+      mActiveVoices(0),
+      mWriteIndex(0),
+      mReadIndex(0),
+      mPlaying(false)
+{
+    mBaseSamplerate = aSamplerate;
+    mChannels = 1;
+    // the voices and the event queue belong to the single playing instance
+    setSingleInstance(true);
+    Wavetable::get(aWaveform);
+    mMaxVoices = aMaxVoices == 0 ? 1 : (aMaxVoices > POLY_SYNTH_MAX_VOICES ? POLY_SYNTH_MAX_VOICES : aMaxVoices);
+}
+
+PolySynth::~PolySynth()
+{
+    stop();
+}
+
+bool PolySynth::push(const PolySynthEvent &event)
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    // no instance would ever read it
+    if (!mPlaying.load())
+        return true;
+    const unsigned int write = mWriteIndex.load(std::memory_order_relaxed);
+    if (write - mReadIndex.load(std::memory_order_acquire) >= POLY_SYNTH_QUEUE_SIZE)
+        return false;
+    mQueue[write % POLY_SYNTH_QUEUE_SIZE] = event;
+    mWriteIndex.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+bool PolySynth::noteOn(float note, float velocity, float glide)
+{
+    PolySynthEvent event = {POLY_NOTE_ON, note, velocity, note, glide};
+    return push(event);
+}
+
+bool PolySynth::noteOff(float note)
+{
+    PolySynthEvent event = {POLY_NOTE_OFF, note, 0.0f, note, 0.0f};
+    return push(event);
+}
+
+bool PolySynth::setNotePitch(float note, float pitch, float glide)
+{
+    PolySynthEvent event = {POLY_NOTE_PITCH, note, 0.0f, pitch, glide};
+    return push(event);
+}
+
+bool PolySynth::allNotesOff()
+{
+    PolySynthEvent event = {POLY_ALL_NOTES_OFF, 0.0f, 0.0f, 0.0f, 0.0f};
+    return push(event);
+}
+
+void PolySynth::setWaveform(int aWaveform)
+{
+    // build the tables here rather than in the audio thread
+    Wavetable::get(aWaveform);
+    mWaveform.store(aWaveform);
+}
+
+void PolySynth::setADSR(float attack, float decay, float sustain, float release)
+{
+    mAttack.store(attack < 0.0f ? 0.0f : attack);
+    mDecay.store(decay < 0.0f ? 0.0f : decay);
+    mSustain.store(sustain < 0.0f ? 0.0f : (sustain > 1.0f ? 1.0f : sustain));
+    mRelease.store(release < 0.0f ? 0.0f : release);
+}
+
+unsigned int PolySynth::getActiveVoices() const
+{
+    return mActiveVoices.load();
+}
+
+SoLoud::AudioSourceInstance *PolySynth::createInstance()
+{
+    mActiveVoices.store(0);
+    return new PolySynthInstance(this);
+}
@@ -0,0 +1,160 @@
+#ifndef POLY_SYNTH_H
+#define POLY_SYNTH_H
+
+#include "soloud.h"
+#include "wavetable.h"
+
+#include <atomic>
+#include <mutex>
+
+/// Maximum notes a [PolySynth] can play at once
+#define POLY_SYNTH_MAX_VOICES 32
+
+/// Samples rendered at once by a voice oscillator
+#define POLY_SYNTH_CHUNK 256
+
+/// Note events queued for the audio thread
+#define POLY_SYNTH_QUEUE_SIZE 256
+
+typedef enum PolySynthEventType
+{
+    POLY_NOTE_ON,
+    POLY_NOTE_OFF,
+    POLY_NOTE_PITCH,
+    POLY_ALL_NOTES_OFF
+} PolySynthEventType_t;
+
+struct PolySynthEvent
+{
+    PolySynthEventType type;
+    /// MIDI note number identifying the note, can be fractional
+    float note;
+    float velocity;
+    /// new pitch for [POLY_NOTE_PITCH]
+    float pitch;
+    /// glide time in seconds
+    float glide;
+};
+
+typedef enum PolySynthStage
+{
+    POLY_STAGE_IDLE,
+    POLY_STAGE_ATTACK,
+    POLY_STAGE_DECAY,
+    POLY_STAGE_SUSTAIN,
+    POLY_STAGE_RELEASE
+} PolySynthStage_t;
+
+struct PolySynthVoice
+{
+    PolySynthStage stage;
+    /// the note given to noteOn, used to find the voice on noteOff
+    float note;
+    float velocity;
+    /// current and target pitch as MIDI note numbers
+    float pitch;
+    float targetPitch;
+    /// pitch change per sample while gliding
+    float glideStep;
+    float phase;
+    float phaseStep;
+    float level;
+    float releaseStep;
+    /// noteOn order, the oldest voice is stolen first
+    unsigned int age;
+};
+
+class PolySynth;
+
+class PolySynthInstance : public SoLoud::AudioSourceInstance
+{
+protected:
+    PolySynth *mParent;
+    PolySynthVoice mVoices[POLY_SYNTH_MAX_VOICES];
+    unsigned int mAge;
+    /// pitch of the last note started, the origin of the next glide
+    float mLastPitch;
+    bool mHasLastPitch;
+
+    /// @brief the frequency in Hz of a MIDI note number.
+    static float pitchToFrequency(float pitch);
+
+    /// @brief apply the note events queued since the last call.
+    void processEvents();
+    void noteOn(const PolySynthEvent &event);
+    PolySynthVoice *allocateVoice(float note);
+
+    /// @brief called when [voice] starts a note. [wasIdle] is false when
+    /// the voice is stolen or retriggered.
+    virtual void startVoice(PolySynthVoice &voice, bool wasIdle) {}
+    /// @brief called when the note of [voice] is released.
+    virtual void release(PolySynthVoice &voice);
+
+private:
+    void renderOscillator(PolySynthVoice &voice, const Wavetable *wavetable, float *aBuffer, unsigned int aSamples);
+
+public:
+    PolySynthInstance(PolySynth *aParent);
+    virtual ~PolySynthInstance();
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual bool hasEnded();
+};
+
+/// A polyphonic instrument playing the band-limited [Basicwave] waveforms.
+///
+/// Each note has its own oscillator, ADSR envelope and glide. Notes are
+/// sent to the audio thread through a lock-free queue and applied at the
+/// start of the next mixed chunk. When all the voices are busy, the
+/// quietest releasing voice is stolen, or else the oldest one; the stolen
+/// voice keeps its phase and level so no click is heard.
+/// Only one instance of this source can be played at a time, and the notes
+/// sent while it is not playing are ignored.
+class PolySynth : public SoLoud::AudioSource
+{
+public:
+    /// @param aSamplerate the sample rate to render at, usually the engine one.
+    /// @param aWaveform one of [Soloud::WAVEFORM].
+    /// @param aMaxVoices notes playing at once, 1 to [POLY_SYNTH_MAX_VOICES].
+    PolySynth(float aSamplerate, int aWaveform, unsigned int aMaxVoices);
+    virtual ~PolySynth();
+
+    /// @brief start [note] (MIDI note number) with [velocity] 0 to 1.
+    /// @param glide if > 0, seconds to glide from the previous note pitch.
+    /// @return false if the event queue is full.
+    bool noteOn(float note, float velocity, float glide);
+    /// @brief release all the voices playing [note].
+    bool noteOff(float note);
+    /// @brief glide the voices playing [note] to [pitch] in [glide] seconds.
+    bool setNotePitch(float note, float pitch, float glide);
+    bool allNotesOff();
+
+    void setWaveform(int aWaveform);
+    /// @brief times in seconds and [sustain] level 0 to 1.
+    void setADSR(float attack, float decay, float sustain, float release);
+    unsigned int getActiveVoices() const;
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+public:
+    unsigned int mMaxVoices;
+    std::atomic<int> mWaveform;
+    std::atomic<float> mAttack;
+    std::atomic<float> mDecay;
+    std::atomic<float> mSustain;
+    std::atomic<float> mRelease;
+    std::atomic<unsigned int> mActiveVoices;
+
+    /// single-consumer ring of note events. Producers are serialized by
+    /// [mWriteMutex], the audio thread never locks.
+    PolySynthEvent mQueue[POLY_SYNTH_QUEUE_SIZE];
+    std::atomic<unsigned int> mWriteIndex;
+    std::atomic<unsigned int> mReadIndex;
+    std::mutex mWriteMutex;
+    /// set while an instance reads [mQueue]
+    std::atomic<bool> mPlaying;
+
+private:
+    bool push(const PolySynthEvent &event);
+};
+
+#endif // POLY_SYNTH_H
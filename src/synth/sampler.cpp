@@ -0,0 +1,186 @@
+#include "sampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+Sampler::Sampler(SoLoud::Soloud *soloud, unsigned int id)
+    : mSoloud(soloud),
+      mId(id)
+{
+    for (int i = 0; i < 128; i++)
+        mKeyCounters[i] = 0;
+}
+
+bool Sampler::addZones(const SamplerZone *zones,
+                       SoLoud::AudioSource *const *sources,
+                       unsigned int count)
+{
+    bool allValid = true;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const SamplerZone &z = zones[i];
+        if (sources[i] == nullptr ||
+            z.loKey > z.hiKey || z.hiKey < 0 || z.loKey > 127 ||
+            z.loVelocity > z.hiVelocity ||
+            z.loopStart < 0.0f || z.release < 0.0f ||
+            z.trigger > SAMPLER_TRIGGER_RELEASE ||
+            (z.seqLength > 1 && (z.seqPosition < 1 || z.seqPosition > z.seqLength)))
+        {
+            allValid = false;
+            continue;
+        }
+        mZones.push_back({z, sources[i]});
+    }
+    return allValid;
+}
+
+void Sampler::clearZones()
+{
+    mZones.clear();
+}
+
+void Sampler::removeSource(SoLoud::AudioSource *source)
+{
+    mZones.erase(std::remove_if(mZones.begin(), mZones.end(),
+                                [source](const Zone &z)
+                                { return z.source == source; }),
+                 mZones.end());
+}
+
+void Sampler::startZones(unsigned int trigger, float note, float velocity, std::vector<Voice> &voices)
+{
+    const int key = (int)floorf(note + 0.5f);
+    const unsigned int counter = key >= 0 && key < 128 ? mKeyCounters[key] : 0;
+
+    for (const Zone &zone : mZones)
+    {
+        const SamplerZone &z = zone.params;
+        if (z.trigger != trigger ||
+            key < z.loKey || key > z.hiKey ||
+            velocity < z.loVelocity || velocity > z.hiVelocity)
+            continue;
+        if (z.seqLength > 1 && counter % z.seqLength != z.seqPosition - 1)
+            continue;
+
+        SoLoud::handle h = mSoloud->play(*zone.source, z.volume * velocity, z.pan, true);
+        if (h == 0)
+            continue;
+        mSoloud->setRelativePlaySpeed(h, powf(2.0f, (note - z.rootKey) / 12.0f));
+        if (trigger == SAMPLER_TRIGGER_ATTACK && z.loop != 0)
+        {
+            mSoloud->setLoopPoint(h, z.loopStart);
+            mSoloud->setLooping(h, true);
+        }
+        else
+        {
+            mSoloud->setLooping(h, false);
+        }
+        voices.push_back({h, z.release});
+    }
+
+    if (voices.size() == 1)
+    {
+        mSoloud->setPause(voices[0].handle, false);
+    }
+    else if (voices.size() > 1)
+    {
+        // unpausing a group is done with one lock of the audio thread, so
+        // the layers start on the same sample
+        SoLoud::handle group = mSoloud->createVoiceGroup();
+        if (group == 0)
+        {
+            for (const Voice &v : voices)
+                mSoloud->setPause(v.handle, false);
+            return;
+        }
+        for (const Voice &v : voices)
+            mSoloud->addVoiceToGroup(group, v.handle);
+        mSoloud->setPause(group, false);
+        mSoloud->destroyVoiceGroup(group);
+    }
+}
+
+void Sampler::prune()
+{
+    for (Note &n : mNotes)
+        n.voices.erase(std::remove_if(n.voices.begin(), n.voices.end(),
+                                      [this](const Voice &v)
+                                      { return !mSoloud->isValidVoiceHandle(v.handle); }),
+                       n.voices.end());
+    mNotes.erase(std::remove_if(mNotes.begin(), mNotes.end(),
+                                [](const Note &n)
+                                { return n.voices.empty(); }),
+                 mNotes.end());
+}
+
+SoLoud::handle Sampler::noteOn(float note, float velocity)
+{
+    velocity = velocity < 0.0f ? 0.0f : (velocity > 1.0f ? 1.0f : velocity);
+    // a retriggered note is cut without its release zones
+    for (auto it = mNotes.begin(); it != mNotes.end(); ++it)
+        if (it->note == note)
+        {
+            release(*it);
+            mNotes.erase(it);
+            break;
+        }
+    prune();
+
+    Note n = {note, velocity, {}};
+    startZones(SAMPLER_TRIGGER_ATTACK, note, velocity, n.voices);
+
+    const int key = (int)floorf(note + 0.5f);
+    if (key >= 0 && key < 128)
+        mKeyCounters[key]++;
+
+    if (n.voices.empty())
+        return 0;
+    SoLoud::handle first = n.voices[0].handle;
+    mNotes.push_back(n);
+    return first;
+}
+
+void Sampler::release(Note &note)
+{
+    for (const Voice &v : note.voices)
+    {
+        // the loop ends, the tail plays while fading out
+        mSoloud->setLooping(v.handle, false);
+        if (v.release > 0.0f)
+        {
+            mSoloud->fadeVolume(v.handle, 0.0f, v.release);
+            mSoloud->scheduleStop(v.handle, v.release);
+        }
+        else
+        {
+            mSoloud->stop(v.handle);
+        }
+    }
+}
+
+void Sampler::noteOff(float note)
+{
+    for (auto it = mNotes.begin(); it != mNotes.end(); ++it)
+    {
+        if (it->note != note)
+            continue;
+        release(*it);
+        std::vector<Voice> tails;
+        startZones(SAMPLER_TRIGGER_RELEASE, it->note, it->velocity, tails);
+        mNotes.erase(it);
+        return;
+    }
+}
+
+void Sampler::allNotesOff()
+{
+    for (Note &n : mNotes)
+        release(n);
+    mNotes.clear();
+}
+
+unsigned int Sampler::getActiveNotes()
+{
+    prune();
+    return (unsigned int)mNotes.size();
+}
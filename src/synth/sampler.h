@@ -0,0 +1,117 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "soloud.h"
+
+#include <vector>
+
+/// The zone will play when a note starts
+#define SAMPLER_TRIGGER_ATTACK 0
+/// The zone will play when a note is released
+#define SAMPLER_TRIGGER_RELEASE 1
+
+/// A sample mapped to a range of keys and velocities, as sent in batches
+/// through FFI. The layout is shared with Dart.
+typedef struct SamplerZone
+{
+    /// the sound to play, a loaded Wav
+    unsigned int soundHash;
+    /// MIDI key range, inclusive
+    int loKey;
+    int hiKey;
+    /// velocity range from 0 to 1, inclusive
+    float loVelocity;
+    float hiVelocity;
+    /// the key which plays the sample at its original speed
+    float rootKey;
+    float volume;
+    float pan;
+    /// if not 0, loop from [loopStart] seconds to the end while the note
+    /// is held
+    unsigned int loop;
+    float loopStart;
+    /// fade out time in seconds after the note is released
+    float release;
+    /// [SAMPLER_TRIGGER_ATTACK] or [SAMPLER_TRIGGER_RELEASE]
+    unsigned int trigger;
+    /// round robin: if [seqLength] is greater than 1 the zone plays only
+    /// on the [seqPosition]th (from 1) of every [seqLength] notes of a key
+    unsigned int seqLength;
+    unsigned int seqPosition;
+} SamplerZone_t;
+
+/// A multi-sample instrument.
+///
+/// A note starts the zones matching its key and velocity in one call:
+/// the voices are created paused, pitched with the relative play speed,
+/// so the resampler of the engine transposes them, and unpaused together.
+class Sampler
+{
+public:
+    Sampler(SoLoud::Soloud *soloud, unsigned int id);
+
+    unsigned int getId() const { return mId; }
+
+    /// @brief add [count] zones. [sources] are the sounds of [zones],
+    /// resolved by the caller.
+    /// @return false if a zone is not valid. The others are added anyway.
+    bool addZones(const SamplerZone *zones,
+                  SoLoud::AudioSource *const *sources,
+                  unsigned int count);
+
+    void clearZones();
+
+    /// @brief remove the zones playing [source]. Used when it is disposed.
+    void removeSource(SoLoud::AudioSource *source);
+
+    /// @brief start the zones of [note]. A note already playing is
+    /// released first.
+    /// @param note MIDI note number, can be fractional.
+    /// @param velocity 0 to 1.
+    /// @return the handle of the first voice started, 0 if no zone matches.
+    SoLoud::handle noteOn(float note, float velocity);
+
+    /// @brief release [note] and start its release zones.
+    void noteOff(float note);
+
+    void allNotesOff();
+
+    /// @brief the number of notes held and still sounding.
+    unsigned int getActiveNotes();
+
+private:
+    struct Zone
+    {
+        SamplerZone params;
+        SoLoud::AudioSource *source;
+    };
+
+    struct Voice
+    {
+        SoLoud::handle handle;
+        /// fade out time of its zone
+        float release;
+    };
+
+    struct Note
+    {
+        float note;
+        float velocity;
+        std::vector<Voice> voices;
+    };
+
+    /// @brief start the zones with [trigger] matching [note] and [velocity].
+    void startZones(unsigned int trigger, float note, float velocity, std::vector<Voice> &voices);
+    void release(Note &note);
+    /// @brief forget the notes whose voices have all ended.
+    void prune();
+
+    SoLoud::Soloud *mSoloud;
+    unsigned int mId;
+    std::vector<Zone> mZones;
+    std::vector<Note> mNotes;
+    /// notes started on each key, for the round robin
+    unsigned int mKeyCounters[128];
+};
+
+#endif // SAMPLER_H
@@ -0,0 +1,161 @@
+#include "sfxr_sample.h"
+
+#include <cstring>
+
+namespace
+{
+    /// FNV-1a over the bytes of one field at a time, skipping the padding
+    /// of the struct
+    template <typename T>
+    void hashField(uint64_t &hash, const T &field)
+    {
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, &field, sizeof(T));
+        for (unsigned char b : bytes)
+        {
+            hash ^= b;
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    void renderSfxr(SoLoud::SfxrParams params, SfxrRender *out)
+    {
+        SoLoud::Sfxr sfxr;
+        sfxr.mParams = params;
+        std::unique_ptr<SoLoud::AudioSourceInstance> instance(sfxr.createInstance());
+        instance->init(sfxr, 0);
+
+        const size_t maxSamples = (size_t)(sfxr.mBaseSamplerate * SFXR_MAX_SECONDS);
+        float block[SAMPLE_GRANULARITY];
+        while (!instance->hasEnded() && out->samples.size() < maxSamples)
+        {
+            const unsigned int n = instance->getAudio(block, SAMPLE_GRANULARITY, SAMPLE_GRANULARITY);
+            out->samples.insert(out->samples.end(), block, block + n);
+            if (n < SAMPLE_GRANULARITY)
+                break;
+        }
+        out->ready.store(true);
+    }
+}
+
+/////////////////////////////////////////
+/// SfxrSampleInstance
+/////////////////////////////////////////
+
+SfxrSampleInstance::SfxrSampleInstance(SfxrSample *aParent)
+    : mRender(aParent->mRender),
+      mOffset(0)
+{
+}
+
+unsigned int SfxrSampleInstance::getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int /*aBufferSize*/)
+{
+    // wait in silence for the rendering
+    if (!mRender->ready.load())
+    {
+        memset(aBuffer, 0, aSamplesToRead * sizeof(float));
+        return aSamplesToRead;
+    }
+
+    const std::vector<float> &samples = mRender->samples;
+    unsigned int n = (unsigned int)samples.size() - mOffset;
+    if (n > aSamplesToRead)
+        n = aSamplesToRead;
+    memcpy(aBuffer, samples.data() + mOffset, n * sizeof(float));
+    mOffset += n;
+    return n;
+}
+
+SoLoud::result SfxrSampleInstance::rewind()
+{
+    mOffset = 0;
+    mStreamPosition = 0.0f;
+    return SoLoud::SO_NO_ERROR;
+}
+
+bool SfxrSampleInstance::hasEnded()
+{
+    return mRender->ready.load() && mOffset >= mRender->samples.size();
+}
+
+/////////////////////////////////////////
+/// SfxrSample
+/////////////////////////////////////////
+
+SfxrSample::SfxrSample(const SoLoud::SfxrParams &params)
+    : mRender(std::make_shared<SfxrRender>())
+{
+    SoLoud::Sfxr sfxr;
+    mBaseSamplerate = sfxr.mBaseSamplerate;
+    mChannels = 1;
+    mRendered = std::async(std::launch::async, renderSfxr, params, mRender.get()).share();
+}
+
+SfxrSample::~SfxrSample()
+{
+    stop();
+    mRendered.wait();
+}
+
+double SfxrSample::getLength()
+{
+    mRendered.wait();
+    return mRender->samples.size() / (double)mBaseSamplerate;
+}
+
+uint64_t SfxrSample::hashParams(const SoLoud::SfxrParams &params)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashField(hash, params.wave_type);
+    hashField(hash, params.p_base_freq);
+    hashField(hash, params.p_freq_limit);
+    hashField(hash, params.p_freq_ramp);
+    hashField(hash, params.p_freq_dramp);
+    hashField(hash, params.p_duty);
+    hashField(hash, params.p_duty_ramp);
+    hashField(hash, params.p_vib_strength);
+    hashField(hash, params.p_vib_speed);
+    hashField(hash, params.p_vib_delay);
+    hashField(hash, params.p_env_attack);
+    hashField(hash, params.p_env_sustain);
+    hashField(hash, params.p_env_decay);
+    hashField(hash, params.p_env_punch);
+    hashField(hash, params.filter_on);
+    hashField(hash, params.p_lpf_resonance);
+    hashField(hash, params.p_lpf_freq);
+    hashField(hash, params.p_lpf_ramp);
+    hashField(hash, params.p_hpf_freq);
+    hashField(hash, params.p_hpf_ramp);
+    hashField(hash, params.p_pha_offset);
+    hashField(hash, params.p_pha_ramp);
+    hashField(hash, params.p_repeat_speed);
+    hashField(hash, params.p_arp_speed);
+    hashField(hash, params.p_arp_mod);
+    hashField(hash, params.master_vol);
+    hashField(hash, params.sound_vol);
+    return hash;
+}
+
+SoLoud::SfxrParams SfxrSample::paramsFromValues(int waveType, const float *values)
+{
+    SoLoud::Sfxr sfxr;
+    SoLoud::SfxrParams params = sfxr.mParams;
+    float *fields[SFXR_PARAM_COUNT] = {
+        &params.p_base_freq, &params.p_freq_limit, &params.p_freq_ramp,
+        &params.p_freq_dramp, &params.p_duty, &params.p_duty_ramp,
+        &params.p_vib_strength, &params.p_vib_speed, &params.p_vib_delay,
+        &params.p_env_attack, &params.p_env_sustain, &params.p_env_decay,
+        &params.p_env_punch, &params.p_lpf_resonance, &params.p_lpf_freq,
+        &params.p_lpf_ramp, &params.p_hpf_freq, &params.p_hpf_ramp,
+        &params.p_pha_offset, &params.p_pha_ramp, &params.p_repeat_speed,
+        &params.p_arp_speed, &params.p_arp_mod, &params.sound_vol};
+    params.wave_type = waveType;
+    for (int i = 0; i < SFXR_PARAM_COUNT; i++)
+        *fields[i] = values[i];
+    return params;
+}
+
+SoLoud::AudioSourceInstance *SfxrSample::createInstance()
+{
+    return new SfxrSampleInstance(this);
+}
@@ -0,0 +1,76 @@
+#ifndef SFXR_SAMPLE_H
+#define SFXR_SAMPLE_H
+
+#include "soloud.h"
+#include "soloud_sfxr.h"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+/// Longest effect rendered, in seconds. sfxr effects end with their volume
+/// envelope, this only bounds pathological parameters.
+#define SFXR_MAX_SECONDS 30
+
+/// Values of a parameter set passed by [SfxrSample::paramsFromValues]
+#define SFXR_PARAM_COUNT 24
+
+/// The PCM of an effect, written once by the rendering thread.
+struct SfxrRender
+{
+    std::vector<float> samples;
+    /// set after [samples] is complete
+    std::atomic<bool> ready;
+
+    SfxrRender() : ready(false) {}
+};
+
+class SfxrSample;
+
+class SfxrSampleInstance : public SoLoud::AudioSourceInstance
+{
+public:
+    SfxrSampleInstance(SfxrSample *aParent);
+    virtual unsigned int getAudio(float *aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize);
+    virtual SoLoud::result rewind();
+    virtual bool hasEnded();
+
+private:
+    std::shared_ptr<SfxrRender> mRender;
+    unsigned int mOffset;
+};
+
+/// An sfxr effect rendered to PCM on a worker thread, so the audio thread
+/// only copies samples. Voices started before the rendering is done output
+/// silence until it is, which takes about a millisecond.
+class SfxrSample : public SoLoud::AudioSource
+{
+public:
+    /// @brief start rendering [params] on a new thread.
+    explicit SfxrSample(const SoLoud::SfxrParams &params);
+    virtual ~SfxrSample();
+
+    /// @return the length in seconds, waiting for the rendering.
+    double getLength();
+
+    /// @return a hash of all the fields of [params]: equal parameters
+    /// render the same samples.
+    static uint64_t hashParams(const SoLoud::SfxrParams &params);
+
+    /// @brief build the parameters of an effect from [SFXR_PARAM_COUNT]
+    /// values, in the order of [SoLoud::SfxrParams] from [p_base_freq] to
+    /// [p_arp_mod], then [sound_vol]. The others keep their defaults.
+    /// @param waveType 0 square, 1 sawtooth, 2 sine, 3 noise.
+    static SoLoud::SfxrParams paramsFromValues(int waveType, const float *values);
+
+    virtual SoLoud::AudioSourceInstance *createInstance();
+
+    std::shared_ptr<SfxrRender> mRender;
+
+private:
+    std::shared_future<void> mRendered;
+};
+
+#endif // SFXR_SAMPLE_H
@@ -0,0 +1,188 @@
+#include "wavetable.h"
+#include "soloud_misc.h"
+#include "soloud_fft.h"
+
+#include <math.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    /// the waveform is sampled this many times finer than the tables to
+    /// compute its harmonics, so the steps of square and saw don't alias
+    const unsigned int kOversample = 8;
+    const unsigned int kWaveforms = SoLoud::Soloud::WAVE_FSAW + 1;
+
+    std::once_flag gOnce[kWaveforms];
+    std::unique_ptr<Wavetable> gTables[kWaveforms];
+
+#ifdef SOLOUD_SSE_INTRINSICS
+    /// wrap the phases to [0, 1). A negative step makes them negative, and
+    /// truncating rounds those up, so they are moved one down
+    inline __m128 wrapPhases(__m128 p)
+    {
+        __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(p));
+        whole = _mm_sub_ps(whole, _mm_and_ps(_mm_cmplt_ps(p, whole), _mm_set1_ps(1.0f)));
+        return _mm_sub_ps(p, whole);
+    }
+#endif
+}
+
+const Wavetable *Wavetable::get(int waveform)
+{
+    if (waveform < 0 || waveform >= (int)kWaveforms)
+        waveform = SoLoud::Soloud::WAVE_SQUARE;
+    std::call_once(gOnce[waveform], [waveform]()
+                   { gTables[waveform].reset(new Wavetable(waveform)); });
+    return gTables[waveform].get();
+}
+
+Wavetable::Wavetable(int waveform)
+{
+    const unsigned int samples = WAVETABLE_SIZE * kOversample;
+
+    // spectrum of the oversampled naive waveform, as interleaved complex
+    std::vector<float> spectrum(samples * 2, 0.0f);
+    for (unsigned int n = 0; n < samples; n++)
+        spectrum[n * 2] = SoLoud::Misc::generateWaveform(waveform, (float)n / samples);
+    SoLoud::FFT::fft(spectrum.data(), samples * 2);
+
+    // each table is the inverse of the harmonics it keeps, resized to the
+    // table length: the bins are scaled from one length to the other
+    mData = new float[WAVETABLE_LEVELS * (WAVETABLE_SIZE + 2)];
+    std::vector<float> bins(WAVETABLE_SIZE * 2);
+    const float scale = (float)WAVETABLE_SIZE / samples;
+    for (unsigned int level = 0; level < WAVETABLE_LEVELS; level++)
+    {
+        unsigned int top = (WAVETABLE_SIZE / 2) >> level;
+        if (top >= WAVETABLE_SIZE / 2)
+            top = WAVETABLE_SIZE / 2 - 1;
+
+        std::fill(bins.begin(), bins.end(), 0.0f);
+        for (unsigned int k = 0; k <= top; k++)
+        {
+            bins[k * 2] = spectrum[k * 2] * scale;
+            bins[k * 2 + 1] = spectrum[k * 2 + 1] * scale;
+            if (k == 0)
+                continue;
+            const unsigned int mirror = WAVETABLE_SIZE - k;
+            bins[mirror * 2] = spectrum[(samples - k) * 2] * scale;
+            bins[mirror * 2 + 1] = spectrum[(samples - k) * 2 + 1] * scale;
+        }
+        SoLoud::FFT::ifft(bins.data(), WAVETABLE_SIZE * 2);
+
+        float *table = mData + level * (WAVETABLE_SIZE + 2);
+        for (unsigned int n = 0; n < WAVETABLE_SIZE; n++)
+            table[n] = bins[n * 2];
+        table[WAVETABLE_SIZE] = table[0];
+        table[WAVETABLE_SIZE + 1] = table[1];
+    }
+}
+
+Wavetable::~Wavetable()
+{
+    delete[] mData;
+}
+
+const float *Wavetable::getLevel(float phaseStep) const
+{
+    const float step = fabsf(phaseStep);
+    unsigned int level = 0;
+    while (level < WAVETABLE_LEVELS - 1 &&
+           (float)((WAVETABLE_SIZE / 2) >> level) * step >= 0.5f)
+        level++;
+    return mData + level * (WAVETABLE_SIZE + 2);
+}
+
+float Wavetable::render(const float *table, float phase, float phaseStep, float *out, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef SOLOUD_SSE_INTRINSICS
+    // 4 consecutive samples per lane
+    __m128 p = _mm_setr_ps(phase, phase + phaseStep, phase + 2 * phaseStep, phase + 3 * phaseStep);
+    const __m128 step4 = _mm_set1_ps(4 * phaseStep);
+    const __m128 size = _mm_set1_ps((float)WAVETABLE_SIZE);
+    alignas(16) int index[4];
+    alignas(16) float a[4], b[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        p = wrapPhases(p);
+        const __m128 pos = _mm_mul_ps(p, size);
+        const __m128i whole = _mm_cvttps_epi32(pos);
+        const __m128 frac = _mm_sub_ps(pos, _mm_cvtepi32_ps(whole));
+        _mm_store_si128((__m128i *)index, whole);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            a[lane] = table[index[lane]];
+            b[lane] = table[index[lane] + 1];
+        }
+        const __m128 va = _mm_load_ps(a);
+        _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b), va), frac)));
+        p = _mm_add_ps(p, step4);
+    }
+    alignas(16) float last[4];
+    _mm_store_ps(last, p);
+    phase = last[0];
+#endif
+    for (; i < count; i++)
+    {
+        phase -= floorf(phase);
+        out[i] = sample(table, phase);
+        phase += phaseStep;
+    }
+    return phase - floorf(phase);
+}
+
+void Wavetable::render4(const float *const tables[4], float phases[4], const float steps[4],
+                        const float gains[4], float *out, unsigned int count)
+{
+#ifdef SOLOUD_SSE_INTRINSICS
+    __m128 p = _mm_loadu_ps(phases);
+    const __m128 step = _mm_loadu_ps(steps);
+    const __m128 gain = _mm_loadu_ps(gains);
+    const __m128 size = _mm_set1_ps((float)WAVETABLE_SIZE);
+    alignas(16) int index[4];
+    alignas(16) float a[4], b[4];
+    for (unsigned int i = 0; i < count; i++)
+    {
+        p = wrapPhases(p);
+        const __m128 pos = _mm_mul_ps(p, size);
+        const __m128i whole = _mm_cvttps_epi32(pos);
+        const __m128 frac = _mm_sub_ps(pos, _mm_cvtepi32_ps(whole));
+        _mm_store_si128((__m128i *)index, whole);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            a[lane] = tables[lane][index[lane]];
+            b[lane] = tables[lane][index[lane] + 1];
+        }
+        const __m128 va = _mm_load_ps(a);
+        __m128 v = _mm_mul_ps(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b), va), frac)), gain);
+        // horizontal sum of the lanes
+        v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+        _mm_store_ss(out + i, v);
+        p = _mm_add_ps(p, step);
+    }
+    p = wrapPhases(p);
+    _mm_storeu_ps(phases, p);
+#else
+    for (unsigned int i = 0; i < count; i++)
+    {
+        float v = 0.0f;
+        for (int lane = 0; lane < 4; lane++)
+        {
+            phases[lane] -= floorf(phases[lane]);
+            v += sample(tables[lane], phases[lane]) * gains[lane];
+            phases[lane] += steps[lane];
+        }
+        out[i] = v;
+    }
+    for (int lane = 0; lane < 4; lane++)
+        phases[lane] -= floorf(phases[lane]);
+#endif
+}
@@ -0,0 +1,57 @@
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include "soloud.h"
+
+/// Samples of one cycle of a table
+#define WAVETABLE_SIZE 2048
+/// Tables per waveform, each one with half the harmonics of the previous
+#define WAVETABLE_LEVELS 11
+
+/// Band-limited tables of the [SoLoud::Soloud::WAVEFORM] waveforms.
+///
+/// The harmonics of each waveform are computed once, then one table per
+/// octave keeps only the harmonics which fit in it: an oscillator reads
+/// the table whose highest harmonic is below Nyquist for its frequency,
+/// so it doesn't alias at high pitch. Reading is a linear interpolation,
+/// done 4 samples or 4 oscillators at a time with SSE where available.
+class Wavetable
+{
+public:
+    /// @brief the tables of [waveform], built on the first call. Building
+    /// takes some milliseconds: call it once out of the audio thread.
+    static const Wavetable *get(int waveform);
+
+    /// @brief the table for an oscillator advancing by [phaseStep] cycles
+    /// per sample.
+    const float *getLevel(float phaseStep) const;
+
+    /// @brief one sample of [table] at [phase] (0 to 1).
+    static inline float sample(const float *table, float phase)
+    {
+        const float pos = phase * WAVETABLE_SIZE;
+        const int index = (int)pos;
+        const float a = table[index];
+        return a + (table[index + 1] - a) * (pos - index);
+    }
+
+    /// @brief render [count] samples of an oscillator into [out].
+    /// @return the phase after the last sample.
+    static float render(const float *table, float phase, float phaseStep, float *out, unsigned int count);
+
+    /// @brief render the sum of 4 oscillators weighted by [gains] into
+    /// [out]. Each oscillator is a lane: [phases] are updated.
+    static void render4(const float *const tables[4], float phases[4], const float steps[4],
+                        const float gains[4], float *out, unsigned int count);
+
+    ~Wavetable();
+
+private:
+    Wavetable(int waveform);
+
+    /// [WAVETABLE_LEVELS] tables of [WAVETABLE_SIZE] + 2 samples, the last
+    /// two repeating the first ones for the interpolation
+    float *mData;
+};
+
+#endif // WAVETABLE_H
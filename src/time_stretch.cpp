@@ -0,0 +1,422 @@
+#include "time_stretch.h"
+#include "soloud_fft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const float kStretchPi = 3.14159265358979323846f;
+    const float kStretchTwoPi = 2.0f * kStretchPi;
+
+    float dot(const float *a, const float *b, unsigned int n)
+    {
+        unsigned int i = 0;
+        float sum = 0.0f;
+#ifdef SOLOUD_SSE_INTRINSICS
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 4 <= n; i += 4)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, acc);
+        sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (; i < n; i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    /// out += in * window * gain
+    void overlapAdd(float *out, const float *in, const float *window, unsigned int n, float gain)
+    {
+        unsigned int i = 0;
+#ifdef SOLOUD_SSE_INTRINSICS
+        const __m128 g = _mm_set1_ps(gain);
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 w = _mm_mul_ps(_mm_loadu_ps(window + i), g);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), w)));
+        }
+#endif
+        for (; i < n; i++)
+            out[i] += in[i] * window[i] * gain;
+    }
+
+    float wrapPhase(float phase)
+    {
+        return phase - kStretchTwoPi * floorf((phase + kStretchPi) / kStretchTwoPi);
+    }
+}
+
+TimeStretch::TimeStretch(TimeStretchMode mode, unsigned int channels, float samplerate)
+    : mMode(mode),
+      mChannels(channels < 1 ? 1 : (channels > MAX_CHANNELS ? MAX_CHANNELS : channels)),
+      mTempo(1.0f),
+      mPitch(1.0f),
+      mLoad(0.0f)
+{
+    // about 20 ms, a period of the lowest voices
+    unsigned int base = 256;
+    while (base < samplerate * 0.02f && base < 2048)
+        base *= 2;
+
+    if (mMode == TIME_STRETCH_PHASE_VOCODER)
+    {
+        mFrame = base * 2;
+        mHop = mFrame / 4;
+        mTolerance = 0;
+    }
+    else
+    {
+        mMode = TIME_STRETCH_WSOLA;
+        mFrame = base;
+        mHop = mFrame / 2;
+        mTolerance = mFrame / 4;
+    }
+
+    mWindow.resize(mFrame);
+    for (unsigned int n = 0; n < mFrame; n++)
+        mWindow[n] = 0.5f - 0.5f * cosf(kStretchTwoPi * n / mFrame);
+
+    // a window, the search on both sides, the reference after the window
+    // and a block read past it
+    mCapacity = mFrame * 2 + mTolerance * 2 + SAMPLE_GRANULARITY;
+    mInput.resize(mCapacity * mChannels);
+    mMono.resize(mCapacity);
+    mScratch.resize(SAMPLE_GRANULARITY * MAX_CHANNELS);
+    mReference.resize(mFrame - mHop);
+    mAccumulator.resize(mFrame * mChannels);
+    mOutput.resize(mHop * mChannels);
+
+    if (mMode == TIME_STRETCH_PHASE_VOCODER)
+    {
+        const unsigned int bins = mFrame / 2 + 1;
+        mSpectrum.resize(mFrame * 2);
+        mMagnitude.resize(bins);
+        mPhase.resize(bins);
+        mLastPhase.resize(bins * mChannels);
+        mSynthPhase.resize(bins * mChannels);
+        mPeaks.reserve(bins);
+    }
+    reset();
+}
+
+void TimeStretch::reset()
+{
+    // the source starts after silence, so that its first sample is in as
+    // many windows as the others; the output of that silence is dropped
+    mInputLength = mFrame - mHop + mTolerance;
+    std::fill(mInput.begin(), mInput.end(), 0.0f);
+    std::fill(mMono.begin(), mMono.end(), 0.0f);
+    std::fill(mAccumulator.begin(), mAccumulator.end(), 0.0f);
+    mPosition = mTolerance;
+    mSkip = mFrame - mHop;
+    mPrevious = 0;
+    mHasReference = false;
+    mHasPhase = false;
+    mOutputRead = 0;
+    mOutputLength = 0;
+}
+
+float TimeStretch::getPitch()
+{
+    return mPitch;
+}
+
+float TimeStretch::getTempo()
+{
+    return mTempo;
+}
+
+void TimeStretch::setTempo(float tempo)
+{
+    mTempo = tempo < 0.25f ? 0.25f : (tempo > 4.0f ? 4.0f : tempo);
+}
+
+void TimeStretch::setPitch(float semitones)
+{
+    semitones = semitones < -24.0f ? -24.0f : (semitones > 24.0f ? 24.0f : semitones);
+    mPitch = powf(2.0f, semitones / 12.0f);
+}
+
+void TimeStretch::fill(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice, unsigned int end)
+{
+    if (end > mCapacity)
+        end = mCapacity;
+    const float monoGain = 1.0f / mChannels;
+    while (mInputLength < end)
+    {
+        unsigned int n = end - mInputLength;
+        if (n > SAMPLE_GRANULARITY)
+            n = SAMPLE_GRANULARITY;
+        const unsigned int read = aSoloud->getVoiceAudio_internal(aVoice, mScratch.data(), n, SAMPLE_GRANULARITY);
+
+        float *mono = mMono.data() + mInputLength;
+        memset(mono, 0, n * sizeof(float));
+        for (unsigned int c = 0; c < mChannels; c++)
+        {
+            const float *src = mScratch.data() + (c < aVoice->mChannels ? c : 0) * SAMPLE_GRANULARITY;
+            float *dst = mInput.data() + c * mCapacity + mInputLength;
+            memcpy(dst, src, read * sizeof(float));
+            memset(dst + read, 0, (n - read) * sizeof(float));
+            for (unsigned int i = 0; i < read; i++)
+                mono[i] += dst[i] * monoGain;
+        }
+        mInputLength += n;
+    }
+}
+
+void TimeStretch::discard(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice, unsigned int keep)
+{
+    if (keep == 0)
+        return;
+    if (keep <= mInputLength)
+    {
+        const unsigned int left = mInputLength - keep;
+        for (unsigned int c = 0; c < mChannels; c++)
+        {
+            float *data = mInput.data() + c * mCapacity;
+            memmove(data, data + keep, left * sizeof(float));
+        }
+        memmove(mMono.data(), mMono.data() + keep, left * sizeof(float));
+        mInputLength = left;
+    }
+    else
+    {
+        // fast tempos skip source the previous windows never reached
+        unsigned int skip = keep - mInputLength;
+        while (skip > 0)
+        {
+            const unsigned int n = skip > SAMPLE_GRANULARITY ? SAMPLE_GRANULARITY : skip;
+            aSoloud->getVoiceAudio_internal(aVoice, mScratch.data(), n, SAMPLE_GRANULARITY);
+            skip -= n;
+        }
+        mInputLength = 0;
+    }
+    mPosition -= keep;
+    mPrevious -= keep;
+}
+
+unsigned int TimeStretch::wsolaSearch(unsigned int pos)
+{
+    if (!mHasReference)
+        return pos;
+
+    // normalized cross-correlation with what followed the previous window,
+    // on every other offset first, then on the neighbours of the best one
+    const unsigned int length = mFrame - mHop;
+    const unsigned int first = pos - mTolerance;
+    const unsigned int last = pos + mTolerance;
+    const float *mono = mMono.data();
+    const float *reference = mReference.data();
+
+    double energy = 0.0;
+    for (unsigned int i = 0; i < length; i++)
+        energy += (double)mono[first + i] * mono[first + i];
+
+    unsigned int best = pos;
+    float bestScore = -1e30f;
+    for (unsigned int c = first; c <= last; c += 2)
+    {
+        const float score = dot(mono + c, reference, length) / sqrtf((float)energy + 1e-9f);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = c;
+        }
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            energy -= (double)mono[c + i] * mono[c + i];
+            energy += (double)mono[c + length + i] * mono[c + length + i];
+        }
+        if (energy < 0.0)
+            energy = 0.0;
+    }
+
+    const unsigned int center = best;
+    for (int side = -1; side <= 1; side += 2)
+    {
+        if ((side < 0 && center == first) || (side > 0 && center == last))
+            continue;
+        const unsigned int c = center + side;
+        const float score = dot(mono + c, reference, length) / sqrtf(dot(mono + c, mono + c, length) + 1e-9f);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+void TimeStretch::vocoderFrame(unsigned int pos, unsigned int analysisHop)
+{
+    const unsigned int n = mFrame;
+    const unsigned int bins = n / 2 + 1;
+    // a Hann window at a quarter overlap, applied twice, sums to 1.5
+    const float gain = 1.0f / 1.5f;
+    float *spectrum = mSpectrum.data();
+
+    for (unsigned int c = 0; c < mChannels; c++)
+    {
+        const float *input = mInput.data() + c * mCapacity + pos;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            spectrum[i * 2] = input[i] * mWindow[i];
+            spectrum[i * 2 + 1] = 0.0f;
+        }
+        SoLoud::FFT::fft(spectrum, n * 2);
+
+        mPeaks.clear();
+        for (unsigned int k = 0; k < bins; k++)
+        {
+            const float re = spectrum[k * 2];
+            const float im = spectrum[k * 2 + 1];
+            mMagnitude[k] = sqrtf(re * re + im * im);
+            mPhase[k] = atan2f(im, re);
+        }
+        for (unsigned int k = 1; k + 1 < bins; k++)
+            if (mMagnitude[k] > mMagnitude[k - 1] && mMagnitude[k] >= mMagnitude[k + 1])
+                mPeaks.push_back(k);
+        if (mPeaks.empty())
+            for (unsigned int k = 0; k < bins; k++)
+                mPeaks.push_back(k);
+
+        float *lastPhase = mLastPhase.data() + c * bins;
+        float *synthPhase = mSynthPhase.data() + c * bins;
+
+        // the peaks advance by their measured frequency over the output hop
+        for (unsigned int p : mPeaks)
+        {
+            if (!mHasPhase)
+            {
+                synthPhase[p] = mPhase[p];
+                continue;
+            }
+            const float omega = kStretchTwoPi * p / n;
+            float frequency = omega;
+            if (analysisHop > 0)
+            {
+                const float deviation = wrapPhase(mPhase[p] - lastPhase[p] - omega * analysisHop);
+                frequency += deviation / analysisHop;
+            }
+            synthPhase[p] = wrapPhase(synthPhase[p] + frequency * mHop);
+        }
+
+        // the bins around a peak keep their phase relative to it
+        unsigned int peak = 0;
+        for (unsigned int k = 0; k < bins; k++)
+        {
+            while (peak + 1 < mPeaks.size() && k * 2 > mPeaks[peak] + mPeaks[peak + 1])
+                peak++;
+            const unsigned int p = mPeaks[peak];
+            if (k != p)
+                synthPhase[k] = wrapPhase(synthPhase[p] + mPhase[k] - mPhase[p]);
+            lastPhase[k] = mPhase[k];
+        }
+
+        for (unsigned int k = 0; k < bins; k++)
+        {
+            spectrum[k * 2] = mMagnitude[k] * cosf(synthPhase[k]);
+            spectrum[k * 2 + 1] = mMagnitude[k] * sinf(synthPhase[k]);
+        }
+        for (unsigned int k = 1; k < n / 2; k++)
+        {
+            spectrum[(n - k) * 2] = spectrum[k * 2];
+            spectrum[(n - k) * 2 + 1] = -spectrum[k * 2 + 1];
+        }
+        SoLoud::FFT::ifft(spectrum, n * 2);
+
+        // the real parts, packed at the start of the buffer
+        for (unsigned int i = 0; i < n; i++)
+            spectrum[i] = spectrum[i * 2];
+        overlapAdd(mAccumulator.data() + c * n, spectrum, mWindow.data(), n, gain);
+    }
+    mHasPhase = true;
+}
+
+void TimeStretch::frame(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice)
+{
+    const unsigned int pos = (unsigned int)mPosition;
+    const unsigned int overlap = mFrame - mHop;
+    fill(aSoloud, aVoice, pos + mTolerance + mFrame + (mMode == TIME_STRETCH_WSOLA ? overlap : 0));
+
+    if (mMode == TIME_STRETCH_WSOLA)
+    {
+        const unsigned int start = wsolaSearch(pos);
+        for (unsigned int c = 0; c < mChannels; c++)
+            overlapAdd(mAccumulator.data() + c * mFrame,
+                       mInput.data() + c * mCapacity + start,
+                       mWindow.data(), mFrame, 1.0f);
+        memcpy(mReference.data(), mMono.data() + start + mHop, overlap * sizeof(float));
+        mHasReference = true;
+    }
+    else
+    {
+        const long long hop = mHasPhase ? (long long)pos - mPrevious : 0;
+        vocoderFrame(pos, (unsigned int)hop);
+        mPrevious = pos;
+    }
+
+    for (unsigned int c = 0; c < mChannels; c++)
+    {
+        float *accumulator = mAccumulator.data() + c * mFrame;
+        memcpy(mOutput.data() + c * mHop, accumulator, mHop * sizeof(float));
+        memmove(accumulator, accumulator + mHop, overlap * sizeof(float));
+        memset(accumulator + overlap, 0, mHop * sizeof(float));
+    }
+    mOutputRead = 0;
+    mOutputLength = mHop;
+
+    mPosition += (double)mTempo / mPitch * mHop;
+    const double keep = floor(mPosition) - mTolerance;
+    discard(aSoloud, aVoice, keep > 0.0 ? (unsigned int)keep : 0);
+}
+
+unsigned int TimeStretch::process(SoLoud::Soloud *aSoloud,
+                                  SoLoud::AudioSourceInstance *aVoice,
+                                  float *aBuffer,
+                                  unsigned int aSamples,
+                                  unsigned int aBufferSize)
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    unsigned int written = 0;
+    while (written < aSamples)
+    {
+        if (mOutputRead == mOutputLength)
+        {
+            frame(aSoloud, aVoice);
+            continue;
+        }
+        unsigned int n = mOutputLength - mOutputRead;
+        if (n > aSamples - written)
+            n = aSamples - written;
+        if (mSkip > 0)
+        {
+            if (n > mSkip)
+                n = mSkip;
+            mSkip -= n;
+            mOutputRead += n;
+            continue;
+        }
+        for (unsigned int c = 0; c < aVoice->mChannels; c++)
+            memcpy(aBuffer + c * aBufferSize + written,
+                   mOutput.data() + (c < mChannels ? c : 0) * mHop + mOutputRead,
+                   n * sizeof(float));
+        written += n;
+        mOutputRead += n;
+    }
+
+    const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - begin;
+    const float duration = aSamples / (aVoice->mSamplerate * mPitch);
+    if (duration > 0.0f)
+        mLoad += (elapsed.count() / duration - mLoad) * 0.05f;
+    return aSamples;
+}
@@ -0,0 +1,131 @@
+#ifndef TIME_STRETCH_H
+#define TIME_STRETCH_H
+
+#include "soloud.h"
+
+#include <vector>
+
+typedef enum TimeStretchMode
+{
+    /// waveform similarity overlap-add, for speech
+    TIME_STRETCH_WSOLA,
+    /// phase vocoder with identity phase locking, for music
+    TIME_STRETCH_PHASE_VOCODER
+} TimeStretchMode_t;
+
+/// Changes the tempo of a voice without changing its pitch, and its pitch
+/// without changing its tempo.
+///
+/// The source of the voice is read at [tempo] / [pitch] times the speed of
+/// the processed data, which the resampler of the engine then plays
+/// [pitch] times faster. Both stack on the relative play speed of the voice.
+///
+/// WSOLA overlap-adds windows of about 20 ms of the source, each one
+/// shifted by up to a quarter of a window to best match the previous one,
+/// which keeps the periods of a voice intact. The phase vocoder rebuilds
+/// windows 4 times longer from their spectrum, advancing the phase of each
+/// peak by its measured frequency and locking the bins around it, which
+/// keeps the harmonics of music in tune.
+///
+/// The correlation search, the windowing and the overlap-add are done 4
+/// samples at a time with SSE where available.
+class TimeStretch : public SoLoud::VoiceProcessor
+{
+public:
+    /// @param channels the channels of the voice.
+    /// @param samplerate the base samplerate of the voice, to size the
+    /// windows.
+    TimeStretch(TimeStretchMode mode, unsigned int channels, float samplerate);
+
+    virtual unsigned int process(SoLoud::Soloud *aSoloud,
+                                 SoLoud::AudioSourceInstance *aVoice,
+                                 float *aBuffer,
+                                 unsigned int aSamples,
+                                 unsigned int aBufferSize);
+    virtual float getPitch();
+    virtual float getTempo();
+    virtual void reset();
+
+    TimeStretchMode getMode() const { return mMode; }
+
+    /// The setters and [getLoad] must be called with the audio mutex locked
+    /// once the stretcher is set to a voice.
+
+    /// @brief set the speed of the source, from 0.25 to 4.
+    void setTempo(float tempo);
+    /// @brief set the transposition in semitones, from -24 to 24.
+    void setPitch(float semitones);
+
+    /// @brief the time spent processing divided by the duration of the
+    /// audio produced, averaged over the last blocks. 0.01 means 1% of a
+    /// core for this voice.
+    float getLoad() const { return mLoad; }
+
+private:
+    /// @brief make sure the input holds [end] samples from its start,
+    /// reading the source. Past its end the source is read as silence.
+    void fill(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice, unsigned int end);
+    /// @brief drop the input before [keep], reading the source if it is
+    /// past the samples read so far.
+    void discard(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice, unsigned int keep);
+    /// @brief overlap-add the next window and move [mHop] finished samples
+    /// to the output.
+    void frame(SoLoud::Soloud *aSoloud, SoLoud::AudioSourceInstance *aVoice);
+    /// @return the start of the window of the source to add, near [pos].
+    unsigned int wsolaSearch(unsigned int pos);
+    void vocoderFrame(unsigned int pos, unsigned int analysisHop);
+
+    TimeStretchMode mMode;
+    unsigned int mChannels;
+    /// window length in samples
+    unsigned int mFrame;
+    /// output samples per window
+    unsigned int mHop;
+    /// WSOLA search range on each side
+    unsigned int mTolerance;
+
+    float mTempo;
+    float mPitch;
+
+    /// source samples of each channel, mCapacity apart
+    std::vector<float> mInput;
+    /// mean of the channels of [mInput], for the WSOLA search
+    std::vector<float> mMono;
+    unsigned int mCapacity;
+    unsigned int mInputLength;
+    /// position of the next window in [mInput]
+    double mPosition;
+    /// start of the previous phase vocoder window in [mInput], negative
+    /// once dropped
+    long long mPrevious;
+    /// source samples read by [fill], one block of each channel
+    std::vector<float> mScratch;
+
+    /// what follows the previous WSOLA window, the target of the search
+    std::vector<float> mReference;
+    bool mHasReference;
+
+    std::vector<float> mWindow;
+    /// overlap-add accumulator of each channel, [mFrame] apart
+    std::vector<float> mAccumulator;
+    /// finished samples of each channel, [mHop] apart
+    std::vector<float> mOutput;
+    unsigned int mOutputRead;
+    unsigned int mOutputLength;
+    /// output samples to drop: the first ones lack the windows overlapping
+    /// them
+    unsigned int mSkip;
+
+    /// phase vocoder state of each channel, [mFrame] / 2 + 1 bins apart
+    std::vector<float> mSpectrum;
+    std::vector<float> mMagnitude;
+    std::vector<float> mPhase;
+    std::vector<float> mLastPhase;
+    std::vector<float> mSynthPhase;
+    std::vector<unsigned int> mPeaks;
+    bool mHasPhase;
+
+    float mLoad;
+};
+
+#endif // TIME_STRETCH_H
@@ -0,0 +1,196 @@
+#include "timeline.h"
+
+#include <algorithm>
+
+namespace
+{
+    /// std heap functions build a max-heap: the "greatest" element is
+    /// the one which has to run first
+    struct RunsLater
+    {
+        bool operator()(const TimelineEvent &a, const TimelineEvent &b) const
+        {
+            if (a.time != b.time)
+                return a.time > b.time;
+            return a.order > b.order;
+        }
+    };
+
+    /// samples mixed before trying again when another thread holds the
+    /// queue
+    const unsigned int kRetrySamples = 64;
+}
+
+Timeline::Timeline(SoLoud::Soloud *soloud)
+    : mSoloud(soloud),
+      mOrder(0),
+      mNextId(1),
+      mTime(0)
+{
+    mQueue.reserve(256);
+    for (unsigned int i = 0; i < FIRED_SLOTS; i++)
+    {
+        mFired[i].id = 0;
+        mFired[i].handle = 0;
+        mFired[i].source = nullptr;
+    }
+}
+
+unsigned int Timeline::mixCallback(void *aUserData, unsigned long long aSampleTime, unsigned int aSamples)
+{
+    return static_cast<Timeline *>(aUserData)->onMix(aSampleTime, aSamples);
+}
+
+unsigned long long Timeline::getTime()
+{
+    return mTime.load();
+}
+
+unsigned int Timeline::schedule(TimelineEvent event)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    event.id = mNextId++;
+    // 0 is never a valid id
+    if (mNextId == 0)
+        mNextId = 1;
+    event.order = mOrder++;
+    mQueue.push_back(event);
+    std::push_heap(mQueue.begin(), mQueue.end(), RunsLater());
+    return event.id;
+}
+
+bool Timeline::cancel(unsigned int eventId)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = std::find_if(mQueue.begin(), mQueue.end(),
+                           [eventId](const TimelineEvent &e)
+                           { return e.id == eventId; });
+    if (it == mQueue.end())
+        return false;
+    mQueue.erase(it);
+    std::make_heap(mQueue.begin(), mQueue.end(), RunsLater());
+    return true;
+}
+
+void Timeline::cancelSource(SoLoud::AudioSource *source)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueue.erase(std::remove_if(mQueue.begin(), mQueue.end(),
+                                [source](const TimelineEvent &e)
+                                { return e.source == source; }),
+                 mQueue.end());
+    std::make_heap(mQueue.begin(), mQueue.end(), RunsLater());
+}
+
+void Timeline::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueue.clear();
+}
+
+void Timeline::addListener(TimelineListener *listener)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mListeners.push_back(listener);
+}
+
+void Timeline::removeListener(TimelineListener *listener)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mListeners.erase(std::remove(mListeners.begin(), mListeners.end(), listener),
+                     mListeners.end());
+}
+
+SoLoud::handle Timeline::getPlayedHandle(unsigned int eventId, SoLoud::AudioSource **source)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    const FiredPlay &fired = mFired[eventId % FIRED_SLOTS];
+    if (fired.id != eventId)
+        return 0;
+    if (source != nullptr)
+        *source = fired.source;
+    return fired.handle;
+}
+
+unsigned int Timeline::onMix(unsigned long long aSampleTime, unsigned int aSamples)
+{
+    // the mixer never waits for a thread scheduling events: what is due is
+    // run with a later segment
+    std::unique_lock<std::mutex> lock(mMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        const unsigned int samples = std::min(aSamples, kRetrySamples);
+        mTime.store(aSampleTime + samples);
+        return samples;
+    }
+
+    while (!mQueue.empty() && mQueue.front().time <= aSampleTime)
+    {
+        std::pop_heap(mQueue.begin(), mQueue.end(), RunsLater());
+        TimelineEvent event = mQueue.back();
+        mQueue.pop_back();
+        run(event);
+    }
+
+    // mix up to the next event
+    unsigned int samples = aSamples;
+    if (!mQueue.empty() && mQueue.front().time < aSampleTime + aSamples)
+        samples = (unsigned int)(mQueue.front().time - aSampleTime);
+
+    for (TimelineListener *listener : mListeners)
+    {
+        unsigned int next = listener->onTimeline(aSampleTime, samples);
+        if (next > 0 && next < samples)
+            samples = next;
+    }
+
+    mTime.store(aSampleTime + samples);
+    return samples;
+}
+
+void Timeline::run(const TimelineEvent &event)
+{
+    SoLoud::handle handle = event.handle;
+    if (event.playEventId != 0)
+    {
+        const FiredPlay &fired = mFired[event.playEventId % FIRED_SLOTS];
+        // the play event has not been run (or was cancelled)
+        if (fired.id != event.playEventId)
+            return;
+        handle = fired.handle;
+    }
+
+    switch (event.action)
+    {
+    case TIMELINE_PLAY:
+    {
+        handle = mSoloud->play(*event.source, event.value, event.pan);
+        FiredPlay &fired = mFired[event.id % FIRED_SLOTS];
+        fired.id = event.id;
+        fired.handle = handle;
+        fired.source = event.source;
+        break;
+    }
+    case TIMELINE_STOP:
+        mSoloud->stop(handle);
+        break;
+    case TIMELINE_PAUSE:
+        mSoloud->setPause(handle, event.value != 0.0f);
+        break;
+    case TIMELINE_VOLUME:
+        mSoloud->setVolume(handle, event.value);
+        break;
+    case TIMELINE_PAN:
+        mSoloud->setPan(handle, event.value);
+        break;
+    case TIMELINE_RELATIVE_SPEED:
+        mSoloud->setRelativePlaySpeed(handle, event.value);
+        break;
+    case TIMELINE_SEEK:
+        mSoloud->seek(handle, event.value);
+        break;
+    case TIMELINE_FILTER_PARAM:
+        mSoloud->setFilterParameter(handle, event.filterId, event.attributeId, event.value);
+        break;
+    }
+}
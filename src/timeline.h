@@ -0,0 +1,129 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "soloud.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/// Actions which can be scheduled at an exact engine sample.
+typedef enum TimelineAction
+{
+    /// start [source] with [value] volume and [pan]
+    TIMELINE_PLAY,
+    TIMELINE_STOP,
+    /// pause if [value] is not 0, otherwise resume
+    TIMELINE_PAUSE,
+    TIMELINE_VOLUME,
+    TIMELINE_PAN,
+    TIMELINE_RELATIVE_SPEED,
+    /// seek to [value] seconds
+    TIMELINE_SEEK,
+    /// set the [attributeId] of the [filterId] filter slot to [value]
+    TIMELINE_FILTER_PARAM
+} TimelineAction_t;
+
+struct TimelineEvent
+{
+    /// engine time in samples
+    unsigned long long time;
+    /// keeps events with the same time in scheduling order
+    unsigned long long order;
+    unsigned int id;
+    TimelineAction action;
+    SoLoud::AudioSource *source;
+    SoLoud::handle handle;
+    /// if not 0, [handle] is the voice started by this play event
+    unsigned int playEventId;
+    unsigned int filterId;
+    unsigned int attributeId;
+    float value;
+    float pan;
+};
+
+/// Something driven by the timeline, ie a sequencer.
+class TimelineListener
+{
+public:
+    virtual ~TimelineListener() {}
+
+    /// @brief called by the audio thread before mixing. Run what is due
+    /// at [aSampleTime].
+    /// @return how many of the next [aSamples] samples can be mixed before
+    /// this must be called again, or 0 if nothing is due in them.
+    virtual unsigned int onTimeline(unsigned long long aSampleTime, unsigned int aSamples) = 0;
+};
+
+/// Events scheduled at an absolute engine time, in samples.
+///
+/// The events are kept in a priority queue consumed by the audio thread
+/// through the SoLoud mix callback: the output buffer is mixed in parts
+/// split at the event times, so an event lands on its exact sample
+/// regardless of the backend buffer size. If another thread holds the queue
+/// when a part is mixed, the audio thread doesn't wait for it: the events
+/// and listeners run a few samples later.
+class Timeline
+{
+public:
+    Timeline(SoLoud::Soloud *soloud);
+
+    /// @brief the function to pass to [Soloud::setMixCallback]
+    static unsigned int mixCallback(void *aUserData, unsigned long long aSampleTime, unsigned int aSamples);
+
+    /// @brief the engine time in samples: the samples mixed so far.
+    unsigned long long getTime();
+
+    /// @brief add an event. Events in the past are run with the next mix.
+    /// @return the id of the event.
+    unsigned int schedule(TimelineEvent event);
+
+    /// @brief remove a pending event.
+    /// @return false if the event has already been run or doesn't exist.
+    bool cancel(unsigned int eventId);
+
+    /// @brief remove the pending events which play [source].
+    void cancelSource(SoLoud::AudioSource *source);
+
+    /// @brief remove all the pending events.
+    void clear();
+
+    /// @brief add a [listener] called before mixing each part of the output.
+    void addListener(TimelineListener *listener);
+
+    /// @brief remove [listener]. When this returns the audio thread is not
+    /// using it anymore.
+    void removeListener(TimelineListener *listener);
+
+    /// @brief get the voice started by a [TIMELINE_PLAY] event.
+    /// @param source if not null, return the source played.
+    /// @return the handle or 0 if the event has not been run yet.
+    /// Only the latest [FIRED_SLOTS] handles are remembered.
+    SoLoud::handle getPlayedHandle(unsigned int eventId, SoLoud::AudioSource **source = nullptr);
+
+private:
+    unsigned int onMix(unsigned long long aSampleTime, unsigned int aSamples);
+    void run(const TimelineEvent &event);
+
+    static const unsigned int FIRED_SLOTS = 1024;
+
+    SoLoud::Soloud *mSoloud;
+    /// also held by the audio thread while running the events, only if free
+    std::mutex mMutex;
+    /// min-heap on [time, order]
+    std::vector<TimelineEvent> mQueue;
+    std::vector<TimelineListener *> mListeners;
+    unsigned long long mOrder;
+    unsigned int mNextId;
+    std::atomic<unsigned long long> mTime;
+
+    struct FiredPlay
+    {
+        unsigned int id;
+        SoLoud::handle handle;
+        SoLoud::AudioSource *source;
+    };
+    FiredPlay mFired[FIRED_SLOTS];
+};
+
+#endif // TIMELINE_H
@@ -0,0 +1,102 @@
+#include "variation_container.h"
+
+#include <algorithm>
+#include <cmath>
+
+VariationContainer::VariationContainer(unsigned int hash, VariationMode mode)
+    : mHash(hash),
+      mMode(mode),
+      mPosition(0),
+      mLast(-1),
+      mMinPitch(0.0f),
+      mMaxPitch(0.0f),
+      mMinVolume(1.0f),
+      mMaxVolume(1.0f),
+      mRandom(std::random_device()())
+{
+}
+
+void VariationContainer::setSounds(const unsigned int *soundHashes, unsigned int count)
+{
+    mSounds.assign(soundHashes, soundHashes + count);
+    mOrder.clear();
+    mPosition = 0;
+    mLast = -1;
+}
+
+void VariationContainer::removeSound(unsigned int soundHash)
+{
+    auto it = std::find(mSounds.begin(), mSounds.end(), soundHash);
+    if (it == mSounds.end())
+        return;
+    mSounds.erase(it);
+    mOrder.clear();
+    mPosition = 0;
+    mLast = -1;
+}
+
+void VariationContainer::setRandomization(float minPitch, float maxPitch, float minVolume, float maxVolume)
+{
+    mMinPitch = std::min(minPitch, maxPitch);
+    mMaxPitch = std::max(minPitch, maxPitch);
+    mMinVolume = std::max(0.0f, std::min(minVolume, maxVolume));
+    mMaxVolume = std::max(0.0f, std::max(minVolume, maxVolume));
+}
+
+float VariationContainer::uniform(float min, float max)
+{
+    if (max <= min)
+        return min;
+    return std::uniform_real_distribution<float>(min, max)(mRandom);
+}
+
+void VariationContainer::shuffle()
+{
+    mOrder.resize(mSounds.size());
+    for (unsigned int i = 0; i < mOrder.size(); i++)
+        mOrder[i] = i;
+    std::shuffle(mOrder.begin(), mOrder.end(), mRandom);
+    // don't repeat the last sound of the previous round
+    if (mOrder.size() > 1 && (int)mOrder[0] == mLast)
+        std::swap(mOrder[0], mOrder[1 + mRandom() % (mOrder.size() - 1)]);
+    mPosition = 0;
+}
+
+bool VariationContainer::next(unsigned int &soundHash, float &volume, float &speed)
+{
+    const unsigned int count = (unsigned int)mSounds.size();
+    if (count == 0)
+        return false;
+
+    unsigned int index = 0;
+    switch (mMode)
+    {
+    case VARIATION_RANDOM_NO_REPEAT:
+        if (count == 1 || mLast < 0)
+        {
+            index = mRandom() % count;
+        }
+        else
+        {
+            // pick among the others, skipping over the last one
+            index = mRandom() % (count - 1);
+            if ((int)index >= mLast)
+                index++;
+        }
+        break;
+    case VARIATION_SHUFFLE:
+        if (mPosition >= mOrder.size())
+            shuffle();
+        index = mOrder[mPosition++];
+        break;
+    case VARIATION_SEQUENTIAL:
+        index = mLast < 0 ? 0 : (mLast + 1) % count;
+        break;
+    }
+    mLast = (int)index;
+
+    soundHash = mSounds[index];
+    volume = uniform(mMinVolume, mMaxVolume);
+    speed = powf(2.0f, uniform(mMinPitch, mMaxPitch) / 12.0f);
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef VARIATION_CONTAINER_H
+#define VARIATION_CONTAINER_H
+
+#include <random>
+#include <vector>
+
+typedef enum VariationMode
+{
+    /// a random sound, never the last one played twice in a row
+    VARIATION_RANDOM_NO_REPEAT,
+    /// all the sounds in a random order, then again in another order
+    VARIATION_SHUFFLE,
+    /// the sounds in the order they were given
+    VARIATION_SEQUENTIAL
+} VariationMode_t;
+
+/// A set of sounds played as one: each trigger picks one of them and
+/// randomizes its pitch and volume, so footsteps or impacts don't repeat
+/// the same sample.
+///
+/// The container only selects: [Player] plays the picked sound like any
+/// other, so its voice, filters and handle are those of that sound.
+class VariationContainer
+{
+public:
+    VariationContainer(unsigned int hash, VariationMode mode);
+
+    unsigned int getHash() const { return mHash; }
+
+    void setSounds(const unsigned int *soundHashes, unsigned int count);
+    /// @brief remove [soundHash] from the set. Used when it is disposed.
+    void removeSound(unsigned int soundHash);
+    bool isEmpty() const { return mSounds.empty(); }
+
+    /// @brief set the range of the random transposition in semitones, and
+    /// of the random volume multiplier.
+    void setRandomization(float minPitch, float maxPitch, float minVolume, float maxVolume);
+
+    /// @brief pick the sound of the next trigger.
+    /// @param soundHash return the sound to play.
+    /// @param volume return the volume multiplier.
+    /// @param speed return the relative play speed.
+    /// @return false if the container is empty.
+    bool next(unsigned int &soundHash, float &volume, float &speed);
+
+private:
+    /// @brief refill [mOrder] with a new permutation of the sounds.
+    void shuffle();
+    float uniform(float min, float max);
+
+    unsigned int mHash;
+    VariationMode mMode;
+    std::vector<unsigned int> mSounds;
+    /// shuffle bag, indices into [mSounds]
+    std::vector<unsigned int> mOrder;
+    unsigned int mPosition;
+    /// index of the last sound picked, -1 if none
+    int mLast;
+
+    float mMinPitch;
+    float mMaxPitch;
+    float mMinVolume;
+    float mMaxVolume;
+
+    std::minstd_rand mRandom;
+};
+
+#endif // VARIATION_CONTAINER_H